@@ -0,0 +1,88 @@
+/** arch_state.h
+ *
+ * This file defines the architectural state of the processor, which is what the fast-forward
+ * engine hands over to the cycle-accurate model, and the point at which the handover happens.
+ *
+ */
+
+#ifndef _ARCH_STATE_H_
+#define _ARCH_STATE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "generic_if.h"
+
+namespace cactus {
+
+// number of comparison flags written by cmp and read by br/fbr, see Classical_execute
+#define NUM_CMP_FLAGS 16
+
+// --------------------------------------------------------------------------------------------
+// the point where fast-forwarding stops
+// --------------------------------------------------------------------------------------------
+// PC:    before the instruction at this address is executed,
+// CYCLE: before the first quantum instruction which starts at or after this 50 MHz cycle,
+// LABEL: before the instruction marked by this label (asm programs only).
+enum Ff_target_type { FF_NONE = 0, FF_PC, FF_CYCLE, FF_LABEL };
+
+class Ff_target {
+  public:
+    Ff_target_type type  = FF_NONE;
+    uint64_t       value = 0;  // pc or cycle
+    std::string    label;
+
+  public:
+    bool is_set() const { return type != FF_NONE; }
+
+    // "pc:<addr>", "cycle:<num>" or "label:<name>". Returns false if the text is not one of them.
+    bool parse(const std::string& text);
+
+    std::string to_string() const;
+};
+
+// --------------------------------------------------------------------------------------------
+// architectural state
+// --------------------------------------------------------------------------------------------
+class Arch_state {
+  public:
+    // set once the fast-forward engine has run, the cycle-accurate model starts from this state
+    bool valid = false;
+
+    // the address of the next instruction
+    unsigned int pc = 0;
+
+    int32_t regs[REG_FILE_NUM]       = { 0 };
+    bool    flags_cmp[NUM_CMP_FLAGS] = { false };
+
+    // the target registers set by smis/smit
+    Q_mask_reg mask_reg;
+
+    // the last measurement result of every qubit
+    std::vector<unsigned int> meas_results;
+
+    // the 50 MHz cycle of the last quantum timing point
+    uint64_t q_cycle = 0;
+
+    // number of instructions executed
+    uint64_t num_insns = 0;
+
+  public:
+    void reset(size_t num_qubits) {
+        valid = false;
+        pc    = 0;
+        for (size_t i = 0; i < REG_FILE_NUM; ++i) regs[i] = 0;
+        for (size_t i = 0; i < NUM_CMP_FLAGS; ++i) flags_cmp[i] = false;
+        flags_cmp[0] = true;  // always
+        mask_reg.reset();
+        meas_results.assign(num_qubits, 0);
+        q_cycle   = 0;
+        num_insns = 0;
+    }
+};
+
+}  // namespace cactus
+
+#endif  // _ARCH_STATE_H_
@@ -0,0 +1,177 @@
+#include "asm_lexer.h"
+
+#include <cctype>
+
+namespace cactus {
+
+namespace {
+
+// numbers larger than this are clamped. They are rejected later by the range checks anyway.
+const unsigned long long MAX_LITERAL = 0xFFFFFFFFFFULL;
+
+inline bool is_ident_start(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+inline bool is_ident_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+inline int hex_digit_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+Asm_lexer::Asm_lexer(const std::string& line)
+    : Asm_lexer(line.data(), line.size()) {}
+
+Asm_lexer::Asm_lexer(const char* line, size_t len)
+    : m_line(line)
+    , m_size(len)
+    , m_pos(0) {
+    m_peeked = scan();
+}
+
+Asm_token Asm_lexer::scan() {
+    Asm_token   token;
+    const size_t n = m_size;
+
+    while (m_pos < n && std::isspace(static_cast<unsigned char>(m_line[m_pos]))) ++m_pos;
+
+    token.pos = m_pos;
+
+    if (m_pos >= n || m_line[m_pos] == '#') {
+        token.type = TK_END;
+        return token;
+    }
+
+    char c = m_line[m_pos];
+
+    if (is_ident_start(c)) {
+        while (m_pos < n && is_ident_char(m_line[m_pos])) ++m_pos;
+        token.type = TK_IDENT;
+        token.len  = m_pos - token.pos;
+        return token;
+    }
+
+    if (is_digit(c) || (c == '-' && m_pos + 1 < n && is_digit(m_line[m_pos + 1]))) {
+        bool negative = (c == '-');
+        if (negative) ++m_pos;
+
+        unsigned long long value = 0;
+        if (m_line[m_pos] == '0' && m_pos + 2 < n &&
+            (m_line[m_pos + 1] == 'x' || m_line[m_pos + 1] == 'X') &&
+            hex_digit_value(m_line[m_pos + 2]) >= 0) {
+            m_pos += 2;
+            while (m_pos < n && hex_digit_value(m_line[m_pos]) >= 0) {
+                value = value * 16 + hex_digit_value(m_line[m_pos++]);
+                if (value > MAX_LITERAL) value = MAX_LITERAL;
+            }
+        } else {
+            while (m_pos < n && is_digit(m_line[m_pos])) {
+                value = value * 10 + (m_line[m_pos++] - '0');
+                if (value > MAX_LITERAL) value = MAX_LITERAL;
+            }
+        }
+
+        // a number glued to letters, e.g. '12ab', is not a valid token
+        if (m_pos < n && is_ident_char(m_line[m_pos])) {
+            while (m_pos < n && is_ident_char(m_line[m_pos])) ++m_pos;
+            token.type = TK_ERROR;
+            token.len  = m_pos - token.pos;
+            return token;
+        }
+
+        token.type  = TK_NUMBER;
+        token.len   = m_pos - token.pos;
+        token.value = negative ? -static_cast<long long>(value) : static_cast<long long>(value);
+        return token;
+    }
+
+    ++m_pos;
+    token.len = 1;
+    switch (c) {
+        case ',':
+            token.type = TK_COMMA;
+            break;
+        case '(':
+            token.type = TK_LPAREN;
+            break;
+        case ')':
+            token.type = TK_RPAREN;
+            break;
+        case '{':
+            token.type = TK_LBRACE;
+            break;
+        case '}':
+            token.type = TK_RBRACE;
+            break;
+        case '|':
+            token.type = TK_PIPE;
+            break;
+        case ':':
+            token.type = TK_COLON;
+            break;
+        default:
+            token.type = TK_ERROR;
+            break;
+    }
+    return token;
+}
+
+Asm_token Asm_lexer::next() {
+    Asm_token token = m_peeked;
+    if (token.type != TK_END) m_peeked = scan();
+    return token;
+}
+
+bool Asm_lexer::accept(Asm_token_type type) {
+    if (m_peeked.type != type) return false;
+    next();
+    return true;
+}
+
+std::string Asm_lexer::text(const Asm_token& token) const {
+    return std::string(m_line + token.pos, token.len);
+}
+
+std::string Asm_lexer::lower_text(const Asm_token& token) const {
+    std::string s = text(token);
+    for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+bool Asm_lexer::ident_is(const Asm_token& token, const char* lower_word) const {
+    if (token.type != TK_IDENT) return false;
+
+    size_t i = 0;
+    for (; i < token.len; ++i) {
+        if (lower_word[i] == '\0') return false;
+        if (std::tolower(static_cast<unsigned char>(m_line[token.pos + i])) != lower_word[i])
+            return false;
+    }
+    return lower_word[i] == '\0';
+}
+
+bool Asm_lexer::is_reg(const Asm_token& token, char prefix, unsigned int& num) const {
+    if (token.type != TK_IDENT || token.len < 2) return false;
+
+    if (std::tolower(static_cast<unsigned char>(m_line[token.pos])) != prefix) return false;
+
+    unsigned long long value = 0;
+    for (size_t i = 1; i < token.len; ++i) {
+        char c = m_line[token.pos + i];
+        if (!is_digit(c)) return false;
+        value = value * 10 + (c - '0');
+        if (value > MAX_LITERAL) value = MAX_LITERAL;
+    }
+
+    num = (value > 0xFFFFFFFFULL) ? 0xFFFFFFFFU : static_cast<unsigned int>(value);
+    return true;
+}
+
+}  // namespace cactus
@@ -0,0 +1,75 @@
+/** asm_lexer.h
+ *
+ * This file defines a single pass tokenizer for one line of eQASM.
+ *
+ * Tokens are produced on demand and refer to the line by position, so tokenizing does not
+ * allocate. The recursive descent parser built on top of it lives in qasm_instruction.cpp.
+ *
+ */
+
+#ifndef _ASM_LEXER_H_
+#define _ASM_LEXER_H_
+
+#include <cstddef>
+#include <string>
+
+namespace cactus {
+
+enum Asm_token_type {
+    TK_IDENT,   // [A-Za-z_][A-Za-z0-9_.]*, e.g. mnemonics, registers, labels
+    TK_NUMBER,  // decimal or hexadecimal (0x) integer, optionally negative
+    TK_COMMA,   // ,
+    TK_LPAREN,  // (
+    TK_RPAREN,  // )
+    TK_LBRACE,  // {
+    TK_RBRACE,  // }
+    TK_PIPE,    // |
+    TK_COLON,   // :
+    TK_END,     // end of the line, or the start of a comment
+    TK_ERROR    // any other character
+};
+
+struct Asm_token {
+    Asm_token_type type  = TK_END;
+    size_t         pos   = 0;  // position in the line
+    size_t         len   = 0;
+    long long      value = 0;  // only for TK_NUMBER
+};
+
+class Asm_lexer {
+  private:
+    const char* m_line;
+    size_t      m_size;
+    size_t      m_pos;
+    Asm_token   m_peeked;
+
+    Asm_token scan();
+
+  public:
+    // the line is referenced, not copied, and must outlive the lexer
+    explicit Asm_lexer(const std::string& line);
+    Asm_lexer(const char* line, size_t len);
+
+    // the next token, without consuming it
+    const Asm_token& peek() const { return m_peeked; }
+
+    // consume and return the next token
+    Asm_token next();
+
+    // consume the next token if it has the given type
+    bool accept(Asm_token_type type);
+
+    std::string text(const Asm_token& token) const;
+    std::string lower_text(const Asm_token& token) const;
+
+    // case insensitive comparison of an identifier with a lower case word
+    bool ident_is(const Asm_token& token, const char* lower_word) const;
+
+    // a register is an identifier made of the given (case insensitive) prefix and a number,
+    // e.g. r3, s10 or T2
+    bool is_reg(const Asm_token& token, char prefix, unsigned int& num) const;
+};
+
+}  // namespace cactus
+
+#endif  // _ASM_LEXER_H_
@@ -0,0 +1,339 @@
+#include "asm_program.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+
+#include "asm_lexer.h"
+#include "logger_wrapper.h"
+#include "mapped_file.h"
+#include "num_util.h"
+#include "thread_pool.h"
+
+namespace cactus {
+
+namespace {
+
+inline bool has_alnum(const std::string& s) {
+    return std::any_of(s.begin(), s.end(),
+                       [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; });
+}
+
+}  // namespace
+
+void Asm_program::clear() {
+    lines.clear();
+    text.clear();
+    map_label.clear();
+    label_refs.clear();
+}
+
+void Asm_program::load(const std::string& asm_fn, unsigned int num_threads) {
+    auto logger = get_logger_or_exit("asm_logger");
+
+    clear();
+
+    // the file is mapped instead of read, so only one line at a time is copied out of it
+    Mapped_file asm_file;
+    if (!asm_file.open(asm_fn)) {
+        logger->error("asm_parser: Failed to open file: '{}'. Simulation aborts!", asm_fn);
+        exit(EXIT_FAILURE);
+    }
+
+    const char* begin = asm_file.data();
+    const char* end   = begin + asm_file.size();
+
+    Thread_pool pool(num_threads);
+
+    size_t num_chunks = 1;
+    if (pool.num_threads() > 1 && min_chunk_size > 0) {
+        // a few chunks per thread, so that a slow chunk does not hold up the others
+        num_chunks = std::min(asm_file.size() / min_chunk_size,
+                              static_cast<size_t>(pool.num_threads()) * 4);
+        num_chunks = std::max(num_chunks, static_cast<size_t>(1));
+    }
+
+    if (num_chunks == 1) {
+        finish(scan_lines(begin, end, 1));
+        resolve_labels();
+    } else {
+        // every chunk starts at the beginning of a line
+        std::vector<const char*> bounds(num_chunks + 1, end);
+        bounds[0] = begin;
+        for (size_t i = 1; i < num_chunks; ++i) {
+            const char* cur = std::max(begin + asm_file.size() / num_chunks * i, bounds[i - 1]);
+            const char* eol = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+            bounds[i]       = (eol == nullptr) ? end : eol + 1;
+        }
+
+        // phase one: the number of the first line of each chunk, then the lines of each chunk
+        std::vector<unsigned int> first_line(num_chunks + 1, 1);
+        pool.run(num_chunks, [&](size_t i) {
+            first_line[i + 1] =
+              static_cast<unsigned int>(std::count(bounds[i], bounds[i + 1], '\n'));
+        });
+        for (size_t i = 1; i <= num_chunks; ++i) first_line[i] += first_line[i - 1];
+
+        std::vector<Asm_program> parts(num_chunks);
+        std::vector<unsigned int> next_line(num_chunks);
+        pool.run(num_chunks, [&](size_t i) {
+            next_line[i] = parts[i].scan_lines(bounds[i], bounds[i + 1], first_line[i]);
+        });
+
+        // phase two: the addresses of the chunks are only known in order. The first definition
+        // of a label is kept, as in a sequential pass.
+        size_t num_lines = 0;
+        size_t text_size = 0;
+        for (const auto& part : parts) {
+            num_lines += part.lines.size();
+            text_size += part.text.size();
+        }
+        lines.reserve(num_lines + 1);
+        text.buffer().reserve(text_size + 4);
+
+        for (auto& part : parts) {
+            unsigned int offset      = static_cast<unsigned int>(lines.size());
+            uint64_t     text_offset = text.append(part.text);
+            for (auto& line : part.lines) {
+                line.asm_text.offset += text_offset;
+                line.src_text.offset += text_offset;
+            }
+            for (const auto& label : part.map_label) {
+                map_label.insert(std::make_pair(label.first, label.second + offset));
+            }
+            for (const auto& ref : part.label_refs) {
+                label_refs.push_back(std::make_pair(ref.first + offset, ref.second));
+            }
+            std::move(part.lines.begin(), part.lines.end(), std::back_inserter(lines));
+            part.clear();
+        }
+
+        // chunks after the end of the file are empty, and do not count the last unterminated line
+        finish(*std::max_element(next_line.begin(), next_line.end()));
+        resolve_labels();
+    }
+
+    logger->trace("asm_parser: Read {} elementary instructions from '{}' in {} chunk(s).",
+                  lines.size(), asm_fn, num_chunks);
+}
+
+unsigned int Asm_program::scan_lines(const char* begin, const char* end, unsigned int line_num) {
+    std::string line;
+
+    for (const char* cur = begin; cur < end;) {
+        const char* eol = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+        if (eol == nullptr) eol = end;
+
+        line.assign(cur, eol);
+        add_src_line(line, line_num++);
+
+        cur = eol + 1;
+    }
+
+    return line_num;
+}
+
+void Asm_program::decode(std::vector<Qasm_instruction>& insns, unsigned int num_threads) {
+    const size_t block_size = 4096;
+    const size_t num_blocks = (lines.size() + block_size - 1) / block_size;
+
+    insns.clear();
+    insns.resize(lines.size());
+
+    // labels are complete, so every block can be decoded on its own. Each block stops at its
+    // first error, and only the error at the lowest address is reported, as in a sequential pass.
+    std::vector<std::string> block_error(num_blocks);
+
+    Thread_pool pool(num_threads);
+    pool.run(num_blocks, [&](size_t b) {
+        size_t last = std::min((b + 1) * block_size, lines.size());
+        for (size_t i = b * block_size; i < last; ++i) {
+            unsigned int addr = static_cast<unsigned int>(i);
+            if (!insns[i].try_set_instruction(text, lines[i], addr, block_error[b])) return;
+        }
+    });
+
+    for (const auto& error_msg : block_error) {
+        if (!error_msg.empty()) {
+            auto logger = get_logger_or_exit("asm_logger");
+            logger->error("{}", error_msg);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void Asm_program::add_src_line(std::string& line, unsigned int line_num) {
+    // remove comments which indicate by first char '#'
+    trim_comments(line);
+
+    // ex: "label: add r1,r2,r3"
+    size_t colon = line.find(':');
+    if (colon != line.npos) {
+        std::string label = line.substr(0, colon);
+        map_label.insert(std::make_pair(trim(label), static_cast<unsigned int>(lines.size())));
+
+        // more than one ':' is not an instruction
+        std::string insn = line.substr(colon + 1);
+        if ((insn.find(':') == insn.npos) && has_alnum(insn)) {
+            convert_line_to_ele_instr(insn, line_num);
+        }
+    } else if (has_alnum(line)) {
+        // ex："add r1,r2,r3"
+        convert_line_to_ele_instr(line, line_num);
+    }
+}
+
+// remember the label used by the br instruction just added, e.g. "br always, loop". Malformed
+// instructions are left to the decoder, which reports them.
+void Asm_program::add_label_ref(const std::string& br_str) {
+    Asm_lexer lexer(br_str);
+    lexer.next();  // mnemonic
+
+    if (!lexer.accept(TK_IDENT)) return;
+    lexer.accept(TK_COMMA);  // the comma is optional, as in the decoder
+
+    Asm_token label = lexer.peek();
+    if ((label.type == TK_IDENT) || (label.type == TK_NUMBER)) {
+        label_refs.push_back(
+          std::make_pair(static_cast<unsigned int>(lines.size() - 1), lexer.text(label)));
+    }
+}
+
+void Asm_program::resolve_labels() {
+    auto logger = get_logger_or_exit("asm_logger");
+
+    size_t num_undefined = 0;
+    for (const auto& ref : label_refs) {
+        Asm_line& line = lines[ref.first];
+
+        auto it_label = map_label.find(ref.second);
+        if (it_label == map_label.end()) {
+            logger->error("asm_parser: Undefined label '{}' used by instruction '{}' at line {}.",
+                          ref.second, text.str(line.src_text), line.line_num);
+            ++num_undefined;
+        } else {
+            line.br_target = it_label->second;
+        }
+    }
+
+    if (num_undefined > 0) {
+        logger->error("asm_parser: Found {} undefined label(s). Simulation aborts!",
+                      num_undefined);
+        exit(EXIT_FAILURE);
+    }
+
+    // the targets are stored in the lines, the label names are no longer needed
+    std::vector<std::pair<unsigned int, std::string>>().swap(label_refs);
+}
+
+void Asm_program::finish(unsigned int line_num) {
+    Asm_line stop_instr;
+    stop_instr.asm_text = text.add("stop");
+    stop_instr.src_text = stop_instr.asm_text;
+    stop_instr.line_num = line_num;
+    lines.push_back(stop_instr);  // add extra stop instructions at the end
+}
+
+void Asm_program::save(Cache_writer& writer) const {
+    writer.put(text.buffer());
+    writer.put(static_cast<uint64_t>(lines.size()));
+    for (const auto& line : lines) {
+        writer.put(line.asm_text);
+        writer.put(line.src_text);
+        writer.put(line.line_num);
+        writer.put(line.br_target);
+        writer.put(line.q_qubit_indices);
+        writer.put(line.q_qubit_tuples);
+        writer.put(line.q_reg_num);
+        writer.put(line.q_op_name);
+        writer.put(line.q_num_tgt_qubits_type);
+    }
+    writer.put(map_label);
+}
+
+bool Asm_program::restore(Cache_reader& reader) {
+    clear();
+
+    reader.get(text.buffer());
+
+    uint64_t num_lines = 0;
+    reader.get(num_lines);
+    for (uint64_t i = 0; reader.ok() && i < num_lines; ++i) {
+        lines.emplace_back();
+        reader.get(lines.back().asm_text);
+        reader.get(lines.back().src_text);
+        reader.get(lines.back().line_num);
+        if (lines.back().asm_text.offset + lines.back().asm_text.length > text.size() ||
+            lines.back().src_text.offset + lines.back().src_text.length > text.size()) {
+            clear();  // not a program image of this format
+            return false;
+        }
+        reader.get(lines.back().br_target);
+        reader.get(lines.back().q_qubit_indices);
+        reader.get(lines.back().q_qubit_tuples);
+        reader.get(lines.back().q_reg_num);
+        reader.get(lines.back().q_op_name);
+        reader.get(lines.back().q_num_tgt_qubits_type);
+    }
+    reader.get(map_label);
+
+    if (!reader.ok() || lines.empty()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+unsigned int Asm_program::convert_line_to_ele_instr(std::string& line_str, unsigned int line_num) {
+    Asm_line    instr_info;
+    std::string bne_content = "";
+    std::string br_label    = "";
+    std::string br_cond     = "";
+
+    instr_info.line_num = line_num;
+
+    // find macro bne,beq
+    trim(line_str);
+    instr_info.src_text = text.add(line_str);
+
+    Asm_lexer lexer(line_str);
+    if (lexer.ident_is(lexer.peek(), "bne")) {
+        br_cond = "ne";
+    } else if (lexer.ident_is(lexer.peek(), "beq")) {
+        br_cond = "eq";
+    } else {
+        // not beq or bne, the instruction is the source line itself
+        instr_info.asm_text = instr_info.src_text;
+        lines.push_back(instr_info);
+        if (lexer.ident_is(lexer.peek(), "br")) add_label_ref(line_str);
+        return 1;
+    }
+
+    size_t start = line_str.find_first_of(" ");
+    if (start != line_str.npos) {
+        bne_content = line_str.substr(start);
+    }
+    size_t end = bne_content.find_last_of(",");
+    if (end != bne_content.npos) {
+        br_label = bne_content.substr(end);
+        bne_content.erase(end);
+    }
+
+    // push back cmp
+    instr_info.asm_text = text.add("cmp " + bne_content);
+    lines.push_back(instr_info);
+
+    // push back nop
+    instr_info.asm_text = text.add("nop");
+    lines.push_back(instr_info);
+
+    // push back br
+    std::string br_str  = "br " + br_cond + br_label;
+    instr_info.asm_text = text.add(br_str);
+    lines.push_back(instr_info);
+    add_label_ref(br_str);
+    return 3;
+}
+
+}  // namespace cactus
@@ -0,0 +1,75 @@
+/** asm_program.h
+ *
+ * This file defines the program image of an eQASM file.
+ *
+ * The program image holds the elementary instructions (macros like bne/beq are expanded) and the
+ * address of every label. Branch targets are resolved once the whole file has been read.
+ * Decoded Qasm_instructions refer to the lines of the image.
+ *
+ * The text of all the lines is kept in a single arena. An instruction and the source line it
+ * comes from share the same text unless the instruction has been expanded from a macro.
+ *
+ */
+
+#ifndef _ASM_PROGRAM_H_
+#define _ASM_PROGRAM_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cache_file.h"
+#include "qasm_instruction.h"
+
+namespace cactus {
+
+class Asm_program {
+  public:
+    std::vector<Asm_line>               lines;      // elementary instructions, ends with stop
+    Asm_text_arena                      text;       // the text the lines refer to
+    std::map<std::string, unsigned int> map_label;  // label -> address
+
+    // files are only split over several threads in chunks of at least this size
+    size_t min_chunk_size = 1 << 20;
+
+  public:
+    // read the whole program from the file, and append the final stop instruction. Large files
+    // are split into chunks which are read on num_threads threads (0 for one per core). The result
+    // is the same as reading the file line by line.
+    void load(const std::string& asm_fn, unsigned int num_threads = 1);
+
+    // decode every line, on num_threads threads. Aborts on the first instruction (in address
+    // order) that cannot be parsed.
+    void decode(std::vector<Qasm_instruction>& insns, unsigned int num_threads = 1);
+
+    // add one line of the source file, e.g. "label: add r1,r2,r3 # comment"
+    void add_src_line(std::string& line, unsigned int line_num);
+
+    // add the extra stop instruction at the end of the program
+    void finish(unsigned int line_num);
+
+    // store the address of the label used by every br instruction in its line. Aborts after
+    // reporting all the labels which are not defined.
+    void resolve_labels();
+
+    void clear();
+
+    // the program image in a cache file. restore() returns false if the content is not usable.
+    void save(Cache_writer& writer) const;
+    bool restore(Cache_reader& reader);
+
+  private:
+    // br instructions whose label is not resolved yet: line index -> label
+    std::vector<std::pair<unsigned int, std::string>> label_refs;
+
+    void add_label_ref(const std::string& br_str);
+
+    // add the lines in [begin, end), and return the number of the line after them
+    unsigned int scan_lines(const char* begin, const char* end, unsigned int line_num);
+
+    unsigned int convert_line_to_ele_instr(std::string& line_str, unsigned int line_num);
+};
+
+}  // namespace cactus
+
+#endif  // _ASM_PROGRAM_H_
@@ -0,0 +1,267 @@
+/** bit_set.h
+ *
+ * This file defines a set of bits with one bit per qubit, e.g. the qubits which are measured in a
+ * cycle, packed into 64-bit words.
+ *
+ * The width is chosen at run time, usually the number of qubits, and the words are stored inline
+ * up to BIT_SET_MAX_WIDTH bits, so that a set is copied, compared and combined a word at a time,
+ * without any heap allocation. Only the words within the width are touched.
+ *
+ */
+
+#ifndef _BIT_SET_H_
+#define _BIT_SET_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <systemc>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cactus {
+
+// the largest width of a set, which is the largest number of qubits which can be simulated
+#define BIT_SET_MAX_WIDTH 1024
+#define BIT_SET_WORD_WIDTH 64
+#define BIT_SET_NUM_WORDS (BIT_SET_MAX_WIDTH / BIT_SET_WORD_WIDTH)
+
+// the number of bits which are set in a word
+inline unsigned int popcount_64(uint64_t word) {
+#ifdef _MSC_VER
+    return static_cast<unsigned int>(__popcnt64(word));
+#else
+    return static_cast<unsigned int>(__builtin_popcountll(word));
+#endif
+}
+
+// the index of the lowest bit which is set in a word, which must not be 0
+inline unsigned int lowest_bit_64(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+}
+
+class Bit_set {
+  private:
+    uint64_t m_words[BIT_SET_NUM_WORDS];
+    size_t   m_width     = 0;
+    size_t   m_num_words = 0;
+
+    // the bits of the last word which are beyond the width are kept 0
+    uint64_t last_word_mask() const {
+        size_t num_bits = m_width % BIT_SET_WORD_WIDTH;
+        return num_bits ? (uint64_t(1) << num_bits) - 1 : ~uint64_t(0);
+    }
+
+  public:
+    // the words are cleared, so that a set which is never sized reads as 0
+    Bit_set()
+        : m_words() {}
+
+    // all the bits are 0
+    explicit Bit_set(size_t width) { resize(width); }
+
+    Bit_set(const Bit_set& other) { *this = other; }
+
+    // the bits which are added are 0. The width is at most BIT_SET_MAX_WIDTH, which is checked
+    // against the number of qubits when the configuration is read.
+    void resize(size_t width) {
+        assert(width <= BIT_SET_MAX_WIDTH);
+        size_t num_words = (width + BIT_SET_WORD_WIDTH - 1) / BIT_SET_WORD_WIDTH;
+        for (size_t w = m_num_words; w < num_words; ++w) {
+            m_words[w] = 0;
+        }
+        m_width     = width;
+        m_num_words = num_words;
+        if (m_num_words > 0) m_words[m_num_words - 1] &= last_word_mask();
+    }
+
+    size_t size() const { return m_width; }
+
+    // all the bits are 0, the width is kept
+    void reset() { std::fill(m_words, m_words + m_num_words, 0); }
+
+    // the bit i must be within the width
+    bool test(size_t i) const {
+        assert(i < m_width);
+        return (m_words[i / BIT_SET_WORD_WIDTH] >> (i % BIT_SET_WORD_WIDTH)) & 1;
+    }
+
+    void set(size_t i) {
+        assert(i < m_width);
+        m_words[i / BIT_SET_WORD_WIDTH] |= uint64_t(1) << (i % BIT_SET_WORD_WIDTH);
+    }
+
+    void set(size_t i, bool value) {
+        if (value) {
+            set(i);
+        } else {
+            reset(i);
+        }
+    }
+
+    void reset(size_t i) {
+        assert(i < m_width);
+        m_words[i / BIT_SET_WORD_WIDTH] &= ~(uint64_t(1) << (i % BIT_SET_WORD_WIDTH));
+    }
+
+    // all the bits within the width are 1
+    void set_all() {
+        std::fill(m_words, m_words + m_num_words, ~uint64_t(0));
+        if (m_num_words > 0) m_words[m_num_words - 1] &= last_word_mask();
+    }
+
+    bool any() const {
+        for (size_t w = 0; w < m_num_words; ++w) {
+            if (m_words[w]) return true;
+        }
+        return false;
+    }
+
+    bool none() const { return !any(); }
+
+    // the number of bits which are 1
+    size_t count() const {
+        size_t num_bits = 0;
+        for (size_t w = 0; w < m_num_words; ++w) {
+            num_bits += popcount_64(m_words[w]);
+        }
+        return num_bits;
+    }
+
+    // the words, the bit i being the bit i % 64 of the word i / 64
+    size_t   num_words() const { return m_num_words; }
+    uint64_t word(size_t w) const { return m_words[w]; }
+    void     set_word(size_t w, uint64_t word) {
+        assert(w < m_num_words);
+        m_words[w] = (w + 1 == m_num_words) ? (word & last_word_mask()) : word;
+    }
+
+    // calls f(i) for each bit i which is 1, in increasing order
+    template <typename Function>
+    void for_each(Function f) const {
+        for (size_t w = 0; w < m_num_words; ++w) {
+            uint64_t word = m_words[w];
+            while (word) {
+                f(w * BIT_SET_WORD_WIDTH + lowest_bit_64(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // the bits of a narrower set are 0 beyond its width
+    Bit_set& operator&=(const Bit_set& other) {
+        size_t num_words = std::min(m_num_words, other.m_num_words);
+        for (size_t w = 0; w < num_words; ++w) {
+            m_words[w] &= other.m_words[w];
+        }
+        std::fill(m_words + num_words, m_words + m_num_words, 0);
+        return *this;
+    }
+
+    Bit_set& operator|=(const Bit_set& other) {
+        size_t num_words = std::min(m_num_words, other.m_num_words);
+        for (size_t w = 0; w < num_words; ++w) {
+            m_words[w] |= other.m_words[w];
+        }
+        if (m_num_words > 0) m_words[m_num_words - 1] &= last_word_mask();
+        return *this;
+    }
+
+    Bit_set& operator^=(const Bit_set& other) {
+        size_t num_words = std::min(m_num_words, other.m_num_words);
+        for (size_t w = 0; w < num_words; ++w) {
+            m_words[w] ^= other.m_words[w];
+        }
+        if (m_num_words > 0) m_words[m_num_words - 1] &= last_word_mask();
+        return *this;
+    }
+
+    // clears the bits which are 1 in the other set
+    Bit_set& and_not(const Bit_set& other) {
+        size_t num_words = std::min(m_num_words, other.m_num_words);
+        for (size_t w = 0; w < num_words; ++w) {
+            m_words[w] &= ~other.m_words[w];
+        }
+        return *this;
+    }
+
+    // the bits below the width of the other set are replaced by its bits, the others are kept
+    Bit_set& overwrite(const Bit_set& other) {
+        size_t width     = std::min(m_width, other.m_width);
+        size_t num_words = width / BIT_SET_WORD_WIDTH;
+        std::copy(other.m_words, other.m_words + num_words, m_words);
+        if (width % BIT_SET_WORD_WIDTH) {
+            uint64_t mask      = (uint64_t(1) << (width % BIT_SET_WORD_WIDTH)) - 1;
+            m_words[num_words] = (m_words[num_words] & ~mask) | (other.m_words[num_words] & mask);
+        }
+        return *this;
+    }
+
+    // overload of operator =
+    Bit_set& operator=(const Bit_set& other) {
+        if (this != &other) {
+            m_width     = other.m_width;
+            m_num_words = other.m_num_words;
+            std::copy(other.m_words, other.m_words + m_num_words, m_words);
+        }
+        return *this;
+    }
+
+    // overload of operator ==
+    bool operator==(const Bit_set& other) const {
+        return (m_width == other.m_width) &&
+               std::equal(m_words, m_words + m_num_words, other.m_words);
+    }
+
+    bool operator!=(const Bit_set& other) const { return !(*this == other); }
+
+    std::string to_hex() const;
+};
+
+inline Bit_set operator&(Bit_set a, const Bit_set& b) { return a &= b; }
+inline Bit_set operator|(Bit_set a, const Bit_set& b) { return a |= b; }
+inline Bit_set operator^(Bit_set a, const Bit_set& b) { return a ^= b; }
+
+// the bits in hexadecimal from the last one without leading zeros, as a mask is written in an
+// instruction, e.g. 6 when the qubits 1 and 2 are set
+inline std::string Bit_set::to_hex() const {
+    std::string hex;
+    char        digits[17];
+    for (size_t w = m_num_words; w-- > 0;) {
+        if (hex.empty()) {
+            if (m_words[w] == 0 && w > 0) continue;
+            snprintf(digits, sizeof(digits), "%llx", static_cast<unsigned long long>(m_words[w]));
+        } else {
+            snprintf(digits, sizeof(digits), "%016llx",
+                     static_cast<unsigned long long>(m_words[w]));
+        }
+        hex += digits;
+    }
+    return hex.empty() ? "0" : hex;
+}
+
+// the bits from the first one, e.g. 0110 when the qubits 1 and 2 are set
+inline std::ostream& operator<<(std::ostream& os, const Bit_set& bits) {
+    for (size_t i = 0; i < bits.size(); ++i) {
+        os << bits.test(i);
+    }
+    return os;
+}
+
+inline void sc_trace(sc_core::sc_trace_file* tf, const Bit_set& bits, const std::string& name) {}
+
+}  // namespace cactus
+
+#endif  // _BIT_SET_H_
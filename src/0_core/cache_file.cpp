@@ -0,0 +1,147 @@
+#include "cache_file.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace cactus {
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'C', 'A', 'C', 'T', 'U', 'S', 'C', 'F'};
+
+}  // namespace
+
+// ============================================================================================
+// Content_hash
+// ============================================================================================
+void Content_hash::add(const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        m_value ^= p[i];
+        m_value *= 1099511628211ULL;
+    }
+}
+
+void Content_hash::add(const std::string& s) {
+    add_pod(static_cast<uint64_t>(s.size()));
+    add(s.data(), s.size());
+}
+
+bool Content_hash::add_file(const std::string& fn) {
+    Mapped_file file;
+    if (!file.open(fn)) return false;
+
+    add_pod(static_cast<uint64_t>(file.size()));
+    add(file.data(), file.size());
+    return true;
+}
+
+std::string Content_hash::hex() const {
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << m_value;
+    return ss.str();
+}
+
+// ============================================================================================
+// Cache_writer
+// ============================================================================================
+void Cache_writer::put(const std::string& s) {
+    put(static_cast<uint64_t>(s.size()));
+    m_buffer.append(s);
+}
+
+bool Cache_writer::commit(const std::string& fn, const std::string& kind) const {
+    std::string tmp_fn = fn + ".tmp" + std::to_string(getpid());
+
+    {
+        std::ofstream out(tmp_fn, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        uint32_t version = CACHE_FORMAT_VERSION;
+        uint64_t size    = kind.size();
+        out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(kind.data(), kind.size());
+        out.write(m_buffer.data(), m_buffer.size());
+
+        if (!out) {
+            out.close();
+            std::remove(tmp_fn.c_str());
+            return false;
+        }
+    }
+
+    // another run may have written the same file meanwhile, which has the same content
+    std::remove(fn.c_str());
+    if (std::rename(tmp_fn.c_str(), fn.c_str()) != 0) {
+        std::remove(tmp_fn.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================================
+// Cache_reader
+// ============================================================================================
+const char* Cache_reader::take(size_t len) {
+    if (!m_ok || static_cast<size_t>(m_end - m_cur) < len) {
+        m_ok = false;
+        return nullptr;
+    }
+    const char* p = m_cur;
+    m_cur += len;
+    return p;
+}
+
+bool Cache_reader::open(const std::string& fn, const std::string& kind) {
+    m_ok = false;
+    if (!m_file.open(fn) || m_file.size() == 0) return false;
+
+    m_cur = m_file.data();
+    m_end = m_cur + m_file.size();
+    m_ok  = true;
+
+    const char* magic = take(sizeof(CACHE_MAGIC));
+    if (magic == nullptr || std::memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        m_ok = false;
+        return false;
+    }
+
+    uint32_t    version = 0;
+    std::string file_kind;
+    get(version);
+    get(file_kind);
+    if (version != CACHE_FORMAT_VERSION || file_kind != kind) m_ok = false;
+
+    return m_ok;
+}
+
+void Cache_reader::get(std::string& s) {
+    uint64_t size = 0;
+    get(size);
+    const char* p = take(static_cast<size_t>(size));
+    if (p != nullptr) {
+        s.assign(p, static_cast<size_t>(size));
+    } else {
+        s.clear();
+    }
+}
+
+std::string cache_file_name(const std::string& cache_dir, const std::string& kind,
+                            const Content_hash& key) {
+    std::string dir = cache_dir;
+    if (!dir.empty() && dir.back() != '/') dir += '/';
+    return dir + kind + "_" + key.hex() + ".bin";
+}
+
+}  // namespace cactus
@@ -0,0 +1,174 @@
+/** cache_file.h
+ *
+ * This file defines the helpers used to keep decoded inputs (programs and configurations) on disk
+ * between runs.
+ *
+ * A cache file is named after a hash of everything its content depends on, so a cache file is
+ * either valid for the current inputs or not found at all. Files are written to a temporary name
+ * first and then renamed, so concurrent runs sharing the same output directory never see a
+ * partially written file.
+ *
+ */
+
+#ifndef _CACHE_FILE_H_
+#define _CACHE_FILE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace cactus {
+
+// bump this whenever the layout of any cached data changes
+#define CACHE_FORMAT_VERSION 5
+
+// ============================================================================================
+// 64-bit FNV-1a hash of the inputs
+// ============================================================================================
+class Content_hash {
+  private:
+    uint64_t m_value = 14695981039346656037ULL;
+
+  public:
+    void add(const void* data, size_t len);
+    void add(const std::string& s);  // the length is hashed too, so ("ab","c") != ("a","bc")
+
+    template <typename T>
+    void add_pod(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be hashed");
+        add(&value, sizeof(T));
+    }
+
+    // hash the content of a file. Returns false if the file cannot be read.
+    bool add_file(const std::string& fn);
+
+    uint64_t    value() const { return m_value; }
+    std::string hex() const;
+};
+
+// ============================================================================================
+// writing a cache file
+// ============================================================================================
+class Cache_writer {
+  private:
+    std::string m_buffer;
+
+  public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put(const std::string& s);
+
+    template <typename T>
+    void put(const std::vector<T>& v) {
+        put(static_cast<uint64_t>(v.size()));
+        for (const auto& e : v) put(e);
+    }
+
+    template <typename K, typename V>
+    void put(const std::map<K, V>& m) {
+        put(static_cast<uint64_t>(m.size()));
+        for (const auto& kv : m) {
+            put(kv.first);
+            put(kv.second);
+        }
+    }
+
+    // a block of plain values, e.g. a table of decoded instructions
+    template <typename T>
+    void put_array(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        put(static_cast<uint64_t>(count));
+        m_buffer.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+
+    const std::string& data() const { return m_buffer; }
+
+    // write the header and the content to the file. Failures are not fatal, the cache is only
+    // an optimization.
+    bool commit(const std::string& fn, const std::string& kind) const;
+};
+
+// ============================================================================================
+// reading a cache file
+// ============================================================================================
+class Cache_reader {
+  private:
+    Mapped_file m_file;
+    const char* m_cur = nullptr;
+    const char* m_end = nullptr;
+    bool        m_ok  = false;
+
+    const char* take(size_t len);
+
+  public:
+    // map the file and check its header. Returns false if there is no usable cache file.
+    bool open(const std::string& fn, const std::string& kind);
+
+    // false as soon as any read went beyond the end of the file
+    bool ok() const { return m_ok; }
+
+    // true when all the content has been consumed
+    bool at_end() const { return m_ok && m_cur == m_end; }
+
+    template <typename T>
+    void get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+        const char* p = take(sizeof(T));
+        if (p != nullptr) std::memcpy(&value, p, sizeof(T));
+    }
+
+    void get(std::string& s);
+
+    template <typename T>
+    void get(std::vector<T>& v) {
+        uint64_t size = 0;
+        get(size);
+        v.clear();
+        for (uint64_t i = 0; m_ok && i < size; ++i) {
+            v.emplace_back();
+            get(v.back());
+        }
+    }
+
+    template <typename K, typename V>
+    void get(std::map<K, V>& m) {
+        uint64_t size = 0;
+        get(size);
+        m.clear();
+        for (uint64_t i = 0; m_ok && i < size; ++i) {
+            K key;
+            get(key);
+            get(m[key]);
+        }
+    }
+
+    template <typename T>
+    void get_array(std::vector<T>& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+        uint64_t count = 0;
+        get(count);
+        if (!m_ok || count > static_cast<uint64_t>(m_end - m_cur) / sizeof(T)) {
+            m_ok = false;
+            return;
+        }
+        v.resize(static_cast<size_t>(count));
+        if (count > 0) std::memcpy(&v[0], take(v.size() * sizeof(T)), v.size() * sizeof(T));
+    }
+};
+
+// the file of the given kind ("program", "config", ...) and key in the cache directory
+std::string cache_file_name(const std::string& cache_dir, const std::string& kind,
+                            const Content_hash& key);
+
+}  // namespace cactus
+
+#endif  // _CACHE_FILE_H_
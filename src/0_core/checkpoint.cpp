@@ -0,0 +1,185 @@
+#include "checkpoint.h"
+
+#include "global_json.h"
+
+namespace cactus {
+
+// ============================================================================================
+// architectural state
+// ============================================================================================
+static void put_bit_set(Cache_writer& writer, const Bit_set& bits) {
+    writer.put(static_cast<uint64_t>(bits.size()));
+    for (size_t w = 0; w < bits.num_words(); ++w) writer.put(bits.word(w));
+}
+
+static bool get_bit_set(Cache_reader& reader, Bit_set& bits) {
+    uint64_t width = 0;
+    reader.get(width);
+    if (width > BIT_SET_MAX_WIDTH) return false;
+
+    bits.resize(static_cast<size_t>(width));
+    for (size_t w = 0; w < bits.num_words(); ++w) {
+        uint64_t word = 0;
+        reader.get(word);
+        bits.set_word(w, word);
+    }
+    return true;
+}
+
+static void put_arch_state(Cache_writer& writer, const Arch_state& state) {
+    writer.put(state.pc);
+    writer.put(state.regs);
+    writer.put(state.flags_cmp);
+
+    for (size_t i = 0; i < 32; ++i) {
+        put_bit_set(writer, state.mask_reg.s_reg_mask[i]);
+        put_bit_set(writer, state.mask_reg.m_reg_mask[i]);
+    }
+    writer.put(state.mask_reg.s_reg_content);
+    writer.put(state.mask_reg.m_reg_content);
+
+    writer.put(state.meas_results);
+    writer.put(state.q_cycle);
+    writer.put(state.num_insns);
+}
+
+// false when a mask is wider than the qubits which can be simulated
+static bool get_arch_state(Cache_reader& reader, Arch_state& state) {
+    reader.get(state.pc);
+    reader.get(state.regs);
+    reader.get(state.flags_cmp);
+
+    for (size_t i = 0; i < 32; ++i) {
+        if (!get_bit_set(reader, state.mask_reg.s_reg_mask[i]) ||
+            !get_bit_set(reader, state.mask_reg.m_reg_mask[i])) {
+            return false;
+        }
+    }
+    reader.get(state.mask_reg.s_reg_content);
+    reader.get(state.mask_reg.m_reg_content);
+
+    reader.get(state.meas_results);
+    reader.get(state.q_cycle);
+    reader.get(state.num_insns);
+
+    state.valid = true;
+    return true;
+}
+
+// ============================================================================================
+// checkpoint file
+// ============================================================================================
+bool checkpoint_key(Content_hash& key) {
+    Global_config& global_config = Global_config::get_instance();
+
+    key.add_pod(global_config.instruction_type);
+    key.add_pod(global_config.assemble_bin);
+    key.add_pod(global_config.qubit_simulator);
+    key.add_pod(global_config.num_qubits);
+    key.add_pod(global_config.vliw_width);
+    key.add(global_config.data_mem_size_str);
+
+    if (global_config.instruction_type == Instruction_type::ASM || global_config.assemble_bin) {
+        if (!key.add_file(global_config.qisa_asm_fn)) return false;
+    } else {
+        if (!key.add_file(global_config.qisa_bin_fn)) return false;
+    }
+
+    for (const auto& lut : global_config.opcode_to_opname_lut) {
+        key.add_pod(lut.first);
+        key.add(lut.second);
+    }
+    for (const auto& edges : global_config.out_edges_of_qubit) {
+        for (unsigned int e : edges) key.add_pod(e);
+        key.add("|");
+    }
+    return true;
+}
+
+bool save_checkpoint(const std::string& fn, const Arch_state& state, Qubit_backend* backend,
+                     std::string& error_msg) {
+    Data_memory* data_memory = Global_config::get_instance().data_memory;
+
+    Content_hash key;
+    if (!checkpoint_key(key)) {
+        error_msg = "the program cannot be read";
+        return false;
+    }
+
+    Cache_writer writer;
+    writer.put(key.value());
+    put_arch_state(writer, state);
+
+    std::vector<uint32_t> words;
+    if (data_memory != nullptr) {
+        words.resize(data_memory->get_mem_size() >> 2);
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] = data_memory->read_mem(static_cast<unsigned int>(i));
+        }
+    }
+    writer.put_array(words.data(), words.size());
+
+    writer.put(backend != nullptr);
+    if (backend != nullptr && !backend->save_state(writer)) {
+        error_msg = "the qubit simulator cannot save its state";
+        return false;
+    }
+
+    if (!writer.commit(fn, "checkpoint")) {
+        error_msg = "the file cannot be written";
+        return false;
+    }
+    return true;
+}
+
+bool restore_checkpoint(const std::string& fn, Arch_state& state, Qubit_backend* backend,
+                        std::string& error_msg) {
+    Data_memory* data_memory = Global_config::get_instance().data_memory;
+
+    Cache_reader reader;
+    if (!reader.open(fn, "checkpoint")) {
+        error_msg = "it is not a checkpoint file of this version of the simulator";
+        return false;
+    }
+
+    Content_hash key;
+    uint64_t     file_key = 0;
+    reader.get(file_key);
+    if (!checkpoint_key(key) || file_key != key.value()) {
+        error_msg = "it has been saved with another program or configuration";
+        return false;
+    }
+
+    Arch_state v_state;
+    if (!get_arch_state(reader, v_state)) {
+        error_msg = "its qubit masks are wider than the qubits which can be simulated";
+        return false;
+    }
+
+    std::vector<uint32_t> words;
+    reader.get_array(words);
+    if (!reader.ok() || data_memory == nullptr ||
+        words.size() != (data_memory->get_mem_size() >> 2)) {
+        error_msg = "the data memory does not match";
+        return false;
+    }
+
+    bool has_qubit_state = false;
+    reader.get(has_qubit_state);
+    if (has_qubit_state && backend != nullptr && !backend->restore_state(reader)) {
+        error_msg = "the qubit simulator cannot restore its state";
+        return false;
+    }
+    if (!reader.ok()) {
+        error_msg = "the file is truncated";
+        return false;
+    }
+
+    for (size_t i = 0; i < words.size(); ++i) {
+        data_memory->write_mem(static_cast<unsigned int>(i), words[i]);
+    }
+    state = v_state;
+    return true;
+}
+
+}  // namespace cactus
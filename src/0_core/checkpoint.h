@@ -0,0 +1,42 @@
+/** checkpoint.h
+ *
+ * This file defines the checkpoint of a simulation, which saves the state reached by the
+ * fast-forward engine so that later runs can start from it instead of simulating the same
+ * beginning of the program again.
+ *
+ * A checkpoint holds the architectural state (see Arch_state), the content of the data memory
+ * and the state of the qubit simulator. It is taken between two instructions, where the
+ * pipelines, the event queues and the pending measurements of the cycle-accurate model are
+ * empty, so the cycle-accurate model starts from a checkpoint exactly as it does after
+ * fast-forwarding.
+ *
+ * A checkpoint can only be restored by a simulation of the same program with the same
+ * configuration, see checkpoint_key().
+ *
+ */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <string>
+
+#include "arch_state.h"
+#include "cache_file.h"
+#include "interface_lib.h"
+
+namespace cactus {
+
+// the program and the configuration of the simulation, from Global_config. Returns false if the
+// program cannot be read.
+bool checkpoint_key(Content_hash& key);
+
+// the state is written to, and read from, a file of the kind "checkpoint". The qubit simulator
+// is optional. Both return false with the reason if the checkpoint cannot be saved or restored.
+bool save_checkpoint(const std::string& fn, const Arch_state& state, Qubit_backend* backend,
+                     std::string& error_msg);
+bool restore_checkpoint(const std::string& fn, Arch_state& state, Qubit_backend* backend,
+                        std::string& error_msg);
+
+}  // namespace cactus
+
+#endif  // _CHECKPOINT_H_
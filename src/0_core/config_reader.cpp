@@ -202,6 +202,9 @@ void config_reader::configure_cmdparser() {
       "<CACTUS_root>\\test_files\\test_input_file_list.json.");
     cmdparser->set_optional<std::string>(
       "d", "dm_size", "1M", "Specify data memory size, size unit can be \"M\" or \"K\".");
+    cmdparser->set_optional<bool>(
+      "e", "no_telf", false,
+      "Do not write the telf logs of the modules, nor run the processes which collect them.");
     cmdparser->set_optional<std::string>(
       "f", "file", "",
       "Specify the name of data memory dump file. Memory will "
@@ -210,16 +213,32 @@ void config_reader::configure_cmdparser() {
       "g", "gate_config", "",
       "Specify qubit gate configuration file. A typical configuration file is "
       "<CACTUS_root>\\test_files\\hw_config\\qubit_gate_config.json.");
+    cmdparser->set_optional<std::string>(
+      "i", "init_checkpoint", "",
+      "Start the simulation from a checkpoint saved by '-w' for the same program and "
+      "configuration.");
     cmdparser->set_optional<std::string>(
       "l", "log_level", "",
       "Specify log level configuration file. A configuration config "
       "file is <CACTUS_root>\\test_files\\log_levels.json.");
     cmdparser->set_optional<std::string>("m", "mock_meas", "",
                                          "Specify the file name of mock measurement result.");
+    cmdparser->set_optional<unsigned int>(
+      "j", "jobs", 0,
+      "Specify the number of threads used to load the program, and of processes running the "
+      "shots ('-y') or the runs of the zygote ('-Z'), 0 for one per core.");
+    cmdparser->set_optional<bool>(
+      "k", "no_cache", false,
+      "Do not reuse the program and configuration decoded by an earlier run, which are cached in "
+      "the output directory.");
     cmdparser->set_optional<unsigned int>("n", "q_num", 7, "Specify qubit number.");
     cmdparser->set_optional<std::string>(
       "o", "output", "./sim_output/",
       "Specify ouput directory for simluation intermediate output.");
+    cmdparser->set_optional<bool>(
+      "p", "levelized", false,
+      "Evaluate the stages of the technology-independent quantum pipeline once per clock in a "
+      "fixed order, instead of as separate SystemC processes. The outputs are the same.");
     cmdparser->set_optional<unsigned int>(
       "q", "q_sim", 0, "Specify qubit simulator, 0 for Quantumsim and 1 for QIcircuit.");
     cmdparser->set_optional<unsigned int>("r", "run", 3000, "Specify total simulation cycles.");
@@ -231,7 +250,39 @@ void config_reader::configure_cmdparser() {
       "t", "tp_config", "",
       "Specify topology configuration file. A typical configuration file is "
       "<CACTUS_root>\\test_files\\hw_config\\cclight_config.json.");
+    cmdparser->set_optional<bool>(
+      "u", "skip_idle", false,
+      "Skip the cycles during which the processor only waits for the next quantum event, e.g. "
+      "during a long qwait. Cycle numbers are the same as without skipping.");
     cmdparser->set_optional<unsigned int>("v", "vliw_width", 2, "Specify VLIW width.");
+    cmdparser->set_optional<std::string>(
+      "w", "save_checkpoint", "",
+      "Save the state reached by fast-forwarding ('-z') to this file, which '-i' restores.");
+    cmdparser->set_optional<bool>(
+      "x", "asm_to_bin", false,
+      "Assemble the assembly file specified by '-a' in-process, and simulate the binary program.");
+    cmdparser->set_optional<unsigned int>(
+      "y", "shots", 0,
+      "Run the program this number of times, each with its own seed, in parallel processes, and "
+      "write the measurement outcomes to shots.csv and histogram.csv in the output directory.");
+    cmdparser->set_optional<std::string>(
+      "z", "fast_forward", "",
+      "Fast-forward the program instruction by instruction up to 'pc:<addr>', 'cycle:<50 MHz "
+      "cycle>' or 'label:<name>', and simulate the rest of it cycle-accurately.");
+    cmdparser->set_optional<bool>(
+      "P", "profile", false,
+      "Count and time the activations of the SystemC processes and the calls into QuantumSim, "
+      "and write the time per module and process and the simulated cycles per second to "
+      "profile.txt in the output directory.");
+    cmdparser->set_optional<bool>(
+      "Q", "async_qsim", false,
+      "Apply the quantum operations in a separate thread, which only the measurements wait for, "
+      "so that the digital model and QuantumSim run on two cores. The outputs are the same.");
+    cmdparser->set_optional<std::string>(
+      "Z", "zygote", "",
+      "Build the simulator once, then read run requests '<program> [<data memory dump file>]' "
+      "from this file, '-' for the standard input, and simulate each of them in a process forked "
+      "from the built simulator. The programs are of the kind of the one given by '-a' or '-b'.");
 }
 
 void config_reader::run_cmdparser() {
@@ -243,6 +294,17 @@ void config_reader::run_cmdparser() {
     unsigned int qsim = cmdparser->get<unsigned int>("q");
     num_sim_cycles    = cmdparser->get<unsigned int>("r");
     vliw_width        = cmdparser->get<unsigned int>("v");
+    num_load_threads  = cmdparser->get<unsigned int>("j");
+    num_shots         = cmdparser->get<unsigned int>("y");
+
+    // bool
+    use_cache        = !cmdparser->get<bool>("k");
+    telf_on          = !cmdparser->get<bool>("e");
+    assemble_bin     = cmdparser->get<bool>("x");
+    skip_idle        = cmdparser->get<bool>("u");
+    levelized_q_pipe = cmdparser->get<bool>("p");
+    async_qsim       = cmdparser->get<bool>("Q");
+    profile          = cmdparser->get<bool>("P");
 
     // std::string
     qisa_asm_fn          = cmdparser->get<std::string>("a");
@@ -255,6 +317,9 @@ void config_reader::run_cmdparser() {
     output_dir           = cmdparser->get<std::string>("o");
     topology_fn          = cmdparser->get<std::string>("t");
     mock_msmt_res_fn     = cmdparser->get<std::string>("m");
+    init_checkpoint_fn   = cmdparser->get<std::string>("i");
+    save_checkpoint_fn   = cmdparser->get<std::string>("w");
+    zygote_fn            = cmdparser->get<std::string>("Z");
 
     // check whether there is a log_level json file in executable directory
     if (log_level_fn.empty()) {
@@ -297,7 +362,7 @@ void config_reader::run_cmdparser() {
     // set memory dump
     data_memory->set_dump(dump_start_addr, dump_mem_size);
 
-    if (!qisa_bin_fn.empty()) {
+    if (!qisa_bin_fn.empty() || assemble_bin) {
         instruction_type = Instruction_type::BIN;
     } else {
         instruction_type = Instruction_type::ASM;
@@ -332,6 +397,53 @@ void config_reader::run_cmdparser() {
         exit(EXIT_FAILURE);
     }
 
+    if (assemble_bin && qisa_asm_fn.empty()) {
+        logger->error("config_reader: '-x' needs an asm file specified by '-a'. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+
+    std::string ff_target_str = cmdparser->get<std::string>("z");
+    if (!ff_target_str.empty() && !ff_target.parse(ff_target_str)) {
+        logger->error("config_reader: '-z' should be 'pc:<addr>', 'cycle:<num>' or "
+                      "'label:<name>', but it is '{}'. Simulation aborts!",
+                      ff_target_str);
+        exit(EXIT_FAILURE);
+    }
+    if (ff_target.type == FF_LABEL && instruction_type != Instruction_type::ASM) {
+        logger->error("config_reader: '-z label:' is only available for asm programs. Simulation "
+                      "aborts!");
+        exit(EXIT_FAILURE);
+    }
+    if (!save_checkpoint_fn.empty() && !ff_target.is_set()) {
+        logger->error("config_reader: '-w' saves the state reached by '-z', which is not "
+                      "specified. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+    if (num_shots > 0 && !save_checkpoint_fn.empty()) {
+        logger->error("config_reader: '-w' cannot be used with '-y', every shot would save the "
+                      "checkpoint. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!zygote_fn.empty() && num_shots > 0) {
+        logger->error("config_reader: '-Z' and '-y' cannot be used together. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+    if (!zygote_fn.empty() && !save_checkpoint_fn.empty()) {
+        logger->error("config_reader: '-w' cannot be used with '-Z', every run would save the "
+                      "checkpoint. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+
+    if (profile && (num_shots > 0 || !zygote_fn.empty())) {
+        logger->error("config_reader: '-P' profiles a single run, it cannot be used with '-y' or "
+                      "'-Z'. Simulation aborts!");
+        exit(EXIT_FAILURE);
+    }
+
+    // the shots, or the runs of the zygote, would all write the same telf logs
+    if (num_shots > 0 || !zygote_fn.empty()) telf_on = false;
+
     delete cmdparser;
     cmdparser = nullptr;
 }
@@ -454,9 +566,32 @@ void config_reader::read_config(std::string config_file_list_fn) {
         read_config_file_list(config_file_list_fn);
     }
 
+    create_dir_if_not_exist(output_dir);
+
+    // the configuration resolved by an earlier run from the same inputs
+    Content_hash key;
+    std::string  cache_fn;
+    if (use_cache && config_cache_key(key)) {
+        create_dir_if_not_exist(cache_dir());
+        cache_fn = cache_file_name(cache_dir(), "config", key);
+
+        Cache_reader reader;
+        if (reader.open(cache_fn, "config") && restore_resolved_config(reader)) {
+            logger->trace("Read the resolved configuration from the cache file '{}'.", cache_fn);
+            return;
+        }
+    }
+
     if (!topology_fn.empty()) {
         read_from_file(topology_fn);
     }
+    // the sets of qubits, e.g. of the measurement interfaces, have a fixed largest width
+    if (num_qubits > BIT_SET_MAX_WIDTH) {
+        logger->error("config_reader: {} qubits are more than the {} qubits which can be "
+                      "simulated. Simulation aborts!",
+                      num_qubits, BIT_SET_MAX_WIDTH);
+        exit(EXIT_FAILURE);
+    }
     // elec_config and mock result is not need in this version
     // read_electronic_config(elec_config_fn);
     // read_mock_msmt_result(msmt_res_fn);
@@ -464,13 +599,103 @@ void config_reader::read_config(std::string config_file_list_fn) {
         read_qubit_gate_config(qubit_gate_config_fn);
     }
 
-    create_dir_if_not_exist(output_dir);
+    if (!cache_fn.empty()) {
+        Cache_writer writer;
+        save_resolved_config(writer);
+        if (!writer.commit(cache_fn, "config")) {
+            logger->warn("Failed to write the cache file '{}'.", cache_fn);
+        }
+    }
 
     if (!config_file_list_fn.empty()) {
         logger->trace("Finished reading configuration successfully.");
     }
 }
 
+std::string config_reader::cache_dir() const {
+    if (!output_dir.empty() && output_dir.back() == '/') return output_dir + "cache";
+    return output_dir + "/cache";
+}
+
+// everything read_from_file() and read_qubit_gate_config() may change
+void config_reader::save_resolved_config(Cache_writer& writer) const {
+    writer.put(num_sim_cycles);
+    writer.put(instruction_type);
+    writer.put(qubit_simulator);
+    writer.put(num_qubits);
+    writer.put(vliw_width);
+    writer.put(data_mem_size_str);
+    writer.put(num_directed_edges);
+    writer.put(in_edges_of_qubit);
+    writer.put(out_edges_of_qubit);
+    writer.put(opcode_to_opname_lut);
+    writer.put(single_qubit_gate_time);
+    writer.put(two_qubit_gate_time);
+}
+
+bool config_reader::restore_resolved_config(Cache_reader& reader) {
+    // only applied once the whole content has been read successfully
+    unsigned int                           v_num_sim_cycles;
+    Instruction_type                       v_instruction_type;
+    Qubit_simulator_type                   v_qubit_simulator;
+    unsigned int                           v_num_qubits;
+    unsigned int                           v_vliw_width;
+    std::string                            v_data_mem_size_str;
+    unsigned int                           v_num_directed_edges;
+    std::vector<std::vector<unsigned int>> v_in_edges_of_qubit;
+    std::vector<std::vector<unsigned int>> v_out_edges_of_qubit;
+    std::map<uint64_t, std::string>        v_opcode_to_opname_lut;
+    std::map<std::string, unsigned int>    v_single_qubit_gate_time;
+    std::map<std::string, unsigned int>    v_two_qubit_gate_time;
+
+    reader.get(v_num_sim_cycles);
+    reader.get(v_instruction_type);
+    reader.get(v_qubit_simulator);
+    reader.get(v_num_qubits);
+    reader.get(v_vliw_width);
+    reader.get(v_data_mem_size_str);
+    reader.get(v_num_directed_edges);
+    reader.get(v_in_edges_of_qubit);
+    reader.get(v_out_edges_of_qubit);
+    reader.get(v_opcode_to_opname_lut);
+    reader.get(v_single_qubit_gate_time);
+    reader.get(v_two_qubit_gate_time);
+
+    if (!reader.at_end()) return false;
+
+    num_sim_cycles         = v_num_sim_cycles;
+    instruction_type       = v_instruction_type;
+    qubit_simulator        = v_qubit_simulator;
+    num_qubits             = v_num_qubits;
+    vliw_width             = v_vliw_width;
+    data_mem_size_str      = v_data_mem_size_str;
+    num_directed_edges     = v_num_directed_edges;
+    in_edges_of_qubit      = v_in_edges_of_qubit;
+    out_edges_of_qubit     = v_out_edges_of_qubit;
+    opcode_to_opname_lut   = v_opcode_to_opname_lut;
+    single_qubit_gate_time = v_single_qubit_gate_time;
+    two_qubit_gate_time    = v_two_qubit_gate_time;
+    return true;
+}
+
+// the resolved configuration depends on the values set so far (defaults and command line) and
+// on the content of the configuration files
+bool config_reader::config_cache_key(Content_hash& key) const {
+    Cache_writer current;
+    save_resolved_config(current);
+
+    key.add_pod(CACHE_FORMAT_VERSION);
+    key.add(current.data());
+
+    key.add(topology_fn.empty() ? "" : "topology");
+    if (!topology_fn.empty() && !key.add_file(topology_fn)) return false;
+
+    key.add(qubit_gate_config_fn.empty() ? "" : "qubit_gate_config");
+    if (!qubit_gate_config_fn.empty() && !key.add_file(qubit_gate_config_fn)) return false;
+
+    return true;
+}
+
 void config_reader::find_config_file(const std::string& config_file_list_fn,
                                      std::string&       config_fn) {
     // If config_fn doesn't exist, try prefixing the dirname of the config file
@@ -6,6 +6,8 @@
 #include <utility>
 #include <vector>
 
+#include "arch_state.h"
+#include "cache_file.h"
 #include "cmdparser/cmdparser.h"
 #include "data_memory.h"
 #include "generic_if.h"
@@ -43,8 +45,14 @@ class config_reader {
     void run_cmdparser();
     void configure_cmdparser();
 
+  public:  // cache of the decoded inputs, see cache_file.h
+    std::string cache_dir() const;
+    void        save_resolved_config(Cache_writer& writer) const;
+    bool        restore_resolved_config(Cache_reader& reader);
+
   private:
     void find_config_file(const std::string& config_file_list_fn, std::string& config_fn);
+    bool config_cache_key(Content_hash& key) const;
 
   public:  // the names of configuration files
     void read_config_file_list(std::string config_file_list_fn);
@@ -151,6 +159,61 @@ class config_reader {
     // ----------------------------------------------------------------------
     unsigned int num_sim_cycles = 3000;  // run 3000 cycles default
 
+    // stop the clocks while the processor only waits, see idle_skip.h
+    bool skip_idle = false;
+
+    // evaluate the technology-independent quantum pipeline once per clock as plain function
+    // calls, instead of one SystemC process per stage, see Q_tech_ind::do_levelized_cycle
+    bool levelized_q_pipe = false;
+
+    // apply the quantum operations in a worker thread of QuantumSim, which overlaps with the
+    // digital model, see If_QuantumSim::run_worker
+    bool async_qsim = false;
+
+    // report where the wall-clock time of the simulation goes, see profiler.h
+    bool profile = false;
+
+    // write the telf logs of the modules. When off, the processes which only log are not created.
+    bool telf_on = true;
+
+    // ----------------------------------------------------------------------
+    // reuse the program and configuration decoded by an earlier run with the same inputs
+    // ----------------------------------------------------------------------
+    bool use_cache = true;
+
+    // threads used to load large programs, and processes running the shots, 0 for one per core
+    unsigned int num_load_threads = 0;
+
+    // assemble the asm program in-process, and simulate it in binary mode
+    bool assemble_bin = false;
+
+    // ----------------------------------------------------------------------
+    // fast-forward, see fast_forward.h
+    // ----------------------------------------------------------------------
+    // where the cycle-accurate simulation starts
+    Ff_target ff_target;
+
+    // the state the cycle-accurate simulation starts from, valid after fast-forwarding
+    Arch_state ff_state;
+
+    // the checkpoint the simulation starts from, and the one it saves when fast-forwarding
+    // stops, see checkpoint.h
+    std::string init_checkpoint_fn = "";
+    std::string save_checkpoint_fn = "";
+
+    // ----------------------------------------------------------------------
+    // shots, see shot_farm.h
+    // ----------------------------------------------------------------------
+    // the number of times the program runs from the elaborated model, 0 for a single run as usual
+    unsigned int num_shots = 0;
+
+    // ----------------------------------------------------------------------
+    // zygote, see zygote.h
+    // ----------------------------------------------------------------------
+    // the file the run requests are read from, "-" for the standard input, empty when the
+    // simulator runs a single program as usual
+    std::string zygote_fn = "";
+
     // ----------------------------------------------------------------------
     // command line parser
     // ----------------------------------------------------------------------
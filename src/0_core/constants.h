@@ -2,7 +2,8 @@
 //#define NUM_QUBITS                        Configuration_driver::num_qubits
 
 #define INSN_WIDTH 32
-#define MEMORY_ADDRESS_WIDTH 21
+// wide enough to address programs of tens of millions of instructions
+#define MEMORY_ADDRESS_WIDTH 32
 #define OPCODE_WIDTH 6
 #define REG_FILE_WIDTH 32
 #define REG_FILE_NUM 32
@@ -22,8 +23,8 @@
 // configurable memory register
 #define G_MEM_OUT_REG 1
 
-// size of instruction cache
-#define CACHE_SIZE 1000000
+// number of binary instructions the instruction cache decodes at a time
+#define ICACHE_DECODE_BLOCK 4096
 
 // size of data memory is set 256*1024*4 byte
 #define DATA_MEMORY_SIZE (256 * 1024)
@@ -1,27 +1,95 @@
 #include "cycle_counter.h"
 
+#include <algorithm>
+
+#include "profiler.h"
+
 namespace cactus {
 
-SC_HAS_PROCESS(Cycle_counter);
+// ============================================================================================
+// Clock_cycles
+// ============================================================================================
+uint64_t Clock_cycles::num_edges_before() {
+    uint64_t now = sc_core::sc_time_stamp().value();
+    return (now > 0) ? num_edges_at(now - 1) : 0;
+}
 
-Cycle_counter::Cycle_counter(sc_core::sc_module_name) {
+uint64_t Clock_cycles::num_edges_at(uint64_t t) {
+    if (!m_resolved) resolve();
 
-    cur_cycle_num = 0;
+    if (t < m_first_edge) return 0;
 
-    SC_CTHREAD(count, in_clock.pos());
+    return (t - m_first_edge) / m_period + 1;
 }
 
-void Cycle_counter::count() {
-
-    while (true) {
+void Clock_cycles::resolve() {
+    auto logger = get_logger_or_exit("console");
 
-        wait();
+    sc_core::sc_interface* clock_if = m_clock->get_interface();
 
-        if (in_started.read()) {
-            cur_cycle_num++;
+    if (auto clock = dynamic_cast<sc_core::sc_clock*>(clock_if)) {
+        sc_core::sc_time first_edge = clock->start_time();
+        if (!clock->posedge_first()) {
+            first_edge += clock->period() * (1.0 - clock->duty_cycle());
+        }
+        m_first_edge = first_edge.value();
+        m_period     = clock->period().value();
+    } else if (auto signal = dynamic_cast<sc_core::sc_object*>(clock_if)) {
+        auto skip_clock = dynamic_cast<Idle_skip_clock*>(signal->get_parent_object());
+        if (skip_clock != nullptr) {
+            m_first_edge = 0;
+            m_period     = skip_clock->period(clock_if).value();
         }
     }
+
+    if (m_period == 0) {
+        logger->error("{}: The cycle numbers are derived from the simulation time, which requires "
+                      "the clock to be an sc_clock or a clock of Idle_skip_clock. Simulation "
+                      "aborts!",
+                      m_clock->name());
+        exit(EXIT_FAILURE);
+    }
+
+    m_resolved = true;
+}
+
+// ============================================================================================
+// Cycle_counter
+// ============================================================================================
+SC_HAS_PROCESS(Cycle_counter);
+
+Cycle_counter::Cycle_counter(sc_core::sc_module_name)
+    : m_clock_cycles(in_clock) {
+
+    // also run at initialization, for a counter started from the beginning
+    SC_METHOD(start_stop);
+    sensitive << in_started;
+}
+
+void Cycle_counter::start_stop() {
+    Profile_process profile;
+
+    // a change is read at the edges after it. The first edge is never counted, not even when
+    // 'started' is true from the beginning.
+    uint64_t num_edges = std::max<uint64_t>(m_clock_cycles.num_edges(), 1);
+
+    if (in_started.read() && !m_running) {
+        m_start_edges = num_edges;
+        m_running     = true;
+    } else if (!in_started.read() && m_running) {
+        m_num_cycles_before += num_edges - m_start_edges;
+        m_running = false;
+    }
+}
+
+unsigned int Cycle_counter::get_cur_cycle_num() {
+    uint64_t num_cycles = m_num_cycles_before;
+    if (m_running) {
+        uint64_t num_edges = m_clock_cycles.num_edges_before();
+        if (num_edges > m_start_edges) num_cycles += num_edges - m_start_edges;
+    }
+
+    return static_cast<unsigned int>(num_cycles);
 }
 
-unsigned int Cycle_counter::get_cur_cycle_num() { return cur_cycle_num; }
 }  // namespace cactus
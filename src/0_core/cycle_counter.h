@@ -1,14 +1,61 @@
 #ifndef _CYCLE_COUNTER_H_
 #define _CYCLE_COUNTER_H_
 
+#include <cstdint>
 #include <iostream>
 #include <systemc>
 #include <unordered_map>
 
+#include "idle_skip.h"
 #include "logger_wrapper.h"
 
 namespace cactus {
 
+// The number of rising edges of a clock up to the current simulation time. It is derived from
+// the time in O(1), instead of being counted by a clocked process which would run on every edge.
+// The clock should be an sc_clock, or a clock of Idle_skip_clock, whose rising edges stay on the
+// same grid of times when idle cycles are skipped.
+class Clock_cycles {
+  public:
+    explicit Clock_cycles(sc_core::sc_in<bool>& clock)
+        : m_clock(&clock) {}
+
+    // the rising edges up to now, the one at the current time included
+    uint64_t num_edges() { return num_edges_at(sc_core::sc_time_stamp()); }
+
+    // the rising edges up to the given time, the one at that time included
+    uint64_t num_edges_at(const sc_core::sc_time& time) { return num_edges_at(time.value()); }
+
+    // the rising edges before now, the one at the current time excluded
+    uint64_t num_edges_before();
+
+    // the cycles a clocked process counts up to now: it starts at the first rising edge and
+    // counts the edges after it, so the edge at the current time is counted before the loggers
+    // read it
+    uint64_t num_cycles() {
+        uint64_t edges = num_edges();
+        return (edges > 0) ? (edges - 1) : 0;
+    }
+
+  protected:
+    sc_core::sc_in<bool>* m_clock;
+
+    // the first rising edge and the period, in units of the time resolution
+    bool     m_resolved   = false;
+    uint64_t m_first_edge = 0;
+    uint64_t m_period     = 0;
+
+    // read from the clock bound to the port, once it is bound
+    void resolve();
+
+    // the rising edges up to a time in units of the time resolution
+    uint64_t num_edges_at(uint64_t time);
+};
+
+// The number of cycles of a clock during which 'started' was true, like a clocked process which
+// counts the rising edges after the first at which it reads 'started' as true, without running
+// on every edge. The edge at the current time is not counted yet, as for the clocked processes
+// which read the number at that edge and used to run before the counting process.
 SC_MODULE(Cycle_counter) {
   public:
     sc_core::sc_in<bool> in_clock;
@@ -18,9 +65,13 @@ SC_MODULE(Cycle_counter) {
     unsigned int get_cur_cycle_num();
 
   protected:
-    unsigned int cur_cycle_num = 0;
+    Clock_cycles m_clock_cycles;
+
+    uint64_t m_num_cycles_before = 0;  // the cycles counted before the last start
+    uint64_t m_start_edges       = 0;  // the edges of the clock up to the last start
+    bool     m_running           = false;
 
-    void count();
+    void start_stop();
 
   public:
     SC_CTOR(Cycle_counter);
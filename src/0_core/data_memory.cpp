@@ -59,6 +59,16 @@ void Data_memory::dump(const std::string& file) {
     f_out.close();
 }
 
+std::vector<unsigned int> Data_memory::dump_words() {
+    std::vector<unsigned int> words;
+
+    for (unsigned int i = dump_start; i < dump_start + dump_size; i = i + 4) {
+        words.push_back(memory[i >> 2]);
+    }
+
+    return words;
+}
+
 unsigned int Data_memory::get_mem_size() { return mem_size; }
 
 Data_memory::~Data_memory() {
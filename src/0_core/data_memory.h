@@ -4,6 +4,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "logger_wrapper.h"
 
@@ -25,6 +26,8 @@ class Data_memory {
     void         write_mem(unsigned int addr, unsigned int data);
     void         set_dump(unsigned int start, unsigned int size);
     void         dump(const std::string& file);
+    // the words the dump writes, in the same order
+    std::vector<unsigned int> dump_words();
     unsigned int get_mem_size();
     ~Data_memory();
 };
@@ -0,0 +1,619 @@
+#include "eqasm_assembler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <set>
+
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "mapped_file.h"
+#include "num_util.h"
+#include "thread_pool.h"
+
+namespace cactus {
+
+namespace {
+
+template <typename K, typename V>
+std::map<V, K> invert(const std::map<K, V>& m) {
+    std::map<V, K> inverse;
+    for (const auto& kv : m) inverse.insert(std::make_pair(kv.second, kv.first));
+    return inverse;
+}
+
+const std::map<unsigned int, std::string>& opcode_names() {
+    static const std::map<unsigned int, std::string> names = invert(Qasm_instruction::map_opcode());
+    return names;
+}
+
+const std::map<unsigned int, std::string>& br_cond_names() {
+    static const std::map<unsigned int, std::string> names =
+      invert(Qasm_instruction::map_br_cond());
+    return names;
+}
+
+// the opcodes of the single format quantum instructions, as named in qisa_opcodes.qmap
+const std::map<std::string, unsigned int>& q_single_opcodes() {
+    static const std::map<std::string, unsigned int> opcodes = {{"smis", SMIS_OPCODE},
+                                                                {"smit", SMIT_OPCODE},
+                                                                {"qwait", QWAIT_OPCODE},
+                                                                {"qwaitr", QWAITR_OPCODE}};
+    return opcodes;
+}
+
+inline uint32_t field(unsigned int value, unsigned int shift) {
+    return static_cast<uint32_t>(value) << shift;
+}
+
+inline bool fits_signed(int value, unsigned int width) {
+    return (value >= -(1 << (width - 1))) && (value < (1 << (width - 1)));
+}
+
+inline bool is_br(uint32_t word) {
+    return ((word & 0xC0000000u) == 0) &&
+           (((word & OPCODE_MASK) >> OPCODE_SHIFT) == OperationName::BR);
+}
+
+inline unsigned int br_target(uint32_t word, unsigned int addr) {
+    return addr + sign_extend((word & BR_ADDR_MASK) >> BR_ADDR_SHIFT, BR_ADDR_WIDTH);
+}
+
+inline std::string to_lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    return s;
+}
+
+// the part of a rotation name the parser checks, e.g. 'x' for 'x90' and 'ym' for 'ym90'
+std::string gate_prefix(const std::string& name) {
+    if (name.empty() || (std::string("xyzr").find(name[0]) == std::string::npos)) return name;
+
+    size_t digit = name.find_first_of("0123456789");
+    if ((digit == std::string::npos) || (digit == 0)) return name;
+    return name.substr(0, digit);
+}
+
+}  // namespace
+
+Eqasm_assembler::Eqasm_assembler() { load_edges(); }
+
+// ============================================================================================
+// opcode tables
+// ============================================================================================
+void Eqasm_assembler::add_q_opcode(const std::string& name, unsigned int opcode) {
+    m_q_opcodes[name] = opcode;
+    m_q_opnames.insert(std::make_pair(opcode, name));
+
+    // the parser calls every measurement 'measure'
+    if (name.find("meas") != std::string::npos) {
+        m_q_opcodes.insert(std::make_pair(std::string("measure"), opcode));
+    }
+}
+
+void Eqasm_assembler::set_q_opcodes(const std::map<uint64_t, std::string>& opcode_to_opname) {
+    m_q_opcodes.clear();
+    m_q_opnames.clear();
+    m_q_opcode_source = "the opcodes of the gate configuration";
+
+    for (const auto& op : opcode_to_opname) {
+        // opcode 0 is the quantum nop, which is never written in asm
+        if (op.first == 0 || op.first > BUNDLE_OP_MASK) continue;
+        add_q_opcode(to_lower(op.second), static_cast<unsigned int>(op.first));
+    }
+}
+
+// lines look like: def_opcode["ldi"] = 0x16, def_q_arg_st['X90'] = 8
+bool Eqasm_assembler::load_qmap(const std::string& qmap_fn, std::string& error_msg) {
+    std::ifstream qmap_file(qmap_fn);
+    if (!qmap_file.is_open()) {
+        error_msg = "Failed to open file: '" + qmap_fn + "'";
+        return false;
+    }
+
+    m_q_opcodes.clear();
+    m_q_opnames.clear();
+    m_q_opcode_source = "'" + qmap_fn + "'";
+
+    std::string  line;
+    unsigned int line_num = 0;
+    while (std::getline(qmap_file, line)) {
+        ++line_num;
+        trim_comments(line);
+        trim(line);
+        if (line.empty()) continue;
+
+        size_t open  = line.find('[');
+        size_t close = line.find(']', open);
+        size_t equal = line.find('=', close);
+        if ((open == std::string::npos) || (close == std::string::npos) ||
+            (equal == std::string::npos) || (close < open + 2)) {
+            error_msg = "Cannot parse line " + std::to_string(line_num) + " of '" + qmap_fn + "'";
+            return false;
+        }
+
+        std::string  kind   = line.substr(0, open);
+        std::string  name   = to_lower(line.substr(open + 2, close - open - 3));
+        std::string  value  = line.substr(equal + 1);
+        unsigned int opcode = 0;
+        try {
+            opcode = static_cast<unsigned int>(std::stoul(trim(value), nullptr, 0));
+        } catch (...) {
+            error_msg = "Cannot parse line " + std::to_string(line_num) + " of '" + qmap_fn + "'";
+            return false;
+        }
+        trim(kind);
+
+        if (kind == "def_opcode") {
+            // the simulator decodes fixed opcodes, which the file cannot change
+            auto cl_it = Qasm_instruction::map_opcode().find(name);
+            auto q_it  = q_single_opcodes().find(name);
+            if (((cl_it != Qasm_instruction::map_opcode().end()) && (cl_it->second != opcode)) ||
+                ((q_it != q_single_opcodes().end()) && (q_it->second != opcode))) {
+                error_msg = "The opcode of '" + name + "' in '" + qmap_fn +
+                            "' differs from the one used by the simulator";
+                return false;
+            }
+        } else if ((kind == "def_q_arg_none") || (kind == "def_q_arg_st") ||
+                   (kind == "def_q_arg_tt")) {
+            bool two_qubit = (kind == "def_q_arg_tt");
+            if ((opcode > BUNDLE_OP_MASK) ||
+                (two_qubit != ((opcode & BUNDLE_TWO_QUBIT_OP) != 0))) {
+                error_msg = "The opcode of '" + name + "' in '" + qmap_fn + "' is out of range";
+                return false;
+            }
+            if (opcode != 0) add_q_opcode(name, opcode);
+        } else {
+            error_msg = "Unknown table '" + kind + "' at line " + std::to_string(line_num) +
+                        " of '" + qmap_fn + "'";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Eqasm_assembler::declare_gates() const {
+    Global_config& global_config = Global_config::get_instance();
+
+    for (const auto& op : m_q_opcodes) {
+        auto& gate_time = (op.second & BUNDLE_TWO_QUBIT_OP) ? global_config.two_qubit_gate_time
+                                                            : global_config.single_qubit_gate_time;
+        gate_time.insert(std::make_pair(op.first, 1u));
+
+        // rotations are checked by their prefix, which takes the time of the first rotation
+        unsigned int time = gate_time[op.first];
+        gate_time.insert(std::make_pair(gate_prefix(op.first), time));
+    }
+}
+
+void Eqasm_assembler::load_edges() {
+    Global_config& global_config = Global_config::get_instance();
+
+    // the default topology does not set num_directed_edges, so the edges are counted here
+    size_t num_edges = global_config.num_directed_edges;
+    for (const auto& edges : global_config.out_edges_of_qubit) {
+        for (unsigned int e : edges) num_edges = std::max(num_edges, static_cast<size_t>(e) + 1);
+    }
+
+    m_edges.assign(num_edges, std::make_pair(0u, 0u));
+    for (size_t q = 0; q < global_config.out_edges_of_qubit.size(); ++q) {
+        for (unsigned int e : global_config.out_edges_of_qubit[q]) {
+            if (e < m_edges.size()) m_edges[e].first = static_cast<unsigned int>(q);
+        }
+    }
+    for (size_t q = 0; q < global_config.in_edges_of_qubit.size(); ++q) {
+        for (unsigned int e : global_config.in_edges_of_qubit[q]) {
+            if (e < m_edges.size()) m_edges[e].second = static_cast<unsigned int>(q);
+        }
+    }
+}
+
+bool Eqasm_assembler::find_edge(size_t left, size_t right, unsigned int& edge) const {
+    for (size_t e = 0; e < m_edges.size(); ++e) {
+        if ((m_edges[e].first == left) && (m_edges[e].second == right)) {
+            edge = static_cast<unsigned int>(e);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================================
+// assembling
+// ============================================================================================
+bool Eqasm_assembler::encode(Qasm_instruction& insn, uint32_t& word, std::string& error_msg) const {
+    word = 0;
+
+    if (insn.is_cl_insn()) {
+        unsigned int opcode = insn.get_opcode();
+        word                = field(opcode, OPCODE_SHIFT);
+
+        switch (opcode) {
+            case OperationName::NOP:
+            case OperationName::STOP:
+                break;
+            case OperationName::BR:
+                if (!fits_signed(insn.get_br_addr(), BR_ADDR_WIDTH)) {
+                    error_msg = "the branch offset cannot be encoded in " +
+                                std::to_string(BR_ADDR_WIDTH) + " bits";
+                    return false;
+                }
+                word |= field(insn.get_br_addr(), BR_ADDR_SHIFT) & BR_ADDR_MASK;
+                word |= field(insn.get_br_cond(), BR_COND_SHIFT);
+                break;
+            case OperationName::CMP:
+                word |= field(insn.get_rs_addr(), RS_ADDR_SHIFT);
+                word |= field(insn.get_rt_addr(), RT_ADDR_SHIFT);
+                break;
+            case OperationName::FBR:
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                word |= field(insn.get_br_cond(), BR_COND_SHIFT);
+                break;
+            case OperationName::FMR:
+                if (insn.get_qubit_sel() >= (1u << QUBIT_SEL_WIDTH)) {
+                    error_msg = "the qubit cannot be encoded in " +
+                                std::to_string(QUBIT_SEL_WIDTH) + " bits";
+                    return false;
+                }
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                word |= field(insn.get_qubit_sel(), QUBIT_SEL_SHIFT);
+                break;
+            case OperationName::LDI:
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                if (!fits_signed(insn.get_imm(), LDI_IMM_WIDTH)) {
+                    error_msg = "the immediate cannot be encoded in " +
+                                std::to_string(LDI_IMM_WIDTH) + " bits";
+                    return false;
+                }
+                word |= field(insn.get_imm(), LDI_IMM_SHIFT) & LDI_IMM_MASK;
+                break;
+            case OperationName::LDUI:
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                word |= field(insn.get_rs_addr(), RS_ADDR_SHIFT);
+                word |= field(insn.get_uimm(), LDUI_IMM_SHIFT);
+                break;
+            case OperationName::ADD:
+            case OperationName::SUB:
+            case OperationName::AND:
+            case OperationName::OR:
+            case OperationName::XOR:
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                word |= field(insn.get_rs_addr(), RS_ADDR_SHIFT);
+                word |= field(insn.get_rt_addr(), RT_ADDR_SHIFT);
+                break;
+            case OperationName::NOT:
+                word |= field(insn.get_rd_addr(), RD_ADDR_SHIFT);
+                word |= field(insn.get_rt_addr(), RT_ADDR_SHIFT);
+                break;
+            default:
+                error_msg = "the instruction has no binary encoding";
+                return false;
+        }
+        return true;
+    }
+
+    const std::vector<unsigned int>& reg_num = insn.get_q_reg_num();
+
+    switch (insn.get_q_insn_type()) {
+        case Q_instr_type::Q_SMIS: {
+            word = field(SMIS_OPCODE, OPCODE_SHIFT) | field(reg_num[0], Q_REG_SHIFT);
+            for (size_t qubit : insn.get_q_qubit_indices()) {
+                if (qubit >= SMIS_MASK_WIDTH) {
+                    error_msg = "qubit " + std::to_string(qubit) + " cannot be encoded in a " +
+                                std::to_string(SMIS_MASK_WIDTH) + "-bit mask";
+                    return false;
+                }
+                word |= 1u << qubit;
+            }
+            break;
+        }
+        case Q_instr_type::Q_SMIT: {
+            word = field(SMIT_OPCODE, OPCODE_SHIFT) | field(reg_num[0], Q_REG_SHIFT);
+            for (const auto& pair : insn.get_q_qubit_tuples()) {
+                unsigned int edge = 0;
+                if (!find_edge(pair[0], pair[1], edge)) {
+                    error_msg = "(" + std::to_string(pair[0]) + ", " + std::to_string(pair[1]) +
+                                ") is not an edge of the topology";
+                    return false;
+                }
+                if (edge >= SMIT_MASK_WIDTH) {
+                    error_msg = "edge " + std::to_string(edge) + " cannot be encoded in a " +
+                                std::to_string(SMIT_MASK_WIDTH) + "-bit mask";
+                    return false;
+                }
+                word |= 1u << edge;
+            }
+            break;
+        }
+        case Q_instr_type::Q_WAIT:
+            if (insn.get_q_time_specified() > (QWAIT_IMM_MASK >> QWAIT_IMM_SHIFT)) {
+                error_msg = "the waiting time cannot be encoded in " +
+                            std::to_string(QWAIT_IMM_WIDTH) + " bits";
+                return false;
+            }
+            word = field(QWAIT_OPCODE, OPCODE_SHIFT) |
+                   field(insn.get_q_time_specified(), QWAIT_IMM_SHIFT);
+            break;
+        case Q_instr_type::Q_WAITR:
+            word = field(QWAITR_OPCODE, OPCODE_SHIFT) | field(insn.get_rs_addr(), RS_ADDR_SHIFT);
+            break;
+        case Q_instr_type::Q_OP: {
+            const std::vector<std::string>& op_name = insn.get_q_op_name();
+            const std::vector<num_tgt_qubits_type_t>& tgt_type = insn.get_q_num_tgt_qubits_type();
+
+            if (op_name.size() > BUNDLE_NUM_OPS) {
+                error_msg = "a binary bundle holds at most " + std::to_string(BUNDLE_NUM_OPS) +
+                            " operations";
+                return false;
+            }
+            if (insn.get_q_time_specified() > BUNDLE_PI_MASK) {
+                error_msg = "the waiting time cannot be encoded in " +
+                            std::to_string(BUNDLE_PI_WIDTH) + " bits";
+                return false;
+            }
+
+            word = Q_BUNDLE_FLAG | insn.get_q_time_specified();
+            for (size_t i = 0; i < op_name.size(); ++i) {
+                auto it = m_q_opcodes.find(op_name[i]);
+                if (it == m_q_opcodes.end()) {
+                    error_msg = "the operation '" + op_name[i] + "' has no opcode";
+                    if (!m_q_opcode_source.empty()) error_msg += " in " + m_q_opcode_source;
+                    return false;
+                }
+                bool two_qubit = (tgt_type[i] == num_tgt_qubits_type_t::MULTIPLE);
+                if (two_qubit != ((it->second & BUNDLE_TWO_QUBIT_OP) != 0)) {
+                    error_msg = "the opcode of '" + op_name[i] + "' targets a different register";
+                    return false;
+                }
+                if (reg_num[i] > BUNDLE_REG_MASK) {
+                    error_msg = "the register cannot be encoded in " +
+                                std::to_string(BUNDLE_REG_WIDTH) + " bits";
+                    return false;
+                }
+                word |= field(it->second, (i == 0) ? BUNDLE_OP0_SHIFT : BUNDLE_OP1_SHIFT);
+                word |= field(reg_num[i], (i == 0) ? BUNDLE_REG0_SHIFT : BUNDLE_REG1_SHIFT);
+            }
+            break;
+        }
+        default:
+            error_msg = "the instruction has no binary encoding";
+            return false;
+    }
+    return true;
+}
+
+void Eqasm_assembler::assemble(const std::string& asm_fn, std::vector<uint32_t>& words,
+                               unsigned int num_threads, bool with_final_stop) {
+    Asm_program program;
+    program.load(asm_fn, num_threads);
+    assemble(program, words, num_threads, with_final_stop);
+}
+
+void Eqasm_assembler::assemble(Asm_program& program, std::vector<uint32_t>& words,
+                               unsigned int num_threads, bool with_final_stop) {
+    std::vector<Qasm_instruction> insns;
+    program.decode(insns, num_threads);
+
+    const size_t block_size = 4096;
+    const size_t num_blocks = (insns.size() + block_size - 1) / block_size;
+
+    words.clear();
+    words.resize(insns.size());
+
+    // as when decoding, only the error at the lowest address is reported
+    std::vector<std::string> block_error(num_blocks);
+
+    Thread_pool pool(num_threads);
+    pool.run(num_blocks, [&](size_t b) {
+        size_t last = std::min((b + 1) * block_size, insns.size());
+        for (size_t i = b * block_size; i < last; ++i) {
+            std::string reason;
+            if (!encode(insns[i], words[i], reason)) {
+                block_error[b] = fmt::format(
+                  "asm_parser: Cannot assemble instruction '{}' at line {}: {}. Simulation aborts!",
+                  insns[i].get_insn_str_in_file(), insns[i].get_insn_line_num_in_file(), reason);
+                return;
+            }
+        }
+    });
+
+    for (const auto& error_msg : block_error) {
+        if (!error_msg.empty()) {
+            auto logger = get_logger_or_exit("asm_logger");
+            logger->error("{}", error_msg);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // the parser always ends the program with an extra stop, which is not in the source. Unless
+    // a branch targets it, dropping it gives the same words as the source, and lets a
+    // disassembled listing assemble back into the same words.
+    if (!with_final_stop && !words.empty()) {
+        unsigned int last_addr = static_cast<unsigned int>(words.size() - 1);
+        bool         is_target = false;
+        for (size_t i = 0; i < words.size() && !is_target; ++i) {
+            is_target = is_br(words[i]) && (br_target(words[i], i) == last_addr);
+        }
+        if (!is_target) words.pop_back();
+    }
+}
+
+// ============================================================================================
+// disassembling
+// ============================================================================================
+std::string Eqasm_assembler::label_name(unsigned int addr) { return "L" + std::to_string(addr); }
+
+bool Eqasm_assembler::disassemble(uint32_t word, unsigned int addr, std::string& text) const {
+    unsigned int opcode = (word & OPCODE_MASK) >> OPCODE_SHIFT;
+    unsigned int rd     = (word & RD_ADDR_MASK) >> RD_ADDR_SHIFT;
+    unsigned int rs     = (word & RS_ADDR_MASK) >> RS_ADDR_SHIFT;
+    unsigned int rt     = (word & RT_ADDR_MASK) >> RT_ADDR_SHIFT;
+
+    text.clear();
+
+    // bundle of quantum operations
+    if (word & Q_BUNDLE_FLAG) {
+        unsigned int pi = word & BUNDLE_PI_MASK;
+        for (unsigned int i = 0; i < BUNDLE_NUM_OPS; ++i) {
+            unsigned int op  = (word >> ((i == 0) ? BUNDLE_OP0_SHIFT : BUNDLE_OP1_SHIFT)) &
+                              BUNDLE_OP_MASK;
+            unsigned int reg = (word >> ((i == 0) ? BUNDLE_REG0_SHIFT : BUNDLE_REG1_SHIFT)) &
+                               BUNDLE_REG_MASK;
+            if (op == 0) continue;
+
+            auto it = m_q_opnames.find(op);
+            if (it == m_q_opnames.end()) return false;
+
+            text += text.empty() ? fmt::format("{}, ", pi) : std::string(" | ");
+            text += fmt::format("{} {}{}", it->second,
+                                (op & BUNDLE_TWO_QUBIT_OP) ? 't' : 's', reg);
+        }
+
+        // a bundle without any operation only waits
+        if (text.empty()) text = fmt::format("qwait {}", pi);
+        return true;
+    }
+
+    // single format quantum instructions
+    if (opcode >= SMIS_OPCODE) {
+        unsigned int reg = (word & Q_REG_MASK) >> Q_REG_SHIFT;
+        std::string  targets;
+
+        switch (opcode) {
+            case SMIS_OPCODE:
+                for (unsigned int q = 0; q < SMIS_MASK_WIDTH; ++q) {
+                    if (!(word & (1u << q))) continue;
+                    targets += fmt::format("{}{}", targets.empty() ? "" : ", ", q);
+                }
+                text = fmt::format("smis s{}, {{{}}}", reg, targets);
+                return true;
+            case SMIT_OPCODE:
+                for (unsigned int e = 0; e < SMIT_MASK_WIDTH; ++e) {
+                    if (!(word & (1u << e))) continue;
+                    if (e >= m_edges.size()) return false;
+                    targets += fmt::format("{}({}, {})", targets.empty() ? "" : ", ",
+                                           m_edges[e].first, m_edges[e].second);
+                }
+                text = fmt::format("smit t{}, {{{}}}", reg, targets);
+                return true;
+            case QWAIT_OPCODE:
+                text = fmt::format("qwait {}", (word & QWAIT_IMM_MASK) >> QWAIT_IMM_SHIFT);
+                return true;
+            case QWAITR_OPCODE:
+                text = fmt::format("qwaitr r{}", rs);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    auto it_name = opcode_names().find(opcode);
+    if (it_name == opcode_names().end()) return false;
+    const std::string& name = it_name->second;
+
+    switch (opcode) {
+        case OperationName::NOP:
+        case OperationName::STOP:
+            text = name;
+            return true;
+        case OperationName::BR:
+        case OperationName::FBR: {
+            auto it_cond = br_cond_names().find((word & BR_COND_MASK) >> BR_COND_SHIFT);
+            if (it_cond == br_cond_names().end()) return false;
+
+            if (opcode == OperationName::FBR) {
+                text = fmt::format("fbr {}, r{}", it_cond->second, rd);
+            } else {
+                text = fmt::format("br {}, {}", it_cond->second,
+                                   label_name(br_target(word, addr)));
+            }
+            return true;
+        }
+        case OperationName::CMP:
+            text = fmt::format("cmp r{}, r{}", rs, rt);
+            return true;
+        case OperationName::FMR:
+            text = fmt::format("fmr r{}, q{}", rd, (word & QUBIT_SEL_MASK) >> QUBIT_SEL_SHIFT);
+            return true;
+        case OperationName::LDI:
+            text = fmt::format("ldi r{}, {}", rd,
+                               sign_extend((word & LDI_IMM_MASK) >> LDI_IMM_SHIFT, LDI_IMM_WIDTH));
+            return true;
+        case OperationName::LDUI:
+            text = fmt::format("ldui r{}, r{}, {}", rd, rs,
+                               (word & LDUI_IMM_MASK) >> LDUI_IMM_SHIFT);
+            return true;
+        case OperationName::ADD:
+        case OperationName::SUB:
+        case OperationName::AND:
+        case OperationName::OR:
+        case OperationName::XOR:
+            text = fmt::format("{} r{}, r{}, r{}", name, rd, rs, rt);
+            return true;
+        case OperationName::NOT:
+            text = fmt::format("not r{}, r{}", rd, rt);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Eqasm_assembler::disassemble(const std::vector<uint32_t>& words, std::ostream& os) const {
+    std::vector<std::string> lines(words.size());
+    std::set<unsigned int>   targets;
+
+    for (size_t addr = 0; addr < words.size(); ++addr) {
+        unsigned int a = static_cast<unsigned int>(addr);
+        if (!disassemble(words[addr], a, lines[addr])) {
+            for (size_t i = 0; i < addr; ++i) os << lines[i] << "\n";
+            os << fmt::format("# cannot disassemble 0x{:08x} at address {}", words[addr], addr)
+               << std::endl;
+            return false;
+        }
+        if (is_br(words[addr])) targets.insert(br_target(words[addr], a));
+    }
+
+    for (size_t addr = 0; addr < words.size(); ++addr) {
+        if (targets.count(static_cast<unsigned int>(addr))) {
+            os << label_name(static_cast<unsigned int>(addr)) << ":\n";
+        }
+        os << "    " << lines[addr] << "\n";
+    }
+    // labels beyond the program, e.g. a branch to the end
+    for (unsigned int target : targets) {
+        if (target >= words.size()) os << label_name(target) << ":\n";
+    }
+    os.flush();
+    return true;
+}
+
+bool Eqasm_assembler::write_bin(const std::string& bin_fn, const std::vector<uint32_t>& words) {
+    std::string bytes(words.size() * 4, '\0');
+    for (size_t i = 0; i < words.size(); ++i) {
+        bytes[4 * i]     = static_cast<char>(words[i] & 0xFF);
+        bytes[4 * i + 1] = static_cast<char>((words[i] >> 8) & 0xFF);
+        bytes[4 * i + 2] = static_cast<char>((words[i] >> 16) & 0xFF);
+        bytes[4 * i + 3] = static_cast<char>((words[i] >> 24) & 0xFF);
+    }
+
+    std::ofstream out(bin_fn, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+    return static_cast<bool>(out);
+}
+
+bool Eqasm_assembler::read_bin(const std::string& bin_fn, std::vector<uint32_t>& words) {
+    Mapped_file file;
+    if (!file.open(bin_fn) || (file.size() % 4 != 0)) return false;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data());
+    words.resize(file.size() / 4);
+    for (size_t i = 0; i < words.size(); ++i, p += 4) {
+        words[i] = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    return true;
+}
+
+}  // namespace cactus
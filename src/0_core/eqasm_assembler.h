@@ -0,0 +1,99 @@
+/** eqasm_assembler.h
+ *
+ * This file defines the eQASM assembler and disassembler.
+ *
+ * The assembler turns an asm program into the 32-bit binary format read by Q_decoder_bin and
+ * Qasm_instruction::set_instruction(unsigned, addr). It reuses the asm parser: a program is
+ * loaded and decoded by Asm_program exactly as in asm mode, and every decoded instruction is then
+ * encoded. Classical opcodes and branch conditions come from the tables of Qasm_instruction, and
+ * quantum operations from a qisa_opcodes.qmap file or from the opcode table of the simulator.
+ *
+ */
+
+#ifndef _EQASM_ASSEMBLER_H_
+#define _EQASM_ASSEMBLER_H_
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "asm_program.h"
+#include "qasm_instruction.h"
+
+namespace cactus {
+
+class Eqasm_assembler {
+  private:
+    // quantum operation name (lower case) -> opcode, and back
+    std::map<std::string, unsigned int> m_q_opcodes;
+    std::map<unsigned int, std::string> m_q_opnames;
+
+    // where the quantum opcodes come from, named in the errors
+    std::string m_q_opcode_source;
+
+    // directed edge -> (source qubit, target qubit), from the topology in Global_config
+    std::vector<std::pair<unsigned int, unsigned int>> m_edges;
+
+    void add_q_opcode(const std::string& name, unsigned int opcode);
+    void load_edges();
+
+    bool find_edge(size_t left, size_t right, unsigned int& edge) const;
+
+  public:
+    // use the opcode table of the simulator in binary mode, i.e.
+    // Global_config::opcode_to_opname_lut
+    void set_q_opcodes(const std::map<uint64_t, std::string>& opcode_to_opname);
+
+    // read the quantum operations from a qisa_opcodes.qmap file. Returns false with a message if
+    // the file cannot be read, or if it gives a classical opcode that differs from the one used
+    // by the simulator.
+    bool load_qmap(const std::string& qmap_fn, std::string& error_msg);
+
+    const std::map<std::string, unsigned int>& q_opcodes() const { return m_q_opcodes; }
+
+    // directed edge -> (source qubit, target qubit), as used by smit
+    const std::vector<std::pair<unsigned int, unsigned int>>& edges() const { return m_edges; }
+
+    // make the quantum operations known to the asm parser, which checks operation names against
+    // the gate times in Global_config. Operations already there are left untouched.
+    void declare_gates() const;
+
+    // encode one decoded asm instruction. Returns false with the reason if it has no binary
+    // encoding.
+    bool encode(Qasm_instruction& insn, uint32_t& word, std::string& error_msg) const;
+
+    // load, decode and encode the whole program on num_threads threads (0 for one per core).
+    // Aborts on the first instruction (in address order) that cannot be encoded.
+    //
+    // The stop the parser appends to the program is only kept for the simulation
+    // (with_final_stop), or when a branch targets it. Otherwise the words are the ones of the
+    // source, as written to a .bin file.
+    void assemble(const std::string& asm_fn, std::vector<uint32_t>& words,
+                  unsigned int num_threads = 1, bool with_final_stop = false);
+    void assemble(Asm_program& program, std::vector<uint32_t>& words,
+                  unsigned int num_threads = 1, bool with_final_stop = false);
+
+    // the asm text of one instruction at the given address. Branch targets are written as
+    // labels named after their address, see label_name(). Returns false for words which are
+    // not valid instructions.
+    bool disassemble(uint32_t word, unsigned int addr, std::string& text) const;
+
+    // a listing of the whole program, with a label before every branch target, which can be
+    // assembled again. Returns false after writing the first word which is not valid.
+    bool disassemble(const std::vector<uint32_t>& words, std::ostream& os) const;
+
+    static std::string label_name(unsigned int addr);
+
+    // binary programs are stored as little endian 32-bit words
+    static bool write_bin(const std::string& bin_fn, const std::vector<uint32_t>& words);
+    static bool read_bin(const std::string& bin_fn, std::vector<uint32_t>& words);
+
+  public:
+    Eqasm_assembler();
+};
+
+}  // namespace cactus
+
+#endif  // _EQASM_ASSEMBLER_H_
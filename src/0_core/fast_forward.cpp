@@ -0,0 +1,521 @@
+#include "fast_forward.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "eqasm_assembler.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "q_data_type.h"
+
+namespace cactus {
+
+// Sim_uint(size_t) sets the width, not the value
+static Sim_uint reg_addr(unsigned int reg_num) {
+    Sim_uint reg;
+    reg = reg_num;
+    return reg;
+}
+
+// ============================================================================================
+// handover target
+// ============================================================================================
+bool Ff_target::parse(const std::string& text) {
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) return false;
+
+    std::string kind = text.substr(0, colon);
+    std::string arg  = text.substr(colon + 1);
+    if (arg.empty()) return false;
+
+    if (kind == "label") {
+        type  = FF_LABEL;
+        label = arg;
+        return true;
+    }
+
+    if (kind != "pc" && kind != "cycle") return false;
+
+    try {
+        size_t pos = 0;
+        value      = std::stoull(arg, &pos, 0);
+        if (pos != arg.size()) return false;
+    } catch (std::exception&) {
+        return false;
+    }
+    type = (kind == "pc") ? FF_PC : FF_CYCLE;
+    return true;
+}
+
+std::string Ff_target::to_string() const {
+    switch (type) {
+        case FF_PC:
+            return "pc " + std::to_string(value);
+        case FF_CYCLE:
+            return "cycle " + std::to_string(value);
+        case FF_LABEL:
+            return "label '" + label + "'";
+        default:
+            return "the end of the program";
+    }
+}
+
+// ============================================================================================
+// loading
+// ============================================================================================
+Fast_forward_engine::Fast_forward_engine(Qubit_backend* backend)
+    : m_backend(backend) {
+
+    Global_config& global_config = Global_config::get_instance();
+
+    m_num_qubits       = global_config.num_qubits;
+    m_opcode_to_opname = global_config.opcode_to_opname_lut;
+
+    Eqasm_assembler assembler;
+    m_edges = assembler.edges();
+
+    m_state.reset(m_num_qubits);
+}
+
+void Fast_forward_engine::load_program() {
+    auto           logger        = get_logger_or_exit("console");
+    Global_config& global_config = Global_config::get_instance();
+
+    if (global_config.instruction_type == Instruction_type::ASM) {
+        load_asm(global_config.qisa_asm_fn, global_config.num_load_threads);
+        return;
+    }
+
+    std::vector<uint32_t> words;
+    if (global_config.assemble_bin) {
+        Eqasm_assembler assembler;
+        assembler.set_q_opcodes(global_config.opcode_to_opname_lut);
+        assembler.declare_gates();
+        assembler.assemble(global_config.qisa_asm_fn, words, global_config.num_load_threads,
+                           true);
+    } else if (!Eqasm_assembler::read_bin(global_config.qisa_bin_fn, words)) {
+        logger->error("fast_forward: Failed to open file: '{}'. Simulation aborts!",
+                      global_config.qisa_bin_fn);
+        exit(EXIT_FAILURE);
+    }
+    load_bin(words);
+}
+
+void Fast_forward_engine::load_asm(const std::string& asm_fn, unsigned int num_threads) {
+    m_type = Instruction_type::ASM;
+    m_program.load(asm_fn, num_threads);
+    m_program.decode(m_insns, num_threads);
+    m_state.reset(m_num_qubits);
+}
+
+void Fast_forward_engine::load_bin(const std::vector<uint32_t>& words) {
+    m_type = Instruction_type::BIN;
+    m_program.clear();
+    m_insns.resize(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        m_insns[i].set_instruction(words[i], static_cast<unsigned int>(i));
+    }
+    m_state.reset(m_num_qubits);
+}
+
+// ============================================================================================
+// execution
+// ============================================================================================
+Ff_stop_reason Fast_forward_engine::run(const Ff_target& target) {
+    auto logger = get_logger_or_exit("console");
+
+    // the address of the instruction to stop at, if any
+    bool         has_target_pc = false;
+    unsigned int target_pc     = 0;
+    if (target.type == FF_PC) {
+        has_target_pc = true;
+        target_pc     = static_cast<unsigned int>(target.value);
+    } else if (target.type == FF_LABEL) {
+        auto it = m_program.map_label.find(target.label);
+        if (m_type != Instruction_type::ASM || it == m_program.map_label.end()) {
+            logger->error("fast_forward: Cannot find the label '{}' in the program. Simulation "
+                          "aborts!",
+                          target.label);
+            exit(EXIT_FAILURE);
+        }
+        has_target_pc = true;
+        target_pc     = it->second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t       first_insn = m_state.num_insns;
+    Ff_stop_reason reason     = FF_PROGRAM_END;
+    m_state.valid             = true;
+
+    while (m_state.pc < m_insns.size()) {
+        if (has_target_pc && m_state.pc == target_pc) {
+            reason = FF_TARGET_REACHED;
+            break;
+        }
+
+        Qasm_instruction& insn = m_insns[m_state.pc];
+
+        if (is_q_insn(insn)) {
+            if ((target.type == FF_CYCLE) && (next_q_cycle(insn) >= target.value)) {
+                reason = FF_TARGET_REACHED;
+                break;
+            }
+            execute_quantum(insn);
+            m_state.pc++;
+        } else {
+            // the stop is left to the cycle-accurate model
+            if (insn.is_stop()) break;
+            execute_classical(insn);
+        }
+        m_state.num_insns++;
+    }
+
+    double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logger->info("fast_forward: Executed {} instructions in {:.3f} s, up to {} (pc: {}, 50 MHz "
+                 "cycle: {}).",
+                 m_state.num_insns - first_insn, seconds,
+                 (reason == FF_TARGET_REACHED) ? target.to_string() : std::string("stop"),
+                 m_state.pc, m_state.q_cycle);
+
+    return reason;
+}
+
+bool Fast_forward_engine::is_q_insn(Qasm_instruction& insn) {
+    if (m_type == Instruction_type::ASM) return insn.is_q_insn();
+
+    uint32_t word = insn.get_insn_bin();
+    return (word & Q_BUNDLE_FLAG) || (((word & OPCODE_MASK) >> OPCODE_SHIFT) >= SMIS_OPCODE);
+}
+
+void Fast_forward_engine::execute_classical(Qasm_instruction& insn) {
+    auto logger = get_logger_or_exit("console");
+
+    // registers are computed as unsigned values, which wrap around like the 32-bit registers
+    uint32_t rs   = static_cast<uint32_t>(m_state.regs[insn.get_rs_addr()]);
+    uint32_t rt   = static_cast<uint32_t>(m_state.regs[insn.get_rt_addr()]);
+    uint32_t imm  = static_cast<uint32_t>(insn.get_imm());
+    int32_t  s_rs = static_cast<int32_t>(rs);
+    int32_t  s_rt = static_cast<int32_t>(rt);
+
+    bool*        flags   = m_state.flags_cmp;
+    unsigned int next_pc = m_state.pc + 1;
+
+    bool     wr_rd = true;
+    uint32_t rd    = 0;
+
+    switch (insn.get_opcode()) {
+        case OperationName::NOP:
+            wr_rd = false;
+            break;
+        case OperationName::ADD:
+            rd = rs + rt;
+            break;
+        case OperationName::ADDI:
+            rd = rs + imm;
+            break;
+        case OperationName::SUB:
+            rd = rs - rt;
+            break;
+        case OperationName::MUL:
+            rd = static_cast<uint32_t>(static_cast<int64_t>(s_rs) * s_rt);
+            break;
+        case OperationName::DIV:
+        case OperationName::REM:
+            if (rt == 0) {
+                logger->error("fast_forward: Division by zero at pc {} ('{}'). Simulation aborts!",
+                              m_state.pc, insn.get_insn_str_in_file());
+                exit(EXIT_FAILURE);
+            }
+            rd = static_cast<uint32_t>((insn.get_opcode() == OperationName::DIV) ? s_rs / s_rt
+                                                                                 : s_rs % s_rt);
+            break;
+        case OperationName::AND:
+            rd = rs & rt;
+            break;
+        case OperationName::OR:
+            rd = rs | rt;
+            break;
+        case OperationName::XOR:
+            rd = rs ^ rt;
+            break;
+        case OperationName::NOT:
+            rd = ~rt;
+            break;
+        case OperationName::LDI:
+            rd = imm;
+            break;
+        case OperationName::LDUI:
+            rd = (insn.get_uimm() << 17) | (rs & 0x1FFFF);
+            break;
+        case OperationName::CMP:
+            wr_rd     = false;
+            flags[2]  = (rs == rt);      // eq
+            flags[3]  = (rs != rt);      // ne
+            flags[8]  = (rs < rt);       // ltu
+            flags[9]  = (rs >= rt);      // geu
+            flags[10] = (rs <= rt);      // leu
+            flags[11] = (rs > rt);       // gtu
+            flags[12] = (s_rs < s_rt);   // lt
+            flags[13] = (s_rs >= s_rt);  // ge
+            flags[14] = (s_rs <= s_rt);  // le
+            flags[15] = (s_rs > s_rt);   // gt
+            break;
+        case OperationName::FBR:
+            rd = flags[insn.get_br_cond()] ? 1 : 0;
+            break;
+        case OperationName::FMR:
+            if (insn.get_qubit_sel() >= m_state.meas_results.size()) {
+                logger->error("fast_forward: fmr reads qubit {}, but there are only {} qubits. "
+                              "Simulation aborts!",
+                              insn.get_qubit_sel(), m_state.meas_results.size());
+                exit(EXIT_FAILURE);
+            }
+            rd = m_state.meas_results[insn.get_qubit_sel()];
+            break;
+        case OperationName::BR:
+            wr_rd = false;
+            if (flags[insn.get_br_cond()]) next_pc = m_state.pc + insn.get_br_addr();
+            break;
+        case OperationName::LB:
+            rd = read_mem(rs + imm, 1);
+            if (rd & 0x80) rd |= 0xFFFFFF00;
+            break;
+        case OperationName::LBU:
+            rd = read_mem(rs + imm, 1);
+            break;
+        case OperationName::LW:
+            rd = read_mem(rs + imm, 4);
+            break;
+        case OperationName::SB:
+            wr_rd = false;
+            write_mem(rs + imm, rt, 1);
+            break;
+        case OperationName::SW:
+            wr_rd = false;
+            write_mem(rs + imm, rt, 4);
+            break;
+        default:
+            logger->error("fast_forward: Cannot execute the instruction at pc {} ('{}', opcode "
+                          "{}). Simulation aborts!",
+                          m_state.pc, insn.get_insn_str_in_file(), insn.get_opcode());
+            exit(EXIT_FAILURE);
+    }
+
+    if (wr_rd) m_state.regs[insn.get_rd_addr()] = static_cast<int32_t>(rd);
+
+    m_state.pc = next_pc;
+}
+
+uint64_t Fast_forward_engine::next_q_cycle(Qasm_instruction& insn) {
+    if (m_type == Instruction_type::ASM) {
+        switch (insn.get_q_insn_type()) {
+            case Q_instr_type::Q_OP:
+            case Q_instr_type::Q_WAIT:
+                return m_state.q_cycle + insn.get_q_time_specified();
+            case Q_instr_type::Q_WAITR:
+                return m_state.q_cycle + static_cast<uint32_t>(m_state.regs[insn.get_rs_addr()]);
+            default:
+                return m_state.q_cycle;
+        }
+    }
+
+    uint32_t word = insn.get_insn_bin();
+    if (word & Q_BUNDLE_FLAG) return m_state.q_cycle + (word & BUNDLE_PI_MASK);
+
+    switch ((word & OPCODE_MASK) >> OPCODE_SHIFT) {
+        case QWAIT_OPCODE:
+            return m_state.q_cycle + ((word & QWAIT_IMM_MASK) >> QWAIT_IMM_SHIFT);
+        case QWAITR_OPCODE:
+            return m_state.q_cycle +
+                   static_cast<uint32_t>(m_state.regs[(word & RS_ADDR_MASK) >> RS_ADDR_SHIFT]);
+        default:
+            return m_state.q_cycle;
+    }
+}
+
+void Fast_forward_engine::execute_quantum(Qasm_instruction& insn) {
+    auto logger = get_logger_or_exit("console");
+
+    m_state.q_cycle = next_q_cycle(insn);
+
+    std::vector<std::string>  op_names;
+    std::vector<unsigned int> reg_nums;
+    std::vector<bool>         two_qubit;
+
+    if (m_type == Instruction_type::ASM) {
+        switch (insn.get_q_insn_type()) {
+            case Q_instr_type::Q_SMIS:
+                m_state.mask_reg.set_s_reg_content(insn.get_q_qubit_indices(),
+                                                   reg_addr(insn.get_q_reg_num()[0]));
+                return;
+            case Q_instr_type::Q_SMIT:
+                m_state.mask_reg.set_m_reg_content(insn.get_q_qubit_tuples(),
+                                                   reg_addr(insn.get_q_reg_num()[0]));
+                return;
+            case Q_instr_type::Q_OP:
+                op_names = insn.get_q_op_name();
+                reg_nums = insn.get_q_reg_num();
+                for (auto type : insn.get_q_num_tgt_qubits_type()) {
+                    two_qubit.push_back(type != SINGLE);
+                }
+                break;
+            default:
+                return;
+        }
+    } else {
+        uint32_t word = insn.get_insn_bin();
+
+        if (word & Q_BUNDLE_FLAG) {
+            for (unsigned int i = 0; i < BUNDLE_NUM_OPS; ++i) {
+                unsigned int op = (word >> ((i == 0) ? BUNDLE_OP0_SHIFT : BUNDLE_OP1_SHIFT)) &
+                                  BUNDLE_OP_MASK;
+                unsigned int reg = (word >> ((i == 0) ? BUNDLE_REG0_SHIFT : BUNDLE_REG1_SHIFT)) &
+                                   BUNDLE_REG_MASK;
+                if (op == 0) continue;  // quantum nop
+
+                auto it = m_opcode_to_opname.find(op);
+                if (it == m_opcode_to_opname.end()) {
+                    logger->error("fast_forward: Opcode '0x{:x}' cannot map to a qubit gate in "
+                                  "qubit simulator. Simulation aborts!",
+                                  op);
+                    exit(EXIT_FAILURE);
+                }
+                op_names.push_back(it->second);
+                reg_nums.push_back(reg);
+                two_qubit.push_back((op & BUNDLE_TWO_QUBIT_OP) != 0);
+            }
+        } else {
+            unsigned int opcode = (word & OPCODE_MASK) >> OPCODE_SHIFT;
+            Sim_uint     reg_num = reg_addr((word & Q_REG_MASK) >> Q_REG_SHIFT);
+            Bit_set      mask;
+
+            if (opcode == SMIS_OPCODE) {
+                mask.resize(SMIS_MASK_WIDTH);
+                mask.set_word(0, word & SMIS_MASK_MASK);
+                m_state.mask_reg.set_reg_mask(mask, reg_num, SINGLE);
+            } else if (opcode == SMIT_OPCODE) {
+                mask.resize(SMIT_MASK_WIDTH);
+                mask.set_word(0, word & SMIT_MASK_MASK);
+                m_state.mask_reg.set_reg_mask(mask, reg_num, MULTIPLE);
+            }
+            return;
+        }
+    }
+
+    issue_bundle(op_names, reg_nums, two_qubit);
+}
+
+void Fast_forward_engine::issue_bundle(const std::vector<std::string>&  op_names,
+                                       const std::vector<unsigned int>& reg_nums,
+                                       const std::vector<bool>&         two_qubit) {
+    auto logger = get_logger_or_exit("console");
+
+    // the operation on every qubit. Like Adi_convert, a two-qubit operation is given at its
+    // left qubit, and the operations are sent in the order of the qubits.
+    std::vector<Atom_qop> qubit_ops(m_num_qubits);
+
+    auto set_op = [&](const std::string& name, size_t left, size_t right, bool is_pair) {
+        if (left >= m_num_qubits || (is_pair && right >= m_num_qubits)) {
+            logger->error("fast_forward: Operation '{}' targets a qubit out of the {} qubits. "
+                          "Simulation aborts!",
+                          name, m_num_qubits);
+            exit(EXIT_FAILURE);
+        }
+        Atom_qop& qop = qubit_ops[left];
+        qop.operation = name;
+        qop.target_qubits.clear();
+        qop.target_qubits.push_back(static_cast<unsigned int>(left));
+        if (is_pair) qop.target_qubits.push_back(static_cast<unsigned int>(right));
+    };
+
+    for (size_t i = 0; i < op_names.size(); ++i) {
+        Sim_uint reg_num = reg_addr(reg_nums[i]);
+
+        if (m_type == Instruction_type::ASM) {
+            if (two_qubit[i]) {
+                for (const auto& tuple : m_state.mask_reg.get_m_reg_content(reg_num)) {
+                    set_op(op_names[i], tuple[0], tuple[1], true);
+                }
+            } else {
+                for (size_t q : m_state.mask_reg.get_s_reg_content(reg_num)) {
+                    set_op(op_names[i], q, 0, false);
+                }
+            }
+            continue;
+        }
+
+        const Bit_set& mask =
+          m_state.mask_reg.get_reg_mask(reg_num, two_qubit[i] ? MULTIPLE : SINGLE);
+        mask.for_each([&](size_t bit) {
+            if (!two_qubit[i]) {
+                set_op(op_names[i], bit, 0, false);
+            } else if (bit < m_edges.size()) {
+                set_op(op_names[i], m_edges[bit].first, m_edges[bit].second, true);
+            }
+        });
+    }
+
+    Ops_2_qsim moment;
+    moment.cycle     = static_cast<unsigned int>(m_state.q_cycle);
+    moment.triggered = true;
+    for (auto& qop : qubit_ops) {
+        if (!qop.target_qubits.empty()) moment.atom_ops.push_back(qop);
+    }
+
+    if (moment.atom_ops.empty() || m_backend == nullptr) return;
+
+    Res_from_qsim res = m_backend->apply_moment(moment);
+    for (const auto& result : res.results) {
+        if (result.first < m_state.meas_results.size()) {
+            m_state.meas_results[result.first] = result.second;
+        }
+    }
+}
+
+// ============================================================================================
+// data memory, little endian, accessed like in Classical_mem
+// ============================================================================================
+void Fast_forward_engine::check_mem_addr(uint32_t addr, unsigned int num_bytes) {
+    Data_memory* data_memory = Global_config::get_instance().data_memory;
+
+    if (data_memory == nullptr ||
+        static_cast<uint64_t>(addr) + num_bytes > data_memory->get_mem_size()) {
+        auto logger = get_logger_or_exit("console");
+        logger->error("fast_forward: Memory address '0x{:08x}' at pc {} is out of data memory "
+                      "size '0x{:08x}'. Simulation aborts!",
+                      addr, m_state.pc, data_memory ? data_memory->get_mem_size() : 0);
+        exit(EXIT_FAILURE);
+    }
+}
+
+uint32_t Fast_forward_engine::read_mem(uint32_t addr, unsigned int num_bytes) {
+    Data_memory* data_memory = Global_config::get_instance().data_memory;
+
+    check_mem_addr(addr, num_bytes);
+
+    uint32_t data = 0;
+    for (unsigned int i = 0; i < num_bytes; ++i) {
+        uint32_t byte_addr = addr + i;
+        uint32_t word      = data_memory->read_mem(byte_addr >> 2);
+        data |= ((word >> (8 * (byte_addr & 3))) & 0xFF) << (8 * i);
+    }
+    return data;
+}
+
+void Fast_forward_engine::write_mem(uint32_t addr, uint32_t data, unsigned int num_bytes) {
+    Data_memory* data_memory = Global_config::get_instance().data_memory;
+
+    check_mem_addr(addr, num_bytes);
+
+    for (unsigned int i = 0; i < num_bytes; ++i) {
+        uint32_t     byte_addr = addr + i;
+        unsigned int shift     = 8 * (byte_addr & 3);
+        uint32_t     word      = data_memory->read_mem(byte_addr >> 2);
+        word = (word & ~(0xFFu << shift)) | (((data >> (8 * i)) & 0xFF) << shift);
+        data_memory->write_mem(byte_addr >> 2, word);
+    }
+}
+
+}  // namespace cactus
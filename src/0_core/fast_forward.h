@@ -0,0 +1,95 @@
+/** fast_forward.h
+ *
+ * This file defines the fast-forward engine, which executes an eQASM program one instruction at
+ * a time, without any pipeline or clock. It is used to skip the uninteresting part of a long
+ * program: the engine runs up to a given point, and the cycle-accurate model continues from the
+ * architectural state the engine has reached (see Arch_state).
+ *
+ * Classical instructions have the same semantics as in Classical_execute and Classical_mem, and
+ * read and write the data memory of the simulation. Quantum instructions follow the timing of
+ * the program: the quantum operations of every bundle are sent, as one moment, to the qubit
+ * simulator at the timing point the bundle specifies. Measurement results are available to fmr
+ * right after the measurement, i.e. the latency of the measurement is not modelled.
+ *
+ */
+
+#ifndef _FAST_FORWARD_H_
+#define _FAST_FORWARD_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "arch_state.h"
+#include "asm_program.h"
+#include "interface_lib.h"
+#include "qasm_instruction.h"
+
+namespace cactus {
+
+// why the engine has stopped
+enum Ff_stop_reason { FF_TARGET_REACHED = 0, FF_PROGRAM_END };
+
+class Fast_forward_engine {
+  private:
+    // the qubit simulator quantum operations are sent to. Without it, quantum operations only
+    // advance the timeline, and measurements return 0.
+    Qubit_backend* m_backend;
+
+    Instruction_type              m_type = Instruction_type::ASM;
+    Asm_program                   m_program;  // asm programs
+    std::vector<Qasm_instruction> m_insns;
+
+    // directed edge -> (source qubit, target qubit), used to decode smit in binary programs
+    std::vector<std::pair<unsigned int, unsigned int>> m_edges;
+
+    // binary opcode -> operation name, as in Adi_convert
+    std::map<uint64_t, std::string> m_opcode_to_opname;
+
+    size_t m_num_qubits = 0;
+
+    Arch_state m_state;
+
+  private:
+    bool is_q_insn(Qasm_instruction& insn);
+
+    void execute_classical(Qasm_instruction& insn);
+    void execute_quantum(Qasm_instruction& insn);
+
+    // send the operations (name, register, two-qubit) of one bundle to the qubit simulator
+    void issue_bundle(const std::vector<std::string>&  op_names,
+                      const std::vector<unsigned int>& reg_nums,
+                      const std::vector<bool>&         two_qubit);
+
+    void     check_mem_addr(uint32_t addr, unsigned int num_bytes);
+    uint32_t read_mem(uint32_t addr, unsigned int num_bytes);
+    void     write_mem(uint32_t addr, uint32_t data, unsigned int num_bytes);
+
+    // the 50 MHz cycle of the timing point after the instruction
+    uint64_t next_q_cycle(Qasm_instruction& insn);
+
+  public:
+    // the program given to the simulation, i.e. Global_config::qisa_asm_fn or qisa_bin_fn
+    void load_program();
+
+    void load_asm(const std::string& asm_fn, unsigned int num_threads = 1);
+    void load_bin(const std::vector<uint32_t>& words);
+
+    // run until the target or a stop instruction, which is not executed. Running again
+    // continues from where the engine has stopped.
+    Ff_stop_reason run(const Ff_target& target);
+
+    const Arch_state& state() const { return m_state; }
+    size_t            num_insns() const { return m_insns.size(); }
+
+    // continue from a state restored from a checkpoint. The program has to be loaded first.
+    void set_state(const Arch_state& state) { m_state = state; }
+
+  public:
+    Fast_forward_engine(Qubit_backend* backend = nullptr);
+};
+
+}  // namespace cactus
+
+#endif  // _FAST_FORWARD_H_
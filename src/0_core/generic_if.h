@@ -12,6 +12,8 @@
 #ifndef _GENERIC_IF_H_
 #define _GENERIC_IF_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -20,6 +22,8 @@
 #include <systemc>
 #include <vector>
 
+#include "bit_set.h"
+
 namespace cactus {
 
 /** todo: all data type in the simulator should contain two kinds of representation:
@@ -32,7 +36,7 @@ namespace cactus {
 
 // An unsigned integer type with a configurable width in binary representation.
 // When it is of interest, the width can be used to extract statistical information.
-// Currently, the maximum allowed width is 64
+// Currently, the maximum allowed width is 64. The qubit masks, which can be wider, are Bit_sets.
 // TODO:  1. to check if unsigned int is sufficient or not;
 //            if not, how to support signed int?
 //        2. add other overloading functions to enable easy use, such as []
@@ -42,8 +46,8 @@ class Sim_uint {
     size_t   width;
 
   public:
-    uint64_t get_value() { return value; }
-    size_t   get_width() { return width; }
+    uint64_t get_value() const { return value; }
+    size_t   get_width() const { return width; }
 
     // overload of operator =
     Sim_uint& operator=(const Sim_uint& other) {
@@ -144,6 +148,219 @@ class cmatrix_t {
     }
 };
 
+// --------------------------------------------------------------------------------------------
+// Fixed-capacity Storage
+// --------------------------------------------------------------------------------------------
+
+// A list stored in slots which are allocated once and then reused. Unlike std::vector, clear()
+// keeps the elements alive, so that the vectors inside them keep their storage, and copying into
+// a slot assigns the element instead of constructing it anew.
+//
+// The slots are kept in a block which is shared by the copies of the list, with a reference
+// count: a copy only takes a reference, and a list whose block is shared copies the elements into
+// a block of its own when it is changed. The blocks which are no longer referenced go back to a
+// pool, elements included, for the next list which needs one. A block taken from the pool gets as
+// many slots as the largest block, so that a list does not grow again in a block which has only
+// served shorter ones. A list passed on unchanged through the stages of the pipeline, and through
+// the signals between them, is thus never copied, and comparing it with its copies does not look
+// at the elements. The stages which have no operation to pass on take a list of default elements
+// with assign_default(), which shares one block per size, so that an idle pipeline compares in
+// O(1) as well. A list which a stage builds anew with other elements is compared element by
+// element, even when its elements are the same: they can be changed through the references the
+// list hands out, so the list cannot keep a generation or a hash of them up to date.
+//
+// A reference to an element must not be kept across an assignment to the list, since the list
+// may then share another block, and a change through it would be seen by the copies. A
+// comparison does not change the lists. The blocks are not thread-safe, the lists are only used
+// by the simulation thread.
+template <typename T>
+class Slot_vector {
+  public:
+    typedef typename std::vector<T>::iterator       iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+  private:
+    class Block {
+      public:
+        std::vector<T> slots;
+        size_t         size = 0;
+        unsigned int   refs = 0;
+    };
+
+    // no block for an empty list which has never been changed
+    Block* m_block = nullptr;
+
+    // the free blocks. It is never destroyed, since lists may be released at exit after it.
+    static std::vector<Block*>& pool() {
+        static std::vector<Block*>* s_pool = new std::vector<Block*>();
+        return *s_pool;
+    }
+
+    // the number of slots of the largest block
+    static size_t& max_slots() {
+        static size_t s_max_slots = 0;
+        return s_max_slots;
+    }
+
+    static void grow(Block& block, size_t num_slots) {
+        if (block.slots.size() >= num_slots) return;
+        block.slots.resize(num_slots);
+        if (num_slots > max_slots()) max_slots() = num_slots;
+    }
+
+    static std::vector<T>& no_slots() {
+        static std::vector<T> s_no_slots;
+        return s_no_slots;
+    }
+
+    // the lists of default elements, by size. They are never destroyed, so that their blocks stay
+    // shared and a change to a list taking one copies it first.
+    static std::vector<Slot_vector*>& default_lists() {
+        static std::vector<Slot_vector*>* s_default_lists = new std::vector<Slot_vector*>();
+        return *s_default_lists;
+    }
+
+    static Block* acquire() {
+        Block* block;
+        if (pool().empty()) {
+            block = new Block();
+        } else {
+            block = pool().back();
+            pool().pop_back();
+        }
+        grow(*block, max_slots());
+        block->size = 0;
+        block->refs = 1;
+        return block;
+    }
+
+    static void release(Block* block) {
+        if (block != nullptr && --block->refs == 0) pool().push_back(block);
+    }
+
+    // the block of this list alone, before a change
+    Block& own() {
+        if (m_block == nullptr) {
+            m_block = acquire();
+        } else if (m_block->refs > 1) {
+            Block* shared = m_block;
+            m_block       = acquire();
+            grow(*m_block, shared->size);
+            std::copy(shared->slots.begin(), shared->slots.begin() + shared->size,
+                      m_block->slots.begin());
+            m_block->size = shared->size;
+            release(shared);
+        }
+        return *m_block;
+    }
+
+  public:
+    Slot_vector() {}
+
+    Slot_vector(const Slot_vector& other) { *this = other; }
+
+    ~Slot_vector() { release(m_block); }
+
+    // allocates the slots, usually at elaboration time
+    void reserve(size_t capacity) {
+        grow(own(), capacity);
+    }
+
+    size_t capacity() const { return m_block ? m_block->slots.size() : 0; }
+    size_t size() const { return m_block ? m_block->size : 0; }
+    bool   empty() const { return size() == 0; }
+
+    T&       operator[](size_t i) { return own().slots[i]; }
+    const T& operator[](size_t i) const { return m_block->slots[i]; }
+
+    iterator begin() { return m_block ? own().slots.begin() : no_slots().begin(); }
+    iterator end() { return begin() + size(); }
+    const_iterator begin() const {
+        return m_block ? m_block->slots.cbegin() : no_slots().cbegin();
+    }
+    const_iterator end() const { return begin() + size(); }
+
+    // the elements stay in their slots, or in the shared block
+    void clear() {
+        if (m_block == nullptr) return;
+
+        if (m_block->refs > 1) {
+            release(m_block);
+            m_block = nullptr;
+        } else {
+            m_block->size = 0;
+        }
+    }
+
+    // there is only an allocation when all the slots are taken
+    void push_back(const T& value) {
+        Block& block = own();
+        if (block.size == block.slots.size()) grow(block, std::max<size_t>(2 * block.size, 1));
+        block.slots[block.size] = value;
+        ++block.size;
+    }
+
+    // the elements which are added are reset to the default one
+    void resize(size_t size) {
+        Block& block = own();
+        grow(block, size);
+        for (size_t i = block.size; i < size; ++i) {
+            block.slots[i] = T();
+        }
+        block.size = size;
+    }
+
+    // the given number of default elements, in the block shared by all such lists
+    void assign_default(size_t size) {
+        std::vector<Slot_vector*>& lists = default_lists();
+        if (lists.size() <= size) lists.resize(size + 1, nullptr);
+        if (lists[size] == nullptr) {
+            lists[size] = new Slot_vector();
+            lists[size]->resize(size);
+        }
+        share(*lists[size]);
+    }
+
+    // whether the list has been taken with assign_default() and not changed since
+    bool is_default() const {
+        const std::vector<Slot_vector*>& lists = default_lists();
+        return m_block != nullptr && size() < lists.size() && lists[size()] != nullptr &&
+               lists[size()]->m_block == m_block;
+    }
+
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    // overload of operator =
+    Slot_vector& operator=(const Slot_vector& other) {
+        share(other);
+        return *this;
+    }
+
+    // overload of operator ==, the copies sharing a block are equal without comparing the
+    // elements, the other lists are compared element by element
+    bool operator==(const Slot_vector& other) const {
+        if (m_block == other.m_block) return true;
+        if (size() != other.size()) return false;
+        return std::equal(begin(), end(), other.begin());
+    }
+
+  private:
+    // takes a reference to the block of the other list
+    void share(const Slot_vector& other) {
+        if (m_block == other.m_block) return;
+
+        if (other.m_block != nullptr) other.m_block->refs++;
+        release(m_block);
+        m_block = other.m_block;
+    }
+};
+
 // --------------------------------------------------------------------------------------------
 // Operation Information
 // --------------------------------------------------------------------------------------------
@@ -198,31 +415,16 @@ class Bare_qop {
     }
 
     // overload of operator =
+    // All the fields are copied, as the copy constructor does: an operation assigned into a slot
+    // which is reused must not keep the fields of the previous one.
     Bare_qop& operator=(const Bare_qop& qop) {
         if (this != &qop) {
-            type = qop.type;
-            switch (type) {
-                case REPR_NAME:
-                    name = qop.name;
-                    break;
-
-                case REPR_OPCODE:
-                    opcode = qop.opcode;
-                    break;
-
-                case REPR_CODEWORD:
-                    codeword = qop.codeword;
-                    break;
-                case REPR_PULSE:
-                    pulse = qop.pulse;
-                    break;
-                case REPR_MATRIX:
-                    matrix = qop.matrix;
-                    break;
-
-                default:
-                    break;
-            }
+            type     = qop.type;
+            name     = qop.name;
+            opcode   = qop.opcode;
+            codeword = qop.codeword;
+            pulse    = qop.pulse;
+            matrix   = qop.matrix;
         }
         return *this;
     };
@@ -317,10 +519,10 @@ class Single_qubit_addr_info {
     size_t somq_width;
 
     // directly stores the indices of qubits
-    std::vector<size_t> qubit_indices;
+    Slot_vector<size_t> qubit_indices;
 
     // use each bit in the mask to indicate if the qubit is selected or not
-    Sim_uint mask;
+    Bit_set mask;
 
   public:
     // default constructor
@@ -333,7 +535,7 @@ class Single_qubit_addr_info {
 
     // reset member variables
     void reset() {
-        mask = 0;
+        mask.resize(0);
         qubit_indices.clear();
     }
 
@@ -341,8 +543,7 @@ class Single_qubit_addr_info {
     Single_qubit_addr_info& operator=(const Single_qubit_addr_info& single_addr) {
         if (this != &single_addr) {
             somq_width = single_addr.somq_width;
-            qubit_indices.assign(single_addr.qubit_indices.begin(),
-                                 single_addr.qubit_indices.end());
+            qubit_indices = single_addr.qubit_indices;
             mask = single_addr.mask;
         }
         return *this;
@@ -366,10 +567,10 @@ class Multi_qubit_addr_info {
     size_t somq_width;
 
     // a list of qubit tuples, used by n-qubit gates, n >= 2
-    std::vector<std::vector<size_t>> qubit_tuples;
+    Slot_vector<std::vector<size_t>> qubit_tuples;
 
     // use each bit in the mask to indicate if a qubit tuple is selected or not
-    Sim_uint mask;
+    Bit_set mask;
 
   public:
     // default constructor
@@ -381,7 +582,7 @@ class Multi_qubit_addr_info {
     }
 
     void reset() {
-        mask = 0;
+        mask.resize(0);
         qubit_tuples.clear();
     }
 
@@ -389,7 +590,7 @@ class Multi_qubit_addr_info {
     Multi_qubit_addr_info& operator=(const Multi_qubit_addr_info& multi_addr) {
         if (this != &multi_addr) {
             somq_width = multi_addr.somq_width;
-            qubit_tuples.assign(multi_addr.qubit_tuples.begin(), multi_addr.qubit_tuples.end());
+            qubit_tuples = multi_addr.qubit_tuples;
             mask = multi_addr.mask;
         }
         return *this;
@@ -457,12 +658,12 @@ class Q_tgt_addr {
 // quantum register
 class Q_mask_reg {
   public:
-    // default 32 single-qubit operation registers
-    Sim_uint                         s_reg_mask[32] = { 0 };
+    // default 32 single-qubit operation registers, the masks are empty after a reset
+    Bit_set                          s_reg_mask[32];
     std::vector<std::vector<size_t>> s_reg_content;  // used for asm instruction
 
     // default 32 multiple-qubit operation registers
-    Sim_uint                                      m_reg_mask[32] = { 0 };
+    Bit_set                                       m_reg_mask[32];
     std::vector<std::vector<std::vector<size_t>>> m_reg_content;  // used for asm instruction
 
   public:
@@ -475,15 +676,15 @@ class Q_mask_reg {
     // reset member variables
     void reset() {
         for (size_t i = 0; i < 32; ++i) {
-            s_reg_mask[i] = 0;
-            m_reg_mask[i] = 0;
-            s_reg_content[i].clear();
+            s_reg_mask[i].resize(0);
+            m_reg_mask[i].resize(0);
             s_reg_content[i].clear();
+            m_reg_content[i].clear();
         }
     }
 
     // write register
-    void set_reg_mask(const Sim_uint& mask, const Sim_uint& reg_num,
+    void set_reg_mask(const Bit_set& mask, const Sim_uint& reg_num,
                       enum num_tgt_qubits_type_t type) {
         if (type == SINGLE) {
             s_reg_mask[reg_num.value] = mask;
@@ -493,7 +694,7 @@ class Q_mask_reg {
     }
 
     // read register
-    Sim_uint get_reg_mask(const Sim_uint& reg_num, enum num_tgt_qubits_type_t type) {
+    const Bit_set& get_reg_mask(const Sim_uint& reg_num, enum num_tgt_qubits_type_t type) const {
         if (type == SINGLE) {
             return s_reg_mask[reg_num.value];
         } else {
@@ -501,24 +702,25 @@ class Q_mask_reg {
         }
     }
 
-    // write single-qubit register
-    void set_s_reg_content(const std::vector<size_t>& content, const Sim_uint& reg_num) {
+    // write single-qubit register, from a std::vector or a Slot_vector
+    template <typename Content>
+    void set_s_reg_content(const Content& content, const Sim_uint& reg_num) {
         s_reg_content[reg_num.value].assign(content.begin(), content.end());
     }
 
-    // write multiple-qubit register
-    void set_m_reg_content(const std::vector<std::vector<size_t>>& content,
-                           const Sim_uint&                         reg_num) {
+    // write multiple-qubit register, from a std::vector or a Slot_vector
+    template <typename Content>
+    void set_m_reg_content(const Content& content, const Sim_uint& reg_num) {
         m_reg_content[reg_num.value].assign(content.begin(), content.end());
     }
 
     // read single-qubit register
-    std::vector<size_t> get_s_reg_content(const Sim_uint& reg_num) {
+    const std::vector<size_t>& get_s_reg_content(const Sim_uint& reg_num) const {
         return s_reg_content[reg_num.value];
     }
 
     // read multiple-qubit register
-    std::vector<std::vector<size_t>> get_m_reg_content(const Sim_uint& reg_num) {
+    const std::vector<std::vector<size_t>>& get_m_reg_content(const Sim_uint& reg_num) const {
         return m_reg_content[reg_num.value];
     }
 };
@@ -677,7 +879,7 @@ class Q_pipe_interface {
     If_content_type if_content;
 
     // information used to update the indirect address register
-    std::vector<Q_tgt_addr> addrs_to_set;
+    Slot_vector<Q_tgt_addr> addrs_to_set;
 
     // timing information
     Timing_info timing;
@@ -685,14 +887,21 @@ class Q_pipe_interface {
     // If address type is HARDWIRE, the address of each operation
     //    is the index of the operation in the ops vecotr.
     Q_addr_type              type;
-    std::vector<Fledged_qop> ops;
+    Slot_vector<Fledged_qop> ops;
 
     // Xiang is not sure about whether this configuration should be here or not.
-    unsigned int vliw_width;
+    unsigned int vliw_width = 0;
 
   public:
     Q_pipe_interface() { if_content = If_content_type(); }
 
+    // allocates the slots for the largest content at elaboration time: one operation per qubit
+    // after the address decoder, and one operation or address per vliw pipelane before it
+    void reserve(size_t num_qubits, size_t vliw_width) {
+        ops.reserve(std::max(num_qubits, vliw_width));
+        addrs_to_set.reserve(vliw_width);
+    }
+
     // reset member variables
     void reset() {
         if_content.reset();
@@ -709,9 +918,8 @@ class Q_pipe_interface {
             timing     = q_pipe_interface.timing;
             type       = q_pipe_interface.type;
             vliw_width = q_pipe_interface.vliw_width;
-            addrs_to_set.assign(q_pipe_interface.addrs_to_set.begin(),
-                                q_pipe_interface.addrs_to_set.end());
-            ops.assign(q_pipe_interface.ops.begin(), q_pipe_interface.ops.end());
+            addrs_to_set = q_pipe_interface.addrs_to_set;
+            ops          = q_pipe_interface.ops;
         }
         return *this;
     }
@@ -861,11 +1069,11 @@ inline std::ostream& operator<<(std::ostream& os, const Q_tgt_addr& addr) {
 
         // single operation mask
         if (addr.type.q_num_type == SINGLE) {
-            mask << "0x" << std::hex << addr.sq_op_addr.mask.value;
+            mask << "0x" << addr.sq_op_addr.mask.to_hex();
             os << std::setfill(' ') << std::setw(10) << mask.str() << " ";
         } else {
             // multi qubits operation mask
-            mask << "0x" << std::hex << addr.mq_op_addr.mask.value;
+            mask << "0x" << addr.mq_op_addr.mask.to_hex();
             os << std::setfill(' ') << std::setw(10) << mask.str() << " ";
         }
 
@@ -1026,20 +1234,21 @@ class Measurement_if {
   public:  // interface
     virtual void reset() = 0;
 
-    virtual void set_meas_ena(const std::vector<bool>& vec)        = 0;
-    virtual void set_meas_ena_cancel(const std::vector<bool>& vec) = 0;
-    virtual void set_meas_data(const std::vector<bool>& vec)       = 0;
-    virtual void set_meas_data_valid(const std::vector<bool>& vec) = 0;
+    virtual void set_meas_ena(const Bit_set& bits)        = 0;
+    virtual void set_meas_ena_cancel(const Bit_set& bits) = 0;
+    virtual void set_meas_data(const Bit_set& bits)       = 0;
+    virtual void set_meas_data_valid(const Bit_set& bits) = 0;
 
-    virtual std::vector<bool> get_meas_ena()        = 0;
-    virtual std::vector<bool> get_meas_ena_cancel() = 0;
-    virtual std::vector<bool> get_meas_data()       = 0;
-    virtual std::vector<bool> get_meas_data_valid() = 0;
+    virtual const Bit_set& get_meas_ena() const        = 0;
+    virtual const Bit_set& get_meas_ena_cancel() const = 0;
+    virtual const Bit_set& get_meas_data() const       = 0;
+    virtual const Bit_set& get_meas_data_valid() const = 0;
 
     virtual ~Measurement_if() = default;
 };
 
-// General measurement interface derived of Measurement_if
+// General measurement interface derived of Measurement_if. There is one bit per qubit, the sets
+// are empty after a reset.
 class Generic_meas_if : public Measurement_if {
   public:
     // timing info is used for log
@@ -1047,58 +1256,54 @@ class Generic_meas_if : public Measurement_if {
 
   private:
     // private variables
-    std::vector<bool> meas_ena;
-    std::vector<bool> meas_ena_cancel;
-    std::vector<bool> meas_data;
-    std::vector<bool> meas_data_valid;
+    Bit_set meas_ena;
+    Bit_set meas_ena_cancel;
+    Bit_set meas_data;
+    Bit_set meas_data_valid;
 
   public:  // public member function
     void reset() {
         timing.reset();
-        meas_data.clear();
-        meas_ena.clear();
-        meas_ena_cancel.clear();
-        meas_data_valid.clear();
+        meas_data.resize(0);
+        meas_ena.resize(0);
+        meas_ena_cancel.resize(0);
+        meas_data_valid.resize(0);
     }
 
     // set meas_ena
-    void set_meas_ena(const std::vector<bool>& vec) { meas_ena.assign(vec.begin(), vec.end()); }
+    void set_meas_ena(const Bit_set& bits) { meas_ena = bits; }
 
     // set meas_ena_cancel
-    void set_meas_ena_cancel(const std::vector<bool>& vec) {
-        meas_ena_cancel.assign(vec.begin(), vec.end());
-    }
+    void set_meas_ena_cancel(const Bit_set& bits) { meas_ena_cancel = bits; }
 
     // set_meas_data
-    void set_meas_data(const std::vector<bool>& vec) { meas_data.assign(vec.begin(), vec.end()); }
+    void set_meas_data(const Bit_set& bits) { meas_data = bits; }
 
     // set_meas_data_valid
-    void set_meas_data_valid(const std::vector<bool>& vec) {
-        meas_data_valid.assign(vec.begin(), vec.end());
-    }
+    void set_meas_data_valid(const Bit_set& bits) { meas_data_valid = bits; }
 
     // get_meas_ena
-    std::vector<bool> get_meas_ena() { return meas_ena; }
+    const Bit_set& get_meas_ena() const { return meas_ena; }
 
     // get_meas_ena_cancel
-    std::vector<bool> get_meas_ena_cancel() { return meas_ena_cancel; }
+    const Bit_set& get_meas_ena_cancel() const { return meas_ena_cancel; }
 
     // get_meas_data
-    std::vector<bool> get_meas_data() { return meas_data; }
+    const Bit_set& get_meas_data() const { return meas_data; }
 
     // get_meas_data_valid
-    std::vector<bool> get_meas_data_valid() { return meas_data_valid; }
+    const Bit_set& get_meas_data_valid() const { return meas_data_valid; }
 
     ~Generic_meas_if() {}
 
     // overload of operator =
     Generic_meas_if& operator=(const Generic_meas_if& meas) {
         if (this != &meas) {
-            timing = meas.timing;
-            meas_ena.assign(meas.meas_ena.begin(), meas.meas_ena.end());
-            meas_ena_cancel.assign(meas.meas_ena_cancel.begin(), meas.meas_ena_cancel.end());
-            meas_data.assign(meas.meas_data.begin(), meas.meas_data.end());
-            meas_data_valid.assign(meas.meas_data_valid.begin(), meas.meas_data_valid.end());
+            timing          = meas.timing;
+            meas_ena        = meas.meas_ena;
+            meas_ena_cancel = meas.meas_ena_cancel;
+            meas_data       = meas.meas_data;
+            meas_data_valid = meas.meas_data_valid;
         }
 
         return *this;
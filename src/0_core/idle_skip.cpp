@@ -0,0 +1,89 @@
+#include "idle_skip.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "logger_wrapper.h"
+
+namespace cactus {
+
+// ============================================================================================
+// Idle_skipper
+// ============================================================================================
+void Idle_skipper::add_module(Idle_skippable* module) { m_modules.push_back(module); }
+
+uint64_t Idle_skipper::num_cycles_to_skip() {
+    if (!m_enabled || m_modules.empty()) return 0;
+
+    uint64_t num_cycles = std::numeric_limits<uint64_t>::max();
+    for (auto module : m_modules) {
+        num_cycles = std::min(num_cycles, module->num_idle_cycles());
+        if (num_cycles < MIN_CYCLES_TO_SKIP) return 0;
+    }
+    return num_cycles;
+}
+
+void Idle_skipper::skip_cycles(uint64_t num_cycles) {
+    for (auto module : m_modules) {
+        module->skip_cycles(num_cycles);
+    }
+    m_num_skipped_cycles += num_cycles;
+}
+
+// ============================================================================================
+// Idle_skip_clock
+// ============================================================================================
+Idle_skip_clock::Idle_skip_clock(const sc_core::sc_module_name& n,
+                                 const sc_core::sc_time&        period_200MHz,
+                                 const sc_core::sc_time&        period_50MHz)
+    : sc_core::sc_module(n) {
+
+    auto logger = get_logger_or_exit("console");
+
+    m_half_period_200MHz = period_200MHz / 2;
+    m_cycles_per_50MHz   = static_cast<unsigned int>(period_50MHz / period_200MHz);
+    if (m_cycles_per_50MHz == 0 || period_200MHz * m_cycles_per_50MHz != period_50MHz) {
+        logger->error("{}: The period of the 50 MHz clock should be a multiple of the one of the "
+                      "200 MHz clock. Simulation aborts!",
+                      this->name());
+        exit(EXIT_FAILURE);
+    }
+
+    Idle_skipper::get_instance().enable(m_cycles_per_50MHz);
+
+    SC_THREAD(generate);
+}
+
+sc_core::sc_time Idle_skip_clock::period(const sc_core::sc_interface* clock) const {
+    if (clock == &clock_200MHz) return m_half_period_200MHz * 2.0;
+    if (clock == &clock_50MHz) return m_half_period_200MHz * (2.0 * m_cycles_per_50MHz);
+
+    return sc_core::SC_ZERO_TIME;
+}
+
+void Idle_skip_clock::generate() {
+    auto          logger   = get_logger_or_exit("console");
+    Idle_skipper& skipper  = Idle_skipper::get_instance();
+    unsigned int  num_half = 2 * m_cycles_per_50MHz;  // half periods in one 50 MHz cycle
+
+    for (unsigned int half = 0;; half = (half + 1) % num_half) {
+        if (half == 0) {
+            uint64_t num_cycles = skipper.num_cycles_to_skip();
+            if (num_cycles > 0) {
+                logger->trace("{}: skip {} idle cycles (50 MHz) @{}", this->name(), num_cycles,
+                              sc_core::sc_time_stamp().to_string());
+                skipper.skip_cycles(num_cycles);
+                wait(m_half_period_200MHz * static_cast<double>(num_half * num_cycles));
+            }
+            clock_50MHz.write(true);
+        } else if (half == m_cycles_per_50MHz) {
+            clock_50MHz.write(false);
+        }
+
+        clock_200MHz.write(half % 2 == 0);
+
+        wait(m_half_period_200MHz);
+    }
+}
+
+}  // namespace cactus
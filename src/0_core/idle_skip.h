@@ -0,0 +1,129 @@
+/** idle_skip.h
+ *
+ * This file defines the skipping of idle cycles. During a long qwait, the classical pipeline is
+ * stalled (fmr, full event queue) or done, and the event queue manager only counts down the
+ * waiting time of the next event: every clocked process runs, but nothing observable changes
+ * until the counter expires.
+ *
+ * Idle_skip_clock generates the 200 MHz and the 50 MHz clocks of the simulation. Before every
+ * rising edge of the 50 MHz clock, it asks every registered module for how many cycles it would
+ * stay idle. If all of them agree on at least MIN_CYCLES_TO_SKIP cycles, the clocks stop for
+ * that many cycles and simulation time jumps over them. The modules are then told how many
+ * cycles have been skipped, so that their counters are the same as if every cycle had been
+ * simulated. The rising edges stay on the same grid of times, so the cycle numbers derived from
+ * the time (see Clock_cycles in cycle_counter.h) need no correction.
+ *
+ * A module which does not register never stops the clocks, and one which is not sure returns 0.
+ * The modules which register are the ones which have something to do during a qwait, or which
+ * can tell whether a measurement or an operation is on its way through them: the classical
+ * decode stage, the event queue manager, the measurement register file, the analog digital
+ * interface, the qubit simulator and the testbench. The other modules only pass values on, and
+ * the ones before and after them decide for them.
+ *
+ */
+
+#ifndef _IDLE_SKIP_H_
+#define _IDLE_SKIP_H_
+
+#include <cstdint>
+#include <systemc>
+#include <vector>
+
+namespace cactus {
+
+// skipping fewer cycles is not worth stopping the clocks
+#define MIN_CYCLES_TO_SKIP 4
+
+// the number of 50 MHz cycles without any activity after which the pipelines are considered
+// empty, which is longer than the latency of any of them
+#define IDLE_QUIET_CYCLES 16
+
+enum class Clock_domain { CLOCK_200MHZ, CLOCK_50MHZ };
+
+class Idle_skippable {
+  public:
+    // the number of coming 50 MHz cycles during which the module would only count, 0 if it may
+    // do anything else, UINT64_MAX if it does not limit skipping.
+    virtual uint64_t num_idle_cycles() = 0;
+
+    // the clocks have been stopped for this number of 50 MHz cycles
+    virtual void skip_cycles(uint64_t num_cycles) = 0;
+
+    virtual ~Idle_skippable() {}
+};
+
+class Idle_skipper {
+  private:
+    std::vector<Idle_skippable*> m_modules;
+    bool                         m_enabled            = false;
+    unsigned int                 m_cycles_per_50MHz   = 4;  // 200 MHz / 50 MHz
+    uint64_t                     m_num_skipped_cycles = 0;
+
+  public:
+    // delete the copy constructor
+    Idle_skipper(const Idle_skipper&) = delete;
+
+    // delete the assignment operator
+    Idle_skipper& operator=(const Idle_skipper&) = delete;
+
+    static Idle_skipper& get_instance() {
+        // the static one ensures only one copy of the Idle_skipper
+        static Idle_skipper s_instance;
+        return s_instance;
+    }
+
+    void add_module(Idle_skippable* module);
+
+    // set by Idle_skip_clock, which is the only one to stop the clocks
+    void enable(unsigned int cycles_per_50MHz) {
+        m_enabled          = true;
+        m_cycles_per_50MHz = cycles_per_50MHz;
+    }
+    bool is_enabled() const { return m_enabled; }
+
+    unsigned int cycles_per_50MHz(Clock_domain domain) const {
+        return (domain == Clock_domain::CLOCK_200MHZ) ? m_cycles_per_50MHz : 1;
+    }
+
+    // the number of 50 MHz cycles all the modules agree to skip, 0 if they do not
+    uint64_t num_cycles_to_skip();
+
+    void skip_cycles(uint64_t num_cycles);
+
+    uint64_t num_skipped_cycles() const { return m_num_skipped_cycles; }
+
+  private:
+    Idle_skipper() = default;
+
+    ~Idle_skipper() = default;
+};
+
+// --------------------------------------------------------------------------------------------
+// the clocks
+// --------------------------------------------------------------------------------------------
+// the same waveforms as an sc_clock with a duty cycle of 0.5 which starts with a rising edge at
+// time 0. The period of the 50 MHz clock is a multiple of the one of the 200 MHz clock.
+SC_MODULE(Idle_skip_clock) {
+  public:
+    sc_core::sc_signal<bool> clock_200MHz;
+    sc_core::sc_signal<bool> clock_50MHz;
+
+  protected:
+    sc_core::sc_time m_half_period_200MHz;
+    unsigned int     m_cycles_per_50MHz;
+
+    void generate();
+
+  public:
+    Idle_skip_clock(const sc_core::sc_module_name& n, const sc_core::sc_time& period_200MHz,
+                    const sc_core::sc_time& period_50MHz);
+
+    // the period of one of both clocks, SC_ZERO_TIME for any other channel
+    sc_core::sc_time period(const sc_core::sc_interface* clock) const;
+
+    SC_HAS_PROCESS(Idle_skip_clock);
+};
+
+}  // namespace cactus
+
+#endif  // _IDLE_SKIP_H_
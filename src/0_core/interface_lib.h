@@ -3,6 +3,7 @@
 
 #include <algorithm>  // tolower
 #include <cassert>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <ostream>
@@ -10,6 +11,8 @@
 #include <systemc>
 #include <vector>
 
+#include "cache_file.h"
+
 namespace cactus {
 
 /*************** Device operation format definition ********************/
@@ -223,6 +226,25 @@ inline std::ostream& operator<<(std::ostream& os, const Res_from_qsim& res_from_
 inline void sc_trace(sc_core::sc_trace_file* tf, const Res_from_qsim& res_from_qsim,
                      const std::string& name){};
 
+// A qubit simulator which applies the operations of one moment when asked to, rather than when
+// they arrive on a signal. It is used outside of the SystemC simulation, e.g. by the fast-forward
+// engine. The moments are given in increasing order of cycles.
+class Qubit_backend {
+  public:
+    virtual Res_from_qsim apply_moment(Ops_2_qsim moment) = 0;
+
+    // the state of the qubits, for checkpoints (see checkpoint.h). Backends which cannot save
+    // their state return false.
+    virtual bool save_state(Cache_writer& writer) { return false; }
+    virtual bool restore_state(Cache_reader& reader) { return false; }
+
+    // seeds the random generator of the measurements, for reproducible shots (see shot_farm.h).
+    // Backends which have no such generator return false.
+    virtual bool set_seed(uint64_t seed) { return false; }
+
+    virtual ~Qubit_backend() {}
+};
+
 }  // namespace cactus
 
 #endif
@@ -0,0 +1,45 @@
+/** mapped_file.h
+ *
+ * This file defines a read-only memory mapping of a whole file.
+ *
+ * The program loaders use it so that large programs are not copied into memory before being
+ * indexed: pages are only brought in by the OS when they are touched.
+ *
+ */
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace cactus {
+
+class Mapped_file {
+  private:
+    const char* m_data = nullptr;
+    size_t      m_size = 0;
+
+#ifdef WIN32
+    void* m_file    = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+  public:
+    Mapped_file() = default;
+    ~Mapped_file();
+
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    // map the whole file. Returns false if the file cannot be opened or mapped.
+    bool open(const std::string& fn);
+    void close();
+
+    const char* data() const { return m_data; }
+    size_t      size() const { return m_size; }
+};
+
+}  // namespace cactus
+
+#endif  // _MAPPED_FILE_H_
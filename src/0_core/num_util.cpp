@@ -426,4 +426,9 @@ std::string extract_integer_words(std::string str) {
     return num_str;
 }
 
+int sign_extend(unsigned int value, unsigned int width) {
+    unsigned int sign_bit = 1u << (width - 1);
+    return static_cast<int>((value ^ sign_bit) - sign_bit);
+}
+
 }  // namespace cactus
@@ -38,6 +38,9 @@ int hexstr_to_int(const std::string& s);
 
 unsigned int hexstr_to_uint(const std::string& s);
 
+// the value of a two's complement field of the given width
+int sign_extend(unsigned int value, unsigned int width);
+
 }  // namespace cactus
 
 #endif  // _NUM_UTIL_H_
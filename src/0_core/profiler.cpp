@@ -0,0 +1,157 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace cactus {
+
+void Profiler::start() {
+    if (!m_enabled || m_running) return;
+
+    m_processes.clear();
+
+    m_start   = std::chrono::steady_clock::now();
+    m_running = true;
+}
+
+void Profiler::stop() {
+    if (!m_running) return;
+
+    m_running = false;
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_start;
+    m_wall_seconds                         = duration.count();
+}
+
+Profiler::Process* Profiler::find_process() {
+    sc_core::sc_process_handle running = sc_core::sc_get_current_process_handle();
+    if (!running.valid()) return nullptr;
+
+    auto it = m_processes.find(running);
+    if (it != m_processes.end()) return &it->second;
+
+    // the names are copied while the process runs, so a process may end before the report
+    Process&            process = m_processes[running];
+    sc_core::sc_object* parent  = running.get_parent_object();
+    process.module_name         = parent ? parent->name() : "";
+    process.name                = running.basename();
+    return &process;
+}
+
+void Profiler::add_section(const char* name, double seconds) {
+    std::lock_guard<std::mutex> lock(m_sections_mutex);
+
+    Section& section = m_sections[name];
+    section.num_calls++;
+    section.seconds += seconds;
+}
+
+bool Profiler::write_report(const std::string& fn, const std::vector<Profiled_clock>& domains) {
+
+    class Module {
+      public:
+        uint64_t                    num_activations = 0;
+        double                      seconds         = 0;
+        std::vector<const Process*> processes;
+    };
+
+    std::ofstream os(fn);
+    if (!os.is_open()) return false;
+
+    double        sim_ns       = sc_core::sc_time_stamp().to_seconds() * 1e9;
+    Idle_skipper& idle_skipper = Idle_skipper::get_instance();
+    uint64_t      num_skipped  = idle_skipper.num_skipped_cycles();
+
+    os << std::fixed;
+    os << "Wall-clock time of the simulation: " << std::setprecision(3) << m_wall_seconds << " s"
+       << std::endl;
+    os << "Simulated time: " << std::setprecision(0) << sim_ns << " ns" << std::endl;
+    // the skipped cycles took no time to simulate, they are left out of the rate
+    for (auto& domain : domains) {
+        double num_skipped_cycles =
+          static_cast<double>(num_skipped * idle_skipper.cycles_per_50MHz(domain.domain));
+        double num_cycles = std::max(sim_ns / domain.period_ns - num_skipped_cycles, 0.0);
+        os << "  " << std::left << std::setw(14) << domain.name << std::right << std::setw(14)
+           << num_cycles << " cycles, " << std::setw(12)
+           << (m_wall_seconds > 0 ? num_cycles / m_wall_seconds : 0) << " cycles/s";
+        if (num_skipped_cycles > 0) os << ", " << num_skipped_cycles << " cycles skipped";
+        os << std::endl;
+    }
+    os << std::endl;
+
+    // the processes by module
+    std::map<std::string, Module> modules;
+    double                        process_seconds = 0;
+    for (auto& entry : m_processes) {
+        const Process& process = entry.second;
+
+        Module& module = modules[process.module_name];
+        module.num_activations += process.num_activations;
+        module.seconds += process.seconds;
+        module.processes.push_back(&process);
+        process_seconds += process.seconds;
+    }
+
+    std::vector<std::pair<std::string, Module*>> sorted_modules;
+    for (auto& entry : modules) sorted_modules.emplace_back(entry.first, &entry.second);
+    std::sort(sorted_modules.begin(), sorted_modules.end(),
+              [](const std::pair<std::string, Module*>& a,
+                 const std::pair<std::string, Module*>& b) {
+                  return a.second->seconds > b.second->seconds;
+              });
+
+    auto write_time = [&](double seconds) {
+        os << std::setprecision(1) << std::setw(7)
+           << (m_wall_seconds > 0 ? 100.0 * seconds / m_wall_seconds : 0) << " %"
+           << std::setprecision(3) << std::setw(13) << seconds;
+    };
+
+    os << "SystemC processes, timed from their activations:" << std::endl;
+    os << "   share     time (s)   activations  module / process" << std::endl;
+    for (auto& entry : sorted_modules) {
+        Module& module = *entry.second;
+        write_time(module.seconds);
+        os << std::setw(14) << module.num_activations << "  " << entry.first << std::endl;
+
+        std::sort(module.processes.begin(), module.processes.end(),
+                  [](const Process* a, const Process* b) { return a->seconds > b->seconds; });
+        for (const Process* process : module.processes) {
+            write_time(process->seconds);
+            os << std::setw(14) << process->num_activations << "    " << process->name
+               << std::endl;
+        }
+    }
+
+    // the rest of the time, in the SystemC kernel, the signal updates and the processes which do
+    // not time their activations
+    write_time(std::max(m_wall_seconds - process_seconds, 0.0));
+    os << std::setw(14) << "-" << "  (not timed by a process)" << std::endl;
+    os << std::endl;
+
+    // the sections, which may overlap the processes, e.g. in the worker of the qubit simulator
+    std::vector<std::pair<std::string, Section>> sections;
+    {
+        std::lock_guard<std::mutex> lock(m_sections_mutex);
+        sections.assign(m_sections.begin(), m_sections.end());
+    }
+    std::sort(sections.begin(), sections.end(),
+              [](const std::pair<std::string, Section>& a,
+                 const std::pair<std::string, Section>& b) {
+                  return a.second.seconds > b.second.seconds;
+              });
+
+    os << "Timed sections:" << std::endl;
+    os << "      calls     time (s)     avg (us)  section" << std::endl;
+    for (auto& entry : sections) {
+        const Section& section = entry.second;
+        os << std::setw(11) << section.num_calls << std::setprecision(3) << std::setw(13)
+           << section.seconds << std::setprecision(1) << std::setw(13)
+           << (section.num_calls ? 1e6 * section.seconds / section.num_calls : 0) << "  "
+           << entry.first << std::endl;
+    }
+
+    return os.good();
+}
+
+}  // namespace cactus
@@ -0,0 +1,171 @@
+/** profiler.h
+ *
+ * This file defines the profiler of the simulation speed, turned on by the option '-P'.
+ *
+ * Each SystemC process counts and times its activations with a Profile_process at its entry
+ * point: the start of the body of a method, or the code after the wait() of a clocked thread. The
+ * names of a process and of its module are looked up at its first activation, while it runs.
+ *
+ * The code which is not a process of its own, e.g. the calls into the Python qubit simulator, is
+ * timed exactly and counted by sections, see Profile_scope.
+ *
+ * The report, profile.txt in the output directory, lists the simulated cycles per wall-clock
+ * second of the clock domains, without the cycles skipped under --skip_idle, the modules sorted
+ * by time with their processes, and the sections. The time outside of the processes, in the
+ * SystemC kernel and the signal updates, is reported as the rest of the wall-clock time.
+ *
+ */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <systemc>
+#include <vector>
+
+#include "idle_skip.h"
+
+namespace cactus {
+
+// a clock of the simulation, whose cycles per second are reported. The cycles skipped under
+// --skip_idle are counted in the cycles of its domain.
+class Profiled_clock {
+  public:
+    std::string  name;
+    double       period_ns;
+    Clock_domain domain;
+};
+
+class Profiler {
+  public:
+    // the activations of a SystemC process, timed by a Profile_process
+    class Process {
+      public:
+        std::string module_name;
+        std::string name;
+        uint64_t    num_activations = 0;
+        double      seconds         = 0;
+    };
+
+  private:
+    // the code timed by a Profile_scope
+    class Section {
+      public:
+        uint64_t num_calls = 0;
+        double   seconds   = 0;
+    };
+
+    bool m_enabled = false;
+    bool m_running = false;
+
+    // only used by the simulation thread. The handle keeps the process alive as a key, its names
+    // are copied at its first activation.
+    std::map<sc_core::sc_process_handle, Process> m_processes;
+
+    std::chrono::steady_clock::time_point m_start;
+    double                                m_wall_seconds = 0;
+
+    // sections may be timed by other threads than the simulation one
+    std::mutex                     m_sections_mutex;
+    std::map<std::string, Section> m_sections;
+
+    Process* find_process();
+
+  public:
+    // delete the copy constructor
+    Profiler(const Profiler&) = delete;
+
+    // delete the assignment operator
+    Profiler& operator=(const Profiler&) = delete;
+
+    static Profiler& get_instance() {
+        // the static one ensures only one copy of the Profiler
+        static Profiler s_instance;
+        return s_instance;
+    }
+
+    void enable() { m_enabled = true; }
+    bool is_enabled() const { return m_enabled; }
+
+    // around the simulation
+    void start();
+    void stop();
+
+    // the running process, counted as activated once more, or nullptr outside of the simulation
+    Process* activate_process() {
+        if (!m_running) return nullptr;
+
+        Process* process = find_process();
+        if (process != nullptr) process->num_activations++;
+        return process;
+    }
+
+    void add_section(const char* name, double seconds);
+
+    // writes the report. Returns false if the file cannot be written.
+    bool write_report(const std::string& fn, const std::vector<Profiled_clock>& domains);
+
+  private:
+    Profiler() = default;
+};
+
+// --------------------------------------------------------------------------------------------
+// counts an activation of the running SystemC process and times it until the end of the block,
+// when the profiler runs. In a clocked thread, it follows the wait() and its block ends before
+// the next one.
+// --------------------------------------------------------------------------------------------
+class Profile_process {
+  private:
+    Profiler::Process*                    m_process;
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    Profile_process()
+        : m_process(Profiler::get_instance().activate_process()) {
+        if (m_process) m_start = std::chrono::steady_clock::now();
+    }
+
+    ~Profile_process() {
+        if (!m_process) return;
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_start;
+        m_process->seconds += duration.count();
+    }
+
+    Profile_process(const Profile_process&) = delete;
+    Profile_process& operator=(const Profile_process&) = delete;
+};
+
+// --------------------------------------------------------------------------------------------
+// times the code from its construction to its destruction as a section of the profile, when the
+// profiler is enabled
+// --------------------------------------------------------------------------------------------
+class Profile_scope {
+  private:
+    const char*                           m_name;
+    bool                                  m_enabled;
+    std::chrono::steady_clock::time_point m_start;
+
+  public:
+    explicit Profile_scope(const char* name)
+        : m_name(name)
+        , m_enabled(Profiler::get_instance().is_enabled()) {
+        if (m_enabled) m_start = std::chrono::steady_clock::now();
+    }
+
+    ~Profile_scope() {
+        if (!m_enabled) return;
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - m_start;
+        Profiler::get_instance().add_section(m_name, duration.count());
+    }
+
+    Profile_scope(const Profile_scope&) = delete;
+    Profile_scope& operator=(const Profile_scope&) = delete;
+};
+
+}  // namespace cactus
+
+#endif  // _PROFILER_H_
@@ -416,7 +416,6 @@ void sc_trace(sc_core::sc_trace_file* tf, const MW_DIO_event& event, const std::
 // --------------------------------------------------------------------------------------------
 VSM_event::VSM_event()
     : Device_event_base() {
-    mask     = 0;
     condbits = 0;
 }
 
@@ -426,7 +425,7 @@ bool operator==(const VSM_event& a, const VSM_event& b) {
 }
 
 string to_string(const VSM_event& event) {
-    string _str_ = "(mask:" + to_string(event.mask) + ", condbits: " + to_string(event.condbits) +
+    string _str_ = "(mask:0x" + event.mask.to_hex() + ", condbits: " + to_string(event.condbits) +
                    ", major_label: " + to_string(event.major_label) +
                    ", minor_label: " + to_string(event.minor_label) + ")";
     return _str_;
@@ -67,6 +67,48 @@ using std::to_string;
 #define LDUI_IMM_WIDTH 15
 #define LDUI_IMM_MASK (0x7FFF << LDUI_IMM_SHIFT)
 
+// --------------------------------------------------------------------------------------------
+// Quantum instruction-related constants, see Q_decoder_bin.
+// --------------------------------------------------------------------------------------------
+
+// the MSb tells a bundle of quantum operations from a single format instruction
+#define Q_BUNDLE_FLAG 0x80000000u
+
+// opcodes of the single format quantum instructions
+#define SMIS_OPCODE 0x20
+#define SMIT_OPCODE 0x28
+#define QWAIT_OPCODE 0x30
+#define QWAITR_OPCODE 0x38
+
+#define Q_REG_SHIFT 20
+#define Q_REG_MASK (0x1F << Q_REG_SHIFT)
+
+#define SMIS_MASK_WIDTH 7
+#define SMIS_MASK_MASK 0x7F
+
+#define SMIT_MASK_WIDTH 16
+#define SMIT_MASK_MASK 0xFFFF
+
+#define QWAIT_IMM_SHIFT 0
+#define QWAIT_IMM_WIDTH 20
+#define QWAIT_IMM_MASK (0xFFFFF << QWAIT_IMM_SHIFT)
+
+// [30:23] opcode 0, [22:17] register 0, [16:9] opcode 1, [8:3] register 1, [2:0] wait time
+#define BUNDLE_NUM_OPS 2
+#define BUNDLE_OP_WIDTH 8
+#define BUNDLE_OP_MASK 0xFF
+#define BUNDLE_REG_WIDTH 6
+#define BUNDLE_REG_MASK 0x3F
+#define BUNDLE_OP0_SHIFT 23
+#define BUNDLE_REG0_SHIFT 17
+#define BUNDLE_OP1_SHIFT 9
+#define BUNDLE_REG1_SHIFT 3
+#define BUNDLE_PI_WIDTH 3
+#define BUNDLE_PI_MASK 0x7
+
+// quantum operations with this opcode bit set target a pair of qubits
+#define BUNDLE_TWO_QUBIT_OP 0x80
+
 enum OperationName {
     NOP  = 0,
     BR   = 1,
@@ -415,7 +457,7 @@ void sc_trace(sc_core::sc_trace_file* tf, const MW_DIO_event& event, const std::
 // --------------------------------------------------------------------------------------------
 class VSM_event : public Device_event_base {
   public:
-    sc_uint<64>              mask;
+    Bit_set                  mask;  // one bit per qubit
     sc_uint<MSMT_COND_WIDTH> condbits;
     // sc_uint<64>							mask_value;
 
@@ -1,24 +1,72 @@
 #include "qasm_instruction.h"
 
 #include <algorithm>
+#include <cctype>
+#include <climits>
 #include <iomanip>
 #include <iostream>
-#include <regex>  // regular expression
 #include <sstream>
 
+#include "logger_wrapper.h"
 #include "num_util.h"
 
 namespace cactus {
 
-Instruction_type Qasm_instruction::get_type() { return type; }
+void Asm_line::clear_q_operands() {
+    q_qubit_indices.clear();
+    q_qubit_tuples.clear();
+    q_reg_num.clear();
+    q_op_name.clear();
+    q_num_tgt_qubits_type.clear();
+}
 
-unsigned int Qasm_instruction::get_insn_bin() { return insn_bin; }
+// ============================================================================================
+// Asm_text_arena
+// ============================================================================================
+Asm_text_ref Asm_text_arena::add(const char* text, size_t len) {
+    Asm_text_ref ref;
+    ref.offset = m_buffer.size();
+    ref.length = static_cast<uint32_t>(len);
+    m_buffer.append(text, len);
+    return ref;
+}
 
-std::string Qasm_instruction::get_insn_asm() { return insn_asm; }
+uint64_t Asm_text_arena::append(const Asm_text_arena& other) {
+    uint64_t offset = m_buffer.size();
+    m_buffer.append(other.m_buffer);
+    return offset;
+}
 
-std::string Qasm_instruction::get_insn_line_num_in_file() { return insn_line_num_in_file; }
+namespace {
+// returned for binary instructions, which do not refer to any asm line
+const Asm_line empty_asm_line;
 
-std::string Qasm_instruction::get_insn_str_in_file() { return insn_str_in_file; }
+// the qubits of smis and smit are within the qubits simulated, which are within the widths of
+// the masks, i.e. BIT_SET_MAX_WIDTH
+long long max_qubit_index() {
+    return static_cast<long long>(Global_config::get_instance().num_qubits) - 1;
+}
+}  // namespace
+
+Instruction_type Qasm_instruction::get_type() const { return type; }
+
+unsigned int Qasm_instruction::get_insn_bin() const { return insn_bin; }
+
+std::string Qasm_instruction::get_insn_asm() const {
+    return src ? text->str(src->asm_text) : std::string();
+}
+
+unsigned int Qasm_instruction::get_insn_line_num_in_file() const {
+    return src ? src->line_num : 0;
+}
+
+std::string Qasm_instruction::get_insn_str_in_file() const {
+    return src ? text->str(src->src_text) : std::string();
+}
+
+Asm_lexer Qasm_instruction::asm_lexer() const {
+    return Asm_lexer(text->data(src->asm_text), src->asm_text.length);
+}
 
 unsigned int Qasm_instruction::get_opcode() { return opcode; }
 
@@ -42,15 +90,24 @@ Q_instr_type Qasm_instruction::get_q_insn_type() { return q_insn_type; }
 
 unsigned int Qasm_instruction::get_q_time_specified() { return q_time_specified; }
 
-std::vector<size_t>& Qasm_instruction::get_q_qubit_indices() { return q_qubit_indices; }
+const std::vector<size_t>& Qasm_instruction::get_q_qubit_indices() const {
+    return src ? src->q_qubit_indices : empty_asm_line.q_qubit_indices;
+}
+
+const std::vector<std::vector<size_t>>& Qasm_instruction::get_q_qubit_tuples() const {
+    return src ? src->q_qubit_tuples : empty_asm_line.q_qubit_tuples;
+}
 
-std::vector<std::vector<size_t>>& Qasm_instruction::get_q_qubit_tuples() { return q_qubit_tuples; }
+const std::vector<unsigned int>& Qasm_instruction::get_q_reg_num() const {
+    return src ? src->q_reg_num : empty_asm_line.q_reg_num;
+}
 
-std::vector<unsigned int>& Qasm_instruction::get_q_reg_num() { return q_reg_num; }
+const std::vector<std::string>& Qasm_instruction::get_q_op_name() const {
+    return src ? src->q_op_name : empty_asm_line.q_op_name;
+}
 
-std::vector<std::string>&           Qasm_instruction::get_q_op_name() { return q_op_name; }
-std::vector<num_tgt_qubits_type_t>& Qasm_instruction::get_q_num_tgt_qubits_type() {
-    return q_num_tgt_qubits_type;
+const std::vector<num_tgt_qubits_type_t>& Qasm_instruction::get_q_num_tgt_qubits_type() const {
+    return src ? src->q_num_tgt_qubits_type : empty_asm_line.q_num_tgt_qubits_type;
 }
 
 bool Qasm_instruction::is_q_insn() { return q_insn; }
@@ -71,430 +128,256 @@ bool Qasm_instruction::is_br() { return cl_insn && (opcode == OperationName::BR)
 
 bool Qasm_instruction::is_stop() { return cl_insn && (opcode == OperationName::STOP); }
 
-void Qasm_instruction::parse_opcode(const std::string& insn) {
+void Qasm_instruction::parse_error(const char* insn_kind) const {
+    throw Asm_parse_error(
+      fmt::format("asm_parser: Cannot parse {} instruction '{}' at line {}. Simulation aborts!",
+                  insn_kind, get_insn_str_in_file(), get_insn_line_num_in_file()));
+}
+
+void Qasm_instruction::abort_on(const Asm_parse_error& e) const {
     auto logger = get_logger_or_exit("asm_logger");
 
-    std::regex pattern_stop("stop", std::regex_constants::icase);
-    std::regex pattern_nop("^\\s*nop\\s*$", std::regex_constants::icase);
-    std::regex pattern_meas("meas", std::regex_constants::icase);
+    logger->error("{}", e.what());
+    exit(EXIT_FAILURE);
+}
 
-    if (insn.find(" ") != insn.npos) {
-        std::string op_string = insn.substr(0, insn.find_first_of(" "));
-        trim(op_string);
+// ============================================================================================
+// Recursive descent helpers. Each of them consumes the expected token(s) from the lexer, or
+// throws an Asm_parse_error with the usual parser error message.
+// ============================================================================================
+void Qasm_instruction::expect(Asm_lexer& lexer, Asm_token_type type, const char* insn_kind) {
+    if (!lexer.accept(type)) parse_error(insn_kind);
+}
 
-        // transform op_string to lower case
-        transform(op_string.begin(), op_string.end(), op_string.begin(), ::tolower);
+unsigned int Qasm_instruction::expect_reg(Asm_lexer& lexer, char prefix, const char* insn_kind) {
+    unsigned int num;
+    if (!lexer.is_reg(lexer.peek(), prefix, num)) parse_error(insn_kind);
+    lexer.next();
+    return num;
+}
 
-        auto it = map_opcode.find(op_string);
-        if (it != map_opcode.end()) {
-            cl_insn   = true;
-            q_insn    = false;
-            meas_insn = false;
-            opcode    = it->second;
-        } else {
-            cl_insn   = false;
-            q_insn    = true;
-            meas_insn = false;
-            opcode    = OperationName::NOP;
-        }
-    } else if (std::regex_search(insn, pattern_nop)) {
-        cl_insn   = true;
-        q_insn    = false;
-        meas_insn = false;
-        opcode    = OperationName::NOP;
-    } else if (std::regex_search(insn, pattern_stop)) {
-        cl_insn   = true;
-        q_insn    = false;
-        meas_insn = false;
-        opcode    = OperationName::STOP;
-    } else {
-        cl_insn   = false;
-        q_insn    = true;
-        meas_insn = false;
-        opcode    = OperationName::NOP;
+long long Qasm_instruction::expect_number(Asm_lexer& lexer, long long min, long long max,
+                                          const char* insn_kind) {
+    Asm_token token = lexer.next();
+    if ((token.type != TK_NUMBER) || (token.value < min) || (token.value > max)) {
+        parse_error(insn_kind);
     }
+    return token.value;
+}
 
-    if (std::regex_search(insn, pattern_meas)) {
-        cl_insn   = false;
-        q_insn    = true;
-        meas_insn = true;
-        opcode    = OperationName::NOP;
+int Qasm_instruction::expect_imm(Asm_lexer& lexer, const char* insn_kind) {
+    Asm_token token = lexer.next();
+    if (token.type != TK_NUMBER) parse_error(insn_kind);
+
+    if (lexer.lower_text(token).find('x') == std::string::npos) {
+        if ((token.value < INT_MIN) || (token.value > INT_MAX)) parse_error(insn_kind);
+        return static_cast<int>(token.value);
     }
+
+    unsigned long long magnitude = (token.value < 0) ? -token.value : token.value;
+    if (magnitude > UINT32_MAX) parse_error(insn_kind);
+    uint32_t bits = static_cast<uint32_t>(magnitude);
+    return static_cast<int>((token.value < 0) ? 0u - bits : bits);
 }
 
-// br <br_cond>,<label>
-void Qasm_instruction::parse_br(const std::string&                         insn,
-                                const std::map<std::string, unsigned int>& map_label,
-                                const unsigned int&                        addr) {
-    auto logger = get_logger_or_exit("asm_logger");
+void Qasm_instruction::skip_separator(Asm_lexer& lexer) { lexer.accept(TK_COMMA); }
 
-    std::string br_content;  // <br_cond>,<label>
-    if (insn.find(" ") != insn.npos) {
-        br_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+void Qasm_instruction::expect_end(Asm_lexer& lexer, const char* insn_kind) {
+    lexer.accept(TK_COMMA);
+    expect(lexer, TK_END, insn_kind);
+}
+
+void Qasm_instruction::parse_opcode(const std::string& insn) {
+    Asm_lexer lexer(insn);
+    Asm_token mnemonic = lexer.peek();
+
+    cl_insn   = false;
+    q_insn    = true;
+    meas_insn = false;
+    opcode    = OperationName::NOP;
+
+    if (mnemonic.type == TK_IDENT) {
+        auto it = map_opcode().find(lexer.lower_text(mnemonic));
+        if (it != map_opcode().end()) {
+            cl_insn = true;
+            q_insn  = false;
+            opcode  = it->second;
+        }
     }
 
-    std::vector<std::string> sub_parts;  // <br_cond> and <label>
-    sub_parts = split(br_content, ',');
-    if (sub_parts.size() != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+    // any operation containing 'meas' is a measurement, e.g. '2, measz s3'
+    for (Asm_token token = lexer.next(); token.type != TK_END; token = lexer.next()) {
+        if ((token.type == TK_IDENT) && (lexer.lower_text(token).find("meas") != std::string::npos)) {
+            cl_insn   = false;
+            q_insn    = true;
+            meas_insn = true;
+            opcode    = OperationName::NOP;
+            break;
+        }
     }
+}
+
+// br <br_cond>,<label>
+void Qasm_instruction::parse_br(const std::string& insn, const unsigned int& addr) {
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
     // get br condition
-    std::string br_cond_str = sub_parts[0];
-    trim(br_cond_str);
+    Asm_token cond = lexer.next();
+    if (cond.type != TK_IDENT) parse_error();
 
-    // transform to lower case
-    transform(br_cond_str.begin(), br_cond_str.end(), br_cond_str.begin(), ::tolower);
+    auto it_cond = map_br_cond().find(lexer.lower_text(cond));
+    if (it_cond == map_br_cond().end()) parse_error();
+    br_cond = it_cond->second;
 
-    auto it_cond = map_br_cond.find(br_cond_str);
-    if (it_cond != map_br_cond.end()) {
-        br_cond = it_cond->second;
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    skip_separator(lexer);
 
     // get branch label
-    std::string  label_str = sub_parts[1];
-    unsigned int label_addr;
-    trim(label_str);
-    auto it_label = map_label.find(label_str);
-    if (it_label != map_label.end()) {
-        label_addr = it_label->second;
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_token label = lexer.next();
+    if ((label.type != TK_IDENT) && (label.type != TK_NUMBER)) parse_error();
+    expect_end(lexer);
 
-    br_addr = label_addr - addr;
+    // the label has been resolved when the program was loaded
+    if (src->br_target == Asm_line::NO_BR_TARGET) parse_error();
+
+    br_addr = static_cast<int>(src->br_target - addr);
 }
 
 // cmp rs,rt
 void Qasm_instruction::parse_cmp(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
-
-    it++;
-    rt_addr = str_to_uint(it->str());  // rt_addr
+    skip_separator(lexer);
+    rt_addr = expect_reg(lexer, 'r');
     rt_used = true;
+    expect_end(lexer);
 }
 
 // fbr <br_cond>,rd
 void Qasm_instruction::parse_fbr(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string fbr_content;  // <br_cond>,<label>
-    if (insn.find(" ") != insn.npos) {
-        fbr_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::vector<std::string> sub_parts;  // <br_cond> and rd
-    sub_parts = split(fbr_content, ',');
-    if (sub_parts.size() != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
     // get br condition
-    std::string fbr_cond_str = sub_parts[0];
-    trim(fbr_cond_str);
+    Asm_token cond = lexer.next();
+    if (cond.type != TK_IDENT) parse_error();
 
-    // transform to lower case
-    transform(fbr_cond_str.begin(), fbr_cond_str.end(), fbr_cond_str.begin(), ::tolower);
+    auto it_cond = map_br_cond().find(lexer.lower_text(cond));
+    if (it_cond == map_br_cond().end()) parse_error();
+    br_cond = it_cond->second;
 
-    auto it_cond = map_br_cond.find(fbr_cond_str);
-    if (it_cond != map_br_cond.end()) {
-        br_cond = it_cond->second;
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    // get rd_addr
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 1) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());
+    skip_separator(lexer);
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
+    expect_end(lexer);
 }
 
 // fmr rd,Qi
 void Qasm_instruction::parse_fmr(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    qubit_sel = str_to_uint(it->str());  // qubit_sel
+    skip_separator(lexer);
+    qubit_sel = expect_reg(lexer, 'q');
+    expect_end(lexer);
 }
 
 // ldi rd,imm
 void Qasm_instruction::parse_ldi(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string ldi_content;
-    if (insn.find(" ") != insn.npos) {
-        ldi_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("-?(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(ldi_content.begin(), ldi_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    std::string imm_str = it->str();
-    if ((imm_str.find("0X") != imm_str.npos) || (imm_str.find("0x") != imm_str.npos)) {
-        imm = hexstr_to_int(imm_str);
-    } else {
-        imm = str_to_int(imm_str);  // imm
-    }
+    skip_separator(lexer);
+    imm = expect_imm(lexer);
+    expect_end(lexer);
 }
 
 // ldui rd,rs,imm
 void Qasm_instruction::parse_ldui(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string ldui_content;
-    if (insn.find(" ") != insn.npos) {
-        ldui_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    std::regex pattern("(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(ldui_content.begin(), ldui_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    skip_separator(lexer);
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
-
-    it++;
-    std::string uimm_str = it->str();
-    if ((uimm_str.find("0X") != uimm_str.npos) || (uimm_str.find("0x") != uimm_str.npos)) {
-        uimm = hexstr_to_uint(uimm_str);
-    } else {
-        uimm = str_to_uint(uimm_str);  // imm
-    }
+    skip_separator(lexer);
+    uimm = static_cast<unsigned int>(expect_number(lexer, 0, UINT_MAX));
+    expect_end(lexer);
 }
 
 // lb rd,offset(rs)
 // lbu rd,offset(rs)
 // lw rd,offset(rs)
 void Qasm_instruction::parse_load_mem(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    std::string load_content;
-    if (insn.find(" ") != insn.npos) {
-        load_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("-?(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(load_content.begin(), load_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    std::string imm_str = it->str();
-    if ((imm_str.find("0X") != imm_str.npos) || (imm_str.find("0x") != imm_str.npos)) {
-        imm = hexstr_to_int(imm_str);
-    } else {
-        imm = str_to_int(imm_str);  // imm
-    }
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    skip_separator(lexer);
+    imm = expect_imm(lexer);
+    expect(lexer, TK_LPAREN);
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
+    expect(lexer, TK_RPAREN);
+    expect_end(lexer);
 }
 
 // sb rt,offset(rs)
 // sw rt,offset(rs)
 void Qasm_instruction::parse_store_mem(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string store_content;
-    if (insn.find(" ") != insn.npos) {
-        store_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("-?(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(store_content.begin(), store_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rt_addr = str_to_uint(it->str());  // rt_addr
+    rt_addr = expect_reg(lexer, 'r');
     rt_used = true;
-
-    it++;
-    std::string imm_str = it->str();
-    if ((imm_str.find("0X") != imm_str.npos) || (imm_str.find("0x") != imm_str.npos)) {
-        imm = hexstr_to_int(imm_str);
-    } else {
-        imm = str_to_int(imm_str);  // imm
-    }
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    skip_separator(lexer);
+    imm = expect_imm(lexer);
+    expect(lexer, TK_LPAREN);
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
+    expect(lexer, TK_RPAREN);
+    expect_end(lexer);
 }
 
 // or rd,rs,rt
 // and rd,rs,rt
 // xor rd,rs,rt
 void Qasm_instruction::parse_logic_operation(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    skip_separator(lexer);
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
-
-    it++;
-    rt_addr = str_to_uint(it->str());  // rt_addr
+    skip_separator(lexer);
+    rt_addr = expect_reg(lexer, 'r');
     rt_used = true;
+    expect_end(lexer);
 }
 
 // not rd,rt
 void Qasm_instruction::parse_not(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 2) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    rt_addr = str_to_uint(it->str());  // rt_addr
+    skip_separator(lexer);
+    rt_addr = expect_reg(lexer, 'r');
     rt_used = true;
+    expect_end(lexer);
 }
 
 // add rd,rs,rt
@@ -503,99 +386,55 @@ void Qasm_instruction::parse_not(const std::string& insn) {
 // mul rd,rs,rt
 // div rd,rs,rt
 void Qasm_instruction::parse_arithmetic_operation(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
-    rd_used = true;
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
-    rs_used = true;
-
-    it++;
-    rt_addr = str_to_uint(it->str());  // rt_addr
-    rt_used = true;
+    // same operands as the logic operations
+    parse_logic_operation(insn);
 }
 
 // addi rd,rs,imm
 void Qasm_instruction::parse_arithmetic_immediate_operation(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string arith_content;
-    if (insn.find(" ") != insn.npos) {
-        arith_content = insn.substr(insn.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("-?(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(arith_content.begin(), arith_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 3) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    Asm_lexer lexer(insn);
+    lexer.next();  // mnemonic
 
-    auto it = begin;
-    rd_addr = str_to_uint(it->str());  // rd_addr
+    rd_addr = expect_reg(lexer, 'r');
     rd_used = true;
-
-    it++;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    skip_separator(lexer);
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
-
-    it++;
-    std::string imm_str = it->str();  // imm
-    if ((imm_str.find("0X") != imm_str.npos) || (imm_str.find("0x") != imm_str.npos)) {
-        imm = hexstr_to_int(imm_str);
-    } else {
-        imm = str_to_int(imm_str);
-    }
+    skip_separator(lexer);
+    imm = expect_imm(lexer);
+    expect_end(lexer);
 }
 
 // qwaitr r1
 void Qasm_instruction::parse_qwaitr(const std::string& insn) {
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::regex pattern_qwaitr("qwaitr", std::regex_constants::icase);
+    Asm_lexer lexer(insn);
 
-    if (!std::regex_search(insn, pattern_qwaitr)) {
+    if (!lexer.ident_is(lexer.peek(), "qwaitr")) {
         return;
     }
+    lexer.next();
 
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn.begin(), insn.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    if (std::distance(begin, end) != 1) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    rs_addr = str_to_uint(it->str());  // rs_addr
+    rs_addr = expect_reg(lexer, 'r');
     rs_used = true;
+    expect_end(lexer);
 }
 
 void Qasm_instruction::parse_q_insn() {
 
+    // binary instructions are decoded by Q_decoder_bin
+    if (src == nullptr) return;
+
+    try {
+        decode_q_operands();
+    } catch (const Asm_parse_error& e) {
+        abort_on(e);
+    }
+}
+
+void Qasm_instruction::decode_q_operands() {
+    // the operands are stored in the asm line, so parsing the same line again is harmless
+    src->clear_q_operands();
+
     // parse q instr type
     parse_q_insn_type();
 
@@ -620,35 +459,38 @@ void Qasm_instruction::parse_q_insn() {
 
 void Qasm_instruction::parse_q_insn_type() {
 
-    std::regex pattern_nop("^\\s*nop\\s*$", std::regex_constants::icase);
-    std::regex pattern_stop("stop", std::regex_constants::icase);
-    std::regex pattern_qwaitr("qwaitr", std::regex_constants::icase);
-    std::regex pattern_qwait("qwait", std::regex_constants::icase);
-    std::regex pattern_smit("smit", std::regex_constants::icase);
-    std::regex pattern_smis("smis", std::regex_constants::icase);
+    Asm_lexer lexer = asm_lexer();
+
+    // skip the optional timing prefix, e.g. '2, h s1'
+    if (lexer.peek().type == TK_NUMBER) {
+        lexer.next();
+        lexer.accept(TK_COMMA);
+    }
+
+    const Asm_token& mnemonic = lexer.peek();
 
     // operation type
-    if (std::regex_search(insn_asm, pattern_smis)) {
+    if (lexer.ident_is(mnemonic, "smis")) {
 
         q_insn_type = Q_instr_type::Q_SMIS;
 
-    } else if (std::regex_search(insn_asm, pattern_smit)) {
+    } else if (lexer.ident_is(mnemonic, "smit")) {
 
         q_insn_type = Q_instr_type::Q_SMIT;
 
-    } else if (std::regex_search(insn_asm, pattern_qwaitr)) {
+    } else if (lexer.ident_is(mnemonic, "qwaitr")) {
 
         q_insn_type = Q_instr_type::Q_WAITR;
 
-    } else if (std::regex_search(insn_asm, pattern_qwait)) {
+    } else if (lexer.ident_is(mnemonic, "qwait")) {
 
         q_insn_type = Q_instr_type::Q_WAIT;
 
-    } else if (std::regex_search(insn_asm, pattern_stop)) {
+    } else if (lexer.ident_is(mnemonic, "stop")) {
 
         q_insn_type = Q_instr_type::Q_STOP;
 
-    } else if (std::regex_search(insn_asm, pattern_nop)) {
+    } else if (lexer.ident_is(mnemonic, "nop")) {
 
         q_insn_type = Q_instr_type::Q_NOP;
 
@@ -657,156 +499,112 @@ void Qasm_instruction::parse_q_insn_type() {
     }
 }
 
+// qwait imm
 void Qasm_instruction::parse_qwait() {
+    Asm_lexer lexer = asm_lexer();
+    lexer.next();  // mnemonic
 
-    auto logger = get_logger_or_exit("asm_logger");
-
-    std::string wait_content;
-    if (insn_asm.find(" ") != insn_asm.npos) {
-        wait_content = insn_asm.substr(insn_asm.find(" "));
-    } else {
-        logger->error(
-          "asm_parser: Cannot parse qwait instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("(0[xX])?[0-9A-Fa-f]+");
-    auto       begin = std::sregex_iterator(wait_content.begin(), wait_content.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    auto       dist  = std::distance(begin, end);
-    if (dist != 1) {
-        logger->error(
-          "asm_parser: Cannot parse qwait instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto        it            = begin;
-    std::string wait_time_str = it->str();
-    if ((wait_time_str.find("0X") != wait_time_str.npos) ||
-        (wait_time_str.find("0x") != wait_time_str.npos)) {
-        q_time_specified = hexstr_to_uint(wait_time_str);
-    } else {
-        q_time_specified = str_to_uint(wait_time_str);
-    }
+    q_time_specified = static_cast<unsigned int>(expect_number(lexer, 0, UINT_MAX, "qwait"));
+    expect_end(lexer, "qwait");
 }
 
+// smis sd, {i, j, ...}
 void Qasm_instruction::parse_smis() {
-    auto logger = get_logger_or_exit("asm_logger");
+    Asm_lexer lexer = asm_lexer();
+    lexer.next();  // mnemonic
 
-    // evite smis instr with T type register
-    std::regex pattern_error("t\\d+");
-    if (std::regex_search(insn_asm, pattern_error)) {
-        logger->error(
-          "asm_parser: Cannot parse smis instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn_asm.begin(), insn_asm.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    auto       dist  = std::distance(begin, end);
-    if (dist < 2) {
-        logger->error(
-          "asm_parser: Cannot parse smis instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
+    src->q_reg_num.push_back(expect_reg(lexer, 's', "smis"));
+    skip_separator(lexer);
+    expect(lexer, TK_LBRACE, "smis");
 
-    auto it = begin;
-    q_reg_num.push_back(str_to_uint(it->str()));
+    do {
+        src->q_qubit_indices.push_back(
+          static_cast<size_t>(expect_number(lexer, 0, max_qubit_index(), "smis")));
+        skip_separator(lexer);
+    } while (lexer.peek().type != TK_RBRACE);
 
-    for (++it; it != end; ++it) {
-        q_qubit_indices.push_back(str_to_sizet(it->str()));
-    }
+    expect(lexer, TK_RBRACE, "smis");
+    expect_end(lexer, "smis");
 }
 
+// smit td, {(i, j), (k, l), ...}, or with the pairs in braces: smit td, {{i, j}, {k, l}, ...}
 void Qasm_instruction::parse_smit() {
-    auto logger = get_logger_or_exit("asm_logger");
+    Asm_lexer lexer = asm_lexer();
+    lexer.next();  // mnemonic
 
-    // evite smis instr with S type register
-    std::regex pattern_error("s\\d+");
-    if (std::regex_search(insn_asm, pattern_error)) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    std::regex pattern("\\d+");
-    auto       begin = std::sregex_iterator(insn_asm.begin(), insn_asm.end(), pattern);
-    auto       end   = std::sregex_iterator();
-    auto       dist  = std::distance(begin, end);
-    if (((dist % 2) == 0) || (dist < 3)) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
-    }
-
-    auto it = begin;
-    q_reg_num.push_back(str_to_uint(it->str()));
+    src->q_reg_num.push_back(expect_reg(lexer, 't', "smit"));
+    skip_separator(lexer);
+    expect(lexer, TK_LBRACE, "smit");
 
     std::vector<size_t> pair;
-    for (++it; it != end; ++it) {
+    do {
         pair.clear();  // clear pair
 
-        pair.push_back(str_to_sizet(it->str()));  // left qubit
+        bool in_braces = lexer.accept(TK_LBRACE);
+        if (!in_braces) expect(lexer, TK_LPAREN, "smit");
+        pair.push_back(static_cast<size_t>(expect_number(lexer, 0, max_qubit_index(), "smit")));
+        skip_separator(lexer);
+        pair.push_back(static_cast<size_t>(expect_number(lexer, 0, max_qubit_index(), "smit")));
+        expect(lexer, in_braces ? TK_RBRACE : TK_RPAREN, "smit");
 
-        ++it;
-        pair.push_back(str_to_sizet(it->str()));  // right qubit
+        src->q_qubit_tuples.push_back(pair);  // add to qubit tuples
+        skip_separator(lexer);
+    } while (lexer.peek().type != TK_RBRACE);
 
-        q_qubit_tuples.push_back(pair);  // add to qubit tuples
-    }
+    expect(lexer, TK_RBRACE, "smit");
+    expect_end(lexer, "smit");
 }
 
+// verify rotation names like x90, ym90, rx45 or ry22_5, and get the name prefix (x, ym, rx...)
 void Qasm_instruction::verify_rotate_angle(const std::string op_name, std::string& op_name_prefix) {
 
-    auto logger = get_logger_or_exit("asm_logger");
+    const size_t n = op_name.size();
+    size_t       i = 0;
 
-    // to verify whole name
-    std::regex pattern_rotate("^r?[xyz]m?\\d+(_\\d+)?$", std::regex_constants::icase);
-    if (!std::regex_search(op_name, pattern_rotate)) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+    // to verify whole name: r?[xyz]m?\d+(_\d+)?
+    bool rotate = (op_name[i] == 'r');
+    if (rotate) ++i;
+
+    if ((i >= n) || ((op_name[i] != 'x') && (op_name[i] != 'y') && (op_name[i] != 'z'))) {
+        parse_error("smit");
     }
+    ++i;
 
-    // to verify r[xyz]m
-    std::regex pattern_rxm("^r[xyz]m", std::regex_constants::icase);
-    if (std::regex_search(op_name, pattern_rxm)) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+    // r[xyz]m is not allowed
+    if ((i < n) && (op_name[i] == 'm')) {
+        if (rotate) parse_error("smit");
+        ++i;
     }
 
-    // to get angle
-    std::regex pattern_angle("\\d{1,3}(_\\d+)?$");
-    auto       begin = std::sregex_iterator(op_name.begin(), op_name.end(), pattern_angle);
-    auto       end   = std::sregex_iterator();
-    auto       dist  = std::distance(begin, end);
-    if (dist != 1) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+    size_t int_begin = i;
+    while ((i < n) && std::isdigit(static_cast<unsigned char>(op_name[i]))) ++i;
+    size_t int_end = i;
+    if (int_begin == int_end) parse_error("smit");
+
+    size_t frac_begin = i;
+    if ((i < n) && (op_name[i] == '_')) {
+        frac_begin = ++i;
+        while ((i < n) && std::isdigit(static_cast<unsigned char>(op_name[i]))) ++i;
+        if (frac_begin == i) parse_error("smit");
     }
+    if (i != n) parse_error("smit");
 
-    std::string angle_str = begin->str();
-    if (angle_str.find("_") != angle_str.npos) {
-        angle_str[angle_str.find("_")] = '.';
+    // the angle is given by at most three integer digits
+    if (int_end - int_begin > 3) int_begin = int_end - 3;
+
+    double angle = 0;
+    for (size_t k = int_begin; k < int_end; ++k) {
+        angle = angle * 10 + (op_name[k] - '0');
+    }
+    double scale = 0.1;
+    for (size_t k = frac_begin; (k < n) && (frac_begin != int_end); ++k, scale /= 10) {
+        angle += (op_name[k] - '0') * scale;
     }
-    double angle = std::stod(angle_str, nullptr);
+
     if (angle > 180) {
-        logger->error(
-          "asm_parser: Cannot parse smit instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+        parse_error("smit");
     }
+
     // before verify rotate angle,it has been checked that its size is at least 2
     if ((op_name[0] == 'r') || (op_name[1] == 'm')) {
         op_name_prefix = op_name.substr(0, 2);
@@ -815,74 +613,42 @@ void Qasm_instruction::verify_rotate_angle(const std::string op_name, std::strin
     }
 }
 
+// [time,] op reg | op reg | ...
 void Qasm_instruction::parse_qop() {
 
-    auto logger = get_logger_or_exit("asm_logger");
-
     Global_config& global_config = Global_config::get_instance();
 
-    // remove wait time
-    std::string qop_content;
-    std::regex  pattern_specified_time("^\\d+\\s*,\\s*\\w", std::regex_constants::icase);
-    if (std::regex_search(insn_asm, pattern_specified_time)) {
-        std::regex  pattern_time("\\d+");
-        std::smatch results;
-        std::regex_search(insn_asm, results, pattern_time);
-        auto it          = results.begin();
-        q_time_specified = str_to_uint(it->str());
-
-        qop_content = insn_asm.substr(insn_asm.find_first_of(",") + 1);
-    } else {
+    Asm_lexer lexer = asm_lexer();
 
+    // get the specified wait time
+    if (lexer.peek().type == TK_NUMBER) {
+        q_time_specified = static_cast<unsigned int>(expect_number(lexer, 0, UINT_MAX));
+        skip_separator(lexer);
+    } else {
         q_time_specified = 1;  // default 1 when there is no specified time
-        qop_content      = insn_asm;
     }
 
-    // parser qop
-    trim(qop_content);
-    std::vector<std::string> qops;
-    qops = split(qop_content, '|');  // split instruction with delimiter |
-
     bool is_mock_meas = false;
-    for (auto it = qops.begin(); it != qops.end(); ++it) {
-        std::string op = *it;
-        trim(op);
+    do {
+        // get operation name, in lower case
+        Asm_token op = lexer.next();
+        if (op.type != TK_IDENT) parse_error();
 
-        // tranform op name to lower case
-        transform(op.begin(), op.end(), op.begin(), ::tolower);
-
-        // get operation name
-        std::string  op_name;
+        std::string  op_name = lexer.lower_text(op);
         unsigned int reg_num;
 
-        if (op != "mock_meas") {
-            if (op.find_first_of(" ") == op.npos) {
-                logger->error(
-                  "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-                  insn_str_in_file, insn_line_num_in_file);
-                exit(EXIT_FAILURE);
-            }
-            op_name = op.substr(0, op.find_first_of(" "));
-
-            std::regex pattern_meas("meas", std::regex_constants::icase);
-            if (std::regex_search(op_name, pattern_meas)) {
+        if (op_name != "mock_meas") {
+            if (op_name.find("meas") != op_name.npos) {
                 op_name = "measure";
             }
 
-            std::regex  pattern_reg("\\d+");
-            std::string reg_str = op.substr(op.find_first_of(" "));
-            auto        begin   = std::sregex_iterator(reg_str.begin(), reg_str.end(), pattern_reg);
-            auto        end     = std::sregex_iterator();
-            auto        dist    = std::distance(begin, end);
-            if (dist != 1) {
-                logger->error(
-                  "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-                  insn_str_in_file, insn_line_num_in_file);
-                exit(EXIT_FAILURE);
+            // single-qubit operations target s registers, two-qubit operations t registers
+            if (!lexer.is_reg(lexer.peek(), 's', reg_num) &&
+                !lexer.is_reg(lexer.peek(), 't', reg_num)) {
+                parse_error();
             }
-            reg_num = str_to_uint(begin->str());
+            lexer.next();
         } else {
-            op_name      = op;
             reg_num      = 0;
             is_mock_meas = true;
         }
@@ -890,9 +656,11 @@ void Qasm_instruction::parse_qop() {
         // find the original name in configure file
         std::string op_name_prefix;
 
-        // specify measure operation name to 'meas'
-        std::regex pattern_rotate("^r?[xyz](m)?", std::regex_constants::icase);
-        if (op_name.size() > 1 && std::regex_search(op_name, pattern_rotate)) {
+        bool like_rotate = (op_name.size() > 1) &&
+                           ((op_name[0] == 'x') || (op_name[0] == 'y') || (op_name[0] == 'z') ||
+                            ((op_name[0] == 'r') && ((op_name[1] == 'x') || (op_name[1] == 'y') ||
+                                                     (op_name[1] == 'z'))));
+        if (like_rotate) {
             verify_rotate_angle(op_name, op_name_prefix);
         } else {
             op_name_prefix = op_name;
@@ -914,23 +682,19 @@ void Qasm_instruction::parse_qop() {
         }
 
         if (!get_num_tgt_qubits_type) {
-            logger->error(
-              "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-              insn_str_in_file, insn_line_num_in_file);
-            exit(EXIT_FAILURE);
+            parse_error();
         }
 
         // store op name and register
-        q_op_name.push_back(op_name);
-        q_reg_num.push_back(reg_num);
-        q_num_tgt_qubits_type.push_back(num_tgt_qubits_ype);
-    }
+        src->q_op_name.push_back(op_name);
+        src->q_reg_num.push_back(reg_num);
+        src->q_num_tgt_qubits_type.push_back(num_tgt_qubits_ype);
+    } while (lexer.accept(TK_PIPE));
+
+    expect_end(lexer);
 
-    if ((q_op_name.size() == 0) || (is_mock_meas && (q_op_name.size() > 1))) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+    if ((src->q_op_name.size() == 0) || (is_mock_meas && (src->q_op_name.size() > 1))) {
+        parse_error();
     }
 }
 
@@ -940,6 +704,10 @@ unsigned int Qasm_instruction::verify_parser_result() {
 
     unsigned int num_qubits = global_config.num_qubits;
 
+    const std::vector<std::vector<size_t>>& q_qubit_tuples  = get_q_qubit_tuples();
+    const std::vector<size_t>&              q_qubit_indices = get_q_qubit_indices();
+    const std::vector<unsigned int>&        q_reg_num       = get_q_reg_num();
+
     if (rs_addr >= (1 << RS_ADDR_WIDTH)) {
         return false;
     }
@@ -975,14 +743,14 @@ unsigned int Qasm_instruction::verify_parser_result() {
 
     for (size_t i = 0; i < q_qubit_tuples.size(); ++i) {
         for (size_t j = 0; j < q_qubit_tuples[i].size(); ++j) {
-            if (q_qubit_tuples[i][j] > num_qubits) {
+            if (q_qubit_tuples[i][j] >= num_qubits) {
                 return false;
             }
         }
     }
 
     for (size_t i = 0; i < q_qubit_indices.size(); ++i) {
-        if (q_qubit_indices[i] > num_qubits) {
+        if (q_qubit_indices[i] >= num_qubits) {
             return false;
         }
     }
@@ -1000,9 +768,8 @@ void Qasm_instruction::reset() {
     type                  = Instruction_type::BIN;
     insn_addr             = 0x0;
     insn_bin              = 0x0;
-    insn_asm              = "";
-    insn_line_num_in_file = "";
-    insn_str_in_file      = "";
+    text                  = nullptr;
+    src                   = nullptr;
     opcode                = OperationName::NOP;
     rs_addr               = 0x1F;
     rt_addr               = 0x1F;
@@ -1021,27 +788,40 @@ void Qasm_instruction::reset() {
 
     q_insn_type      = Q_instr_type::Q_NOP;
     q_time_specified = 0;
+}
 
-    q_qubit_indices.clear();
-    q_qubit_tuples.clear();
-    q_reg_num.clear();
-    q_op_name.clear();
-    q_num_tgt_qubits_type.clear();
+void Qasm_instruction::set_instruction(const Asm_text_arena& asm_text, Asm_line& insn,
+                                       const unsigned int& addr) {
+    try {
+        decode_asm(asm_text, insn, addr);
+    } catch (const Asm_parse_error& e) {
+        abort_on(e);
+    }
 }
 
-void Qasm_instruction::set_instruction(const std::vector<std::string>&            insn,
-                                       const std::map<std::string, unsigned int>& map_label,
-                                       const unsigned int&                        addr) {
-    auto logger = get_logger_or_exit("asm_logger");
+bool Qasm_instruction::try_set_instruction(const Asm_text_arena& asm_text, Asm_line& insn,
+                                           const unsigned int& addr, std::string& error_msg) {
+    try {
+        decode_asm(asm_text, insn, addr);
+    } catch (const Asm_parse_error& e) {
+        error_msg = e.what();
+        return false;
+    }
+    return true;
+}
 
+void Qasm_instruction::decode_asm(const Asm_text_arena& asm_text, Asm_line& insn,
+                                  const unsigned int& addr) {
     reset();
 
-    type                  = Instruction_type::ASM;
-    insn_line_num_in_file = insn[1];
-    insn_str_in_file      = insn[2];
-    insn_addr             = addr;
-    insn_bin              = 0x0;
-    insn_asm              = insn[0];
+    type      = Instruction_type::ASM;
+    text      = &asm_text;
+    src       = &insn;
+    insn_addr = addr;
+    insn_bin  = 0x0;
+
+    // only built for the time of decoding, the instruction keeps referring to the arena
+    const std::string insn_asm = asm_text.str(insn.asm_text);
 
     parse_opcode(insn_asm);  // get opcode,cl_insn,q_insn,meas_insn
 
@@ -1050,7 +830,7 @@ void Qasm_instruction::set_instruction(const std::vector<std::string>&
             case OperationName::NOP:
                 break;
             case OperationName::BR:
-                parse_br(insn_asm, map_label, addr);
+                parse_br(insn_asm, addr);
                 break;
             case OperationName::CMP:
                 parse_cmp(insn_asm);
@@ -1097,10 +877,7 @@ void Qasm_instruction::set_instruction(const std::vector<std::string>&
             case OperationName::STOP:
                 break;
             default:
-                logger->error(
-                  "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-                  insn_str_in_file, insn_line_num_in_file);
-                exit(EXIT_FAILURE);
+                parse_error();
         }
     }
     if (q_insn) {
@@ -1108,10 +885,12 @@ void Qasm_instruction::set_instruction(const std::vector<std::string>&
     }
 
     if (!verify_parser_result()) {
-        logger->error(
-          "asm_parser: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-          insn_str_in_file, insn_line_num_in_file);
-        exit(EXIT_FAILURE);
+        parse_error();
+    }
+
+    // the quantum operands are decoded once here, and only read by the quantum decoder
+    if (q_insn) {
+        decode_q_operands();
     }
 }
 
@@ -1132,12 +911,20 @@ void Qasm_instruction::set_instruction(const unsigned int& insn, const unsigned
     meas_insn   = meas_a || meas_b;
 
     opcode = (insn & OPCODE_MASK) >> OPCODE_SHIFT;
+
+    // qwaitr reads the waiting time from a classical register
+    if (q_insn && ((insn & Q_BUNDLE_FLAG) == 0) && (opcode == QWAITR_OPCODE)) {
+        rs_addr = (insn & RS_ADDR_MASK) >> RS_ADDR_SHIFT;
+        rs_used = true;
+    }
+
     if (cl_insn) {
         switch (opcode) {
             case OperationName::NOP:
                 break;
             case OperationName::BR:
-                br_addr = (insn & BR_ADDR_MASK) >> BR_ADDR_SHIFT;
+                // the offset is signed, so that programs can branch backwards
+                br_addr = sign_extend((insn & BR_ADDR_MASK) >> BR_ADDR_SHIFT, BR_ADDR_WIDTH);
                 br_cond = (insn & BR_COND_MASK) >> BR_COND_SHIFT;
                 break;
             case OperationName::CMP:
@@ -1147,7 +934,7 @@ void Qasm_instruction::set_instruction(const unsigned int& insn, const unsigned
                 rt_used = true;
                 break;
             case OperationName::FBR:
-                br_addr = (insn & BR_ADDR_MASK) >> BR_ADDR_SHIFT;
+                br_cond = (insn & BR_COND_MASK) >> BR_COND_SHIFT;
                 rd_addr = (insn & RD_ADDR_MASK) >> RD_ADDR_SHIFT;
                 rd_used = true;
                 break;
@@ -1157,7 +944,7 @@ void Qasm_instruction::set_instruction(const unsigned int& insn, const unsigned
                 rd_used   = true;
                 break;
             case OperationName::LDI:
-                imm     = (insn & LDI_IMM_MASK) >> LDI_IMM_SHIFT;
+                imm     = sign_extend((insn & LDI_IMM_MASK) >> LDI_IMM_SHIFT, LDI_IMM_WIDTH);
                 rd_addr = (insn & RD_ADDR_MASK) >> RD_ADDR_SHIFT;
                 rd_used = true;
                 break;
@@ -1226,130 +1013,33 @@ void Qasm_instruction::set_instruction(const unsigned int& insn, const unsigned
     }
 }
 
-Qasm_instruction& Qasm_instruction::operator=(const Qasm_instruction& insn) {
-    if (this != &insn) {
-        type                  = insn.type;
-        insn_addr             = insn.insn_addr;
-        insn_str_in_file      = insn.insn_str_in_file;
-        insn_line_num_in_file = insn.insn_line_num_in_file;
-        insn_bin              = insn.insn_bin;
-        insn_asm              = insn.insn_asm;
-        opcode                = insn.opcode;
-        rs_addr               = insn.rs_addr;
-        rt_addr               = insn.rt_addr;
-        rd_addr               = insn.rd_addr;
-        imm                   = insn.imm;
-        uimm                  = insn.uimm;
-        br_addr               = insn.br_addr;
-        br_cond               = insn.br_cond;
-        qubit_sel             = insn.qubit_sel;
-        rd_used               = insn.rd_used;
-        rs_used               = insn.rs_used;
-        rt_used               = insn.rt_used;
-        cl_insn               = insn.cl_insn;
-        q_insn                = insn.q_insn;
-        meas_insn             = insn.meas_insn;
-
-        q_insn_type      = insn.q_insn_type;
-        q_time_specified = insn.q_time_specified;
-
-        q_qubit_indices.assign(insn.q_qubit_indices.begin(), insn.q_qubit_indices.end());
-        q_qubit_tuples.assign(insn.q_qubit_tuples.begin(), insn.q_qubit_tuples.end());
-        q_reg_num.assign(insn.q_reg_num.begin(), insn.q_reg_num.end());
-        q_op_name.assign(insn.q_op_name.begin(), insn.q_op_name.end());
-        q_num_tgt_qubits_type.assign(insn.q_num_tgt_qubits_type.begin(),
-                                     insn.q_num_tgt_qubits_type.end());
-    }
-    return *this;
-}
-
 bool Qasm_instruction::operator==(const Qasm_instruction& insn) const {
     return (type == insn.type) && (insn_addr == insn.insn_addr) && (insn_bin == insn.insn_bin) &&
-           (insn_asm == insn.insn_asm);
+           (src == insn.src);
 }
 
-Qasm_instruction::Qasm_instruction() {
-    reset();
-    initial_map_opcode();
-    initial_map_br_cond();
-}
+Qasm_instruction::Qasm_instruction() { reset(); }
 
-void Qasm_instruction::initial_map_opcode() {
-    map_opcode.insert(std::make_pair("BR", OperationName::BR));
-    map_opcode.insert(std::make_pair("br", OperationName::BR));
-    map_opcode.insert(std::make_pair("CMP", OperationName::CMP));
-    map_opcode.insert(std::make_pair("cmp", OperationName::CMP));
-    map_opcode.insert(std::make_pair("FBR", OperationName::FBR));
-    map_opcode.insert(std::make_pair("fbr", OperationName::FBR));
-    map_opcode.insert(std::make_pair("FMR", OperationName::FMR));
-    map_opcode.insert(std::make_pair("fmr", OperationName::FMR));
-    map_opcode.insert(std::make_pair("LDI", OperationName::LDI));
-    map_opcode.insert(std::make_pair("ldi", OperationName::LDI));
-    map_opcode.insert(std::make_pair("LDUI", OperationName::LDUI));
-    map_opcode.insert(std::make_pair("ldui", OperationName::LDUI));
-    map_opcode.insert(std::make_pair("ADD", OperationName::ADD));
-    map_opcode.insert(std::make_pair("add", OperationName::ADD));
-    map_opcode.insert(std::make_pair("ADDI", OperationName::ADDI));
-    map_opcode.insert(std::make_pair("addi", OperationName::ADDI));
-    map_opcode.insert(std::make_pair("SUB", OperationName::SUB));
-    map_opcode.insert(std::make_pair("sub", OperationName::SUB));
-    map_opcode.insert(std::make_pair("AND", OperationName::AND));
-    map_opcode.insert(std::make_pair("and", OperationName::AND));
-    map_opcode.insert(std::make_pair("OR", OperationName::OR));
-    map_opcode.insert(std::make_pair("or", OperationName::OR));
-    map_opcode.insert(std::make_pair("XOR", OperationName::XOR));
-    map_opcode.insert(std::make_pair("xor", OperationName::XOR));
-    map_opcode.insert(std::make_pair("NOT", OperationName::NOT));
-    map_opcode.insert(std::make_pair("not", OperationName::NOT));
-    map_opcode.insert(std::make_pair("LB", OperationName::LB));
-    map_opcode.insert(std::make_pair("lb", OperationName::LB));
-    map_opcode.insert(std::make_pair("LBU", OperationName::LBU));
-    map_opcode.insert(std::make_pair("lbu", OperationName::LBU));
-    map_opcode.insert(std::make_pair("LW", OperationName::LW));
-    map_opcode.insert(std::make_pair("lw", OperationName::LW));
-    map_opcode.insert(std::make_pair("SB", OperationName::SB));
-    map_opcode.insert(std::make_pair("sb", OperationName::SB));
-    map_opcode.insert(std::make_pair("SW", OperationName::SW));
-    map_opcode.insert(std::make_pair("sw", OperationName::SW));
-    map_opcode.insert(std::make_pair("REM", OperationName::REM));
-    map_opcode.insert(std::make_pair("rem", OperationName::REM));
-    map_opcode.insert(std::make_pair("MUL", OperationName::MUL));
-    map_opcode.insert(std::make_pair("mul", OperationName::MUL));
-    map_opcode.insert(std::make_pair("DIV", OperationName::DIV));
-    map_opcode.insert(std::make_pair("div", OperationName::DIV));
-    map_opcode.insert(std::make_pair("NOP", OperationName::NOP));
-    map_opcode.insert(std::make_pair("nop", OperationName::NOP));
-    map_opcode.insert(std::make_pair("STOP", OperationName::STOP));
-    map_opcode.insert(std::make_pair("stop", OperationName::STOP));
-}
+const std::map<std::string, unsigned int>& Qasm_instruction::map_opcode() {
+    static const std::map<std::string, unsigned int> opcodes = {
+      {"br", OperationName::BR},     {"cmp", OperationName::CMP},   {"fbr", OperationName::FBR},
+      {"fmr", OperationName::FMR},   {"ldi", OperationName::LDI},   {"ldui", OperationName::LDUI},
+      {"add", OperationName::ADD},   {"addi", OperationName::ADDI}, {"sub", OperationName::SUB},
+      {"and", OperationName::AND},   {"or", OperationName::OR},     {"xor", OperationName::XOR},
+      {"not", OperationName::NOT},   {"lb", OperationName::LB},     {"lbu", OperationName::LBU},
+      {"lw", OperationName::LW},     {"sb", OperationName::SB},     {"sw", OperationName::SW},
+      {"rem", OperationName::REM},   {"mul", OperationName::MUL},   {"div", OperationName::DIV},
+      {"nop", OperationName::NOP},   {"stop", OperationName::STOP}};
 
-void Qasm_instruction::initial_map_br_cond() {
-    map_br_cond.insert(std::make_pair("ALWAYS", 0));
-    map_br_cond.insert(std::make_pair("always", 0));
-    map_br_cond.insert(std::make_pair("NEVER", 1));
-    map_br_cond.insert(std::make_pair("never", 1));
-    map_br_cond.insert(std::make_pair("EQ", 2));
-    map_br_cond.insert(std::make_pair("eq", 2));
-    map_br_cond.insert(std::make_pair("NE", 3));
-    map_br_cond.insert(std::make_pair("ne", 3));
-    map_br_cond.insert(std::make_pair("LTU", 8));
-    map_br_cond.insert(std::make_pair("ltu", 8));
-    map_br_cond.insert(std::make_pair("GEU", 9));
-    map_br_cond.insert(std::make_pair("geu", 9));
-    map_br_cond.insert(std::make_pair("LEU", 10));
-    map_br_cond.insert(std::make_pair("leu", 10));
-    map_br_cond.insert(std::make_pair("GTU", 11));
-    map_br_cond.insert(std::make_pair("gtu", 11));
-    map_br_cond.insert(std::make_pair("LT", 12));
-    map_br_cond.insert(std::make_pair("lt", 12));
-    map_br_cond.insert(std::make_pair("GE", 13));
-    map_br_cond.insert(std::make_pair("ge", 13));
-    map_br_cond.insert(std::make_pair("LE", 14));
-    map_br_cond.insert(std::make_pair("le", 14));
-    map_br_cond.insert(std::make_pair("GT", 15));
-    map_br_cond.insert(std::make_pair("gt", 15));
+    return opcodes;
 }
 
-Qasm_instruction::~Qasm_instruction() {}
+const std::map<std::string, unsigned int>& Qasm_instruction::map_br_cond() {
+    static const std::map<std::string, unsigned int> br_conds = {
+      {"always", 0}, {"never", 1}, {"eq", 2},  {"ne", 3},  {"ltu", 8},  {"geu", 9},
+      {"leu", 10},   {"gtu", 11},  {"lt", 12}, {"ge", 13}, {"le", 14}, {"gt", 15}};
+
+    return br_conds;
+}
 
 }  // namespace cactus
@@ -9,44 +9,114 @@
 #ifndef _QASM_INSTRUCTION_H_
 #define _QASM_INSTRUCTION_H_
 
+#include <cstdint>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <systemc>
+#include <type_traits>
+#include <vector>
 
+#include "asm_lexer.h"
 #include "generic_if.h"
 #include "q_data_type.h"
 
 namespace cactus {
 
+/**
+ * A piece of text in the text arena of a program image.
+ */
+struct Asm_text_ref {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+};
+
+/**
+ * All the source text of a program image, kept in one buffer.
+ *
+ * Lines refer to their text by offset, so the buffer may grow while the program is loaded, and
+ * strings are only built when an error message or a trace needs them.
+ */
+class Asm_text_arena {
+  private:
+    std::string m_buffer;
+
+  public:
+    Asm_text_ref add(const char* text, size_t len);
+    Asm_text_ref add(const std::string& s) { return add(s.data(), s.size()); }
+
+    // append the text of another arena, and return the offset its text starts at
+    uint64_t append(const Asm_text_arena& other);
+
+    const char* data(const Asm_text_ref& ref) const { return m_buffer.data() + ref.offset; }
+    std::string str(const Asm_text_ref& ref) const { return std::string(data(ref), ref.length); }
+
+    size_t size() const { return m_buffer.size(); }
+    void   clear() { std::string().swap(m_buffer); }
+
+    // the whole buffer, for the cache file
+    const std::string& buffer() const { return m_buffer; }
+    std::string&       buffer() { return m_buffer; }
+};
+
+/**
+ * One elementary instruction of the asm program image, together with the quantum operands
+ * derived from it.
+ *
+ * A decoded Qasm_instruction only keeps a pointer to its Asm_line, so that copying an instruction
+ * through the pipeline registers does not copy any string or vector. The program image therefore
+ * must not be modified (or reallocated) once instructions have been decoded from it.
+ */
+struct Asm_line {
+    Asm_text_ref asm_text;      // the elementary instruction to parse
+    Asm_text_ref src_text;      // the original line in the asm file
+    unsigned int line_num = 0;  // line number in the asm file
+
+    // the absolute address of the label used by a br instruction, resolved when the program is
+    // loaded
+    static const unsigned int NO_BR_TARGET = 0xFFFFFFFF;
+    unsigned int              br_target    = NO_BR_TARGET;
+
+    // quantum operands, decoded together with the instruction by set_instruction()
+    std::vector<size_t>                q_qubit_indices;
+    std::vector<std::vector<size_t>>   q_qubit_tuples;
+    std::vector<unsigned int>          q_reg_num;
+    std::vector<std::string>           q_op_name;
+    std::vector<num_tgt_qubits_type_t> q_num_tgt_qubits_type;
+
+    void clear_q_operands();
+};
+
+// thrown by the parser helpers. The public entries turn it into the usual error message and
+// abort the simulation, except try_set_instruction(), which hands it to the caller.
+class Asm_parse_error : public std::runtime_error {
+  public:
+    explicit Asm_parse_error(const std::string& msg)
+        : std::runtime_error(msg) {}
+};
+
 class Qasm_instruction {
   public:
     Instruction_type type;
     unsigned int     insn_addr;
     unsigned int     insn_bin;
-    std::string      insn_asm;
-    std::string      insn_line_num_in_file;
-    std::string      insn_str_in_file;
 
   private:  // member variables
-    unsigned int                        opcode;
-    std::map<std::string, unsigned int> map_opcode;
-    unsigned int                        rs_addr;
-    unsigned int                        rd_addr;
-    unsigned int                        rt_addr;
-    int                                 imm;
-    unsigned                            uimm;
+    const Asm_text_arena* text;  // the text of the program image, nullptr for binary instructions
+    Asm_line*             src;   // nullptr for binary instructions
+
+    unsigned int opcode;
+    unsigned int rs_addr;
+    unsigned int rd_addr;
+    unsigned int rt_addr;
+    int          imm;
+    unsigned     uimm;
     // br_cond is used for br and fbr
-    int                                 br_addr;
-    unsigned int                        br_cond;
-    std::map<std::string, unsigned int> map_br_cond;
-    unsigned int                        qubit_sel;
-    Q_instr_type                        q_insn_type;
-    std::vector<size_t>                 q_qubit_indices;
-    std::vector<std::vector<size_t>>    q_qubit_tuples;
-    std::vector<unsigned int>           q_reg_num;
-    std::vector<std::string>            q_op_name;
-    std::vector<num_tgt_qubits_type_t>  q_num_tgt_qubits_type;
-    unsigned int                        q_time_specified;
+    int          br_addr;
+    unsigned int br_cond;
+    unsigned int qubit_sel;
+    Q_instr_type q_insn_type;
+    unsigned int q_time_specified;
 
     bool rd_used;    // is rd used in this instruction
     bool rs_used;    // is rs used in this instruction
@@ -55,30 +125,50 @@ class Qasm_instruction {
     bool q_insn;     // quantum instruction
     bool meas_insn;  // measure instruction
 
-    unsigned int m_num_qubits;
+  private:  // parser helpers
+    // throw an Asm_parse_error naming the instruction that cannot be parsed
+    [[noreturn]] void parse_error(const char* insn_kind = "asm") const;
+    [[noreturn]] void abort_on(const Asm_parse_error& e) const;
+
+    void decode_asm(const Asm_text_arena& asm_text, Asm_line& insn, const unsigned int& addr);
+    void decode_q_operands();
+
+    // a lexer over the elementary instruction, read in place from the text arena
+    Asm_lexer asm_lexer() const;
+
+    void         expect(Asm_lexer& lexer, Asm_token_type type, const char* insn_kind = "asm");
+    unsigned int expect_reg(Asm_lexer& lexer, char prefix, const char* insn_kind = "asm");
+    long long    expect_number(Asm_lexer& lexer, long long min, long long max,
+                               const char* insn_kind = "asm");
+    // a signed immediate. A hexadecimal literal of up to 32 bits gives the bits of the int,
+    // e.g. 0xFFFFFFFF is -1.
+    int          expect_imm(Asm_lexer& lexer, const char* insn_kind = "asm");
+    // the operands may be separated by commas or blanks, and may end with a comma
+    void         skip_separator(Asm_lexer& lexer);
+    void         expect_end(Asm_lexer& lexer, const char* insn_kind = "asm");
 
   public:  // member function
-    Instruction_type                    get_type();
-    unsigned int                        get_insn_bin();
-    std::string                         get_insn_asm();
-    std::string                         get_insn_line_num_in_file();
-    std::string                         get_insn_str_in_file();
-    unsigned int                        get_opcode();
-    unsigned int                        get_rs_addr();
-    unsigned int                        get_rt_addr();
-    unsigned int                        get_rd_addr();
-    unsigned int                        get_uimm();
-    int                                 get_imm();
-    int                                 get_br_addr();
-    unsigned int                        get_br_cond();
-    unsigned int                        get_qubit_sel();
-    Q_instr_type                        get_q_insn_type();
-    unsigned int                        get_q_time_specified();
-    std::vector<size_t>&                get_q_qubit_indices();
-    std::vector<std::vector<size_t>>&   get_q_qubit_tuples();
-    std::vector<unsigned int>&          get_q_reg_num();
-    std::vector<std::string>&           get_q_op_name();
-    std::vector<num_tgt_qubits_type_t>& get_q_num_tgt_qubits_type();
+    Instruction_type                          get_type() const;
+    unsigned int                              get_insn_bin() const;
+    std::string                               get_insn_asm() const;
+    unsigned int                              get_insn_line_num_in_file() const;
+    std::string                               get_insn_str_in_file() const;
+    unsigned int                              get_opcode();
+    unsigned int                              get_rs_addr();
+    unsigned int                              get_rt_addr();
+    unsigned int                              get_rd_addr();
+    unsigned int                              get_uimm();
+    int                                       get_imm();
+    int                                       get_br_addr();
+    unsigned int                              get_br_cond();
+    unsigned int                              get_qubit_sel();
+    Q_instr_type                              get_q_insn_type();
+    unsigned int                              get_q_time_specified();
+    const std::vector<size_t>&                get_q_qubit_indices() const;
+    const std::vector<std::vector<size_t>>&   get_q_qubit_tuples() const;
+    const std::vector<unsigned int>&          get_q_reg_num() const;
+    const std::vector<std::string>&           get_q_op_name() const;
+    const std::vector<num_tgt_qubits_type_t>& get_q_num_tgt_qubits_type() const;
 
     bool is_q_insn();
     bool is_rd_used();
@@ -92,8 +182,7 @@ class Qasm_instruction {
 
     // NOP and STOP do not need parse
     void parse_opcode(const std::string& insn);
-    void parse_br(const std::string& insn, const std::map<std::string, unsigned int>& map_label,
-                  const unsigned int& addr);
+    void parse_br(const std::string& insn, const unsigned int& addr);
     void parse_cmp(const std::string& insn);
     void parse_fbr(const std::string& insn);
     void parse_fmr(const std::string& insn);
@@ -109,6 +198,7 @@ class Qasm_instruction {
     void parse_arithmetic_operation(const std::string& insn);
     void parse_arithmetic_immediate_operation(const std::string& insn);
 
+    // decode the quantum operands again. set_instruction() has already done it.
     void parse_q_insn();
     void parse_q_insn_type();
     void parse_qwait();
@@ -122,25 +212,39 @@ class Qasm_instruction {
   public:
     void reset();
 
-    void set_instruction(const std::vector<std::string>&            insn,
-                         const std::map<std::string, unsigned int>& map_label,
-                         const unsigned int&                        addr);
+    // the asm line and its text are referenced, not copied. See Asm_line. The branch target of a
+    // br instruction must have been resolved (see Asm_program).
+    void set_instruction(const Asm_text_arena& asm_text, Asm_line& insn, const unsigned int& addr);
+
+    // the same as above, but returns false with the error message instead of aborting, so that
+    // the caller can decide which error to report. Used when decoding on several threads.
+    bool try_set_instruction(const Asm_text_arena& asm_text, Asm_line& insn,
+                             const unsigned int& addr, std::string& error_msg);
 
     void set_instruction(const unsigned int& insn, const unsigned int& addr);
 
-    Qasm_instruction& operator=(const Qasm_instruction& insn);  // operation =
+    // refer to the given asm line again, e.g. after the decoded instruction has been copied from
+    // a cache file together with the program image it was decoded from
+    void rebind(const Asm_text_arena& asm_text, Asm_line& insn) {
+        text = &asm_text;
+        src  = &insn;
+    }
 
     bool operator==(const Qasm_instruction& insn) const;  // operator ==
 
-    void initial_map_opcode();
-    void initial_map_br_cond();
+    // shared lookup tables, keys are in lower case
+    static const std::map<std::string, unsigned int>& map_opcode();
+    static const std::map<std::string, unsigned int>& map_br_cond();
 
   public:
     Qasm_instruction();
-
-    ~Qasm_instruction();
 };
 
+// Qasm_instruction is written to many pipeline registers every clock cycle, and should stay a
+// plain record that is copied without any allocation.
+static_assert(std::is_trivially_copyable<Qasm_instruction>::value,
+              "Qasm_instruction should be trivially copyable");
+
 inline void sc_trace(sc_core::sc_trace_file* tf, const Qasm_instruction& insn,
                      const std::string& name) {}
 
@@ -0,0 +1,297 @@
+#include "shot_farm.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace cactus {
+
+// ============================================================================================
+// Shot_result
+// ============================================================================================
+std::string Shot_result::outcome(unsigned int num_qubits) const {
+    std::string bits(num_qubits, '-');
+
+    for (auto& m : meas) {
+        if (m.first < num_qubits) bits[num_qubits - 1 - m.first] = m.second ? '1' : '0';
+    }
+    return bits;
+}
+
+std::string Shot_result::serialize() const {
+    std::stringstream ss;
+
+    ss << meas.size();
+    for (auto& m : meas) ss << " " << m.first << " " << m.second;
+    ss << " " << mem_words.size();
+    for (auto word : mem_words) ss << " " << word;
+    ss << std::endl;
+
+    return ss.str();
+}
+
+bool Shot_result::deserialize(const std::string& line) {
+    std::stringstream ss(line);
+    size_t            num_meas  = 0;
+    size_t            num_words = 0;
+
+    meas.clear();
+    mem_words.clear();
+
+    if (!(ss >> num_meas)) return false;
+    for (size_t i = 0; i < num_meas; ++i) {
+        unsigned int qubit  = 0;
+        bool         result = false;
+        if (!(ss >> qubit >> result)) return false;
+        meas.emplace_back(qubit, result);
+    }
+
+    if (!(ss >> num_words)) return false;
+    for (size_t i = 0; i < num_words; ++i) {
+        unsigned int word = 0;
+        if (!(ss >> word)) return false;
+        mem_words.push_back(word);
+    }
+    return true;
+}
+
+// ============================================================================================
+// Shot_farm
+// ============================================================================================
+Shot_farm::Shot_farm(unsigned int num_shots, const std::string& output_dir,
+                     unsigned int num_workers)
+    : m_num_shots(num_shots)
+    , m_output_dir(output_dir)
+    , m_num_workers(num_workers) {
+
+    if (!m_output_dir.empty() && m_output_dir.back() != '/') m_output_dir += "/";
+
+    if (m_num_workers == 0) m_num_workers = std::thread::hardware_concurrency();
+
+    // hardware_concurrency() may not be able to tell
+    if (m_num_workers == 0) m_num_workers = 1;
+}
+
+uint64_t Shot_farm::shot_seed(unsigned int shot) {
+    // splitmix64, so that the seeds of consecutive shots are far apart
+    uint64_t z = (static_cast<uint64_t>(shot) + 1) * 0x9e3779b97f4a7c15ULL;
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::string Shot_farm::shot_log_fn(unsigned int shot) const {
+    return m_output_dir + "shot_" + std::to_string(shot) + ".log";
+}
+
+#ifdef WIN32
+// ------------------------------------------------------------------
+//  Windows
+// ------------------------------------------------------------------
+void Shot_farm::run_in_child(const Shot_fn& run_shot, unsigned int shot, int fd) const {}
+
+bool Shot_farm::run(const Shot_fn& run_shot, std::string& error_msg) {
+    error_msg = "running shots needs fork(), which Windows does not have";
+    return false;
+}
+
+#else
+// ------------------------------------------------------------------
+//  Non-Windows
+// ------------------------------------------------------------------
+void Shot_farm::run_in_child(const Shot_fn& run_shot, unsigned int shot, int fd) const {
+
+    // the output of the shot is only kept if it fails
+    int log_fd = open(shot_log_fn(shot).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log_fd >= 0) {
+        dup2(log_fd, STDOUT_FILENO);
+        close(log_fd);
+    }
+
+    Shot_result result;
+    bool        ok = run_shot(shot, shot_seed(shot), result);
+
+    if (ok) {
+        std::string line    = result.serialize();
+        size_t      written = 0;
+        while (written < line.size()) {
+            ssize_t n = write(fd, line.data() + written, line.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                ok = false;
+                break;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+    close(fd);
+
+    std::cout.flush();
+    fflush(stdout);
+
+    // the elaborated model belongs to the parent, its destructors must not run here
+    _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+bool Shot_farm::run(const Shot_fn& run_shot, std::string& error_msg) {
+
+    struct Worker {
+        pid_t        pid;
+        int          fd;
+        unsigned int shot;
+        std::string  data;
+    };
+
+    std::vector<Worker> workers;
+    unsigned int        next_shot = 0;
+    bool                failed    = false;
+
+    m_results.assign(m_num_shots, Shot_result());
+
+    // anything still buffered would be written again by every child
+    std::cout.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    while (!failed && (next_shot < m_num_shots || !workers.empty())) {
+
+        // start a shot on every idle worker
+        while (next_shot < m_num_shots && workers.size() < m_num_workers) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                error_msg = "cannot create a pipe to a worker";
+                failed    = true;
+                break;
+            }
+
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                error_msg = "cannot fork a worker";
+                failed    = true;
+                break;
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                for (auto& worker : workers) close(worker.fd);
+                run_in_child(run_shot, next_shot, fds[1]);
+            }
+
+            close(fds[1]);
+            workers.push_back(Worker{pid, fds[0], next_shot, ""});
+            next_shot++;
+        }
+        if (failed || workers.empty()) break;
+
+        // wait for the output of any running shot
+        std::vector<struct pollfd> poll_fds;
+        for (auto& worker : workers) poll_fds.push_back({worker.fd, POLLIN, 0});
+
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            error_msg = "cannot wait for the workers";
+            failed    = true;
+            break;
+        }
+
+        // from the back, so that erasing a worker does not move the ones still to be read
+        for (size_t i = workers.size(); i-- > 0;) {
+            if (poll_fds[i].revents == 0) continue;
+
+            Worker& worker = workers[i];
+            char    buf[4096];
+            ssize_t n = read(worker.fd, buf, sizeof(buf));
+            if (n > 0) {
+                worker.data.append(buf, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+
+            // the shot has ended
+            close(worker.fd);
+            int status = 0;
+            waitpid(worker.pid, &status, 0);
+
+            bool ok = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+                      m_results[worker.shot].deserialize(worker.data);
+            if (ok) {
+                std::remove(shot_log_fn(worker.shot).c_str());
+            } else if (!failed) {
+                error_msg = "shot " + std::to_string(worker.shot) + " (seed " +
+                            std::to_string(shot_seed(worker.shot)) + ") has failed, see '" +
+                            shot_log_fn(worker.shot) + "'";
+                failed    = true;
+            }
+            workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+
+    // the shots still running are of no use anymore
+    for (auto& worker : workers) {
+        kill(worker.pid, SIGKILL);
+        close(worker.fd);
+        waitpid(worker.pid, nullptr, 0);
+        std::remove(shot_log_fn(worker.shot).c_str());
+    }
+
+    return !failed;
+}
+
+#endif
+
+std::map<std::string, unsigned int> Shot_farm::histogram(unsigned int num_qubits) const {
+    std::map<std::string, unsigned int> counts;
+
+    for (auto& result : m_results) counts[result.outcome(num_qubits)]++;
+
+    return counts;
+}
+
+bool Shot_farm::write_csv(unsigned int num_qubits) const {
+
+    std::ofstream shots_os(m_output_dir + "shots.csv");
+    if (!shots_os.is_open()) return false;
+
+    shots_os << "shot, seed, outcome, measurements, data memory" << std::endl;
+    for (unsigned int shot = 0; shot < m_results.size(); ++shot) {
+        const Shot_result& result = m_results[shot];
+
+        shots_os << shot << ", " << shot_seed(shot) << ", " << result.outcome(num_qubits) << ", ";
+        for (size_t i = 0; i < result.meas.size(); ++i) {
+            shots_os << (i ? " " : "") << "q" << result.meas[i].first << "="
+                     << result.meas[i].second;
+        }
+        shots_os << ", ";
+        for (size_t i = 0; i < result.mem_words.size(); ++i) {
+            shots_os << (i ? " " : "") << "0x" << std::setfill('0') << std::setw(8) << std::hex
+                     << result.mem_words[i] << std::dec;
+        }
+        shots_os << std::endl;
+    }
+
+    std::ofstream hist_os(m_output_dir + "histogram.csv");
+    if (!hist_os.is_open()) return false;
+
+    hist_os << "outcome, count, frequency" << std::endl;
+    for (auto& entry : histogram(num_qubits)) {
+        hist_os << entry.first << ", " << entry.second << ", "
+                << static_cast<double>(entry.second) / m_results.size() << std::endl;
+    }
+
+    return shots_os.good() && hist_os.good();
+}
+
+}  // namespace cactus
@@ -0,0 +1,129 @@
+/** shot_farm.h
+ *
+ * This file defines the running of many shots of the same program, for the statistics of the
+ * measurement outcomes.
+ *
+ * SystemC elaborates and simulates only once per process. The simulator is therefore elaborated
+ * once, and every shot runs in a child process forked from it, which simulates and exits. The
+ * children share the elaborated model with the parent (copy-on-write), so a shot costs its
+ * simulation and a fork, and up to one shot per core runs at a time.
+ *
+ * Every shot seeds the qubit simulator with its own seed, derived from its index, so that any
+ * shot can be reproduced. The child sends back what the shot has measured (see Shot_record) and
+ * the words of the data memory dump, which the parent merges into:
+ *  - shots.csv, one line per shot,
+ *  - histogram.csv, the number of shots per outcome, the last result measured on every qubit.
+ *
+ */
+
+#ifndef _SHOT_FARM_H_
+#define _SHOT_FARM_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cactus {
+
+// what a shot has measured, and the content of the data memory at its end
+class Shot_result {
+  public:
+    // (qubit, result) in the order of the measurements
+    std::vector<std::pair<unsigned int, bool>> meas;
+
+    // the words of the data memory dump, empty if it is not asked for
+    std::vector<unsigned int> mem_words;
+
+  public:
+    // the last result of every qubit, from the highest qubit to qubit 0, '-' if never measured
+    std::string outcome(unsigned int num_qubits) const;
+
+    // a single line of text, to send the result from a child to the parent
+    std::string serialize() const;
+    bool        deserialize(const std::string& line);
+};
+
+// --------------------------------------------------------------------------------------------
+// the measurements of the running shot
+// --------------------------------------------------------------------------------------------
+class Shot_record {
+  private:
+    bool        m_enabled = false;
+    Shot_result m_result;
+
+  public:
+    // delete the copy constructor
+    Shot_record(const Shot_record&) = delete;
+
+    // delete the assignment operator
+    Shot_record& operator=(const Shot_record&) = delete;
+
+    static Shot_record& get_instance() {
+        // the static one ensures only one copy of the Shot_record
+        static Shot_record s_instance;
+        return s_instance;
+    }
+
+    // measurements are only recorded when running shots
+    void enable() { m_enabled = true; }
+    bool is_enabled() const { return m_enabled; }
+
+    void add_meas(unsigned int qubit, bool result) { m_result.meas.emplace_back(qubit, result); }
+
+    Shot_result& result() { return m_result; }
+
+  private:
+    Shot_record() = default;
+
+    ~Shot_record() = default;
+};
+
+// --------------------------------------------------------------------------------------------
+// the pool of processes which run the shots
+// --------------------------------------------------------------------------------------------
+class Shot_farm {
+  public:
+    // runs a shot in a child process, and returns false if it fails
+    typedef std::function<bool(unsigned int shot, uint64_t seed, Shot_result& result)> Shot_fn;
+
+  private:
+    unsigned int m_num_shots;
+    std::string  m_output_dir;
+    unsigned int m_num_workers;
+
+    std::vector<Shot_result> m_results;
+
+    // the output of a shot, kept if it fails
+    std::string shot_log_fn(unsigned int shot) const;
+
+    void run_in_child(const Shot_fn& run_shot, unsigned int shot, int fd) const;
+
+  public:
+    // 0 workers runs one shot per core of the host at a time
+    Shot_farm(unsigned int num_shots, const std::string& output_dir, unsigned int num_workers = 0);
+
+    unsigned int num_workers() const { return m_num_workers; }
+
+    // the seed of a shot only depends on its index
+    static uint64_t shot_seed(unsigned int shot);
+
+    // runs every shot in a child process forked from the calling one, and collects the results.
+    // Returns false, with the reason, as soon as a shot fails.
+    bool run(const Shot_fn& run_shot, std::string& error_msg);
+
+    const std::vector<Shot_result>& results() const { return m_results; }
+
+    // the number of shots per outcome
+    std::map<std::string, unsigned int> histogram(unsigned int num_qubits) const;
+
+    // writes shots.csv and histogram.csv into the output directory. Returns false if they cannot
+    // be written.
+    bool write_csv(unsigned int num_qubits) const;
+};
+
+}  // namespace cactus
+
+#endif  // _SHOT_FARM_H_
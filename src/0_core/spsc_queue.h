@@ -0,0 +1,95 @@
+/** spsc_queue.h
+ *
+ * This file defines a bounded queue between exactly one producer thread and one consumer thread.
+ * It needs no lock: the producer only writes the tail, the consumer only writes the head, and
+ * each reads the index of the other to tell whether the queue is full or empty.
+ *
+ * push() waits while the queue is full, and pop() while it is empty. They first yield, and then
+ * sleep briefly, so that a side which waits for long does not keep a core busy.
+ *
+ */
+
+#ifndef _SPSC_QUEUE_H_
+#define _SPSC_QUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cactus {
+
+// the number of times a waiting side yields before it sleeps
+#define SPSC_QUEUE_NUM_YIELDS 256
+
+template <typename T>
+class Spsc_queue {
+  private:
+    std::vector<T> m_slots;
+    size_t         m_mask;
+
+    // on separate cache lines, so that both sides do not invalidate the line of each other
+    alignas(64) std::atomic<size_t> m_head;  // the next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> m_tail;  // the next slot to push, written by the producer
+
+    static void backoff(unsigned int& num_waits) {
+        if (num_waits++ < SPSC_QUEUE_NUM_YIELDS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+  public:
+    // the capacity is rounded up to a power of 2
+    explicit Spsc_queue(size_t capacity)
+        : m_head(0)
+        , m_tail(0) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    Spsc_queue(const Spsc_queue&) = delete;
+    Spsc_queue& operator=(const Spsc_queue&) = delete;
+
+    size_t capacity() const { return m_slots.size(); }
+
+    // producer side. The item is moved into the queue only if there is room for it.
+    bool try_push(T& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) return false;
+
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T item) {
+        unsigned int num_waits = 0;
+        while (!try_push(item)) backoff(num_waits);
+    }
+
+    // consumer side
+    bool try_pop(T& item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        item = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void pop(T& item) {
+        unsigned int num_waits = 0;
+        while (!try_pop(item)) backoff(num_waits);
+    }
+};
+
+}  // namespace cactus
+
+#endif  // _SPSC_QUEUE_H_
@@ -7,7 +7,7 @@ namespace cactus {
 Telf_module::Telf_module(const sc_core::sc_module_name& n)
     : sc_core::sc_module(n) {
 
-    auto logger = get_logger_or_exit("telf_logger");
+    telf_logger = get_logger_or_exit("telf_logger");
 }
 
 Telf_module::~Telf_module() {}
@@ -30,6 +30,9 @@ class Telf_module : public sc_core::sc_module {
   protected:
     std::ofstream telf_os;
 
+    // kept for the methods called on every clock cycle
+    std::shared_ptr<spdlog::logger> telf_logger;
+
   public:  // methods for telf logging
     void open_telf_file();
 
@@ -0,0 +1,43 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cactus {
+
+Thread_pool::Thread_pool(unsigned int num_threads)
+    : m_num_threads(num_threads) {
+
+    if (m_num_threads == 0) m_num_threads = std::thread::hardware_concurrency();
+
+    // hardware_concurrency() may not be able to tell
+    if (m_num_threads == 0) m_num_threads = 1;
+}
+
+void Thread_pool::run(size_t num_tasks, const std::function<void(size_t)>& task) const {
+    size_t num_workers = std::min(static_cast<size_t>(m_num_threads), num_tasks);
+
+    if (num_workers <= 1) {
+        for (size_t i = 0; i < num_tasks; ++i) task(i);
+        return;
+    }
+
+    std::atomic<size_t> next_task(0);
+
+    auto worker = [&]() {
+        for (size_t i = next_task++; i < num_tasks; i = next_task++) task(i);
+    };
+
+    // the calling thread works as well
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers - 1);
+    for (size_t i = 1; i < num_workers; ++i) threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& t : threads) t.join();
+}
+
+}  // namespace cactus
@@ -0,0 +1,35 @@
+/** thread_pool.h
+ *
+ * This file defines a minimal pool of worker threads used to split long loading work (e.g.
+ * parsing a large eQASM program) over the cores of the host.
+ *
+ * The simulation itself stays single-threaded. The pool only lives for the duration of run().
+ *
+ */
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace cactus {
+
+class Thread_pool {
+  private:
+    unsigned int m_num_threads;
+
+  public:
+    // 0 uses one thread per core of the host
+    explicit Thread_pool(unsigned int num_threads = 0);
+
+    unsigned int num_threads() const { return m_num_threads; }
+
+    // call task(i) for every i in [0, num_tasks), and return when all of them are done. Tasks are
+    // handed out in order to the idle threads, so they must not depend on each other.
+    void run(size_t num_tasks, const std::function<void(size_t)>& task) const;
+};
+
+}  // namespace cactus
+
+#endif  // _THREAD_POOL_H_
@@ -3,6 +3,7 @@
 
 #include <systemc>
 
+#include "profiler.h"
 #include "q_data_type.h"
 namespace cactus {
 using sc_core::sc_in;
@@ -24,8 +25,9 @@ SC_MODULE(Operation_mux) {
     void do_work();
 
     SC_CTOR(Operation_mux) {
-        SC_THREAD(do_work);
+        SC_METHOD(do_work);
         sensitive << in_sel << in_op_left << in_op_right << in_valid;
+        dont_initialize();
     }
 };
 
@@ -43,8 +45,9 @@ SC_MODULE(Micro_operation_or) {
     SC_CTOR(Micro_operation_or) {
         in_u_ops.init(VLIW_WIDTH);
 
-        SC_THREAD(do_work);
+        SC_METHOD(do_work);
         sensitive << in_u_ops[0] << in_u_ops[1];
+        dont_initialize();
     }
 };
 
@@ -59,6 +62,7 @@ SC_MODULE(delay_elements) {
     inline void delay() {
         while (true) {
             wait();
+            Profile_process profile;
 
             delay_buffer[0].write(data_in.read());
             for (int i = 0; i < delay_cycles - 1; ++i) {
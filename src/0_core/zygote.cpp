@@ -0,0 +1,230 @@
+#include "zygote.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace cactus {
+
+// ============================================================================================
+// Run_request
+// ============================================================================================
+bool Run_request::parse(const std::string& line) {
+    std::stringstream ss(line);
+
+    program.clear();
+    data_mem_dump_fn.clear();
+
+    if (!(ss >> program) || program[0] == '#') return false;
+    ss >> data_mem_dump_fn;
+
+    return true;
+}
+
+// ============================================================================================
+// Zygote
+// ============================================================================================
+Zygote::Zygote(const std::string& output_dir, unsigned int num_workers)
+    : m_output_dir(output_dir)
+    , m_num_workers(num_workers) {
+
+    if (!m_output_dir.empty() && m_output_dir.back() != '/') m_output_dir += "/";
+
+    if (m_num_workers == 0) m_num_workers = std::thread::hardware_concurrency();
+
+    // hardware_concurrency() may not be able to tell
+    if (m_num_workers == 0) m_num_workers = 1;
+}
+
+std::string Zygote::run_log_fn(unsigned int run) const {
+    return m_output_dir + "run_" + std::to_string(run) + ".log";
+}
+
+#ifdef WIN32
+// ------------------------------------------------------------------
+//  Windows
+// ------------------------------------------------------------------
+void Zygote::run_in_child(const Run_fn& run, const Run_request& request,
+                          unsigned int index) const {}
+
+bool Zygote::serve(int requests_fd, std::ostream& report, const Run_fn& run,
+                   unsigned int& num_failed, std::string& error_msg) {
+    error_msg = "serving runs needs fork(), which Windows does not have";
+    return false;
+}
+
+#else
+// ------------------------------------------------------------------
+//  Non-Windows
+// ------------------------------------------------------------------
+void Zygote::run_in_child(const Run_fn& run, const Run_request& request,
+                          unsigned int index) const {
+
+    // the output of the run is only kept if it fails
+    int log_fd = open(run_log_fn(index).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log_fd >= 0) {
+        dup2(log_fd, STDOUT_FILENO);
+        dup2(log_fd, STDERR_FILENO);
+        close(log_fd);
+    }
+
+    int exit_code = run(request);
+
+    std::cout.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    // the warmed-up model belongs to the zygote, its destructors must not run here
+    _exit(exit_code);
+}
+
+bool Zygote::serve(int requests_fd, std::ostream& report, const Run_fn& run,
+                   unsigned int& num_failed, std::string& error_msg) {
+
+    typedef std::chrono::steady_clock Clock;
+
+    // the write end of the pipe of a run is only held by its child, so the read end sees the
+    // end of the file once the run has exited
+    struct Running {
+        unsigned int      index;
+        std::string       program;
+        Clock::time_point start;
+        int               exit_fd;
+    };
+
+    std::map<pid_t, Running> running;
+    unsigned int             num_runs = 0;
+    bool                     eof      = false;
+    std::string              pending;  // the requests read but not served yet
+
+    num_failed = 0;
+
+    // reports a run which has ended, and waits for its exit status
+    auto reap = [&](std::map<pid_t, Running>::iterator it) {
+        int status = 0;
+        while (waitpid(it->first, &status, 0) < 0 && errno == EINTR) {
+        }
+        close(it->second.exit_fd);
+
+        double seconds   = std::chrono::duration<double>(Clock::now() - it->second.start).count();
+        int    exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+        report << "run " << it->second.index << (exit_code == 0 ? " passed" : " failed")
+               << " (exit code " << exit_code << ") in " << std::fixed << std::setprecision(3)
+               << seconds << " s: " << it->second.program;
+        if (exit_code == 0) {
+            std::remove(run_log_fn(it->second.index).c_str());
+        } else {
+            report << ", see '" << run_log_fn(it->second.index) << "'";
+            num_failed++;
+        }
+        report << std::endl;
+
+        running.erase(it);
+    };
+
+    // the next complete request line, or the last one without a new line at the end
+    auto next_line = [&](std::string& line) {
+        size_t end = pending.find('\n');
+        if (end == std::string::npos) {
+            if (!eof || pending.empty()) return false;
+            end = pending.size();
+        }
+        line = pending.substr(0, end);
+        pending.erase(0, std::min(end + 1, pending.size()));
+        return true;
+    };
+
+    while (true) {
+        std::string line;
+        Run_request request;
+
+        if (running.size() < m_num_workers && next_line(line)) {
+            if (!request.parse(line)) continue;
+
+            int exit_pipe[2];
+            if (pipe(exit_pipe) != 0) {
+                error_msg = "cannot create a pipe for a run of '" + request.program + "'";
+                break;
+            }
+            // not kept by the processes the run may execute
+            fcntl(exit_pipe[1], F_SETFD, FD_CLOEXEC);
+
+            // anything still buffered would be written again by the child
+            report.flush();
+            std::cout.flush();
+            fflush(stdout);
+            fflush(stderr);
+
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(exit_pipe[0]);
+                close(exit_pipe[1]);
+                error_msg = "cannot fork a run of '" + request.program + "'";
+                break;
+            }
+            if (pid == 0) {
+                close(exit_pipe[0]);
+                run_in_child(run, request, num_runs);
+            }
+            close(exit_pipe[1]);
+
+            running[pid] = Running{num_runs, request.program, Clock::now(), exit_pipe[0]};
+            num_runs++;
+            continue;
+        }
+
+        if (eof && pending.empty() && running.empty()) return true;
+
+        // wait for the end of a run, or for more requests if a run can be started
+        std::vector<struct pollfd> poll_fds;
+        for (auto& entry : running) poll_fds.push_back({entry.second.exit_fd, POLLIN, 0});
+        bool read_requests = !eof && running.size() < m_num_workers;
+        if (read_requests) poll_fds.push_back({requests_fd, POLLIN, 0});
+
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            error_msg = "cannot wait for the runs and the requests";
+            break;
+        }
+
+        if (read_requests && poll_fds.back().revents != 0) {
+            char    buf[4096];
+            ssize_t n = read(requests_fd, buf, sizeof(buf));
+            if (n > 0) {
+                pending.append(buf, static_cast<size_t>(n));
+            } else if (n == 0 || errno != EINTR) {
+                eof = true;
+            }
+        }
+
+        auto it = running.begin();
+        for (size_t i = 0; it != running.end(); ++i) {
+            auto current = it++;
+            if (poll_fds[i].revents != 0) reap(current);
+        }
+    }
+
+    // the runs already started are still reported
+    while (!running.empty()) reap(running.begin());
+    return false;
+}
+
+#endif
+
+}  // namespace cactus
@@ -0,0 +1,69 @@
+/** zygote.h
+ *
+ * This file defines the serving of many short simulations from a single warmed-up process.
+ *
+ * Building the model, starting Python and importing QuantumSim, and reading the configuration
+ * files take seconds, which is most of the time of a short program. The zygote does this once,
+ * and then waits for run requests. Every request is served by a child process forked from the
+ * zygote, which shares the warmed-up model with it (copy-on-write), loads the program of the
+ * request and simulates it at once.
+ *
+ * A request is a line '<program> [<data memory dump file>]'. Empty lines and lines starting
+ * with '#' are skipped. The programs are of the kind the zygote was started with (asm, binary,
+ * or asm assembled in-process), since the model is built for it.
+ *
+ * Up to one run per core is served at a time. The zygote reports every run when it ends, on a
+ * line 'run <n> passed|failed (exit code <c>) in <t> s: <program>', also while it waits for the
+ * next request, e.g. on the standard input: it polls the requests together with a pipe of each
+ * run, which is closed when the run exits. The output of a run is kept
+ * in run_<n>.log in the output directory if it fails.
+ *
+ */
+
+#ifndef _ZYGOTE_H_
+#define _ZYGOTE_H_
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace cactus {
+
+class Run_request {
+  public:
+    std::string program;
+    std::string data_mem_dump_fn;
+
+  public:
+    // returns false if the line is not a request
+    bool parse(const std::string& line);
+};
+
+class Zygote {
+  public:
+    // runs a request in a child process, and returns its exit code
+    typedef std::function<int(const Run_request& request)> Run_fn;
+
+  private:
+    std::string  m_output_dir;
+    unsigned int m_num_workers;
+
+    std::string run_log_fn(unsigned int run) const;
+
+    void run_in_child(const Run_fn& run, const Run_request& request, unsigned int index) const;
+
+  public:
+    // 0 workers serves one run per core of the host at a time
+    Zygote(const std::string& output_dir, unsigned int num_workers = 0);
+
+    unsigned int num_workers() const { return m_num_workers; }
+
+    // serves the requests read from the file descriptor until its end, and reports the runs to
+    // the output stream. Returns false, with the reason, if the runs cannot be started.
+    bool serve(int requests_fd, std::ostream& report, const Run_fn& run, unsigned int& num_failed,
+               std::string& error_msg);
+};
+
+}  // namespace cactus
+
+#endif  // _ZYGOTE_H_
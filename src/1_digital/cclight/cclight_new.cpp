@@ -11,6 +11,8 @@ void CC_Light::config() {
 
 void CC_Light::init_mem_asm(std::string asm_fn) { classical_top.init_mem_asm(asm_fn); }
 
+void CC_Light::load_program() { classical_top.load_program(); }
+
 CC_Light::CC_Light(const sc_core::sc_module_name& n)
     : sc_core::sc_module(n)
     , classical_top("classical")
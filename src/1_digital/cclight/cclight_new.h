@@ -39,6 +39,9 @@ SC_MODULE(CC_Light) {
   public:
     void init_mem_asm(std::string asm_fn);
 
+    // see Icache_rtl::load_program()
+    void load_program();
+
   private:  // internal modules
     Classical_part       classical_top;
     Quantum_pipeline     quantum_top;
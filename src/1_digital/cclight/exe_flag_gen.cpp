@@ -2,6 +2,8 @@
 
 #include <vector>
 
+#include "profiler.h"
+
 namespace cactus {
 
 Fce_logic::Fce_logic(const sc_core::sc_module_name& n)
@@ -21,6 +23,7 @@ void Fce_logic::log_msmt_his() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (reset.read()) {
             for (size_t i = 0; i < msmt_res_his.size(); ++i) {
@@ -49,6 +52,7 @@ void Fce_logic::gen_exe_flag() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         exe_flag[0] = 1;
         exe_flag[1] = msmt_res_his[0].read();
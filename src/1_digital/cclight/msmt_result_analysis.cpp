@@ -1,6 +1,6 @@
 #include "msmt_result_analysis.h"
 
-#include <vector>
+#include "profiler.h"
 
 namespace cactus {
 
@@ -40,6 +40,7 @@ void Msmt_result_analysis::write_meas_cancel_fifo() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (meas_cancel_fifo.num_available() > MEAS_CANCEL_FIFO_DEPTH) {
             logger->error(
@@ -55,21 +56,15 @@ void Msmt_result_analysis::write_meas_cancel_fifo() {
 
 void Msmt_result_analysis::read_meas_cancel_fifo() {
 
-    std::vector<bool> vec_meas_cancel;
-    Generic_meas_if   meas;
+    // default output when fifo is empty
+    Generic_meas_if meas;
+    meas.set_meas_ena_cancel(Bit_set(m_num_qubits));
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (meas_cancel_fifo.num_available() == 0) {
-            // default output when fifo is empty
-            meas.reset();
-            vec_meas_cancel.clear();
-            for (size_t i = 0; i < m_num_qubits; ++i) {
-                vec_meas_cancel.push_back(false);
-            }
-
-            meas.set_meas_ena_cancel(vec_meas_cancel);
             out_Qp2MRF_meas_cancel.write(meas);
         } else {
             out_Qp2MRF_meas_cancel.write(meas_cancel_fifo.read());
@@ -83,6 +78,7 @@ void Msmt_result_analysis::write_meas_result_fifo() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (meas_result_fifo.num_available() > MEAS_RESULT_FIFO_DEPTH) {
             logger->error(
@@ -98,25 +94,16 @@ void Msmt_result_analysis::write_meas_result_fifo() {
 
 void Msmt_result_analysis::read_meas_result_fifo() {
 
-    std::vector<bool> vec_meas_data;
-    std::vector<bool> vec_meas_data_valid;
-    Generic_meas_if   meas;
+    // default output when fifo is empty
+    Generic_meas_if meas;
+    meas.set_meas_data(Bit_set(m_num_qubits));
+    meas.set_meas_data_valid(Bit_set(m_num_qubits));
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (meas_result_fifo.num_available() == 0) {
-            // default output when fifo is empty
-            meas.reset();
-            vec_meas_data.clear();
-            vec_meas_data_valid.clear();
-            for (size_t i = 0; i < m_num_qubits; ++i) {
-                vec_meas_data.push_back(false);
-                vec_meas_data_valid.push_back(false);
-            }
-
-            meas.set_meas_data(vec_meas_data);
-            meas.set_meas_data_valid(vec_meas_data_valid);
             out_Qm2MRF_meas_result.write(meas);
         } else {
             out_Qm2MRF_meas_result.write(meas_result_fifo.read());
@@ -60,10 +60,12 @@ class Valid_msmt_mask_gen : public sc_core::sc_module {
         SC_CTHREAD(msmt_result_gen, clock.pos());
         SC_CTHREAD(rising_edge_detect, clock.pos());
 
-        SC_THREAD(rising_edge_gen);
+        SC_METHOD(rising_edge_gen);
         sensitive << old_uhfqc_result_valid << uhfqc2dio;
-        SC_THREAD(drive_output);
+        dont_initialize();
+        SC_METHOD(drive_output);
         sensitive << i_read_enable;
+        dont_initialize();
     }
 };
 
@@ -144,23 +146,15 @@ inline void Valid_msmt_mask_gen<g_num_meas_qubits>::rising_edge_detect() {
 
 template <int g_num_meas_qubits>
 inline void Valid_msmt_mask_gen<g_num_meas_qubits>::rising_edge_gen() {
-    while (true) {
-        wait();
-
-        if (!old_uhfqc_result_valid.read() && uhfqc2dio.read()[g_num_meas_qubits])
-            uhfqc_result_valid_re.write(1);
-        else
-            uhfqc_result_valid_re.write(0);
-    }
+    if (!old_uhfqc_result_valid.read() && uhfqc2dio.read()[g_num_meas_qubits])
+        uhfqc_result_valid_re.write(1);
+    else
+        uhfqc_result_valid_re.write(0);
 }
 
 template <int g_num_meas_qubits>
 inline void Valid_msmt_mask_gen<g_num_meas_qubits>::drive_output() {
-    while (true) {
-        wait();
-
-        read_enable.write(i_read_enable.read());
-    }
+    read_enable.write(i_read_enable.read());
 }
 
 }  // namespace cactus
@@ -18,7 +18,7 @@ using sc_core::sc_vector;
 using sc_dt::sc_int;
 using sc_dt::sc_uint;
 
-class Classical_decode : public Telf_module {
+class Classical_decode : public Telf_module, public Idle_skippable {
   public:
     sc_in<bool> clock;
     // this signal indicates the signal_initiate process, which initiate relevant signals
@@ -112,12 +112,25 @@ class Classical_decode : public Telf_module {
     void fmr_interlocking_logic();
     void hazard_detection();
 
-    void clock_counter();
+    void stall_tracking();
     void write_insn_file();
 
+  protected:  // the last valid instruction seen by decode_stage and br_start
+    Qasm_instruction      m_decoded_insn;
+    sc_uint<OPCODE_WIDTH> m_decoded_opcode;
+    Qasm_instruction      m_br_insn;
+
   public:  // member variables
     unsigned int m_num_qubits = 0;
-    int          m_num_cycles = 0;
+    Clock_cycles m_clock_cycles{clock};  // the cycle numbers of the telf log
+
+    // the pipeline is stalled by anything but a load-use hazard, since the given rising edge
+    bool     m_stalled           = false;
+    uint64_t m_stall_start_edges = 0;
+
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
 
   public:  // member function
     void config();
@@ -108,8 +108,8 @@ class Classical_execute : public Telf_module {
   protected:  // methods
     void de2ex_ff();
     void write_to_qp();
+    void init_flags();
     void execution();
-    void clock_counter();
     void write_insn_file();
 
   public:  // member function
@@ -118,7 +118,7 @@ class Classical_execute : public Telf_module {
 
   public:  // member variables
     unsigned int m_num_qubits = 0;
-    int          m_num_cycles = 0;
+    Clock_cycles m_clock_cycles{clock};  // the cycle numbers of the telf log
 
   public:
     Classical_execute(const sc_core::sc_module_name& n);
@@ -1,6 +1,7 @@
 #include "classical_mem.h"
 
 #include "num_util.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -13,7 +14,7 @@ void Classical_mem::config() {
     m_data_mem      = global_config.data_memory;
     m_data_mem_size = m_data_mem->get_mem_size();
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "classical_mem");
 };
 
@@ -36,10 +37,9 @@ Classical_mem::Classical_mem(const sc_core::sc_module_name& n)
     // write to memory
     SC_CTHREAD(write_mem, clock.pos());
     // sign extend
-    SC_THREAD(sign_extend);
+    SC_METHOD(sign_extend);
     sensitive << mem_sext << mem_addr_sel << mem_out_data;
-
-    SC_CTHREAD(clock_counter, clock.pos());
+    dont_initialize();
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -49,6 +49,7 @@ Classical_mem::~Classical_mem() { close_telf_file(); }
 void Classical_mem::ex2mem_ff() {
     while (true) {
         wait();
+        Profile_process profile;
 
         mem_insn.write(ex_insn.read());
         mem_ex_rd_value.write(ex_rd_value.read());
@@ -77,6 +78,7 @@ void Classical_mem::read_mem() {
     std::string  addr_sel_for_log;
     while (true) {
         wait();
+        Profile_process profile;
 
         if (ex_run.read() && ex_mem_strobe.read() && ex_mem_rw.read()) {
 
@@ -231,7 +233,8 @@ void Classical_mem::read_mem() {
             if (is_telf_on) {
                 telf_os << std::setfill(' ') << std::setw(15)
                         << sc_core::sc_time_stamp().to_string();
-                telf_os << " " << std::setfill(' ') << std::setw(11) << std::dec << m_num_cycles;
+                telf_os << " " << std::setfill(' ') << std::setw(11) << std::dec
+                        << m_clock_cycles.num_cycles();
                 telf_os << " " << std::setfill(' ') << std::setw(3) << "r";
                 telf_os << " " << std::setfill(' ') << std::setw(10) << addr_sel_for_log;
                 telf_os << " " << std::setfill('0') << std::setw(8) << std::hex << read_addr;
@@ -255,6 +258,7 @@ void Classical_mem::write_mem() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         // store instr
         if (ex_run.read() && ex_mem_strobe.read() && !ex_mem_rw.read()) {
@@ -441,7 +445,8 @@ void Classical_mem::write_mem() {
             if (is_telf_on) {
                 telf_os << std::setfill(' ') << std::setw(15)
                         << sc_core::sc_time_stamp().to_string();
-                telf_os << " " << std::setfill(' ') << std::setw(11) << std::dec << m_num_cycles;
+                telf_os << " " << std::setfill(' ') << std::setw(11) << std::dec
+                        << m_clock_cycles.num_cycles();
                 telf_os << " " << std::setfill(' ') << std::setw(3) << "w";
                 telf_os << " " << std::setfill(' ') << std::setw(10) << addr_sel_for_log;
                 telf_os << " " << std::setfill('0') << std::setw(8) << std::hex << write_addr;
@@ -453,54 +458,43 @@ void Classical_mem::write_mem() {
 }
 
 void Classical_mem::sign_extend() {
-    auto logger = get_logger_or_exit("console");
-
-    sc_int<32> data;
-
-    while (true) {
-        wait();
-
-        /* sign extend :  The value of the left-most bit of the data (bit 15 or bit 7) is copied
-         * to all bits to the left (into the high-order bits) */
-        /* non sign extend: 0 is copied to all bits to the left (into the high-order bits)*/
-        switch (mem_addr_sel.read()) {
-            case ADDR_BYTE:  // byte access
-                if (mem_sext.read() && (mem_out_data.read() & 0x80)) {
-                    // sign value and copy 1 to the left bits
-                    mem_rd_value.write(mem_out_data.read() | 0xffffff00);
-                } else {
-                    mem_rd_value.write(mem_out_data.read().to_uint());
-                }
-                break;
-            case ADDR_HALF_WORD:  // half word access
-                if (mem_sext.read() && (mem_out_data.read() & 0x8000)) {
-                    // sign value and copy 1 to the left bits
-                    mem_rd_value.write(mem_out_data.read() | 0xffff0000);
-                } else {
-                    mem_rd_value.write(mem_out_data.read().to_uint());
-                }
-                break;
-            case ADDR_WORD:  // word access
+    Profile_process profile;
+
+    /* sign extend :  The value of the left-most bit of the data (bit 15 or bit 7) is copied
+     * to all bits to the left (into the high-order bits) */
+    /* non sign extend: 0 is copied to all bits to the left (into the high-order bits)*/
+    switch (mem_addr_sel.read()) {
+        case ADDR_BYTE:  // byte access
+            if (mem_sext.read() && (mem_out_data.read() & 0x80)) {
+                // sign value and copy 1 to the left bits
+                mem_rd_value.write(mem_out_data.read() | 0xffffff00);
+            } else {
                 mem_rd_value.write(mem_out_data.read().to_uint());
-                break;
-            default:
-                logger->error(
-                  "{}: Unrecognized memory access type. Support types: byte, half word, word. "
-                  "Simulation aborts!",
-                  this->name());
-                exit(EXIT_FAILURE);
-                break;
+            }
+            break;
+        case ADDR_HALF_WORD:  // half word access
+            if (mem_sext.read() && (mem_out_data.read() & 0x8000)) {
+                // sign value and copy 1 to the left bits
+                mem_rd_value.write(mem_out_data.read() | 0xffff0000);
+            } else {
+                mem_rd_value.write(mem_out_data.read().to_uint());
+            }
+            break;
+        case ADDR_WORD:  // word access
+            mem_rd_value.write(mem_out_data.read().to_uint());
+            break;
+        default: {
+            auto logger = get_logger_or_exit("console");
+            logger->error(
+              "{}: Unrecognized memory access type. Support types: byte, half word, word. "
+              "Simulation aborts!",
+              this->name());
+            exit(EXIT_FAILURE);
+            break;
         }
     }
 }
 
-void Classical_mem::clock_counter() {
-    while (true) {
-        wait();
-        m_num_cycles++;
-    }
-}
-
 void Classical_mem::add_telf_header() {
     // Specify the signal type
     telf_os << "#memory access" << std::endl;
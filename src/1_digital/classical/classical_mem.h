@@ -66,7 +66,6 @@ class Classical_mem : public Telf_module {
     void write_mem();
     void read_mem();
     void sign_extend();
-    void clock_counter();
 
   public:  // member function
     void config();
@@ -75,8 +74,8 @@ class Classical_mem : public Telf_module {
   public:  // member variables
     std::string  m_output_dir;
     unsigned int m_data_mem_size = 0;
-    int          m_num_cycles    = 0;
     Data_memory* m_data_mem;
+    Clock_cycles m_clock_cycles{clock};  // the cycle numbers of the telf log
 
   public:
     Classical_mem(const sc_core::sc_module_name& n);
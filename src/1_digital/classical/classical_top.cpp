@@ -11,6 +11,8 @@ void Classical_part::config() {
 
 void Classical_part::init_mem_asm(std::string asm_fn) { icache.init_mem_asm(asm_fn); }
 
+void Classical_part::load_program() { icache.load_program(); }
+
 Classical_part::Classical_part(const sc_core::sc_module_name& n)
     : sc_core::sc_module(n)
     , classical_pipeline("Classical_pipeline")
@@ -47,6 +47,9 @@ SC_MODULE(Classical_part) {
   public:
     void init_mem_asm(std::string asm_fn);
 
+    // see Icache_rtl::load_program()
+    void load_program();
+
   protected:  // sub-modules
     Classical_pipeline classical_pipeline;
     Meas_reg_file      meas_reg_file;
@@ -1,6 +1,7 @@
 #include "classical_wb.h"
 
 #include "num_util.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -9,7 +10,7 @@ void Classical_wb::config() {
     Global_config& global_config = Global_config::get_instance();
 
     m_output_dir = global_config.output_dir;
-    is_telf_on   = true;
+    is_telf_on   = global_config.telf_on;
     telf_fn      = sep_telf_fn(global_config.output_dir, this->name(), "classical_wb");
 };
 
@@ -26,10 +27,9 @@ Classical_wb::Classical_wb(const sc_core::sc_module_name& n)
 
     // writeback stage
     SC_CTHREAD(mem2wb_ff, clock.pos());
-    SC_THREAD(write_reg_file);
+    SC_METHOD(write_reg_file);
     sensitive << wb_wr_rd_en << wb_rd_addr << wb_rd_value << init;
-
-    SC_CTHREAD(clock_counter, clock.pos());
+    dont_initialize();
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -39,6 +39,7 @@ Classical_wb::~Classical_wb() { close_telf_file(); }
 void Classical_wb::mem2wb_ff() {
     while (true) {
         wait();
+        Profile_process profile;
 
         wb_insn.write(mem_insn.read());
         wb_wr_rd_en.write(mem_wr_rd_en.read());
@@ -54,43 +55,35 @@ void Classical_wb::mem2wb_ff() {
 }
 
 void Classical_wb::write_reg_file() {
+    Profile_process profile;
 
-    while (true) {
-        wait();
-
-        // initial register file
-        if (init.read()) {
-            for (size_t i = 0; i < REG_FILE_WIDTH; ++i) {
-                reg_file[i] = 0;
-            }
+    // initial register file, with the values reached by the fast-forward engine if it has run
+    if (init.read()) {
+        const Arch_state& ff_state = Global_config::get_instance().ff_state;
+        for (size_t i = 0; i < REG_FILE_NUM; ++i) {
+            reg_file[i] = ff_state.valid ? ff_state.regs[i] : 0;
         }
+    }
 
-        // write back register
-        if (wb_run) {
-            if (wb_wr_rd_en) {
-                reg_file[static_cast<size_t>(wb_rd_addr.read())] = wb_rd_value.read();
-
-                // Write the text output
-                if (is_telf_on) {
-                    telf_os << std::setfill(' ') << std::setw(15)
-                            << sc_core::sc_time_stamp().to_string();
-                    telf_os << ",    " << std::setfill(' ') << std::setw(11) << m_num_cycles;
-                    telf_os << ",    " << std::setfill(' ') << std::setw(13) << wb_rd_addr.read();
-                    telf_os << ",    " << std::setfill(' ') << std::setw(14) << wb_rd_value.read();
-                    telf_os << std::endl;
-                }
+    // write back register
+    if (wb_run) {
+        if (wb_wr_rd_en) {
+            reg_file[static_cast<size_t>(wb_rd_addr.read())] = wb_rd_value.read();
+
+            // Write the text output
+            if (is_telf_on) {
+                telf_os << std::setfill(' ') << std::setw(15)
+                        << sc_core::sc_time_stamp().to_string();
+                telf_os << ",    " << std::setfill(' ') << std::setw(11)
+                        << m_clock_cycles.num_cycles();
+                telf_os << ",    " << std::setfill(' ') << std::setw(13) << wb_rd_addr.read();
+                telf_os << ",    " << std::setfill(' ') << std::setw(14) << wb_rd_value.read();
+                telf_os << std::endl;
             }
         }
     }
 }
 
-void Classical_wb::clock_counter() {
-    while (true) {
-        wait();
-        m_num_cycles++;
-    }
-}
-
 void Classical_wb::add_telf_header() {
 
     // Specify the signal type
@@ -46,15 +46,14 @@ class Classical_wb : public Telf_module {
   protected:  // methods
     void mem2wb_ff();
     void write_reg_file();
-    void clock_counter();
 
   public:  // member function
     void config();
     void add_telf_header();
 
   public:  // member variables
-    std::string m_output_dir;
-    int         m_num_cycles = 0;
+    std::string  m_output_dir;
+    Clock_cycles m_clock_cycles{clock};  // the cycle numbers of the telf log
 
   public:
     Classical_wb(const sc_core::sc_module_name& n);
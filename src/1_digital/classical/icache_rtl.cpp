@@ -1,15 +1,29 @@
 ﻿#include "icache_rtl.h"
 
-#include <fstream>
+#include <algorithm>
 #include <iomanip>
-#include <regex>  //regular expression
 #include <sstream>
 #include <systemc>
 
 #include "logger_wrapper.h"
+#include "profiler.h"
 
 namespace cactus {
 
+void Icache_rtl::load_program() {
+    Global_config& global_config = Global_config::get_instance();
+
+    if (m_instruction_type == Instruction_type::BIN) {
+        if (global_config.assemble_bin) {
+            assemble_mem_bin(global_config.qisa_asm_fn);
+        } else {
+            init_mem_bin(global_config.qisa_bin_fn);
+        }
+    } else {
+        init_mem_asm(global_config.qisa_asm_fn);
+    }
+}
+
 void Icache_rtl::init_mem_bin(std::string qisa_bin_fn) {
 
     auto logger = get_logger_or_exit("cache_logger");
@@ -17,238 +31,245 @@ void Icache_rtl::init_mem_bin(std::string qisa_bin_fn) {
     logger->trace("{}: Initializing the ICACHE with the binary file: '{}'.", this->name(),
                   qisa_bin_fn);
 
-    cache_mem_bin.clear();
-    cache_mem_bin.resize(CACHE_SIZE);
-
-    std::ifstream qisa_file;
-
-    qisa_file.open(qisa_bin_fn, std::ios::binary);
-
-    if (!qisa_file) {
+    // the file is mapped rather than read. Pages are only loaded when instructions are fetched.
+    if (!cache_mem_bin.open(qisa_bin_fn)) {
         logger->error("{}: Failed to open file: '{}'. Simulation aborts!", this->name(),
                       qisa_bin_fn);
         exit(EXIT_FAILURE);
     }
-    logger->debug("{}: Successfully opened the file '{}'.", this->name(), qisa_bin_fn);
+    logger->debug("{}: Successfully mapped the file '{}' (size: {}).", this->name(), qisa_bin_fn,
+                  cache_mem_bin.size());
+
+    load_bin_program(cache_mem_bin.size() / 4);
+}
 
-    qisa_file.seekg(0, qisa_file.end);
-    unsigned int length = static_cast<unsigned int>(qisa_file.tellg());
+void Icache_rtl::assemble_mem_bin(std::string qisa_asm_fn) {
+    auto           logger        = get_logger_or_exit("cache_logger");
+    Global_config& global_config = Global_config::get_instance();
 
-    if (length / 4 > CACHE_SIZE) {
+    logger->trace("{}: Initializing the ICACHE with the asm file '{}' assembled in-process.",
+                  this->name(), qisa_asm_fn);
+
+    // quantum operations are encoded with the opcodes the simulation decodes
+    Eqasm_assembler assembler;
+    assembler.set_q_opcodes(global_config.opcode_to_opname_lut);
+    assembler.declare_gates();
+    assembler.assemble(qisa_asm_fn, assembled_bin, global_config.num_load_threads, true);
+
+    load_bin_program(assembled_bin.size());
+}
+
+void Icache_rtl::load_bin_program(size_t num_words) {
+    auto logger = get_logger_or_exit("cache_logger");
+
+    if (num_words >= (1ULL << MEMORY_ADDRESS_WIDTH)) {
         logger->error(
-          "{}: The size of the input program ({}) exceeds the cache size ({}). "
+          "{}: The size of the input program ({}) exceeds the address space ({}). "
           "Simulation aborts!",
-          this->name(), length / 4, CACHE_SIZE);
+          this->name(), num_words, 1ULL << MEMORY_ADDRESS_WIDTH);
         exit(EXIT_FAILURE);
     }
-    logger->debug(
-      "{}: The size of the input program ({}) does not exceed the"
-      " cache size ({}).",
-      this->name(), length / 4, CACHE_SIZE);
 
-    program_length = length / 4;
+    program_length = static_cast<unsigned int>(num_words);
+
+    // dumping every instruction is only affordable when it is really asked for
+    if (logger->should_log(spdlog::level::debug)) {
+        std::stringstream ss;
+
+        ss.str("");
+        for (unsigned int i = 0; i < program_length; ++i) {
+            ss << "0x" << std::setfill('0') << std::setw(8) << std::hex << read_bin_word(i)
+               << "  ";
+
+            if ((i + 1) % 8 == 0) {
+                ss << std::endl;
+            }
+        }
+
+        logger->debug("{}: Instructions of the program:\n{}", this->name(), ss.str());
+    }
 
-    qisa_file.seekg(0, qisa_file.beg);
+    logger->trace("{}: Successfully read the binary qisa program, which has {} instructions.",
+                  this->name(), program_length);
 
-    // every instruction is 32 bits. The additional 4 is a slight larger space to avoid bug.
-    char* buffer = new char[CACHE_SIZE * 4 + 4];
+    decode_program();
+}
 
-    qisa_file.read(buffer, length);
+void Icache_rtl::init_mem_asm(std::string qisa_asm_fn) {
+    auto           logger        = get_logger_or_exit("cache_logger");
+    Global_config& global_config = Global_config::get_instance();
 
-    logger->debug("{}: Successfully read the binary file into the buffer (size: {}).", this->name(),
-                  length);
-    unsigned int cur_insn;
+    logger->trace("{}: Initializing the ICACHE with the asm file: '{}'.", this->name(),
+                  qisa_asm_fn);
 
-    std::stringstream ss;
+    cache_mem_decoded.clear();  // refers to the old program image
+
+    // the program decoded by an earlier run from the same inputs
+    std::string cache_fn;
+    if (global_config.use_cache) {
+        Content_hash key;
+        if (program_cache_key(qisa_asm_fn, key)) {
+            create_dir_if_not_exist(global_config.cache_dir());
+            cache_fn = cache_file_name(global_config.cache_dir(), "program", key);
+
+            if (restore_program(cache_fn)) {
+                logger->trace("{}: Read the decoded program ({} instructions) from the cache file "
+                              "'{}'.",
+                              this->name(), asm_program.lines.size() - 1, cache_fn);
+                return;
+            }
+        }
+    }
 
-    ss.str("");
-    for (size_t i = 0; i < length; i = i + 4) {
-        cur_insn = (buffer[i] & 0xFF) + ((buffer[i + 1] << 8) & 0xFF00) +
-                   ((buffer[i + 2] << 16) & 0xFF0000) + ((buffer[i + 3] << 24) & 0xFF000000);
+    asm_program.load(qisa_asm_fn, global_config.num_load_threads);
 
-        cache_mem_bin[i / 4] = cur_insn;
+    logger->trace("{}: Successfully read the asm qisa program, which has {} instructions.",
+                  this->name(), asm_program.lines.size() - 1);
 
-        ss << "0x" << std::setfill('0') << std::setw(8) << std::hex << cur_insn << "  ";
+    decode_program();
 
-        if ((i + 4) % 32 == 0) {
-            ss << std::endl;
+    if (!cache_fn.empty()) {
+        Cache_writer writer;
+        asm_program.save(writer);
+        writer.put_array(cache_mem_decoded.data(), cache_mem_decoded.size());
+        if (!writer.commit(cache_fn, "program")) {
+            logger->warn("{}: Failed to write the cache file '{}'.", this->name(), cache_fn);
         }
     }
-    delete[] buffer;
+}
 
-    logger->debug("{}: Instructions read from the file:\n{}", this->name(), ss.str());
+// the decoded program depends on the program text, and on the configuration used to check the
+// operations and the qubits
+bool Icache_rtl::program_cache_key(const std::string& qisa_asm_fn, Content_hash& key) {
+    Global_config& global_config = Global_config::get_instance();
 
-    logger->trace("{}: Successfully read the binary qisa program, which has {} instructions.",
-                  this->name(), length / 4);
+    Cache_writer config;
+    config.put(global_config.num_qubits);
+    config.put(global_config.single_qubit_gate_time);
+    config.put(global_config.two_qubit_gate_time);
 
-    qisa_file.close();
+    key.add_pod(CACHE_FORMAT_VERSION);
+    key.add_pod(sizeof(Qasm_instruction));
+    key.add(config.data());
+    return key.add_file(qisa_asm_fn);
 }
 
-unsigned int Icache_rtl::convert_line_to_ele_instr(std::vector<std::vector<std::string>>& vec_instr,
-                                                   std::string&                           line_str,
-                                                   const std::string& line_num_str) {
-    std::vector<std::string> instr_info;
-    std::string              bne_content = "";
-    std::string              br_label    = "";
-    std::string              br_cond     = "";
-
-    // find macro bne,beq
-    trim(line_str);
-    std::regex pattern_bne("bne", std::regex_constants::icase);
-    std::regex pattern_beq("beq", std::regex_constants::icase);
-    if (std::regex_search(line_str, pattern_bne)) {
-        br_cond = "ne";
-    } else if (std::regex_search(line_str, pattern_beq)) {
-        br_cond = "eq";
-    } else {
-        // not beq or bne
-        instr_info.push_back(line_str);
-        instr_info.push_back(line_num_str);
-        instr_info.push_back(line_str);
-        vec_instr.push_back(instr_info);
-        return 1;
-    }
+bool Icache_rtl::restore_program(const std::string& cache_fn) {
+    Cache_reader reader;
+    if (!reader.open(cache_fn, "program") || !asm_program.restore(reader)) return false;
 
-    size_t start = line_str.find_first_of(" ");
-    if (start != line_str.npos) {
-        bne_content = line_str.substr(start);
+    reader.get_array(cache_mem_decoded);
+    if (!reader.at_end() || cache_mem_decoded.size() != asm_program.lines.size()) {
+        asm_program.clear();
+        cache_mem_decoded.clear();
+        return false;
     }
-    size_t end = bne_content.find_last_of(",");
-    if (end != bne_content.npos) {
-        br_label = bne_content.substr(end);
-        bne_content.erase(end);
+
+    // the cached instructions still point into the program image of the run that wrote them
+    for (size_t i = 0; i < cache_mem_decoded.size(); ++i) {
+        cache_mem_decoded[i].rebind(asm_program.text, asm_program.lines[i]);
     }
-    // push back cmp
-    instr_info.push_back("cmp " + bne_content);
-    instr_info.push_back(line_num_str);
-    instr_info.push_back(line_str);
-    vec_instr.push_back(instr_info);
-
-    // push back nop
-    instr_info.clear();
-    instr_info.push_back("nop");
-    instr_info.push_back(line_num_str);
-    instr_info.push_back(line_str);
-    vec_instr.push_back(instr_info);
-
-    // push back br
-    instr_info.clear();
-    instr_info.push_back("br " + br_cond + br_label);
-    instr_info.push_back(line_num_str);
-    instr_info.push_back(line_str);
-    vec_instr.push_back(instr_info);
-    return 3;
+    return true;
 }
 
-void Icache_rtl::init_mem_asm(std::string qisa_asm_fn) {
+void Icache_rtl::decode_program() {
     auto logger = get_logger_or_exit("cache_logger");
 
-    logger->trace("{}: Initializing the ICACHE with the asm file: '{}'.", this->name(),
-                  qisa_asm_fn);
+    cache_mem_decoded.clear();
+    decoded_blocks.clear();
 
-    cache_mem_asm.clear();
+    if (m_instruction_type == Instruction_type::BIN) {
+        // decoding is deferred to the first fetch of each block
+        decoded_blocks.resize((static_cast<size_t>(program_length) + ICACHE_DECODE_BLOCK - 1) /
+                              ICACHE_DECODE_BLOCK);
 
-    std::ifstream qisa_file;
-    qisa_file.open(qisa_asm_fn);
-    if (!qisa_file) {
-        logger->error("{}: Failed to open file: '{}'. Simulation aborts!", this->name(),
-                      qisa_asm_fn);
-        exit(EXIT_FAILURE);
+        // what the memory returns beyond the program
+        bin_padding_insn.set_instruction(0u, program_length);
+
+        logger->trace("{}: Indexed {} instructions in {} blocks.", this->name(), program_length,
+                      decoded_blocks.size());
+    } else {
+        // labels are only complete after the whole file has been read
+        asm_program.decode(cache_mem_decoded, Global_config::get_instance().num_load_threads);
+
+        logger->trace("{}: Decoded {} instructions.", this->name(), cache_mem_decoded.size());
     }
-    logger->debug("{}: Successfully opened the file '{}'.", this->name(), qisa_asm_fn);
+}
 
-    unsigned int count = 0;
-    std::string  insn;
-    unsigned int line_num = 1;
-    std::string  line_num_str;
+unsigned int Icache_rtl::read_bin_word(unsigned int addr) const {
+    if (!assembled_bin.empty()) return assembled_bin[addr];
 
-    while (getline(qisa_file, insn)) {
+    // instructions are stored little endian
+    const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(cache_mem_bin.data()) + static_cast<size_t>(addr) * 4;
 
-        // remove comments which indicate by first char '#'
-        line_num_str = to_string(line_num++);
-        trim_comments(insn);
+    return static_cast<unsigned int>(p[0]) | (static_cast<unsigned int>(p[1]) << 8) |
+           (static_cast<unsigned int>(p[2]) << 16) | (static_cast<unsigned int>(p[3]) << 24);
+}
 
-        // ex: "label: add r1,r2,r3"
-        if (insn.find(":") != insn.npos) {
-            std::vector<std::string> sub_parts;
-            sub_parts = split(insn, ':');
+void Icache_rtl::decode_bin_block(size_t block) {
+    size_t first = block * ICACHE_DECODE_BLOCK;
+    size_t last  = std::min(first + ICACHE_DECODE_BLOCK, static_cast<size_t>(program_length));
 
-            std::string label = trim(sub_parts[0]);
-            map_label.insert(std::make_pair(label, count));
+    std::vector<Qasm_instruction>& insns = decoded_blocks[block];
+    insns.resize(last - first);
+    for (size_t addr = first; addr < last; ++addr) {
+        unsigned int insn_addr = static_cast<unsigned int>(addr);
+        insns[addr - first].set_instruction(read_bin_word(insn_addr), insn_addr);
+    }
+}
 
-            std::regex pattern("[0-9a-zA-Z]+");
-            if ((sub_parts.size() == 2) && std::regex_search(sub_parts[1], pattern)) {
-                // cache_mem_asm.push_back(trim(sub_parts[1]));
-                // count++;
-                count += convert_line_to_ele_instr(cache_mem_asm, sub_parts[1], line_num_str);
-            }
-        } else {
-            // ex："add r1,r2,r3"
-            std::regex pattern("[0-9a-zA-Z]+");
-            if (std::regex_search(insn, pattern)) {
-                // cache_mem_asm.push_back(trim(insn));
-                // count++;
-                count += convert_line_to_ele_instr(cache_mem_asm, insn, line_num_str);
-            }
-        }
+const Qasm_instruction& Icache_rtl::fetch_decoded(unsigned int addr) {
+    if (m_instruction_type != Instruction_type::BIN) {
+        if (addr >= cache_mem_decoded.size()) return cache_mem_decoded.back();
+        return cache_mem_decoded[addr];
     }
 
-    std::vector<std::string> stop_instr;
-    stop_instr.push_back("stop");
-    stop_instr.push_back(to_string(line_num++));
-    stop_instr.push_back("stop");
-    cache_mem_asm.push_back(stop_instr);  // add extra stop instructions at the end
+    if (addr >= program_length) return bin_padding_insn;
 
-    logger->trace("{}: Successfully read the asm qisa program, which has {} instructions.",
-                  this->name(), count);
+    size_t block = addr / ICACHE_DECODE_BLOCK;
+    if (decoded_blocks[block].empty()) decode_bin_block(block);
 
-    qisa_file.close();
+    return decoded_blocks[block][addr % ICACHE_DECODE_BLOCK];
 }
 
 void Icache_rtl::combinational_gen() {
-    auto logger = get_logger_or_exit("cache_logger");
+    Profile_process profile;
 
-    while (true) {
-        wait();
-
-        if (Clp2Ic_branching.read() && Clp2Ic_ready.read()) {
-            // logger->debug("Clp2Ic_branching is 1. Jump. Target: {}.",
-            // static_cast<unsigned int>(Clp2Ic_target.read()));
-            pc = Clp2Ic_target.read();
-            branch.write(1);
-        } else {
-            // logger->debug("No jump. Next PC: {}.",
-            // static_cast<unsigned int>(pcc.read()));
-            pc = pcc.read();
-            branch.write(branchc.read());
-        }
+    if (Clp2Ic_branching.read() && Clp2Ic_ready.read()) {
+        // logger->debug("Clp2Ic_branching is 1. Jump. Target: {}.",
+        // static_cast<unsigned int>(Clp2Ic_target.read()));
+        pc = Clp2Ic_target.read();
+        branch.write(1);
+    } else {
+        // logger->debug("No jump. Next PC: {}.",
+        // static_cast<unsigned int>(pcc.read()));
+        pc = pcc.read();
+        branch.write(branchc.read());
+    }
 
-        if (readya.read()) {
-            pcb = pca.read() + 1;
-            // logger->debug("ReadyA is 1. PC_B: {}.", static_cast<unsigned int>(pcb.read()));
-            branchb.write(0);
-        } else {
-            pcb = pca.read();
-            // logger->debug("ReadyA is 0. PC_B: {}.", static_cast<unsigned int>(pcb.read()));
-            branchb = brancha.read();
-        }
+    if (readya.read()) {
+        pcb = pca.read() + 1;
+        // logger->debug("ReadyA is 1. PC_B: {}.", static_cast<unsigned int>(pcb.read()));
+        branchb.write(0);
+    } else {
+        pcb = pca.read();
+        // logger->debug("ReadyA is 0. PC_B: {}.", static_cast<unsigned int>(pcb.read()));
+        branchb = brancha.read();
     }
 }
 
 void Icache_rtl::register_right() {
-    auto logger = get_logger_or_exit("cache_logger");
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        // logger->debug("Called the function register_right().");
+    // logger->debug("Called the function register_right().");
 
-        if (G_PC_REGISTER > 0) {
-            pca     = pc.read();
-            brancha = branch.read();
-            // logger->debug("Read readya: {} with G_PC_REGISTER > 0.",
-            //     static_cast<unsigned int>(Clp2Ic_ready.read()));
-            readya = Clp2Ic_ready.read();
-        }
+    if (G_PC_REGISTER > 0) {
+        pca     = pc.read();
+        brancha = branch.read();
+        // logger->debug("Read readya: {} with G_PC_REGISTER > 0.",
+        //     static_cast<unsigned int>(Clp2Ic_ready.read()));
+        readya = Clp2Ic_ready.read();
     }
 }
 
@@ -257,6 +278,7 @@ void Icache_rtl::register_left_logic() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         // logger->debug("Called the function register_left_logic().");
 
@@ -277,6 +299,7 @@ void Icache_rtl::register_left_logic() {
 void Icache_rtl::register_right_logic() {
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_PC_REGISTER > 0) {
             pcc     = pcb.read();
@@ -292,6 +315,7 @@ void Icache_rtl::register_right_logic() {
 void Icache_rtl::register_at_memory_pipeline() {
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_PC_REGISTER == 2) {
             if (Clp2Ic_ready.read()) {
@@ -306,13 +330,11 @@ void Icache_rtl::register_at_memory_pipeline() {
 }
 
 void Icache_rtl::no_register_memory_pipeline() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_PC_REGISTER < 2) {
-            pc_reg_a     = pc.read();
-            branch_reg_a = branch.read();
-        }
+    if (G_PC_REGISTER < 2) {
+        pc_reg_a     = pc.read();
+        branch_reg_a = branch.read();
     }
 }
 
@@ -325,22 +347,15 @@ void Icache_rtl::read_insn() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         // the Branch signal needs to go to the processor one transfer earlier than the instruction
         // signal.
         if (Clp2Ic_ready.read()) {
             cache_pc = pc_reg_a.read().to_uint();
             logger->debug("{}: trying to read. PC to read: 0x{:08x}", this->name(), cache_pc);
-            if (m_instruction_type == Instruction_type::BIN) {
-                v_insn.set_instruction(cache_mem_bin[cache_pc], cache_pc);
-            } else {
-                if (cache_pc >= cache_mem_asm.size()) {
-                    v_insn.set_instruction(cache_mem_asm[cache_mem_asm.size() - 1], map_label,
-                                           cache_pc);
-                } else {
-                    v_insn.set_instruction(cache_mem_asm[cache_pc], map_label, cache_pc);
-                }
-            }
+            v_insn           = fetch_decoded(cache_pc);
+            v_insn.insn_addr = cache_pc;
 
             if (G_MEM_OUT_REG != 0) {
                 insn_reg_b = v_insn;
@@ -354,6 +369,7 @@ void Icache_rtl::read_insn() {
 void Icache_rtl::memory_out_reg() {
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_MEM_OUT_REG != 0) {
             if (Clp2Ic_ready.read()) {
@@ -367,31 +383,20 @@ void Icache_rtl::memory_out_reg() {
 }
 
 void Icache_rtl::no_memory_out_reg() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_MEM_OUT_REG == 0) {
-            branch_reg_b = branch_reg_a.read();
-        }
+    if (G_MEM_OUT_REG == 0) {
+        branch_reg_b = branch_reg_a.read();
     }
 }
 
 void Icache_rtl::drive_cache_output() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        IC2Clp_insn    = insn_reg_c.read();
-        IC2Clp_br_done = branch_reg_b.read();
-        // The output is always valid since this is an on-chip memory
-        IC2Clp_valid.write(1);
-    }
-}
-
-void Icache_rtl::clock_counter() {
-    while (true) {
-        wait();
-        num_cycles++;
-    }
+    IC2Clp_insn    = insn_reg_c.read();
+    IC2Clp_br_done = branch_reg_b.read();
+    // The output is always valid since this is an on-chip memory
+    IC2Clp_valid.write(1);
 }
 
 // void Icache_rtl::write_output_file() {
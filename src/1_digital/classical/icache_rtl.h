@@ -3,7 +3,11 @@
 
 #include <systemc.h>
 
+#include "asm_program.h"
+#include "cache_file.h"
+#include "eqasm_assembler.h"
 #include "global_json.h"
+#include "mapped_file.h"
 #include "num_util.h"
 #include "qasm_instruction.h"
 
@@ -30,15 +34,22 @@ SC_MODULE(Icache_rtl) {
     sc_out<Qasm_instruction> IC2Clp_insn;
 
   public:  // other signals
-    int num_cycles = 0;
     // std::ofstream
     // insn_result_veri_out;
 
   public:  // methods
-    void         init_mem_bin(std::string qisa_bin_fn);
-    unsigned int convert_line_to_ele_instr(std::vector<std::vector<std::string>> & vec_instr,
-                                           std::string & line_str, const std::string& line_num_str);
-    void         init_mem_asm(std::string qisa_asm_fn);
+    void init_mem_bin(std::string qisa_bin_fn);
+    void assemble_mem_bin(std::string qisa_asm_fn);
+    void init_mem_asm(std::string qisa_asm_fn);
+    void decode_program();
+
+    // (re)loads the program Global_config::qisa_asm_fn or qisa_bin_fn, of the instruction type
+    // the module was built for
+    void load_program();
+
+    // the decoded instruction at the given address. Any address beyond the program returns the
+    // trailing stop for asm, and the zero padding word for bin.
+    const Qasm_instruction& fetch_decoded(unsigned int addr);
 
     void combinational_gen();
     void register_left_logic();
@@ -53,7 +64,6 @@ SC_MODULE(Icache_rtl) {
 
     void drive_cache_output();
 
-    void clock_counter();
     // void write_output_file();
 
   protected:  // internal signals
@@ -73,10 +83,25 @@ SC_MODULE(Icache_rtl) {
     sc_signal<Qasm_instruction>              insn_reg_b;
     sc_signal<Qasm_instruction>              insn_reg_c;
 
-    std::vector<unsigned int>             cache_mem_bin;
-    std::vector<std::vector<std::string>> cache_mem_asm;
-    unsigned int                          program_length;
-    std::map<std::string, unsigned int>   map_label;
+    // bin: the program file is mapped (or assembled in-process), and instructions are decoded
+    // block by block on first fetch
+    Mapped_file                                cache_mem_bin;
+    std::vector<uint32_t>                      assembled_bin;
+    unsigned int                               program_length = 0;
+    std::vector<std::vector<Qasm_instruction>> decoded_blocks;  // empty until first fetched
+    Qasm_instruction                           bin_padding_insn;
+
+    // asm: the whole program decoded once at initialization. Fetch only reads entries from this
+    // table. The last entry is the trailing stop.
+    Asm_program                   asm_program;  // referenced by cache_mem_decoded
+    std::vector<Qasm_instruction> cache_mem_decoded;
+
+    void         load_bin_program(size_t num_words);
+    unsigned int read_bin_word(unsigned int addr) const;
+    void         decode_bin_block(size_t block);
+
+    bool program_cache_key(const std::string& qisa_asm_fn, Content_hash& key);
+    bool restore_program(const std::string& cache_fn);
 
   public:  // member variables
     Instruction_type m_instruction_type;
@@ -91,35 +116,35 @@ SC_MODULE(Icache_rtl) {
         auto logger = get_logger_or_exit("cache_logger");
         logger->trace("Start initializing {}...", this->name());
 
-        if (global_config.instruction_type == Instruction_type::BIN) {
-            init_mem_bin(global_config.qisa_bin_fn);
-        } else {
-            init_mem_asm(global_config.qisa_asm_fn);
-        }
+        load_program();
 
-        SC_THREAD(combinational_gen);
+        SC_METHOD(combinational_gen);
         sensitive << Clp2Ic_target << Clp2Ic_branching << Clp2Ic_ready << pcc << branchc << readya
                   << pca << brancha;
+        dont_initialize();
 
-        SC_THREAD(register_right);
+        SC_METHOD(register_right);
         sensitive << pc << branch << Clp2Ic_ready;
+        dont_initialize();
 
         SC_CTHREAD(register_left_logic, clock.pos());
         SC_CTHREAD(register_right_logic, clock.pos());
         SC_CTHREAD(register_at_memory_pipeline, clock.pos());
 
-        SC_THREAD(no_register_memory_pipeline);
+        SC_METHOD(no_register_memory_pipeline);
         sensitive << pc << branch;
+        dont_initialize();
 
         SC_CTHREAD(read_insn, clock.pos());
         SC_CTHREAD(memory_out_reg, clock.pos());
-        SC_THREAD(no_memory_out_reg);
+        SC_METHOD(no_memory_out_reg);
         sensitive << branch_reg_a;
+        dont_initialize();
 
-        SC_THREAD(drive_cache_output);
+        SC_METHOD(drive_cache_output);
         sensitive << insn_reg_c << branch_reg_b;
+        dont_initialize();
 
-        SC_CTHREAD(clock_counter, clock.pos());
         // SC_CTHREAD(write_output_file, clock.pos());
 
         logger->trace("Finished initializing {}...", this->name());
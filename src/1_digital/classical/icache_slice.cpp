@@ -1,10 +1,13 @@
 #include "icache_slice.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Icache_slice::command_slice_gen() {
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_CMD_SLICE == 1) {
             Sl2Ic_branching.write(Clp2Sl_branching.read());
@@ -18,19 +21,18 @@ void Icache_slice::command_slice_gen() {
 }
 
 void Icache_slice::no_command_slice() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_CMD_SLICE == 0) {
-            Sl2Ic_branching.write(Clp2Sl_branching.read());
-            Sl2Ic_target.write(Clp2Sl_target.read());
-        }
+    if (G_CMD_SLICE == 0) {
+        Sl2Ic_branching.write(Clp2Sl_branching.read());
+        Sl2Ic_target.write(Clp2Sl_target.read());
     }
 }
 
 void Icache_slice::ready_slice_gen() {
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_READY_SLICE == 1) {
             if (Rsl_buf_invalid.read() && IC2Sl_valid.read() && !Dsl2Rsl_ready.read()) {
@@ -48,46 +50,40 @@ void Icache_slice::ready_slice_gen() {
 }
 
 void Icache_slice::drive_slice_output() {
-    while (true) {
-        wait();
-
-        if (G_READY_SLICE == 1) {
-            if (!Rsl_buf_invalid.read()) {
-                // supply the contents of the buffer
-                Rsl2Dsl_br_done = Rsl_buf_br_done.read();
-                Rsl2Dsl_insn    = Rsl_buf_insn.read();
-                Rsl2Dsl_valid.write(1);
-            } else {
-                // drive the output directly
-                Rsl2Dsl_br_done = IC2Sl_br_done.read();
-                Rsl2Dsl_insn    = IC2Sl_insn.read();
-                Rsl2Dsl_valid   = IC2Sl_valid.read();
-            }
+    Profile_process profile;
+
+    if (G_READY_SLICE == 1) {
+        if (!Rsl_buf_invalid.read()) {
+            // supply the contents of the buffer
+            Rsl2Dsl_br_done = Rsl_buf_br_done.read();
+            Rsl2Dsl_insn    = Rsl_buf_insn.read();
+            Rsl2Dsl_valid.write(1);
+        } else {
+            // drive the output directly
+            Rsl2Dsl_br_done = IC2Sl_br_done.read();
+            Rsl2Dsl_insn    = IC2Sl_insn.read();
+            Rsl2Dsl_valid   = IC2Sl_valid.read();
         }
     }
 }
 
 void Icache_slice::no_ready_slice() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_READY_SLICE == 0) {
-            Rsl2Dsl_br_done = IC2Sl_br_done.read();
-            Rsl2Dsl_insn    = IC2Sl_insn.read();
-            Rsl2Dsl_valid   = IC2Sl_valid.read();
-            Sl2Ic_ready     = Dsl2Rsl_ready.read();
-        }
+    if (G_READY_SLICE == 0) {
+        Rsl2Dsl_br_done = IC2Sl_br_done.read();
+        Rsl2Dsl_insn    = IC2Sl_insn.read();
+        Rsl2Dsl_valid   = IC2Sl_valid.read();
+        Sl2Ic_ready     = Dsl2Rsl_ready.read();
     }
 }
 
 void Icache_slice::drive_ready() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_READY_SLICE == 1) {
-            // Tie our ready output to the buffer state register
-            Sl2Ic_ready = Rsl_buf_invalid.read();
-        }
+    if (G_READY_SLICE == 1) {
+        // Tie our ready output to the buffer state register
+        Sl2Ic_ready = Rsl_buf_invalid.read();
     }
 }
 
@@ -95,6 +91,7 @@ void Icache_slice::data_slice_gen() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (G_DATA_SLICE == 1) {
             if (!Dsl_buf_valid.read() && Rsl2Dsl_valid.read()) {
@@ -115,41 +112,35 @@ void Icache_slice::data_slice_gen() {
 }
 
 void Icache_slice::drive_ready_output() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_DATA_SLICE == 1) {
-            if (!Dsl_buf_valid.read() || Clp2Sl_ready.read()) {
-                Dsl2Rsl_ready.write(1);
-            } else {
-                Dsl2Rsl_ready.write(0);
-            }
+    if (G_DATA_SLICE == 1) {
+        if (!Dsl_buf_valid.read() || Clp2Sl_ready.read()) {
+            Dsl2Rsl_ready.write(1);
+        } else {
+            Dsl2Rsl_ready.write(0);
         }
     }
 }
 
 void Icache_slice::drive_data_output() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_DATA_SLICE == 1) {
-            Sl2Clp_br_done = Dsl_buf_br_done.read();
-            Sl2Clp_insn    = Dsl_buf_insn.read();
-            Sl2Clp_valid   = Dsl_buf_valid.read();
-        }
+    if (G_DATA_SLICE == 1) {
+        Sl2Clp_br_done = Dsl_buf_br_done.read();
+        Sl2Clp_insn    = Dsl_buf_insn.read();
+        Sl2Clp_valid   = Dsl_buf_valid.read();
     }
 }
 
 void Icache_slice::no_data_slice() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        if (G_DATA_SLICE == 0) {
-            Sl2Clp_br_done = Rsl2Dsl_br_done.read();
-            Sl2Clp_insn    = Rsl2Dsl_insn.read();
-            Sl2Clp_valid   = Rsl2Dsl_valid.read();
-            Dsl2Rsl_ready  = Clp2Sl_ready.read();
-        }
+    if (G_DATA_SLICE == 0) {
+        Sl2Clp_br_done = Rsl2Dsl_br_done.read();
+        Sl2Clp_insn    = Rsl2Dsl_insn.read();
+        Sl2Clp_valid   = Rsl2Dsl_valid.read();
+        Dsl2Rsl_ready  = Clp2Sl_ready.read();
     }
 }
 
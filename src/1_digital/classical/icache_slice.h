@@ -66,25 +66,32 @@ SC_MODULE(Icache_slice) {
         logger->trace("Start initializing {}...", this->name());
 
         SC_CTHREAD(command_slice_gen, clock.pos());
-        SC_THREAD(no_command_slice);
+        SC_METHOD(no_command_slice);
         sensitive << Clp2Sl_branching << Clp2Sl_target;
+        dont_initialize();
 
         SC_CTHREAD(ready_slice_gen, clock.pos());
-        SC_THREAD(drive_slice_output);
+        SC_METHOD(drive_slice_output);
         sensitive << Rsl_buf_br_done << Rsl_buf_insn << Rsl_buf_invalid << IC2Sl_br_done
                   << IC2Sl_insn << IC2Sl_valid;
-        SC_THREAD(no_ready_slice);
+        dont_initialize();
+        SC_METHOD(no_ready_slice);
         sensitive << IC2Sl_br_done << IC2Sl_insn << IC2Sl_valid << Dsl2Rsl_ready;
-        SC_THREAD(drive_ready);
+        dont_initialize();
+        SC_METHOD(drive_ready);
         sensitive << Rsl_buf_invalid;
+        dont_initialize();
 
         SC_CTHREAD(data_slice_gen, clock.pos());
-        SC_THREAD(no_data_slice);
+        SC_METHOD(no_data_slice);
         sensitive << Rsl2Dsl_br_done << Rsl2Dsl_insn << Rsl2Dsl_valid;
-        SC_THREAD(drive_ready_output);
+        dont_initialize();
+        SC_METHOD(drive_ready_output);
         sensitive << Dsl_buf_valid << Clp2Sl_ready;
-        SC_THREAD(drive_data_output);
+        dont_initialize();
+        SC_METHOD(drive_data_output);
         sensitive << Dsl_buf_br_done << Dsl_buf_insn << Dsl_buf_valid;
+        dont_initialize();
 
         logger->trace("Finished initializing {}...", this->name());
     }
@@ -47,4 +47,6 @@ ICache::ICache(const sc_core::sc_module_name& n)
 
 void ICache::init_mem_asm(std::string asm_fn) { icache_rtl.init_mem_asm(asm_fn); }
 
+void ICache::load_program() { icache_rtl.load_program(); }
+
 }  // end of namespace cactus
@@ -25,6 +25,9 @@ SC_MODULE(ICache) {
   public:
     void init_mem_asm(std::string asm_fn);
 
+    // see Icache_rtl::load_program()
+    void load_program();
+
   protected:  // internal signals
     // branch & target from Slice to Cache
     sc_signal<bool>                          Sl2Ic_branching;
@@ -3,6 +3,8 @@
 #include <iomanip>
 #include <sstream>
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Meas_reg_file_rtl::config() {
@@ -11,10 +13,19 @@ void Meas_reg_file_rtl::config() {
 
     num_qubits   = global_config.num_qubits;
     m_output_dir = global_config.output_dir;
+    is_telf_on   = global_config.telf_on;
 }
 
+// the derived signals start as wide as the sets written to them, so that only a change of a bit
+// notifies the processes which are sensitive to them
+static Bit_set cleared_qubit_bits() { return Bit_set(Global_config::get_instance().num_qubits); }
+
 Meas_reg_file_rtl::Meas_reg_file_rtl(const sc_core::sc_module_name& n)
-    : sc_core::sc_module(n) {
+    : sc_core::sc_module(n)
+    , Qp2MRF_qubit_ena_sig("Qp2MRF_qubit_ena_sig", cleared_qubit_bits())
+    , Qp2MRF_qubit_ena_cancel_sig("Qp2MRF_qubit_ena_cancel_sig", cleared_qubit_bits())
+    , Qm2MRF_qubit_ena_sig("Qm2MRF_qubit_ena_sig", cleared_qubit_bits())
+    , Qm2MRF_qubit_data_sig("Qm2MRF_qubit_data_sig", cleared_qubit_bits()) {
 
     auto logger = get_logger_or_exit("console", CODE_POSITION);
 
@@ -22,42 +33,45 @@ Meas_reg_file_rtl::Meas_reg_file_rtl(const sc_core::sc_module_name& n)
 
     config();
 
-    open_telf_file();
+    if (is_telf_on) open_telf_file();
 
-    pending_meas_counter.init(num_qubits);
+    m_pending_meas_counter.assign(num_qubits, 0);
 
-    Qp2MRF_qubit_ena_sig.init(num_qubits);
-    Qp2MRF_qubit_ena_cancel_sig.init(num_qubits);
-    Qm2MRF_qubit_data_sig.init(num_qubits);
-    Qm2MRF_qubit_ena_sig.init(num_qubits);
+    m_qp_qubit_ena.resize(num_qubits);
+    m_qp_qubit_ena_cancel.resize(num_qubits);
+    m_qm_qubit_ena.resize(num_qubits);
+    m_qm_qubit_data.resize(num_qubits);
     MRF2Clp_data.init(num_qubits);
     MRF2Clp_valid.init(num_qubits);
+    m_MRF2Clp_data.resize(num_qubits);
+    m_MRF2Clp_valid.resize(num_qubits);
 
-    qubit_valid.init(num_qubits);
     qubit_threshold.init(num_qubits);
-    qubit_data.init(num_qubits);
 
-    SC_THREAD(update_signals);
+    SC_METHOD(update_signals);
     sensitive << Qp2MRF_meas_issue << Qp2MRF_meas_cancel << Qm2MRF_meas_result;
+    dont_initialize();
 
-    SC_CTHREAD(log_IO, clock.pos());
+    // formatting the IO on every clock cycle is only affordable when it is really asked for
+    if (get_logger_or_exit("MRF_logger", CODE_POSITION)->should_log(spdlog::level::debug)) {
+        SC_CTHREAD(log_IO, clock.pos());
+    }
 
     SC_CTHREAD(interlocking_counter, clock.pos());
-    SC_THREAD(interlocking_ready);
+    SC_METHOD(interlocking_ready);
     sensitive << i_lock_counter;
+    dont_initialize();
 
     SC_CTHREAD(qubit_valid_counter, clock.pos());
-    SC_THREAD(generate_signals);
-    for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-        sensitive << pending_meas_counter[i];
-    }
 
     SC_CTHREAD(output_register, clock.pos());
 
-    SC_CTHREAD(clock_counter, clock.pos());
-    SC_THREAD(write_output_file);
-    for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-        sensitive << Qm2MRF_qubit_data_sig[i] << Qm2MRF_qubit_ena_sig[i];
+    Idle_skipper::get_instance().add_module(this);
+
+    if (is_telf_on) {
+        SC_METHOD(write_output_file);
+        sensitive << Qm2MRF_qubit_data_sig << Qm2MRF_qubit_ena_sig;
+        dont_initialize();
     }
 
     logger->trace("Finished initializing {}...", this->name());
@@ -98,49 +112,21 @@ void Meas_reg_file_rtl::close_telf_file() {
 }
 
 void Meas_reg_file_rtl::update_signals() {
+    Profile_process profile;
 
-    Generic_meas_if meas_issue;
-    Generic_meas_if meas_cancel;
-    Generic_meas_if meas_result;
-
-    std::vector<bool> vec_meas_ena;
-    std::vector<bool> vec_meas_en_cancel;
-    std::vector<bool> vec_meas_data;
-    std::vector<bool> vec_meas_data_valid;
-    bool              qp_meas_issue;
-
-    while (true) {
-        wait();
-
-        // derive signals from measurement generic interface
-        meas_issue  = Qp2MRF_meas_issue.read();
-        meas_cancel = Qp2MRF_meas_cancel.read();
-        meas_result = Qm2MRF_meas_result.read();
+    // derive signals from measurement generic interface
+    const Bit_set&         meas_ena        = Qp2MRF_meas_issue.read().get_meas_ena();
+    const Bit_set&         meas_ena_cancel = Qp2MRF_meas_cancel.read().get_meas_ena_cancel();
+    const Generic_meas_if& meas_result     = Qm2MRF_meas_result.read();
 
-        vec_meas_ena        = meas_issue.get_meas_ena();
-        vec_meas_en_cancel  = meas_cancel.get_meas_ena_cancel();
-        vec_meas_data       = meas_result.get_meas_data();
-        vec_meas_data_valid = meas_result.get_meas_data_valid();
-
-        qp_meas_issue = false;
-        for (size_t i = 0; i < vec_meas_ena.size(); ++i) {
-            Qp2MRF_qubit_ena_sig[i].write(vec_meas_ena[i] ? 1 : 0);
-            qp_meas_issue |= vec_meas_ena[i];
-        }
-        Qp2MRF_meas_issue_sig.write(qp_meas_issue);
+    Qp2MRF_qubit_ena_sig.write(m_qp_qubit_ena.overwrite(meas_ena));
+    Qp2MRF_meas_issue_sig.write(meas_ena.any());
 
-        for (size_t i = 0; i < vec_meas_en_cancel.size(); ++i) {
-            Qp2MRF_qubit_ena_cancel_sig[i].write(vec_meas_en_cancel[i] ? 1 : 0);
-        }
+    Qp2MRF_qubit_ena_cancel_sig.write(m_qp_qubit_ena_cancel.overwrite(meas_ena_cancel));
 
-        for (size_t i = 0; i < vec_meas_data.size(); ++i) {
-            Qm2MRF_qubit_data_sig[i].write(vec_meas_data[i] ? 1 : 0);
-        }
+    Qm2MRF_qubit_data_sig.write(m_qm_qubit_data.overwrite(meas_result.get_meas_data()));
 
-        for (size_t i = 0; i < vec_meas_data_valid.size(); ++i) {
-            Qm2MRF_qubit_ena_sig[i].write(vec_meas_data_valid[i] ? 1 : 0);
-        }
-    }
+    Qm2MRF_qubit_ena_sig.write(m_qm_qubit_ena.overwrite(meas_result.get_meas_data_valid()));
 }
 
 void Meas_reg_file_rtl::log_IO() {
@@ -154,6 +140,7 @@ void Meas_reg_file_rtl::log_IO() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         ss.str("");
         ss << "@" << sc_core::sc_time_stamp() << ",";
@@ -165,17 +152,14 @@ void Meas_reg_file_rtl::log_IO() {
                << std::endl;
 
         ss_tmp.str("");
-        valid_msmt_res = false;
+        const Bit_set& qm_qubit_ena  = Qm2MRF_qubit_ena_sig.read();
+        const Bit_set& qm_qubit_data = Qm2MRF_qubit_data_sig.read();
+        valid_msmt_res               = qm_qubit_ena.any();
 
         ss_tmp << "\n\tUHFQC result -> MRF: [";
-        for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-
-            ss_tmp << i << ":(" << Qm2MRF_qubit_ena_sig[i].read() << ", "
-                   << Qm2MRF_qubit_data_sig[i].read() << ") ";
+        for (size_t i = 0; i < qm_qubit_ena.size() && i < qm_qubit_data.size(); ++i) {
 
-            if (Qm2MRF_qubit_ena_sig[i].read()) {
-                valid_msmt_res = true;
-            }
+            ss_tmp << i << ":(" << qm_qubit_ena.test(i) << ", " << qm_qubit_data.test(i) << ") ";
         }
         ss_tmp << "]\n";
 
@@ -194,7 +178,7 @@ void Meas_reg_file_rtl::log_IO() {
         ss << "\tpending_meas_counter: [";
         for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
 
-            ss << pending_meas_counter[i].read() << " ";
+            ss << m_pending_meas_counter[i] << " ";
         }
         ss << "]\n";
 
@@ -210,6 +194,7 @@ void Meas_reg_file_rtl::interlocking_counter() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         v_lock_counter = i_lock_counter.read();
 
@@ -233,138 +218,162 @@ void Meas_reg_file_rtl::interlocking_counter() {
 }
 
 void Meas_reg_file_rtl::interlocking_ready() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        i_lock_ready.write(1);
+    i_lock_ready.write(1);
 
-        if (i_lock_counter.read() != 0) {
-            i_lock_ready.write(0);
-        }
-        if (Clp2MRF_meas_issue.read()) {
-            i_lock_ready.write(0);
-        }
+    if (i_lock_counter.read() != 0) {
+        i_lock_ready.write(0);
+    }
+    if (Clp2MRF_meas_issue.read()) {
+        i_lock_ready.write(0);
     }
 }
 
 void Meas_reg_file_rtl::qubit_valid_counter() {
-    sc_uint<G_INTERLOCK_COUNTER_BITS> v_counter;
-    sc_uint<1>*                       v_qp_qubit_ena;
-    sc_uint<1>*                       v_qp_qubit_ena_cancel;
-    sc_uint<1>*                       v_qm_qubit_ena;
-    sc_uint<1>*                       v_qubit_data;
-    sc_uint<1>*                       v_qm_qubit_data;
-    v_qp_qubit_ena        = new sc_uint<1>[num_qubits];
-    v_qp_qubit_ena_cancel = new sc_uint<1>[num_qubits];
-    v_qm_qubit_data       = new sc_uint<1>[num_qubits];
-    v_qm_qubit_ena        = new sc_uint<1>[num_qubits];
-    v_qubit_data          = new sc_uint<1>[num_qubits];
+    Bit_set v_qubit_data(num_qubits);
+    Bit_set v_qubit_valid(num_qubits);
+    Bit_set v_qubit_touched(num_qubits);
+    bool    v_counter_changed;
+
+    // the results measured by the fast-forward engine, if it has run
+    const Arch_state& ff_state = Global_config::get_instance().ff_state;
+    for (size_t q = 0; q < num_qubits; ++q) {
+        v_qubit_data.set(q, ff_state.valid && q < ff_state.meas_results.size() &&
+                              ff_state.meas_results[q]);
+    }
+
     while (true) {
         wait();
+        Profile_process profile;
 
-        for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-            v_qp_qubit_ena[i]        = Qp2MRF_qubit_ena_sig[i].read();
-            v_qp_qubit_ena_cancel[i] = Qp2MRF_qubit_ena_cancel_sig[i].read();
-            v_qm_qubit_ena[i]        = Qm2MRF_qubit_ena_sig[i].read();
-            v_qm_qubit_data[i]       = Qm2MRF_qubit_data_sig[i].read();
-        }
+        const Bit_set& v_qp_qubit_ena        = Qp2MRF_qubit_ena_sig.read();
+        const Bit_set& v_qp_qubit_ena_cancel = Qp2MRF_qubit_ena_cancel_sig.read();
+        const Bit_set& v_qm_qubit_ena        = Qm2MRF_qubit_ena_sig.read();
+        const Bit_set& v_qm_qubit_data       = Qm2MRF_qubit_data_sig.read();
+
+        // only the counters of the qubits which are measured, cancelled or returned can change
+        v_qubit_touched.reset();
+        v_qubit_touched |= v_qp_qubit_ena;
+        v_qubit_touched |= v_qp_qubit_ena_cancel;
+        v_qubit_touched |= v_qm_qubit_ena;
 
-        for (int q = 0; q < static_cast<int>(num_qubits); q++) {
-            v_counter = pending_meas_counter[q].read();
+        v_counter_changed = false;
+        v_qubit_touched.for_each([&](size_t q) {
+            sc_uint<G_INTERLOCK_COUNTER_BITS> v_counter = m_pending_meas_counter[q];
 
-            if (v_qp_qubit_ena[q] == 1) {
+            // the touched qubit may be beyond a set which has not been written yet
+            if (q < v_qp_qubit_ena.size() && v_qp_qubit_ena.test(q)) {
                 v_counter = v_counter + 1;
             }
-            if (v_qp_qubit_ena_cancel[q] == 1) {
+            if (q < v_qp_qubit_ena_cancel.size() && v_qp_qubit_ena_cancel.test(q)) {
                 v_counter = v_counter - 1;
             }
-            if (v_qm_qubit_ena[q] == 1) {
+            if (q < v_qm_qubit_ena.size() && v_qm_qubit_ena.test(q)) {
                 v_counter = v_counter - 1;
-                // update the data register when new data is available
-                v_qubit_data[q] = v_qm_qubit_data[q];
             }
-            if (reset.read()) v_counter = 0;
+            v_counter_changed |= (v_counter != m_pending_meas_counter[q]);
+            m_pending_meas_counter[q] = v_counter;
+        });
+
+        if (v_qubit_touched.any() || reset.read() || Clp2MRF_meas_issue.read() ||
+            Qp2MRF_meas_issue_sig.read()) {
+            m_num_quiet_cycles = 0;
+        } else {
+            m_num_quiet_cycles++;
+        }
 
-            pending_meas_counter[q].write(v_counter);
+        if (reset.read()) {
+            for (auto& v_counter : m_pending_meas_counter) {
+                v_counter_changed |= (v_counter != 0);
+                v_counter = 0;
+            }
         }
 
-        for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-            qubit_data[i].write(v_qubit_data[i]);
+        // update the data register when new data is available
+        v_qubit_data.and_not(v_qm_qubit_ena);
+        v_qubit_data |= v_qm_qubit_data & v_qm_qubit_ena;
+        qubit_data.write(v_qubit_data);
+
+        // a qubit is valid when none of its measurements is pending. As the counters, the valid
+        // bits are only derived once a counter changes.
+        if (v_counter_changed) {
+            for (size_t q = 0; q < num_qubits; ++q) {
+                v_qubit_valid.set(q, m_pending_meas_counter[q] == 0);
+            }
+            qubit_valid.write(v_qubit_valid);
         }
     }
 }
 
-void Meas_reg_file_rtl::generate_signals() {
-    sc_uint<1>* v_qubit_valid;
-    v_qubit_valid = new sc_uint<1>[num_qubits];
-    while (true) {
-        wait();
+uint64_t Meas_reg_file_rtl::num_idle_cycles() {
+    unsigned int cycles_per_50MHz =
+      Idle_skipper::get_instance().cycles_per_50MHz(Clock_domain::CLOCK_200MHZ);
 
-        for (int q = 0; q < static_cast<int>(num_qubits); q++) {
-            if (pending_meas_counter[q].read() == 0)
-                v_qubit_valid[q] = 1;
-            else
-                v_qubit_valid[q] = 0;
+    // the registers hold their values once the last change has gone through them. The counters
+    // of the pending measurements and the interlocking counter keep theirs.
+    if (m_num_quiet_cycles < IDLE_QUIET_CYCLES * cycles_per_50MHz) return 0;
+    return UINT64_MAX;
+}
 
-            // if (pending_meas_counter[q].read() == 32)
-            // qubit_threshold.write(1);
-            qubit_valid[q].write(v_qubit_valid[q]);
-        }
-    }
+void Meas_reg_file_rtl::skip_cycles(uint64_t num_cycles) {
+    m_num_quiet_cycles +=
+      num_cycles * Idle_skipper::get_instance().cycles_per_50MHz(Clock_domain::CLOCK_200MHZ);
+}
+
+void Meas_reg_file_rtl::write_changed_bits(sc_vector<sc_out<sc_uint<1>>>& ports, Bit_set& written,
+                                           const Bit_set& bits) {
+    Bit_set changed = written ^ bits;
+    changed.for_each([&](size_t q) { ports[q].write(bits.test(q)); });
+    written = bits;
 }
 
 void Meas_reg_file_rtl::output_register() {
+    Bit_set v_qubit_data(num_qubits);
+    Bit_set v_qubit_valid(num_qubits);
+
     while (true) {
         wait();
+        Profile_process profile;
 
-        for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-            MRF2Clp_data[i].write(qubit_data[i].read());
-        }
+        // the internal signals are empty until they are first written
+        v_qubit_data.reset();
+        v_qubit_data |= qubit_data.read();
 
-        for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-            // if there is a measure instruction not processed by quantum pipeline yet, all qubits
-            // are invalid
-            if (!i_lock_ready.read() || Clp2MRF_meas_issue.read())
-                MRF2Clp_valid[i].write(0);
-            else
-                MRF2Clp_valid[i].write(qubit_valid[i].read());
+        // if there is a measure instruction not processed by quantum pipeline yet, all qubits are
+        // invalid
+        v_qubit_valid.reset();
+        if (reset.read()) {
+            v_qubit_valid.set_all();
+        } else if (i_lock_ready.read() && !Clp2MRF_meas_issue.read()) {
+            v_qubit_valid |= qubit_valid.read();
         }
 
+        write_changed_bits(MRF2Clp_data, m_MRF2Clp_data, v_qubit_data);
+        write_changed_bits(MRF2Clp_valid, m_MRF2Clp_valid, v_qubit_valid);
+
         // since threshold is not useful at current stage
         MRF2Clp_ready.write(1);
-
-        if (reset.read()) {
-            MRF2Clp_ready.write(1);
-            for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
-                MRF2Clp_valid[i].write(1);
-            }
-        }
-    }
-}
-
-void Meas_reg_file_rtl::clock_counter() {
-    while (true) {
-        wait();
-        num_cycles++;
     }
 }
 
 void Meas_reg_file_rtl::write_output_file() {
-    while (true) {
-        wait();
-
-        // Write the text output
-        msmt_result_veri_out << std::setfill(' ') << std::setw(11) << num_cycles;
-        msmt_result_veri_out << ",    " << std::setfill(' ') << std::setw(5) << "0b'";
-        for (int i = (num_qubits - 1); i >= 0; i--) {
-            msmt_result_veri_out << Qm2MRF_qubit_data_sig[i].read();
-        }
-        msmt_result_veri_out << ",    " << std::setfill(' ') << std::setw(4) << "0b'";
-        for (int i = (num_qubits - 1); i >= 0; i--) {
-            msmt_result_veri_out << Qm2MRF_qubit_ena_sig[i].read();
-        }
-        msmt_result_veri_out << std::endl;
+    Profile_process profile;
+
+    // Write the text output
+    msmt_result_veri_out << std::setfill(' ') << std::setw(11) << m_clock_cycles.num_cycles();
+    msmt_result_veri_out << ",    " << std::setfill(' ') << std::setw(5) << "0b'";
+    // a set which has not been written yet reads as 0
+    const Bit_set& qm_qubit_data = Qm2MRF_qubit_data_sig.read();
+    const Bit_set& qm_qubit_ena  = Qm2MRF_qubit_ena_sig.read();
+    for (size_t i = num_qubits; i-- > 0;) {
+        msmt_result_veri_out << (i < qm_qubit_data.size() && qm_qubit_data.test(i));
+    }
+    msmt_result_veri_out << ",    " << std::setfill(' ') << std::setw(4) << "0b'";
+    for (size_t i = num_qubits; i-- > 0;) {
+        msmt_result_veri_out << (i < qm_qubit_ena.size() && qm_qubit_ena.test(i));
     }
+    msmt_result_veri_out << std::endl;
 }
 
 Meas_reg_file_rtl::~Meas_reg_file_rtl() { close_telf_file(); }
@@ -2,9 +2,11 @@
 #define _MEAS_REG_FILE_H_
 
 #include <systemc>
+#include <vector>
 
 #include "generic_if.h"
 #include "global_json.h"
+#include "cycle_counter.h"
 #include "logger_wrapper.h"
 #include "num_util.h"
 
@@ -16,7 +18,7 @@ using sc_core::sc_signal;
 using sc_core::sc_vector;
 using sc_dt::sc_uint;
 
-SC_MODULE(Meas_reg_file_rtl) {
+SC_MODULE(Meas_reg_file_rtl), public Idle_skippable {
   public:
     std::ofstream msmt_result_veri_out;
 
@@ -42,22 +44,20 @@ SC_MODULE(Meas_reg_file_rtl) {
     sc_signal<sc_uint<G_INTERLOCK_COUNTER_BITS>> i_lock_counter;
     sc_signal<bool>                              i_lock_ready;
     sc_signal<bool>                              i_lock_threshold;
-    sc_vector<sc_signal<sc_uint<1>>>             qubit_valid;
+    sc_signal<Bit_set>                           qubit_valid;
     sc_vector<sc_signal<sc_uint<1>>>             qubit_threshold;
-    sc_vector<sc_signal<sc_uint<1>>>             qubit_data;
-    // counter for each qubit
-    sc_vector<sc_signal<sc_uint<G_INTERLOCK_COUNTER_BITS>>> pending_meas_counter;
+    sc_signal<Bit_set>                           qubit_data;
 
-    // signal derived by quantum pipeline interface
-    sc_signal<bool>                  Qp2MRF_meas_issue_sig;
-    sc_vector<sc_signal<sc_uint<1>>> Qp2MRF_qubit_ena_sig;
-    sc_vector<sc_signal<sc_uint<1>>> Qp2MRF_qubit_ena_cancel_sig;
+    // signal derived by quantum pipeline interface, one bit per qubit
+    sc_signal<bool>    Qp2MRF_meas_issue_sig;
+    sc_signal<Bit_set> Qp2MRF_qubit_ena_sig;
+    sc_signal<Bit_set> Qp2MRF_qubit_ena_cancel_sig;
 
-    // signal derived by quantum measurement device sig
-    sc_vector<sc_signal<sc_uint<1>>> Qm2MRF_qubit_ena_sig;
-    sc_vector<sc_signal<sc_uint<1>>> Qm2MRF_qubit_data_sig;
+    // signal derived by quantum measurement device sig, one bit per qubit
+    sc_signal<Bit_set> Qm2MRF_qubit_ena_sig;
+    sc_signal<Bit_set> Qm2MRF_qubit_data_sig;
 
-    int num_cycles = 0;
+    Clock_cycles m_clock_cycles{clock};  // the cycle numbers of the telf log
 
   protected:  // modules
     void log_IO();
@@ -66,10 +66,8 @@ SC_MODULE(Meas_reg_file_rtl) {
     void interlocking_counter();
     void interlocking_ready();
     void qubit_valid_counter();
-    void generate_signals();
     void output_register();
 
-    void clock_counter();
     void write_output_file();
 
     void open_telf_file();
@@ -79,9 +77,35 @@ SC_MODULE(Meas_reg_file_rtl) {
   protected:
     unsigned int num_qubits = 0;
     std::string  m_output_dir;
+    bool         is_telf_on = false;
+
+    // counter for each qubit
+    std::vector<sc_uint<G_INTERLOCK_COUNTER_BITS>> m_pending_meas_counter;
+
+    // the values of the derived signals, whose bits beyond the width of the latest input keep
+    // their value
+    Bit_set m_qp_qubit_ena;
+    Bit_set m_qp_qubit_ena_cancel;
+    Bit_set m_qm_qubit_ena;
+    Bit_set m_qm_qubit_data;
+
+    // the values last written to the ports of the classical pipeline
+    Bit_set m_MRF2Clp_data;
+    Bit_set m_MRF2Clp_valid;
+
+    // the cycles since a measurement was last issued, cancelled or returned, or the reset
+    uint64_t m_num_quiet_cycles = 0;
 
     void config();
 
+    // writes the ports whose bit differs from the value last written
+    void write_changed_bits(sc_vector<sc_out<sc_uint<1>>>& ports, Bit_set& written,
+                            const Bit_set& bits);
+
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
+
   public:
     Meas_reg_file_rtl(const sc_core::sc_module_name& n);
 
@@ -2,6 +2,8 @@
 
 #include <sstream>
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Meas_reg_file_slice::config() {
@@ -25,9 +27,13 @@ Meas_reg_file_slice::Meas_reg_file_slice(const sc_core::sc_module_name& n)
     MRF2MCS_valid.init(num_qubits);
 
     SC_CTHREAD(slice_register, clock.pos());
-    SC_CTHREAD(log_IO, clock.pos());
-    SC_THREAD(drive_directly);
+    // formatting the IO on every clock cycle is only affordable when it is really asked for
+    if (logger->should_log(spdlog::level::debug)) {
+        SC_CTHREAD(log_IO, clock.pos());
+    }
+    SC_METHOD(drive_directly);
     sensitive << i_MCS2MRF_meas_issue;
+    dont_initialize();
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -40,6 +46,7 @@ void Meas_reg_file_slice::log_IO() {
 
     while (true) {
         wait();
+        Profile_process profile;
         ss.str("");
         ss << "@" << sc_core::sc_time_stamp() << ",";
         ss << "Meas_reg_file_slice IO:\n";
@@ -71,6 +78,7 @@ void Meas_reg_file_slice::log_IO() {
 void Meas_reg_file_slice::slice_register() {
     while (true) {
         wait();
+        Profile_process profile;
 
         for (int i = 0; i < static_cast<int>(num_qubits); ++i) {
             // valid signal must go low starting from the clock cycle following CLP measure issue
@@ -99,10 +107,8 @@ void Meas_reg_file_slice::slice_register() {
 }
 
 void Meas_reg_file_slice::drive_directly() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        MCS2MRF_meas_issue.write(i_MCS2MRF_meas_issue.read());
-    }
+    MCS2MRF_meas_issue.write(i_MCS2MRF_meas_issue.read());
 }
 }  // namespace cactus
@@ -1,5 +1,7 @@
 #include "event_queue_manager.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Event_queue_manager::config() {
@@ -7,7 +9,7 @@ void Event_queue_manager::config() {
 
     m_num_qubits = global_config.num_qubits;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "event_queue_manager");
 }
 
@@ -21,6 +23,8 @@ Event_queue_manager::Event_queue_manager(const sc_core::sc_module_name& n)
     config();
     open_telf_file();
 
+    Idle_skipper::get_instance().add_module(this);
+
     // methods
     SC_CTHREAD(write_fifo, in_clock.pos());
 
@@ -30,21 +34,27 @@ Event_queue_manager::Event_queue_manager(const sc_core::sc_module_name& n)
 
     SC_CTHREAD(generate_count_finish_sig, in_50MHz_clock.pos());
 
-    SC_THREAD(generate_counter_start);
+    SC_METHOD(generate_counter_start);
     sensitive << i_run << i_run_pos_old << counter_finished_sig << reset;
+    dont_initialize();
 
-    SC_THREAD(generate_event_queue_read_sig);
+    SC_METHOD(generate_event_queue_read_sig);
     sensitive << counter_finished_sig << i_run_pos << i_run_pos_old << reset;
+    dont_initialize();
 
-    SC_THREAD(generate_run_pos_sig);
+    SC_METHOD(generate_run_pos_sig);
     sensitive << i_run << i_run_old << reset;
+    dont_initialize();
 
-    SC_THREAD(write_state);
+    SC_METHOD(write_state);
     sensitive << i_error_state << reset;
+    dont_initialize();
 
     SC_CTHREAD(counter_control, in_50MHz_clock.pos());
 
-    SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -52,17 +62,23 @@ Event_queue_manager::Event_queue_manager(const sc_core::sc_module_name& n)
 // cthread
 void Event_queue_manager::write_fifo() {
 
-    Q_pipe_interface q_pipe_interface;
+    // the write waits while the queue is full, and would then queue a later content of the
+    // input: the event of this cycle is copied first
+    Q_pipe_interface event;
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();  // clear everything at the begin of every cycle
-        q_pipe_interface = in_q_pipe_interface.read();
+        const Q_pipe_interface& q_pipe_interface = in_q_pipe_interface.read();
 
         // queued valid event info
         if (q_pipe_interface.if_content.valid_wait) {
-            event_queue.write(q_pipe_interface);
+            event = q_pipe_interface;
+            event_queue.write(event);
+            m_num_cycles_no_input = 0;
+        } else {
+            m_num_cycles_no_input++;
         }
     }
 }
@@ -72,8 +88,12 @@ void Event_queue_manager::read_fifo() {
 
     auto logger = get_logger_or_exit("console");
 
+    // read into, so that the storage of the operations is reused
+    Q_pipe_interface q_pipe_interface;
+
     while (true) {
         wait();
+        Profile_process profile;
 
         // whether event queue is almost full
         if (event_queue.num_available() >= 16) {
@@ -85,7 +105,8 @@ void Event_queue_manager::read_fifo() {
         // received read request
         if (event_queue_read_sig.read()) {
 
-            q_pipe_interface_sig.write(event_queue.read());
+            event_queue.read(q_pipe_interface);
+            q_pipe_interface_sig.write(q_pipe_interface);
 
             // whether event queue is empty
             if (event_queue.num_available() != 0) {
@@ -97,17 +118,15 @@ void Event_queue_manager::read_fifo() {
     }
 }
 
-// thread
+// method
 void Event_queue_manager::generate_run_pos_sig() {
+    Profile_process profile;
 
-    while (true) {
-        wait();
-        // detect a rising edge on the run signal
-        if (i_run.read() && !i_run_old.read()) {
-            i_run_pos.write(true);
-        } else {
-            i_run_pos.write(false);
-        }
+    // detect a rising edge on the run signal
+    if (i_run.read() && !i_run_old.read()) {
+        i_run_pos.write(true);
+    } else {
+        i_run_pos.write(false);
     }
 }
 
@@ -118,6 +137,7 @@ void Event_queue_manager::counter_control() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         if (i_run.read() && eq_empty.read()) {
             i_error_state.write(1);
@@ -133,57 +153,49 @@ void Event_queue_manager::counter_control() {
     }
 }
 
-// thread
+// method
 void Event_queue_manager::write_state() {
-    while (true) {
-        wait();
+    Profile_process profile;
 
-        // output event queue state
-        out_error_state.write(i_error_state.read());
-    }
+    // output event queue state
+    out_error_state.write(i_error_state.read());
 }
 
-// thread
+// method
 void Event_queue_manager::generate_event_queue_read_sig() {
+    Profile_process profile;
 
-    auto logger = get_logger_or_exit("telf_logger");
+    // generate read request signal for the event queue
+    // i_run_pos_old is used to generate an extra read request for next event
+    if (i_run_pos_old.read() || i_run_pos.read() || counter_finished_sig.read()) {
+        event_queue_read_sig.write(true);
 
-    while (true) {
-        wait();
-
-        // generate read request signal for the event queue
-        // i_run_pos_old is used to generate an extra read request for next event
-        if (i_run_pos_old.read() || i_run_pos.read() || counter_finished_sig.read()) {
-            event_queue_read_sig.write(true);
-
-            logger->trace("{}: generate event queue read request @{}", this->name(),
-                          sc_core::sc_time_stamp().to_string());
-        } else {
-            event_queue_read_sig.write(false);
+        if (telf_logger->should_log(spdlog::level::trace)) {
+            telf_logger->trace("{}: generate event queue read request @{}", this->name(),
+                               sc_core::sc_time_stamp().to_string());
         }
+    } else {
+        event_queue_read_sig.write(false);
     }
 }
 
-// thread
+// method
 void Event_queue_manager::generate_counter_start() {
-
-    auto logger = get_logger_or_exit("telf_logger");
-
-    while (true) {
-        wait();
-
-        // generate counter start signal of each event
-        if (!i_run.read() || i_error_state.read()) {
-            counter_start.write(false);
-        } else {
-            if (i_run_pos_old.read() | counter_finished_sig.read()) {
-                counter_start.write(true);
-
-                logger->trace("{}: counter start @{}", this->name(),
-                              sc_core::sc_time_stamp().to_string());
-            } else {
-                counter_start.write(false);
+    Profile_process profile;
+
+    // generate counter start signal of each event
+    if (!i_run.read() || i_error_state.read()) {
+        counter_start.write(false);
+    } else {
+        if (i_run_pos_old.read() | counter_finished_sig.read()) {
+            counter_start.write(true);
+
+            if (telf_logger->should_log(spdlog::level::trace)) {
+                telf_logger->trace("{}: counter start @{}", this->name(),
+                                   sc_core::sc_time_stamp().to_string());
             }
+        } else {
+            counter_start.write(false);
         }
     }
 }
@@ -193,12 +205,17 @@ void Event_queue_manager::generate_count_finish_sig() {
 
     auto logger = get_logger_or_exit("telf_logger");
 
-    Q_pipe_interface q_pipe_interface;
+    unsigned int v_counter;
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface = q_pipe_interface_sig.read();
+        // the counter has run during the cycles skipped since the last clock edge
+        v_counter            = counter.read() + static_cast<unsigned int>(m_num_skipped_cycles);
+        m_num_skipped_cycles = 0;
+
+        const Q_pipe_interface& q_pipe_interface = q_pipe_interface_sig.read();
         if (counter_start.read()) {
             // event ready to output
             q_pipe_interface_next_sig.write(q_pipe_interface);
@@ -207,8 +224,8 @@ void Event_queue_manager::generate_count_finish_sig() {
 
         // counter is running
         if (counter_running.read()) {
-            if (counter < target_count_value.read()) {
-                counter.write(counter.read() + 1);
+            if (v_counter < target_count_value.read()) {
+                counter.write(v_counter + 1);
             } else {
                 counter_running.write(false);
                 counter.write(0);
@@ -224,7 +241,7 @@ void Event_queue_manager::generate_count_finish_sig() {
         // whether reached the last one count
         if (counter_start.read() && (q_pipe_interface.timing.wait_time == 2)) {
             last_but_one.write(1);
-        } else if ((counter.read() == (target_count_value.read() - 2))) {
+        } else if ((v_counter == (target_count_value.read() - 2))) {
             last_but_one.write(1);
         } else {
             last_but_one.write(0);
@@ -250,33 +267,73 @@ void Event_queue_manager::do_output() {
 
     while (true) {
         wait();
+        Profile_process profile;
         q_pipe_interface.reset();
 
         // output event
         if (counter_finished_sig.read()) {
+            m_num_cycles_no_output = 0;
+
             q_pipe_interface = q_pipe_interface_next_sig.read();
             out_q_pipe_interface.write(q_pipe_interface);
 
-            logger->trace("{}: dequeue @{}, timing label '0x{:x}'", this->name(),
-                          sc_core::sc_time_stamp().to_string(), q_pipe_interface.timing.label);
+            if (logger->should_log(spdlog::level::trace)) {
+                logger->trace("{}: dequeue @{}, timing label '0x{:x}'", this->name(),
+                              sc_core::sc_time_stamp().to_string(), q_pipe_interface.timing.label);
+            }
         } else {
-            q_pipe_interface.ops.resize(m_num_qubits);
+            m_num_cycles_no_output++;
+
+            q_pipe_interface.ops.assign_default(m_num_qubits);
             out_q_pipe_interface.write(q_pipe_interface);
         }
     }
 }
 
+uint64_t Event_queue_manager::num_idle_cycles() {
+    unsigned int cycles_per_50MHz =
+      Idle_skipper::get_instance().cycles_per_50MHz(Clock_domain::CLOCK_200MHZ);
+
+    // the pipeline before the queue is empty, and the last event has gone on long ago. The
+    // analog digital interface, the qubit simulator and the measurement register file after it
+    // tell themselves whether they are empty.
+    if (m_num_cycles_no_input < IDLE_QUIET_CYCLES * cycles_per_50MHz ||
+        m_num_cycles_no_output < IDLE_QUIET_CYCLES) {
+        return 0;
+    }
+
+    // only the counter of the current event is running
+    if (!counter_running.read() || counter_start.read() || counter_finished_sig.read() ||
+        last_but_one.read() || event_queue_read_sig.read()) {
+        return 0;
+    }
+
+    // the last cycles before the event is output are simulated, see generate_count_finish_sig()
+    uint64_t v_counter = counter.read() + m_num_skipped_cycles;
+    uint64_t target    = target_count_value.read();
+    if (v_counter + 3 > target) return 0;
+    return target - 3 - v_counter;
+}
+
+void Event_queue_manager::skip_cycles(uint64_t num_cycles) {
+    unsigned int cycles_per_50MHz =
+      Idle_skipper::get_instance().cycles_per_50MHz(Clock_domain::CLOCK_200MHZ);
+
+    m_num_cycles_no_input += num_cycles * cycles_per_50MHz;
+    m_num_cycles_no_output += num_cycles;
+
+    // only the running counter changes, see num_idle_cycles()
+    if (counter_running.read()) m_num_skipped_cycles += num_cycles;
+}
+
 void Event_queue_manager::log_telf() {
-    Q_pipe_interface q_pipe_interface;
     while (true) {
 
         wait();
-
-        q_pipe_interface.reset();
-        q_pipe_interface = out_q_pipe_interface.read();
+        Profile_process profile;
 
         if (is_telf_on) {
-            telf_os << q_pipe_interface;
+            telf_os << out_q_pipe_interface.read();
         }
     }
 }
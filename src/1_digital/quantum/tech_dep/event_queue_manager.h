@@ -8,6 +8,7 @@
 #include "generic_if.h"
 #include "global_counter.h"
 #include "global_json.h"
+#include "idle_skip.h"
 #include "num_util.h"
 #include "q_data_type.h"
 #include "telf_module.h"
@@ -20,7 +21,7 @@ using sc_core::sc_signal;
 using sc_core::sc_vector;
 using sc_dt::sc_uint;
 
-class Event_queue_manager : public Telf_module {
+class Event_queue_manager : public Telf_module, public Idle_skippable {
   public:
     // input
     sc_in<bool> in_clock;
@@ -70,6 +71,12 @@ class Event_queue_manager : public Telf_module {
   public:
     unsigned int m_num_qubits;
 
+    // idle cycles, see idle_skip.h. The counter of the current event has to be advanced by the
+    // cycles skipped since the last 50 MHz clock edge.
+    uint64_t m_num_cycles_no_input  = 0;  // 200 MHz cycles without any event written
+    uint64_t m_num_cycles_no_output = 0;  // 50 MHz cycles without any event output
+    uint64_t m_num_skipped_cycles   = 0;
+
   public:
     // methods
     void read_fifo();
@@ -99,6 +106,10 @@ class Event_queue_manager : public Telf_module {
     // write log
     void log_telf();
 
+  public:
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
+
   public:
     void config();
 
@@ -1,5 +1,7 @@
 #include "fast_conditional_execution.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Fast_conditional_execution::config() {
@@ -7,7 +9,7 @@ void Fast_conditional_execution::config() {
 
     m_num_qubits = global_config.num_qubits;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "meas_ena_cancel");
 }
 
@@ -25,7 +27,9 @@ Fast_conditional_execution::Fast_conditional_execution(const sc_core::sc_module_
     SC_CTHREAD(do_output, in_50MHz_clock.pos());
 
     // output log
-    SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -36,24 +40,23 @@ void Fast_conditional_execution::do_output() {
 
     auto logger = get_logger_or_exit("console");
 
-    Q_pipe_interface  q_pipe_interface;
-    Generic_meas_if   meas;
-    std::vector<bool> vec_meas_ena_cancel;
+    Q_pipe_interface q_pipe_interface;
+    Generic_meas_if  meas;
+    Bit_set          meas_ena_cancel;
 
     while (true) {
         wait();
+        Profile_process profile;
 
         // clear meas info
         meas.reset();
-        vec_meas_ena_cancel.clear();
 
         // when received reset sig
         if (reset.read()) {
             // reset meas_ena_cancel
-            for (size_t i = 0; i < m_num_qubits; ++i) {
-                vec_meas_ena_cancel.push_back(false);
-            }
-            meas.set_meas_ena_cancel(vec_meas_ena_cancel);
+            meas_ena_cancel.resize(m_num_qubits);
+            meas_ena_cancel.reset();
+            meas.set_meas_ena_cancel(meas_ena_cancel);
             out_Qp2MRF_meas_cancel.write(meas);
 
             // reset operations
@@ -65,19 +68,17 @@ void Fast_conditional_execution::do_output() {
 
         q_pipe_interface = in_q_pipe_interface.read();
 
-        // traverse each qubit operation to find measurement operation
-        for (size_t i = 0; i < q_pipe_interface.ops.size(); ++i) {
+        // one bit for each qubit operation
+        if (!q_pipe_interface.ops.empty()) meas.timing = q_pipe_interface.timing;
 
-            meas.timing = q_pipe_interface.timing;
-
-            // TODO: currently fast condition execution has not been designed yet
-            // if execute condition on i-th qubit which has a measurement operation is not
-            // satisfied,then meas_ena_cancel should be set false on i-th qubit
-            // it will be done in future work. we set it false just for now.
-            vec_meas_ena_cancel.push_back(false);
-        }
+        // TODO: currently fast condition execution has not been designed yet
+        // if execute condition on i-th qubit which has a measurement operation is not
+        // satisfied,then meas_ena_cancel should be set false on i-th qubit
+        // it will be done in future work. we set it false just for now.
+        meas_ena_cancel.resize(q_pipe_interface.ops.size());
+        meas_ena_cancel.reset();
 
-        meas.set_meas_ena_cancel(vec_meas_ena_cancel);
+        meas.set_meas_ena_cancel(meas_ena_cancel);
         out_Qp2MRF_meas_cancel.write(meas);
 
         // TODO: currently fast condition execution has not been designed yet
@@ -88,33 +89,21 @@ void Fast_conditional_execution::do_output() {
 }
 
 void Fast_conditional_execution::log_telf() {
-
-    Generic_meas_if   meas;
-    std::vector<bool> vec_meas_ena_cancel;
-    bool              meas_issue_cancel;
-
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (is_telf_on) {
 
-            // clear previous data
-            vec_meas_ena_cancel.clear();
-
-            meas                = out_Qp2MRF_meas_cancel.read();
-            vec_meas_ena_cancel = meas.get_meas_ena_cancel();
-
-            meas_issue_cancel = 0;
-            for (size_t i = 0; i < vec_meas_ena_cancel.size(); ++i) {
-                meas_issue_cancel |= vec_meas_ena_cancel[i];
-            }
+            const Generic_meas_if& meas            = out_Qp2MRF_meas_cancel.read();
+            const Bit_set&         meas_ena_cancel = meas.get_meas_ena_cancel();
 
-            if (meas_issue_cancel) {
+            if (meas_ena_cancel.any()) {
                 // telf_os << meas;
                 telf_os << std::setfill(' ') << std::setw(12) << meas.timing.label;
-                for (size_t i = 0; i < vec_meas_ena_cancel.size(); ++i) {
-                    telf_os << " " << std::setfill(' ') << std::setw(3) << vec_meas_ena_cancel[i];
+                for (size_t i = 0; i < meas_ena_cancel.size(); ++i) {
+                    telf_os << " " << std::setfill(' ') << std::setw(3) << meas_ena_cancel.test(i);
                 }
                 telf_os << std::endl;
             }
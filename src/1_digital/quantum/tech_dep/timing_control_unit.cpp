@@ -1,5 +1,7 @@
 #include "timing_control_unit.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Timing_control_unit::config() {
@@ -34,23 +36,22 @@ Timing_control_unit::Timing_control_unit(const sc_core::sc_module_name& n)
     out_Qp2clp_ready.initialize(true);
 
     // methods
-    SC_THREAD(do_output);
+    SC_METHOD(do_output);
     sensitive << out_eq_almostfull << reset;
+    dont_initialize();
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
-// thread
+// method
 void Timing_control_unit::do_output() {
-    while (true) {
-        wait();
-
-        // whether quantum pipeline is ready
-        if (reset.read()) {
-            out_Qp2clp_ready = true;
-        } else {
-            out_Qp2clp_ready = !out_eq_almostfull.read();
-        }
+    Profile_process profile;
+
+    // whether quantum pipeline is ready
+    if (reset.read()) {
+        out_Qp2clp_ready = true;
+    } else {
+        out_Qp2clp_ready = !out_eq_almostfull.read();
     }
 }
 
@@ -2,15 +2,32 @@
 
 #include <sstream>
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Address_decoder::config() {
     Global_config& global_config = Global_config::get_instance();
 
     m_num_qubits = global_config.num_qubits;
+    m_levelized  = global_config.levelized_q_pipe;
 
     out_edges_of_qubit = global_config.out_edges_of_qubit;
     in_edges_of_qubit  = global_config.in_edges_of_qubit;
+
+    qubits_of_edge.clear();
+    for (size_t q = 0; q < out_edges_of_qubit.size(); ++q) {
+        for (unsigned int edge : out_edges_of_qubit[q]) {
+            if (edge >= qubits_of_edge.size()) qubits_of_edge.resize(edge + 1);
+            qubits_of_edge[edge].first = q;
+        }
+    }
+    for (size_t q = 0; q < in_edges_of_qubit.size(); ++q) {
+        for (unsigned int edge : in_edges_of_qubit[q]) {
+            if (edge >= qubits_of_edge.size()) qubits_of_edge.resize(edge + 1);
+            qubits_of_edge[edge].second = q;
+        }
+    }
 }
 
 Address_decoder::Address_decoder(const sc_core::sc_module_name& n)
@@ -21,197 +38,193 @@ Address_decoder::Address_decoder(const sc_core::sc_module_name& n)
 
     config();
 
-    SC_THREAD(mask_decode);
-    sensitive << in_q_pipe_interface;
+    vec_qop.resize(m_num_qubits);  // used for hardwire addressing
+    m_q_pipe_interface.reserve(m_num_qubits, Global_config::get_instance().vliw_width);
+
+    if (!m_levelized) {
+        SC_METHOD(mask_decode);
+        sensitive << in_q_pipe_interface;
+        dont_initialize();
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
 void Address_decoder::mask_decode() {
+    Profile_process profile;
 
-    auto logger = get_logger_or_exit("telf_logger");
-
-    Q_pipe_interface         q_pipe_interface;
-    Fledged_qop              qop;
-    std::vector<Fledged_qop> vec_qop;
-    std::vector<size_t>      qubit_tuple;
+    decode_mask(in_q_pipe_interface.read(), m_q_pipe_interface);
 
-    std::stringstream ss;  // log stringstream
+    out_q_pipe_interface.write(m_q_pipe_interface);
+}
 
-    vec_qop.resize(m_num_qubits);  // used for hardwire addressing
+void Address_decoder::check_mask_bit(size_t bit, size_t num_bits, const std::string& kind) {
+    if (bit < num_bits) return;
 
-    while (true) {
-        wait();
+    auto logger = get_logger_or_exit("console");
+    logger->error("{}: The bit {} of the mask selects no {} out of the {}. Simulation aborts!",
+                  this->name(), bit, kind, num_bits);
+    exit(EXIT_FAILURE);
+}
 
-        ss.str("");  // clear log stringstream
+void Address_decoder::decode_mask(const Q_pipe_interface& input,
+                                  Q_pipe_interface&       q_pipe_interface) {
 
-        q_pipe_interface = in_q_pipe_interface.read();
+    Fledged_qop&         qop         = m_qop;
+    std::vector<size_t>& qubit_tuple = m_qubit_tuple;
 
-        for (size_t i = 0; i < m_num_qubits; ++i) {  // clear qop at the begin of every cycle
-            vec_qop[i].reset();
-        }
+    // the list of qubits is only formatted when it is logged
+    bool              log_qubits = telf_logger->should_log(spdlog::level::debug);
+    std::stringstream ss;  // log stringstream
 
-        if (reset.read()) {  // when received reset signals
-            q_pipe_interface.reset();
-            for (size_t i = 0; i < m_num_qubits; ++i) {  // push hardwire operation
-                q_pipe_interface.ops.push_back(vec_qop[i]);
-            }
+    q_pipe_interface = input;
 
-            out_q_pipe_interface.write(q_pipe_interface);
+    for (size_t i = 0; i < m_num_qubits; ++i) {  // clear qop at the begin of every cycle
+        vec_qop[i].reset();
+    }
+    qubit_tuple.clear();
 
-            continue;
+    if (reset.read()) {  // when received reset signals
+        q_pipe_interface.reset();
+        for (size_t i = 0; i < m_num_qubits; ++i) {  // push hardwire operation
+            q_pipe_interface.ops.push_back(vec_qop[i]);
         }
 
-        if (q_pipe_interface.if_content.valid_qop) {
-            qop = q_pipe_interface.ops[0];
-            // addressing type is indirect reg num
-            if (qop.addr.type.c_type == INDIRECT_REG_NUM) {
+        return;
+    }
 
-                if (qop.addr.type.q_num_type ==
-                    SINGLE) {  // check each mask bit of single-qubit operation
+    if (q_pipe_interface.if_content.valid_qop) {
+        qop = input.ops[0];
+        // addressing type is indirect reg num
+        if (qop.addr.type.c_type == INDIRECT_REG_NUM) {
 
-                    ss << "{";
-                    for (size_t i = 0; i < qop.addr.sq_op_addr.mask.get_width(); ++i) {
-                        if ((qop.addr.sq_op_addr.mask.get_value() >> i) & 0x1) {
+            if (qop.addr.type.q_num_type ==
+                SINGLE) {  // check each mask bit of single-qubit operation
+                const Bit_set& mask = qop.addr.sq_op_addr.mask;
 
-                            vec_qop[i]                  = qop;  // set i-th hardwire qubit
-                            vec_qop[i].timing           = q_pipe_interface.timing;
-                            vec_qop[i].addr.type.c_type = HARDWIRE;
-                            vec_qop[i].addr.sq_op_addr.qubit_indices.push_back(i);
+                if (log_qubits) ss << "{";
+                mask.for_each([&](size_t i) {
+                    check_mask_bit(i, m_num_qubits, "qubit");
 
-                            ss << i << " ";
-                        }
-                    }
+                    vec_qop[i]                  = qop;  // set i-th hardwire qubit
+                    vec_qop[i].timing           = q_pipe_interface.timing;
+                    vec_qop[i].addr.type.c_type = HARDWIRE;
+                    vec_qop[i].addr.sq_op_addr.qubit_indices.push_back(i);
 
-                    ss << "}";
-                    logger->debug("{}: type:single, mask:0x{:x}, indice:{}", this->name(),
-                                  qop.addr.sq_op_addr.mask.get_value(), ss.str());
-                } else {  // check each mask bit of multi-qubit operation, get left qubit and right
-                    // qubit
-                    ss << "{";
-                    size_t left_qubit, right_qubit;
-                    for (size_t i = 0; i < qop.addr.mq_op_addr.mask.get_width(); ++i) {
-
-                        if ((qop.addr.mq_op_addr.mask.get_value() >> i) & 0x1) {  // mask bit valid
-                            for (size_t j = 0; j < out_edges_of_qubit.size();
-                                 ++j) {  // left qubit addr
-                                std::vector<unsigned int>::iterator it = std::find(
-                                  out_edges_of_qubit[j].begin(), out_edges_of_qubit[j].end(), i);
-
-                                if (it != out_edges_of_qubit[j].end()) {
-                                    left_qubit = j;
-                                    break;
-                                }
-                            }
-
-                            for (size_t k = 0; k < in_edges_of_qubit.size();
-                                 ++k) {  // right qubit addr
-                                std::vector<unsigned int>::iterator it = std::find(
-                                  in_edges_of_qubit[k].begin(), in_edges_of_qubit[k].end(), i);
-                                if (it != in_edges_of_qubit[k].end()) {
-                                    right_qubit = k;
-                                    break;
-                                }
-                            }
-
-                            // set left qubit and right qubit
-                            qubit_tuple.push_back(left_qubit);
-                            qubit_tuple.push_back(right_qubit);
-
-                            vec_qop[left_qubit]                   = qop;
-                            vec_qop[right_qubit]                  = qop;
-                            vec_qop[left_qubit].timing            = q_pipe_interface.timing;
-                            vec_qop[right_qubit].timing           = q_pipe_interface.timing;
-                            vec_qop[left_qubit].addr.type.c_type  = HARDWIRE;
-                            vec_qop[right_qubit].addr.type.c_type = HARDWIRE;
-                            vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
-                            vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.push_back(
-                              qubit_tuple);
-
-                            qubit_tuple.clear();
-
-                            ss << "(" << left_qubit << " " << right_qubit << ")"
-                               << " ";
-                        }  // end of mask bit valid
-                    }      // end of check each mask bit
+                    if (log_qubits) ss << i << " ";
+                });
 
+                if (log_qubits) {
                     ss << "}";
-                    logger->debug("{}: type:multiple, mask:0x{:x}, tuple:{}", this->name(),
-                                  qop.addr.mq_op_addr.mask.get_value(), ss.str());
-                }  //  end of multipul qubits operation
-
-            } else if (qop.addr.type.c_type == INDIRECT_REG_CONTENT) {
-                // addressing type is indirect reg num
-                if (qop.addr.type.q_num_type == SINGLE) {  // single-qubit operation
-                    ss << "{";
-
-                    // if operation is mock_meas and default register 0 has no assigned qubits
-                    if (qop.op.name == "mock_meas") {
-                        qop.addr.sq_op_addr.qubit_indices.clear();
-                        for (size_t i = 0; i < m_num_qubits; ++i) {
-                            qop.addr.sq_op_addr.qubit_indices.push_back(i);
-                        }
-                    }
+                    telf_logger->debug("{}: type:single, mask:0x{}, indice:{}", this->name(),
+                                       mask.to_hex(), ss.str());
+                }
+            } else {  // check each mask bit of multi-qubit operation, get left qubit and right
+                // qubit
+                const Bit_set& mask = qop.addr.mq_op_addr.mask;
 
-                    for (size_t i = 0; i < qop.addr.sq_op_addr.qubit_indices.size(); ++i) {
+                if (log_qubits) ss << "{";
+                mask.for_each([&](size_t edge) {
+                    check_mask_bit(edge, qubits_of_edge.size(), "edge");
 
-                        size_t qubit = qop.addr.sq_op_addr.qubit_indices[i];
+                    size_t left_qubit  = qubits_of_edge[edge].first;
+                    size_t right_qubit = qubits_of_edge[edge].second;
 
-                        vec_qop[qubit]                  = qop;  // set i-th hardwire qubit
-                        vec_qop[qubit].timing           = q_pipe_interface.timing;
-                        vec_qop[qubit].addr.type.c_type = HARDWIRE;
-                        vec_qop[qubit].addr.sq_op_addr.qubit_indices.clear();
-                        vec_qop[qubit].addr.sq_op_addr.qubit_indices.push_back(qubit);
+                    // set left qubit and right qubit
+                    qubit_tuple.push_back(left_qubit);
+                    qubit_tuple.push_back(right_qubit);
 
-                        ss << qubit << " ";
-                    }
+                    vec_qop[left_qubit]                   = qop;
+                    vec_qop[right_qubit]                  = qop;
+                    vec_qop[left_qubit].timing            = q_pipe_interface.timing;
+                    vec_qop[right_qubit].timing           = q_pipe_interface.timing;
+                    vec_qop[left_qubit].addr.type.c_type  = HARDWIRE;
+                    vec_qop[right_qubit].addr.type.c_type = HARDWIRE;
+                    vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
+                    vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
+
+                    qubit_tuple.clear();
+
+                    if (log_qubits) ss << "(" << left_qubit << " " << right_qubit << ")"
+                       << " ";
+                });
 
+                if (log_qubits) {
                     ss << "}";
-                    logger->debug("{}: type:single, indice:{}", this->name(), ss.str());
-
-                } else {  // multi-qubit operation
-                    size_t left_qubit, right_qubit;
-                    ss << "{";
-                    for (size_t i = 0; i < qop.addr.mq_op_addr.qubit_tuples.size(); ++i) {
-                        left_qubit  = qop.addr.mq_op_addr.qubit_tuples[i][0];
-                        right_qubit = qop.addr.mq_op_addr.qubit_tuples[i][1];
-
-                        // set left qubit and right qubit
-                        qubit_tuple.push_back(left_qubit);
-                        qubit_tuple.push_back(right_qubit);
-
-                        vec_qop[left_qubit]                  = qop;
-                        vec_qop[left_qubit].timing           = q_pipe_interface.timing;
-                        vec_qop[left_qubit].addr.type.c_type = HARDWIRE;
-                        vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.clear();
-                        vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
-
-                        vec_qop[right_qubit]                  = qop;
-                        vec_qop[right_qubit].timing           = q_pipe_interface.timing;
-                        vec_qop[right_qubit].addr.type.c_type = HARDWIRE;
-                        vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.clear();
-                        vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
-
-                        qubit_tuple.clear();
-
-                        ss << "(" << left_qubit << " " << right_qubit << ")"
-                           << " ";
+                    telf_logger->debug("{}: type:multiple, mask:0x{}, tuple:{}", this->name(),
+                                       mask.to_hex(), ss.str());
+                }
+            }  //  end of multipul qubits operation
+
+        } else if (qop.addr.type.c_type == INDIRECT_REG_CONTENT) {
+            // addressing type is indirect reg num
+            if (qop.addr.type.q_num_type == SINGLE) {  // single-qubit operation
+                if (log_qubits) ss << "{";
+
+                // if operation is mock_meas and default register 0 has no assigned qubits
+                if (qop.op.name == "mock_meas") {
+                    qop.addr.sq_op_addr.qubit_indices.clear();
+                    for (size_t i = 0; i < m_num_qubits; ++i) {
+                        qop.addr.sq_op_addr.qubit_indices.push_back(i);
                     }
+                }
 
-                    ss << "}";
-                    logger->debug("{}: type:multiple, tuple:{}", this->name(), ss.str());
+                for (size_t i = 0; i < qop.addr.sq_op_addr.qubit_indices.size(); ++i) {
+
+                    size_t qubit = qop.addr.sq_op_addr.qubit_indices[i];
+
+                    vec_qop[qubit]                  = qop;  // set i-th hardwire qubit
+                    vec_qop[qubit].timing           = q_pipe_interface.timing;
+                    vec_qop[qubit].addr.type.c_type = HARDWIRE;
+                    vec_qop[qubit].addr.sq_op_addr.qubit_indices.clear();
+                    vec_qop[qubit].addr.sq_op_addr.qubit_indices.push_back(qubit);
+
+                    if (log_qubits) ss << qubit << " ";
                 }
-            } else {
-                // other addressing mode do not need address decoder
-            }
-        }
 
-        q_pipe_interface.ops.clear();
-        for (size_t i = 0; i < m_num_qubits; ++i) {  // push hardwire operation
-            q_pipe_interface.ops.push_back(vec_qop[i]);
+                if (log_qubits) ss << "}";
+                telf_logger->debug("{}: type:single, indice:{}", this->name(), ss.str());
+
+            } else {  // multi-qubit operation
+                size_t left_qubit, right_qubit;
+                if (log_qubits) ss << "{";
+                for (size_t i = 0; i < qop.addr.mq_op_addr.qubit_tuples.size(); ++i) {
+                    left_qubit  = qop.addr.mq_op_addr.qubit_tuples[i][0];
+                    right_qubit = qop.addr.mq_op_addr.qubit_tuples[i][1];
+
+                    // set left qubit and right qubit
+                    qubit_tuple.push_back(left_qubit);
+                    qubit_tuple.push_back(right_qubit);
+
+                    vec_qop[left_qubit]                  = qop;
+                    vec_qop[left_qubit].timing           = q_pipe_interface.timing;
+                    vec_qop[left_qubit].addr.type.c_type = HARDWIRE;
+                    vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.clear();
+                    vec_qop[left_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
+
+                    vec_qop[right_qubit]                  = qop;
+                    vec_qop[right_qubit].timing           = q_pipe_interface.timing;
+                    vec_qop[right_qubit].addr.type.c_type = HARDWIRE;
+                    vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.clear();
+                    vec_qop[right_qubit].addr.mq_op_addr.qubit_tuples.push_back(qubit_tuple);
+
+                    qubit_tuple.clear();
+
+                    if (log_qubits) ss << "(" << left_qubit << " " << right_qubit << ")"
+                       << " ";
+                }
+
+                if (log_qubits) ss << "}";
+                telf_logger->debug("{}: type:multiple, tuple:{}", this->name(), ss.str());
+            }
+        } else {
+            // other addressing mode do not need address decoder
         }
+    }
 
-        out_q_pipe_interface.write(q_pipe_interface);
+    q_pipe_interface.ops.clear();
+    for (size_t i = 0; i < m_num_qubits; ++i) {  // push hardwire operation
+        q_pipe_interface.ops.push_back(vec_qop[i]);
     }
 }
 
@@ -4,6 +4,8 @@
 #define ADDR_DECODER_LATENCY 1
 
 #include <systemc>
+#include <utility>
+#include <vector>
 
 #include "generic_if.h"
 #include "global_counter.h"
@@ -37,8 +39,26 @@ class Address_decoder : public Telf_module {
     // The list of all the edges whose left qubit is i.
     std::vector<std::vector<unsigned int>> out_edges_of_qubit;
 
+    // The left and right qubits of each edge, so that a mask bit is decoded without a search.
+    std::vector<std::pair<size_t, size_t>> qubits_of_edge;
+
   public:
     unsigned int m_num_qubits;
+    bool         m_levelized;
+
+  protected:
+    // the operation on each qubit
+    std::vector<Fledged_qop> vec_qop;
+
+    // the output of mask_decode, kept across activations
+    Q_pipe_interface m_q_pipe_interface;
+
+    // the scratch of decode_mask, kept so that the decoding does not allocate in every cycle
+    Fledged_qop         m_qop;
+    std::vector<size_t> m_qubit_tuple;
+
+    // aborts the simulation when a mask bit has no qubit or edge
+    void check_mask_bit(size_t bit, size_t num_bits, const std::string& kind);
 
   public:
     void config();
@@ -49,6 +69,9 @@ class Address_decoder : public Telf_module {
 
     void mask_decode();
 
+    // the output for the current input. Also called by the levelized quantum pipeline.
+    void decode_mask(const Q_pipe_interface& input, Q_pipe_interface& q_pipe_interface);
+
   public:
     Address_decoder(const sc_core::sc_module_name& n);
 
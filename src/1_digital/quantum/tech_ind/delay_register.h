@@ -3,6 +3,8 @@
 
 #include <systemc>
 
+#include "profiler.h"
+
 namespace cactus {
 
 using sc_core::sc_in;
@@ -23,6 +25,7 @@ SC_MODULE(Delay_register) {
     inline void delay() {
         while (true) {
             wait();
+            Profile_process profile;
 
             delay_buffer[0].write(data_in.read());
 
@@ -1,12 +1,14 @@
 #include "mask_reg_file.h"
 
 #include "num_util.h"
+#include "profiler.h"
 
 namespace cactus {
 void Mask_register_file::config() {
     Global_config& global_config = Global_config::get_instance();
 
     m_vliw_width = global_config.vliw_width;
+    m_levelized  = global_config.levelized_q_pipe;
 }
 
 Mask_register_file::Mask_register_file(const sc_core::sc_module_name& n)
@@ -17,141 +19,166 @@ Mask_register_file::Mask_register_file(const sc_core::sc_module_name& n)
 
     config();
 
-    SC_CTHREAD(do_write, in_clock.pos());
-    SC_CTHREAD(do_read, in_clock.pos());
+    if (!m_levelized) {
+        SC_CTHREAD(do_write, in_clock.pos());
+        SC_CTHREAD(do_read, in_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
 void Mask_register_file::do_write() {
+    while (true) {
+        wait();
+        Profile_process profile;
+
+        write_regs(in_q_pipe_interface.read());
+    }
+}
 
-    auto logger = get_logger_or_exit("telf_logger");
+void Mask_register_file::do_read() {
 
     Q_pipe_interface q_pipe_interface;
-    Q_tgt_addr       addr_to_set;
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();  // clear everything at the begin of every cycle
+        read_regs(in_q_pipe_interface.read(), q_pipe_interface);
 
-        if (!reset.read()) {
+        out_q_pipe_interface.write(q_pipe_interface);
+    }
+}
 
-            q_pipe_interface = in_q_pipe_interface.read();
+void Mask_register_file::write_regs(const Q_pipe_interface& q_pipe_interface) {
+
+    if (reset.read()) {
+        // the registers set by the fast-forward engine, if it has run
+        const Arch_state& ff_state = Global_config::get_instance().ff_state;
+        if (ff_state.valid) {
+            q_mask_reg = ff_state.mask_reg;
         } else {
             q_mask_reg.reset();
         }
+        return;
+    }
 
-        if (!q_pipe_interface.if_content.valid_set_addr) continue;
-
-        // update register
-        for (size_t i = 0; i < q_pipe_interface.addrs_to_set.size(); ++i) {
+    if (!q_pipe_interface.if_content.valid_set_addr) return;
 
-            addr_to_set = q_pipe_interface.addrs_to_set[i];
-            if (addr_to_set.type.c_type == INDIRECT_REG_NUM) {  // register addressing
+    // the masks are only formatted when they are logged
+    bool log_masks = telf_logger->should_log(spdlog::level::debug);
 
-                if (addr_to_set.type.q_num_type ==
-                    SINGLE) {  // update register which used for single-qubit operation
-                    q_mask_reg.set_reg_mask(addr_to_set.sq_op_addr.mask,
-                                            addr_to_set.indirect_addr_reg_num,
-                                            addr_to_set.type.q_num_type);
+    // update register
+    for (size_t i = 0; i < q_pipe_interface.addrs_to_set.size(); ++i) {
 
-                    logger->debug("{}: update register,type:single,reg_num:{},mask:0x{:x}",
-                                  this->name(), addr_to_set.indirect_addr_reg_num.get_value(),
-                                  addr_to_set.sq_op_addr.mask.get_value());
+        const Q_tgt_addr& addr_to_set = q_pipe_interface.addrs_to_set[i];
+        if (addr_to_set.type.c_type == INDIRECT_REG_NUM) {  // register addressing
 
-                } else {  // update register which used for multi-qubit operation
-                    q_mask_reg.set_reg_mask(addr_to_set.mq_op_addr.mask,
-                                            addr_to_set.indirect_addr_reg_num,
-                                            addr_to_set.type.q_num_type);
+            if (addr_to_set.type.q_num_type ==
+                SINGLE) {  // update register which used for single-qubit operation
+                q_mask_reg.set_reg_mask(addr_to_set.sq_op_addr.mask,
+                                        addr_to_set.indirect_addr_reg_num,
+                                        addr_to_set.type.q_num_type);
 
-                    logger->debug("{}: update register,type:multiple,reg_num:{}, mask:0x{:x}",
-                                  this->name(), addr_to_set.indirect_addr_reg_num.get_value(),
-                                  addr_to_set.mq_op_addr.mask.get_value());
+                if (log_masks) {
+                    telf_logger->debug("{}: update register,type:single,reg_num:{},mask:0x{}",
+                                       this->name(), addr_to_set.indirect_addr_reg_num.get_value(),
+                                       addr_to_set.sq_op_addr.mask.to_hex());
                 }
-            } else if (addr_to_set.type.c_type == INDIRECT_REG_CONTENT) {
-                if (addr_to_set.type.q_num_type == SINGLE) {
-                    // update register which used for single-qubit operation
-                    q_mask_reg.set_s_reg_content(addr_to_set.sq_op_addr.qubit_indices,
-                                                 addr_to_set.indirect_addr_reg_num);
-                } else {
-                    // update register which used for multi-qubit operation
-                    q_mask_reg.set_m_reg_content(addr_to_set.mq_op_addr.qubit_tuples,
-                                                 addr_to_set.indirect_addr_reg_num);
+
+            } else {  // update register which used for multi-qubit operation
+                q_mask_reg.set_reg_mask(addr_to_set.mq_op_addr.mask,
+                                        addr_to_set.indirect_addr_reg_num,
+                                        addr_to_set.type.q_num_type);
+
+                if (log_masks) {
+                    telf_logger->debug("{}: update register,type:multiple,reg_num:{}, mask:0x{}",
+                                       this->name(), addr_to_set.indirect_addr_reg_num.get_value(),
+                                       addr_to_set.mq_op_addr.mask.to_hex());
                 }
+            }
+        } else if (addr_to_set.type.c_type == INDIRECT_REG_CONTENT) {
+            if (addr_to_set.type.q_num_type == SINGLE) {
+                // update register which used for single-qubit operation
+                q_mask_reg.set_s_reg_content(addr_to_set.sq_op_addr.qubit_indices,
+                                             addr_to_set.indirect_addr_reg_num);
             } else {
-                // other addressing mode do not need write register
+                // update register which used for multi-qubit operation
+                q_mask_reg.set_m_reg_content(addr_to_set.mq_op_addr.qubit_tuples,
+                                             addr_to_set.indirect_addr_reg_num);
             }
+        } else {
+            // other addressing mode do not need write register
         }
     }
 }
 
-void Mask_register_file::do_read() {
+void Mask_register_file::read_regs(const Q_pipe_interface& input, Q_pipe_interface& output) {
 
-    auto logger = get_logger_or_exit("telf_logger");
+    output.reset();  // clear everything at the begin of every cycle
 
-    Q_pipe_interface q_pipe_interface;
-    Fledged_qop      qop;
+    if (reset.read()) {  // when received reset sig
+        return;
+    }
 
-    while (true) {
-        wait();
+    output = input;
 
-        q_pipe_interface.reset();  // clear everything at the begin of every cycle
+    if (output.if_content.valid_qop) {
 
-        if (reset.read()) {  // when received reset sig
-            out_q_pipe_interface.write(q_pipe_interface);
-            continue;
-        }
+        // the masks are only formatted when they are logged
+        bool log_masks = telf_logger->should_log(spdlog::level::debug);
 
-        q_pipe_interface = in_q_pipe_interface.read();
+        // read register
+        Fledged_qop& qop = m_qop;
+        qop              = input.ops[0];
+        if (qop.addr.type.c_type == INDIRECT_REG_NUM) {
+            // single-qubit operation
+            if (qop.addr.type.q_num_type == SINGLE) {
+                qop.addr.sq_op_addr.mask =
+                  q_mask_reg.get_reg_mask(qop.addr.indirect_addr_reg_num, qop.addr.type.q_num_type);
 
-        if (q_pipe_interface.if_content.valid_qop) {
-
-            // read register
-            qop = q_pipe_interface.ops[0];
-            if (qop.addr.type.c_type == INDIRECT_REG_NUM) {
-                // single-qubit operation
-                if (qop.addr.type.q_num_type == SINGLE) {
-                    qop.addr.sq_op_addr.mask = q_mask_reg.get_reg_mask(
-                      qop.addr.indirect_addr_reg_num, qop.addr.type.q_num_type);
-
-                    logger->debug("{}: read register,type:single,reg_num:{},mask:0x{:x}",
-                                  this->name(), qop.addr.indirect_addr_reg_num.get_value(),
-                                  qop.addr.sq_op_addr.mask.get_value());
-                } else {
-                    // multi-qubit operation
-                    qop.addr.mq_op_addr.mask = q_mask_reg.get_reg_mask(
-                      qop.addr.indirect_addr_reg_num, qop.addr.type.q_num_type);
-
-                    logger->debug("{}: read register,type:multiple,reg_num:{},mask:0x{:x}",
-                                  this->name(), qop.addr.indirect_addr_reg_num.get_value(),
-                                  qop.addr.mq_op_addr.mask.get_value());
+                if (log_masks) {
+                    telf_logger->debug("{}: read register,type:single,reg_num:{},mask:0x{}",
+                                       this->name(), qop.addr.indirect_addr_reg_num.get_value(),
+                                       qop.addr.sq_op_addr.mask.to_hex());
                 }
-            } else if (qop.addr.type.c_type == INDIRECT_REG_CONTENT) {
-                if (qop.addr.type.q_num_type == SINGLE) {
-                    // single-qubit operation
-                    qop.addr.sq_op_addr.qubit_indices =
-                      q_mask_reg.get_s_reg_content(qop.addr.indirect_addr_reg_num);
-
-                } else {
-                    // multi-qubit operation
-                    qop.addr.mq_op_addr.qubit_tuples =
-                      q_mask_reg.get_m_reg_content(qop.addr.indirect_addr_reg_num);
+            } else {
+                // multi-qubit operation
+                qop.addr.mq_op_addr.mask =
+                  q_mask_reg.get_reg_mask(qop.addr.indirect_addr_reg_num, qop.addr.type.q_num_type);
+
+                if (log_masks) {
+                    telf_logger->debug("{}: read register,type:multiple,reg_num:{},mask:0x{}",
+                                       this->name(), qop.addr.indirect_addr_reg_num.get_value(),
+                                       qop.addr.mq_op_addr.mask.to_hex());
                 }
+            }
+        } else if (qop.addr.type.c_type == INDIRECT_REG_CONTENT) {
+            if (qop.addr.type.q_num_type == SINGLE) {
+                // single-qubit operation
+                const std::vector<size_t>& content =
+                  q_mask_reg.get_s_reg_content(qop.addr.indirect_addr_reg_num);
+                qop.addr.sq_op_addr.qubit_indices.assign(content.begin(), content.end());
 
             } else {
-                // other addressing mode donot need read register
+                // multi-qubit operation
+                const std::vector<std::vector<size_t>>& content =
+                  q_mask_reg.get_m_reg_content(qop.addr.indirect_addr_reg_num);
+                qop.addr.mq_op_addr.qubit_tuples.assign(content.begin(), content.end());
             }
 
-            q_pipe_interface.ops.clear();
-            q_pipe_interface.ops.push_back(qop);
         } else {
-            // other addressing mode do not need read register
+            // other addressing mode donot need read register
         }
 
-        q_pipe_interface.if_content.valid_set_addr = false;  // make it false for subsequent modules
-        out_q_pipe_interface.write(q_pipe_interface);
+        output.ops.clear();
+        output.ops.push_back(qop);
+    } else {
+        // other addressing mode do not need read register
     }
+
+    // make it false for subsequent modules
+    output.if_content.valid_set_addr = false;
 }
 
 void Mask_register_file::add_telf_header() {}
@@ -33,13 +33,22 @@ class Mask_register_file : public Telf_module {
   private:  // internal register
     Q_mask_reg q_mask_reg;
 
+    // the operation read by read_regs, kept so that reading does not allocate in every cycle
+    Fledged_qop m_qop;
+
   public:  // global setting
     unsigned int m_vliw_width;
+    bool         m_levelized;
 
   public:  // methods:
     void do_write();
     void do_read();
 
+    // what the two clocked threads do in one cycle. Also called by the levelized quantum
+    // pipeline.
+    void write_regs(const Q_pipe_interface& q_pipe_interface);
+    void read_regs(const Q_pipe_interface& input, Q_pipe_interface& output);
+
   public:
     void config();
 
@@ -1,13 +1,16 @@
 #include "meas_issue_gen.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Meas_issue_gen::config() {
     Global_config& global_config = Global_config::get_instance();
 
     m_num_qubits = global_config.num_qubits;
+    m_levelized  = global_config.levelized_q_pipe;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "meas_issue_gen");
 }
 
@@ -21,11 +24,13 @@ Meas_issue_gen::Meas_issue_gen(const sc_core::sc_module_name& n)
 
     open_telf_file();
 
-    // output measure issue
-    SC_CTHREAD(do_output, in_clock.pos());
+    if (!m_levelized) {
+        // output measure issue
+        SC_CTHREAD(do_output, in_clock.pos());
 
-    // output log
-    SC_CTHREAD(log_telf, in_clock.pos());
+        // output log
+        SC_CTHREAD(log_telf, in_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -34,103 +39,90 @@ Meas_issue_gen::~Meas_issue_gen() { close_telf_file(); }
 
 void Meas_issue_gen::do_output() {
 
-    auto logger = get_logger_or_exit("telf_logger");
-
-    Q_pipe_interface  q_pipe_interface;
-    Generic_meas_if   meas;
-    std::vector<bool> vec_meas_ena;
+    Generic_meas_if meas;
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        // clear meas info
-        meas.reset();
-        vec_meas_ena.clear();
+        gen_meas_issue(in_q_pipe_interface.read(), meas);
 
-        // when received reset sig
-        if (reset.read()) {
-            // reset meas_ena
-            for (size_t i = 0; i < m_num_qubits; ++i) {
-                vec_meas_ena.push_back(false);
-            }
-            meas.set_meas_ena(vec_meas_ena);
-            out_Qp2MRF_meas_issue.write(meas);
+        out_Qp2MRF_meas_issue.write(meas);
+    }
+}
 
-            continue;
-        }
+void Meas_issue_gen::gen_meas_issue(const Q_pipe_interface& q_pipe_interface,
+                                    Generic_meas_if&        meas) {
 
-        q_pipe_interface = in_q_pipe_interface.read();
-
-        // iterate each qubit operation to find measurement operation
-        for (size_t i = 0; i < q_pipe_interface.ops.size(); ++i) {
-
-            meas.timing = q_pipe_interface.timing;
-            // representation is opcode
-            if (q_pipe_interface.ops[i].op.type == REPR_OPCODE) {
-                if (q_pipe_interface.ops[i].op.opcode == 6) {
-                    vec_meas_ena.push_back(true);
-                } else {
-                    vec_meas_ena.push_back(false);
-                }
-            } else if (q_pipe_interface.ops[i].op.type == REPR_NAME) {
-                // representation is name
-                if ((q_pipe_interface.ops[i].op.name.find("Meas") !=
-                     q_pipe_interface.ops[i].op.name.npos) ||
-                    (q_pipe_interface.ops[i].op.name.find("meas") !=
-                     q_pipe_interface.ops[i].op.name.npos)) {
-                    vec_meas_ena.push_back(true);
-                } else {
-                    vec_meas_ena.push_back(false);
-                }
-            } else if (q_pipe_interface.ops[i].op.type == REPR_UNDEF) {
-                // invalid operation
-                vec_meas_ena.push_back(false);
-            } else {
-                // other representation type is not support now
-                logger->error(
-                  "{}: Representation type {} is not support currently. Simulation Aborts!",
-                  this->name(), q_pipe_interface.ops[i].op.type);
-                exit(EXIT_FAILURE);
-            }
-        }  // end of iterate each qubit operation to find measurement operation
+    // clear meas info
+    meas.reset();
 
-        meas.set_meas_ena(vec_meas_ena);
-        out_Qp2MRF_meas_issue.write(meas);
+    // when received reset sig
+    if (reset.read()) {
+        // reset meas_ena
+        m_meas_ena.resize(m_num_qubits);
+        m_meas_ena.reset();
+        meas.set_meas_ena(m_meas_ena);
+
+        return;
     }
-}
 
-void Meas_issue_gen::log_telf() {
+    m_meas_ena.resize(q_pipe_interface.ops.size());
+    m_meas_ena.reset();
 
-    Generic_meas_if   meas;
-    std::vector<bool> vec_meas_ena;
-    bool              meas_issue;
+    // iterate each qubit operation to find measurement operation
+    for (size_t i = 0; i < q_pipe_interface.ops.size(); ++i) {
 
-    while (true) {
+        meas.timing = q_pipe_interface.timing;
+        // representation is opcode
+        if (q_pipe_interface.ops[i].op.type == REPR_OPCODE) {
+            if (q_pipe_interface.ops[i].op.opcode == 6) {
+                m_meas_ena.set(i);
+            }
+        } else if (q_pipe_interface.ops[i].op.type == REPR_NAME) {
+            // representation is name
+            if ((q_pipe_interface.ops[i].op.name.find("Meas") !=
+                 q_pipe_interface.ops[i].op.name.npos) ||
+                (q_pipe_interface.ops[i].op.name.find("meas") !=
+                 q_pipe_interface.ops[i].op.name.npos)) {
+                m_meas_ena.set(i);
+            }
+        } else if (q_pipe_interface.ops[i].op.type == REPR_UNDEF) {
+            // invalid operation
+        } else {
+            // other representation type is not support now
+            telf_logger->error(
+              "{}: Representation type {} is not support currently. Simulation Aborts!",
+              this->name(), q_pipe_interface.ops[i].op.type);
+            exit(EXIT_FAILURE);
+        }
+    }  // end of iterate each qubit operation to find measurement operation
+
+    meas.set_meas_ena(m_meas_ena);
+}
 
+void Meas_issue_gen::log_telf() {
+    while (true) {
         wait();
+        Profile_process profile;
 
-        if (is_telf_on) {
+        log_telf_line(out_Qp2MRF_meas_issue.read());
+    }
+}
 
-            // clear previous data
-            vec_meas_ena.clear();
+void Meas_issue_gen::log_telf_line(const Generic_meas_if& meas) {
 
-            meas         = out_Qp2MRF_meas_issue.read();
-            vec_meas_ena = meas.get_meas_ena();
+    if (!is_telf_on) return;
 
-            meas_issue = 0;
-            for (size_t i = 0; i < vec_meas_ena.size(); ++i) {
-                meas_issue |= vec_meas_ena[i];
-            }
+    const Bit_set& meas_ena = meas.get_meas_ena();
 
-            if (meas_issue) {
-                // telf_os << meas;
-                telf_os << std::setfill(' ') << std::setw(12) << meas.timing.label;
-                for (size_t i = 0; i < vec_meas_ena.size(); ++i) {
-                    telf_os << " " << std::setfill(' ') << std::setw(3) << vec_meas_ena[i];
-                }
-                telf_os << std::endl;
-            }
+    if (meas_ena.any()) {
+        // telf_os << meas;
+        telf_os << std::setfill(' ') << std::setw(12) << meas.timing.label;
+        for (size_t i = 0; i < meas_ena.size(); ++i) {
+            telf_os << " " << std::setfill(' ') << std::setw(3) << meas_ena.test(i);
         }
+        telf_os << std::endl;
     }
 }
 
@@ -36,6 +36,10 @@ class Meas_issue_gen : public Telf_module {
   public:
     unsigned int m_num_qubits;
     std::string  m_instruction_type;
+    bool         m_levelized;
+
+  protected:
+    Bit_set m_meas_ena;
 
   public:
     void config();
@@ -43,8 +47,13 @@ class Meas_issue_gen : public Telf_module {
     // output measure issue
     void do_output();
 
+    // the measurement issue for the current input. Also called by the levelized quantum
+    // pipeline.
+    void gen_meas_issue(const Q_pipe_interface& q_pipe_interface, Generic_meas_if& meas);
+
     // output log
     void log_telf();
+    void log_telf_line(const Generic_meas_if& meas);
     void add_telf_header();
     void add_telf_line();
 
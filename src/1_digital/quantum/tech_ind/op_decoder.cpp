@@ -1,10 +1,13 @@
 #include "op_decoder.h"
 
+#include "profiler.h"
+
 namespace cactus {
 void Op_decoder::config() {
     Global_config& global_config = Global_config::get_instance();
 
     m_num_qubits = global_config.num_qubits;
+    m_levelized  = global_config.levelized_q_pipe;
 }
 
 Op_decoder::Op_decoder(const sc_core::sc_module_name& n)
@@ -15,23 +18,27 @@ Op_decoder::Op_decoder(const sc_core::sc_module_name& n)
 
     config();
 
-    SC_THREAD(do_output);
-    sensitive << in_q_pipe_interface;
+    if (!m_levelized) {
+        SC_METHOD(do_output);
+        sensitive << in_q_pipe_interface;
+        dont_initialize();
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
 void Op_decoder::do_output() {
+    Profile_process profile;
 
-    Q_pipe_interface q_pipe_interface;
+    decode_op(in_q_pipe_interface.read(), m_q_pipe_interface);
 
-    while (true) {
-        wait();
+    out_q_pipe_interface.write(m_q_pipe_interface);
+}
 
-        // TODO: operation from one representation to another
-        // currently, straight with input
-        out_q_pipe_interface.write(in_q_pipe_interface.read());
-    }
+void Op_decoder::decode_op(const Q_pipe_interface& input, Q_pipe_interface& output) {
+    // TODO: operation from one representation to another
+    // currently, straight with input
+    output = input;
 }
 
 void Op_decoder::add_telf_header() {}
@@ -30,10 +30,18 @@ class Op_decoder : public Telf_module {
 
   public:
     unsigned int m_num_qubits;
+    bool         m_levelized;
+
+  protected:
+    // the output of do_output, kept across activations
+    Q_pipe_interface m_q_pipe_interface;
 
   public:  // methods
     void do_output();
 
+    // the output for the current input. Also called by the levelized quantum pipeline.
+    void decode_op(const Q_pipe_interface& input, Q_pipe_interface& output);
+
   public:
     void config();
 
@@ -1,5 +1,7 @@
 #include "operation_combiner.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Operation_combiner::config() {
@@ -7,8 +9,9 @@ void Operation_combiner::config() {
 
     m_num_qubits = global_config.num_qubits;
     m_vliw_width = global_config.vliw_width;
+    m_levelized  = global_config.levelized_q_pipe;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "op_combine");
 }
 
@@ -21,23 +24,30 @@ Operation_combiner::Operation_combiner(const sc_core::sc_module_name& n)
     config();
     open_telf_file();
 
+    m_merged_q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
+    m_cached_q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
+
     // initial signals
     Q_pipe_interface q_pipe_interface;
-    q_pipe_interface.ops.resize(m_num_qubits);
+    q_pipe_interface.ops.assign_default(m_num_qubits);
     q_pipe_interface_sig.write(q_pipe_interface);
+    m_cached_q_pipe_interface = q_pipe_interface;
 
     // initial I/O port
     vec_in_q_pipe_interface.init(m_vliw_width);
 
-    SC_CTHREAD(do_output, in_clock.pos());
+    if (!m_levelized) {
+        SC_CTHREAD(do_output, in_clock.pos());
 
-    SC_THREAD(detect_timestamp_match);
-    sensitive << i_timestamp << reset;
-    for (size_t i = 0; i < m_vliw_width; ++i) {
-        sensitive << vec_in_q_pipe_interface[i];
-    }
+        SC_METHOD(detect_timestamp_match);
+        sensitive << i_timestamp << reset;
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            sensitive << vec_in_q_pipe_interface[i];
+        }
+        dont_initialize();
 
-    SC_CTHREAD(log_telf, in_clock.pos());
+        SC_CTHREAD(log_telf, in_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -46,152 +56,173 @@ Operation_combiner::~Operation_combiner() { close_telf_file(); }
 
 void Operation_combiner::do_output() {
 
-    auto logger = get_logger_or_exit("console");
-
     std::vector<Q_pipe_interface> vec_q_pipe_interface;
     Q_pipe_interface              q_pipe_interface;
+    Q_pipe_interface              cached_q_pipe_interface;
+    unsigned int                  timestamp;
 
     vec_q_pipe_interface.resize(m_vliw_width);
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();  // clear the temp variable
-        q_pipe_interface.ops.resize(m_num_qubits);
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            vec_q_pipe_interface[i] = vec_in_q_pipe_interface[i].read();
+        }
+        cached_q_pipe_interface = q_pipe_interface_sig.read();
+        timestamp               = i_timestamp.read();
 
-        if (reset.read()) {  // when received reset sig
-            i_timestamp.write(0);
-            out_q_pipe_interface.write(q_pipe_interface);
-            q_pipe_interface_sig.write(q_pipe_interface);  // update cached data
+        combine(vec_q_pipe_interface, i_timestamp_match.read(), cached_q_pipe_interface, timestamp,
+                q_pipe_interface);
 
-            continue;
-        }
+        out_q_pipe_interface.write(q_pipe_interface);
+        i_timestamp.write(timestamp);                         // update timing label
+        q_pipe_interface_sig.write(cached_q_pipe_interface);  // update cached data
+    }
+}
 
-        // merge each vliw pipelane
-        // only need to care Q_pipe_interface member variable: if_content,timing,vliw_width,ops
-        for (size_t i = 0; i < m_vliw_width; ++i) {
-            vec_q_pipe_interface[i].reset();
-            vec_q_pipe_interface[i] = vec_in_q_pipe_interface[i].read();
+void Operation_combiner::combine(const std::vector<Q_pipe_interface>& vec_q_pipe_interface,
+                                 bool timestamp_match, Q_pipe_interface& cached_q_pipe_interface,
+                                 unsigned int& timestamp, Q_pipe_interface& output) {
 
-            q_pipe_interface.if_content = vec_q_pipe_interface[i].if_content;
-            q_pipe_interface.timing     = vec_q_pipe_interface[i].timing;
-            q_pipe_interface.vliw_width = vec_q_pipe_interface[i].vliw_width;
-
-            for (size_t j = 0; j < vec_q_pipe_interface[i].ops.size(); ++j) {
-
-                if (q_pipe_interface.ops[j].is_valid() &&
-                    vec_q_pipe_interface[i]
-                      .ops[j]
-                      .is_valid()) {  // cause conflict when two operations on the same qubit
-                    logger->error(
-                      "{}: More than one qubit gate on qubit {} at timing label '0x{:x}'",
-                      this->name(), j, q_pipe_interface.timing.label);
-                    exit(EXIT_FAILURE);
-                } else if (!q_pipe_interface.ops[j].is_valid() &&
-                           vec_q_pipe_interface[i].ops[j].is_valid()) {
-
-                    q_pipe_interface.ops[j] = vec_q_pipe_interface[i].ops[j];
-                } else {
-                    // if no valid operation on this qubit,do nothing
-                }
-            }
-        }
+    Q_pipe_interface& q_pipe_interface = m_merged_q_pipe_interface;
+
+    q_pipe_interface.reset();  // clear the temp variable
+    q_pipe_interface.ops.assign_default(m_num_qubits);
 
-        // check whether there is a valid qop when if_content.valid_qop == true
-        bool check_valid_qop = false;
-        for (size_t i = 0; i < q_pipe_interface.ops.size(); ++i) {
-            if (q_pipe_interface.ops[i].is_valid()) {
-                check_valid_qop = true;
-                break;
+    // the operations are read through a const list, so that a list without a valid operation
+    // goes on sharing the block of default operations
+    const Slot_vector<Fledged_qop>& merged_ops = q_pipe_interface.ops;
+
+    if (reset.read()) {  // when received reset sig
+        timestamp               = 0;
+        output                  = q_pipe_interface;
+        cached_q_pipe_interface = q_pipe_interface;  // update cached data
+        return;
+    }
+
+    // merge each vliw pipelane
+    // only need to care Q_pipe_interface member variable: if_content,timing,vliw_width,ops
+    for (size_t i = 0; i < m_vliw_width; ++i) {
+        q_pipe_interface.if_content = vec_q_pipe_interface[i].if_content;
+        q_pipe_interface.timing     = vec_q_pipe_interface[i].timing;
+        q_pipe_interface.vliw_width = vec_q_pipe_interface[i].vliw_width;
+
+        for (size_t j = 0; j < vec_q_pipe_interface[i].ops.size(); ++j) {
+
+            if (merged_ops[j].is_valid() &&
+                vec_q_pipe_interface[i]
+                  .ops[j]
+                  .is_valid()) {  // cause conflict when two operations on the same qubit
+                auto logger = get_logger_or_exit("console");
+                logger->error("{}: More than one qubit gate on qubit {} at timing label '0x{:x}'",
+                              this->name(), j, q_pipe_interface.timing.label);
+                exit(EXIT_FAILURE);
+            } else if (!merged_ops[j].is_valid() &&
+                       vec_q_pipe_interface[i].ops[j].is_valid()) {
+
+                q_pipe_interface.ops[j] = vec_q_pipe_interface[i].ops[j];
+            } else {
+                // if no valid operation on this qubit,do nothing
             }
         }
-        if (!check_valid_qop && q_pipe_interface.if_content.valid_qop) {
-            logger->error(
-              "{}: No qubit has been assigned at current quantum operation with timing label "
-              "'0x{:x}'. Simulations aborts!",
-              this->name(), q_pipe_interface.timing.label);
-            exit(EXIT_FAILURE);
-        }
+    }
 
-        // do output when received next timing label
-        if (!i_timestamp_match) {
-            out_q_pipe_interface.write(q_pipe_interface_sig);
-            i_timestamp.write(q_pipe_interface.timing.label);  // update timing label
-            q_pipe_interface_sig.write(q_pipe_interface);      // update cached data
-        } else {
-            Q_pipe_interface tmp_q_pipe_interface;
-            tmp_q_pipe_interface.ops.resize(m_num_qubits);
+    // check whether there is a valid qop when if_content.valid_qop == true
+    bool check_valid_qop = false;
+    for (size_t i = 0; i < merged_ops.size(); ++i) {
+        if (merged_ops[i].is_valid()) {
+            check_valid_qop = true;
+            break;
+        }
+    }
+    if (!check_valid_qop && q_pipe_interface.if_content.valid_qop) {
+        auto logger = get_logger_or_exit("console");
+        logger->error(
+          "{}: No qubit has been assigned at current quantum operation with timing label "
+          "'0x{:x}'. Simulations aborts!",
+          this->name(), q_pipe_interface.timing.label);
+        exit(EXIT_FAILURE);
+    }
 
-            out_q_pipe_interface.write(tmp_q_pipe_interface);  // default output
+    // do output when received next timing label
+    if (!timestamp_match) {
+        output                  = cached_q_pipe_interface;
+        timestamp               = q_pipe_interface.timing.label;  // update timing label
+        cached_q_pipe_interface = q_pipe_interface;               // update cached data
+        return;
+    }
 
-            tmp_q_pipe_interface = q_pipe_interface_sig.read();
+    output = Q_pipe_interface();  // default output
+    output.ops.assign_default(m_num_qubits);
+
+    // merge next instruction which has the same timing label
+    // only need to care Q_pipe_interface member variable: if_content,timing,ops
+    cached_q_pipe_interface.if_content.valid_qop |= q_pipe_interface.if_content.valid_qop;
+    cached_q_pipe_interface.if_content.valid_wait |= q_pipe_interface.if_content.valid_wait;
+
+    if (cached_q_pipe_interface.timing.label != q_pipe_interface.timing.label) {
+        auto logger = get_logger_or_exit("console");
+        logger->error(
+          "{}: Error occurs when combining the operations at different instructions which "
+          "has the same timing label '0x{:x}'.",
+          this->name(), q_pipe_interface.timing.label);
+        exit(EXIT_FAILURE);
+    }
 
-            // merge next instruction which has the same timing label
-            // only need to care Q_pipe_interface member variable: if_content,timing,ops
-            tmp_q_pipe_interface.if_content.valid_qop |= q_pipe_interface.if_content.valid_qop;
-            tmp_q_pipe_interface.if_content.valid_wait |= q_pipe_interface.if_content.valid_wait;
+    const Slot_vector<Fledged_qop>& cached_ops = cached_q_pipe_interface.ops;
 
-            if (tmp_q_pipe_interface.timing.label != q_pipe_interface.timing.label) {
-                logger->error(
-                  "{}: Error occurs when combining the operations at different instructions which "
-                  "has the same timing label '0x{:x}'.",
-                  this->name(), q_pipe_interface.timing.label);
-                exit(EXIT_FAILURE);
-            }
+    for (size_t j = 0; j < m_num_qubits; ++j) {
 
-            for (size_t j = 0; j < m_num_qubits; ++j) {
-
-                if (tmp_q_pipe_interface.ops[j].is_valid() &&
-                    q_pipe_interface.ops[j]
-                      .is_valid()) {  // cause conflict when two operations on the same qubit
-                    logger->error("{}: Operations conflict on qubit {} at timing label '0x{:x}'",
-                                  this->name(), j, q_pipe_interface.timing.label);
-                    exit(EXIT_FAILURE);
-                } else if (!tmp_q_pipe_interface.ops[j].is_valid() &&
-                           q_pipe_interface.ops[j].is_valid()) {
-
-                    tmp_q_pipe_interface.ops[j] = q_pipe_interface.ops[j];
-                } else {
-                    // if no valid operation on this qubit,do nothing
-                }
-            }
+        if (cached_ops[j].is_valid() &&
+            merged_ops[j].is_valid()) {  // cause conflict when two operations on the same qubit
+            auto logger = get_logger_or_exit("console");
+            logger->error("{}: Operations conflict on qubit {} at timing label '0x{:x}'",
+                          this->name(), j, q_pipe_interface.timing.label);
+            exit(EXIT_FAILURE);
+        } else if (!cached_ops[j].is_valid() && merged_ops[j].is_valid()) {
 
-            q_pipe_interface_sig.write(tmp_q_pipe_interface);
+            cached_q_pipe_interface.ops[j] = merged_ops[j];
+        } else {
+            // if no valid operation on this qubit,do nothing
         }
     }
 }
 
 void Operation_combiner::detect_timestamp_match() {
+    Profile_process profile;
 
-    std::vector<Q_pipe_interface> vec_q_pipe_interface;
-    vec_q_pipe_interface.resize(m_vliw_width);
+    i_timestamp_match =
+      is_timestamp_match(vec_in_q_pipe_interface[m_vliw_width - 1].read(), i_timestamp.read());
+}
 
-    while (true) {
-        wait();
+bool Operation_combiner::is_timestamp_match(const Q_pipe_interface& last_q_pipe_interface,
+                                            unsigned int            timestamp) {
 
-        for (size_t i = 0; i < m_vliw_width; ++i) {
-            vec_q_pipe_interface[i] = vec_in_q_pipe_interface[i].read();
-            if (!reset.read() && (i_timestamp != vec_q_pipe_interface[i].timing.label)) {
-                i_timestamp_match = false;
-            } else {
-                i_timestamp_match = true;
-            }
-        }
-    }
+    return reset.read() || (timestamp == last_q_pipe_interface.timing.label);
+}
+
+void Operation_combiner::combine_cycle(const std::vector<Q_pipe_interface>& vec_q_pipe_interface,
+                                       Q_pipe_interface&                    output) {
+
+    bool timestamp_match = is_timestamp_match(vec_q_pipe_interface[m_vliw_width - 1], m_timestamp);
+
+    combine(vec_q_pipe_interface, timestamp_match, m_cached_q_pipe_interface, m_timestamp, output);
 }
 
 void Operation_combiner::log_telf() {
-    Q_pipe_interface q_pipe_interface;
     while (true) {
-
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();
-        q_pipe_interface = out_q_pipe_interface.read();
+        log_telf_line(out_q_pipe_interface.read());
+    }
+}
 
-        if (is_telf_on) {
-            telf_os << q_pipe_interface;
-        }
+void Operation_combiner::log_telf_line(const Q_pipe_interface& q_pipe_interface) {
+    if (is_telf_on) {
+        telf_os << q_pipe_interface;
     }
 }
 
@@ -40,6 +40,15 @@ class Operation_combiner : public Telf_module {
   public:
     unsigned int m_num_qubits;
     unsigned int m_vliw_width;
+    bool         m_levelized;
+
+  protected:
+    // the operations of the vliw pipelanes in the current cycle
+    Q_pipe_interface m_merged_q_pipe_interface;
+
+    // the state kept in q_pipe_interface_sig and i_timestamp, in the levelized quantum pipeline
+    Q_pipe_interface m_cached_q_pipe_interface;
+    unsigned int     m_timestamp = 0;
 
   public:  // methods
     void do_output();
@@ -48,6 +57,21 @@ class Operation_combiner : public Telf_module {
 
     void log_telf();  // log method
 
+    // one cycle of do_output(), with the state passed in and out
+    void combine(const std::vector<Q_pipe_interface>& vec_q_pipe_interface, bool timestamp_match,
+                 Q_pipe_interface& cached_q_pipe_interface, unsigned int& timestamp,
+                 Q_pipe_interface& output);
+
+    // every pipelane carries the timing of the same instruction, the last one decides
+    bool is_timestamp_match(const Q_pipe_interface& last_q_pipe_interface, unsigned int timestamp);
+
+    // one cycle of the combiner in the levelized quantum pipeline, on the outputs of the vliw
+    // pipelanes in the previous cycle
+    void combine_cycle(const std::vector<Q_pipe_interface>& vec_q_pipe_interface,
+                       Q_pipe_interface&                    output);
+
+    void log_telf_line(const Q_pipe_interface& q_pipe_interface);
+
   public:
     void config();
 
@@ -1,10 +1,21 @@
 #include "q_decoder.h"
 
+#include "global_json.h"
+
 namespace cactus {
 
 Q_decoder::Q_decoder(const sc_core::sc_module_name& n)
-    : Telf_module(n) {}
+    : Telf_module(n) {
+
+    m_levelized = Global_config::get_instance().levelized_q_pipe;
+}
 
 Q_decoder::~Q_decoder() {}
 
+void Q_decoder::log_telf_line(const Q_pipe_interface& q_pipe_interface) {
+    if (is_telf_on) {
+        telf_os << q_pipe_interface;
+    }
+}
+
 }  // namespace cactus
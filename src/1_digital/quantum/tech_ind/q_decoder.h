@@ -28,6 +28,17 @@ class Q_decoder : public Telf_module {
     // interface to the subsequent unit
     sc_out<Q_pipe_interface> out_q_pipe_interface;
 
+  public:
+    // the output of the current cycle, as written by the clocked thread of the decoder. Also
+    // called by the levelized quantum pipeline.
+    virtual void decode(Q_pipe_interface& q_pipe_interface) = 0;
+
+    void log_telf_line(const Q_pipe_interface& q_pipe_interface);
+
+  protected:
+    // the processes are replaced by the levelized quantum pipeline
+    bool m_levelized = false;
+
   public:
     Q_decoder(const sc_core::sc_module_name& n);
 
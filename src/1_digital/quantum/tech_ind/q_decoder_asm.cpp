@@ -4,6 +4,7 @@
 #include <regex>  // regular expression
 
 #include "global_json.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -13,7 +14,7 @@ void Q_decoder_asm::config() {
     m_vliw_width = global_config.vliw_width;
     m_num_qubits = global_config.num_qubits;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "q_decoder_asm");
 }
 
@@ -27,9 +28,11 @@ Q_decoder_asm::Q_decoder_asm(const sc_core::sc_module_name& n)
 
     open_telf_file();
 
-    SC_CTHREAD(output, in_clock.pos());
+    if (!m_levelized) {
+        SC_CTHREAD(output, in_clock.pos());
 
-    SC_CTHREAD(log_telf, in_clock.pos());
+        SC_CTHREAD(log_telf, in_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -38,44 +41,44 @@ Q_decoder_asm::~Q_decoder_asm() { close_telf_file(); }
 
 void Q_decoder_asm::output() {
 
-    auto logger = get_logger_or_exit("telf_logger");
-
     Q_pipe_interface q_pipe_interface;
-    Qasm_instruction cur_insn;
-
-    unsigned int rs_wait;
+    q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();  // clear everything at the beginning of each clock
+        decode(q_pipe_interface);
 
-        if (reset.read()) {  // when recieve reset sig
+        out_q_pipe_interface.write(q_pipe_interface);
+    }
+}
 
-            set_nop(q_pipe_interface);
-            out_q_pipe_interface.write(q_pipe_interface);
-            continue;
-        }
-
-        cur_insn = in_bundle.read();
-        rs_wait  = in_rs_wait_time.read().to_uint();
-
-        if (in_valid_bundle.read()) {
-            cur_insn.parse_q_insn();
-            try {
-                set_q_insn(q_pipe_interface, cur_insn, rs_wait);
-            } catch (...) {
-                logger->error(
-                  "{}: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
-                  this->name(), cur_insn.get_insn_str_in_file(),
-                  cur_insn.get_insn_line_num_in_file());
-                exit(EXIT_FAILURE);
-            }
-        } else {
-            set_nop(q_pipe_interface);
-        }
+void Q_decoder_asm::decode(Q_pipe_interface& q_pipe_interface) {
 
-        out_q_pipe_interface.write(q_pipe_interface);
+    q_pipe_interface.reset();  // clear everything at the beginning of each clock
+
+    if (reset.read()) {  // when recieve reset sig
+        set_nop(q_pipe_interface);
+        return;
+    }
+
+    if (!in_valid_bundle.read()) {
+        set_nop(q_pipe_interface);
+        return;
+    }
+
+    Qasm_instruction cur_insn = in_bundle.read();
+    unsigned int     rs_wait  = in_rs_wait_time.read().to_uint();
+
+    // the operands have been decoded when the program was loaded
+    try {
+        set_q_insn(q_pipe_interface, cur_insn, rs_wait);
+    } catch (...) {
+        telf_logger->error("{}: Cannot parse asm instruction '{}' at line {}. Simulation aborts!",
+                           this->name(), cur_insn.get_insn_str_in_file(),
+                           cur_insn.get_insn_line_num_in_file());
+        exit(EXIT_FAILURE);
     }
 }
 
@@ -105,7 +108,8 @@ void Q_decoder_asm::set_q_insn(Q_pipe_interface& q_pipe_interface, Qasm_instruct
 
 void Q_decoder_asm::set_smis(Q_pipe_interface& q_pipe_interface, Qasm_instruction& instruction) {
 
-    Q_tgt_addr addr_to_set;
+    Q_tgt_addr& addr_to_set = m_addr_to_set;
+    addr_to_set.reset();
 
     q_pipe_interface.if_content.valid_wait     = false;
     q_pipe_interface.if_content.valid_qop      = false;
@@ -123,16 +127,14 @@ void Q_decoder_asm::set_smis(Q_pipe_interface& q_pipe_interface, Qasm_instructio
 
     q_pipe_interface.addrs_to_set.push_back(addr_to_set);
 
-    for (size_t i = 0; i < m_vliw_width; ++i) {  // reset operations
-        Fledged_qop fledge_qop;
-        fledge_qop.reset();
-        q_pipe_interface.ops.push_back(fledge_qop);
-    }
+    q_pipe_interface.ops.assign_default(m_vliw_width);  // reset operations
 }
 
 void Q_decoder_asm::set_smit(Q_pipe_interface& q_pipe_interface, Qasm_instruction& instruction) {
 
-    Q_tgt_addr addr_to_set;
+    Q_tgt_addr& addr_to_set = m_addr_to_set;
+    addr_to_set.reset();
+
     q_pipe_interface.if_content.valid_wait     = false;
     q_pipe_interface.if_content.valid_qop      = false;
     q_pipe_interface.if_content.valid_set_addr = true;
@@ -149,11 +151,7 @@ void Q_decoder_asm::set_smit(Q_pipe_interface& q_pipe_interface, Qasm_instructio
 
     q_pipe_interface.addrs_to_set.push_back(addr_to_set);
 
-    for (size_t i = 0; i < m_vliw_width; ++i) {  // reset operations
-        Fledged_qop fledge_qop;
-        fledge_qop.reset();
-        q_pipe_interface.ops.push_back(fledge_qop);
-    }
+    q_pipe_interface.ops.assign_default(m_vliw_width);  // reset operations
 }
 
 void Q_decoder_asm::set_wait(Q_pipe_interface& q_pipe_interface, Qasm_instruction& instruction,
@@ -181,11 +179,7 @@ void Q_decoder_asm::set_wait(Q_pipe_interface& q_pipe_interface, Qasm_instructio
 
     logger->trace("{}: content_type:wait, wait_time:0x{:x}", this->name(), wait_time);
 
-    for (size_t i = 0; i < m_vliw_width; ++i) {  // reset operations
-        Fledged_qop fledge_qop;
-        fledge_qop.reset();
-        q_pipe_interface.ops.push_back(fledge_qop);
-    }
+    q_pipe_interface.ops.assign_default(m_vliw_width);  // reset operations
 }
 
 void Q_decoder_asm::set_qop(Q_pipe_interface& q_pipe_interface, Qasm_instruction& instruction) {
@@ -218,7 +212,8 @@ void Q_decoder_asm::set_qop(Q_pipe_interface& q_pipe_interface, Qasm_instruction
 
     // set operation info
     for (size_t i = 0; i < instruction.get_q_op_name().size(); ++i) {
-        Fledged_qop fledge_qop;
+        Fledged_qop& fledge_qop = m_qop;
+        fledge_qop.reset();
 
         fledge_qop.timing  = q_pipe_interface.timing;
         fledge_qop.op.type = REPR_NAME;
@@ -243,24 +238,15 @@ void Q_decoder_asm::set_nop(Q_pipe_interface& q_pipe_interface) {
     q_pipe_interface.if_content.valid_qop      = false;
     q_pipe_interface.if_content.valid_set_addr = false;
 
-    for (size_t i = 0; i < m_vliw_width; ++i) {  // reset operations
-        Fledged_qop fledge_qop;
-        fledge_qop.reset();
-        q_pipe_interface.ops.push_back(fledge_qop);
-    }
+    q_pipe_interface.ops.assign_default(m_vliw_width);  // reset operations
 }
 
 void Q_decoder_asm::log_telf() {
-    Q_pipe_interface q_pipe_interface;
-
     while (true) {
         wait();
+        Profile_process profile;
 
-        q_pipe_interface.reset();
-        q_pipe_interface = out_q_pipe_interface.read();
-        if (is_telf_on) {
-            telf_os << q_pipe_interface;
-        }
+        log_telf_line(out_q_pipe_interface.read());
     }
 }
 
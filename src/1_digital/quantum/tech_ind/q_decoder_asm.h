@@ -42,12 +42,19 @@ class Q_decoder_asm : public Q_decoder {
   public:  // methods
     void output();
 
+    void decode(Q_pipe_interface& q_pipe_interface) override;
+
     void log_telf();
 
   public:
     unsigned int m_num_qubits;
     unsigned int m_vliw_width;
 
+  protected:
+    // the address and the operation being decoded, kept so that their qubit lists are reused
+    Q_tgt_addr  m_addr_to_set;
+    Fledged_qop m_qop;
+
   public:
     Q_decoder_asm(const sc_core::sc_module_name& n);
 
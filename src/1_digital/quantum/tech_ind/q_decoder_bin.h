@@ -27,6 +27,7 @@ class Q_decoder_bin : public Q_decoder {
   public:
     // Write the output. Clocked thread.
     void do_output();
+    void decode(Q_pipe_interface& q_pipe_interface) override;
     void log_telf();
 
     void config();
@@ -1,5 +1,7 @@
 #include "q_tech_ind.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Q_tech_ind::config() {
@@ -8,6 +10,7 @@ void Q_tech_ind::config() {
     m_num_qubits       = global_config.num_qubits;
     m_vliw_width       = global_config.vliw_width;
     m_instruction_type = global_config.instruction_type;
+    m_levelized        = global_config.levelized_q_pipe;
 }
 
 Q_tech_ind::Q_tech_ind(const sc_core::sc_module_name& n)
@@ -86,8 +89,25 @@ Q_tech_ind::Q_tech_ind(const sc_core::sc_module_name& n)
     // output
     meas_issue_gen.out_Qp2MRF_meas_issue(out_Qp2MRF_meas_issue);
 
+    // the storage of the interfaces between the stages, allocated once
+    m_distributed_q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
+
     // methods
-    SC_CTHREAD(do_output, in_clock.pos());
+    if (m_levelized) {
+        m_vec_vliw_in.resize(m_vliw_width);
+        m_vec_vliw_out.resize(m_vliw_width);
+
+        m_decoded_q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
+        m_combined_q_pipe_interface.reserve(m_num_qubits, m_vliw_width);
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            m_vec_vliw_in[i].reserve(m_num_qubits, m_vliw_width);
+            m_vec_vliw_out[i].reserve(m_num_qubits, m_vliw_width);
+        }
+
+        SC_CTHREAD(do_levelized_cycle, in_clock.pos());
+    } else {
+        SC_CTHREAD(do_output, in_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -101,64 +121,102 @@ Q_tech_ind::~Q_tech_ind() {
 
 void Q_tech_ind::do_output() {
 
-    auto logger = get_logger_or_exit("telf_logger");
-
-    Q_pipe_interface tmp_in_q_pipe_interface;
-    Q_pipe_interface tmp_out_q_pipe_interface;
+    std::vector<Q_pipe_interface> vec_q_pipe_interface(m_vliw_width);
+    for (size_t i = 0; i < m_vliw_width; ++i) {
+        vec_q_pipe_interface[i].reserve(m_num_qubits, m_vliw_width);
+    }
 
     while (true) {
         wait();
+        Profile_process profile;
 
-        tmp_in_q_pipe_interface.reset();  // clear everything at the begin of every cycle
+        distribute(q_pipe_interface_sig.read(), vec_q_pipe_interface);
 
-        if (!reset.read()) {
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            vec_vliw_in_pipe_sig[i].write(vec_q_pipe_interface[i]);
+        }
+    }
+}
 
-            tmp_in_q_pipe_interface = q_pipe_interface_sig.read();
+void Q_tech_ind::distribute(const Q_pipe_interface&        q_pipe_interface,
+                            std::vector<Q_pipe_interface>& vec_q_pipe_interface) {
 
-            if (tmp_in_q_pipe_interface.if_content.valid_wait) {  // generate new timing point
+    Q_pipe_interface& tmp_out_q_pipe_interface = m_distributed_q_pipe_interface;
 
-                if ((tgt_timing_type == TIMING_POINT) &&
-                    (tmp_in_q_pipe_interface.timing.type == WAIT_TIME)) {
+    if (reset.read()) {
+        current_timing.type      = TIMING_POINT;
+        current_timing.wait_time = 0;
+        current_timing.label     = 0;  // reset timing label
 
-                    current_timing.type      = TIMING_POINT;
-                    current_timing.wait_time = tmp_in_q_pipe_interface.timing.wait_time;
-                    current_timing.label++;  // update timing label
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            vec_q_pipe_interface[i].reset();
+        }
+        return;
+    }
 
-                    logger->debug("{}: generate new timing point,wait time:0x{:x},label:0x{:x}",
-                                  this->name(), current_timing.wait_time, current_timing.label);
-                } else {
-                    logger->error(
-                      "{}: Unsupported timing type convertion,source_type:{},"
-                      "target_type:{}",
-                      this->name(), tmp_in_q_pipe_interface.timing.type, tgt_timing_type);
-                    exit(EXIT_FAILURE);
-                }
-            } else {  // do not generate new timing point,still use the previous timing
-            }
+    if (q_pipe_interface.if_content.valid_wait) {  // generate new timing point
 
-            // distribute operations to each vliw pipelane
-            tmp_out_q_pipe_interface        = tmp_in_q_pipe_interface;
-            tmp_out_q_pipe_interface.timing = current_timing;
+        if ((tgt_timing_type == TIMING_POINT) && (q_pipe_interface.timing.type == WAIT_TIME)) {
 
-            for (size_t i = 0; i < tmp_in_q_pipe_interface.ops.size(); ++i) {
-                tmp_out_q_pipe_interface.ops.clear();  // clear operations
+            current_timing.type      = TIMING_POINT;
+            current_timing.wait_time = q_pipe_interface.timing.wait_time;
+            current_timing.label++;  // update timing label
 
-                tmp_out_q_pipe_interface.ops.push_back(
-                  tmp_in_q_pipe_interface.ops[i]);  // push i-th operation
+            telf_logger->debug("{}: generate new timing point,wait time:0x{:x},label:0x{:x}",
+                               this->name(), current_timing.wait_time, current_timing.label);
+        } else {
+            telf_logger->error(
+              "{}: Unsupported timing type convertion,source_type:{},"
+              "target_type:{}",
+              this->name(), q_pipe_interface.timing.type, tgt_timing_type);
+            exit(EXIT_FAILURE);
+        }
+    } else {  // do not generate new timing point,still use the previous timing
+    }
 
-                vec_vliw_in_pipe_sig[i].write(tmp_out_q_pipe_interface);
-            }
+    // distribute operations to each vliw pipelane
+    tmp_out_q_pipe_interface        = q_pipe_interface;
+    tmp_out_q_pipe_interface.timing = current_timing;
 
+    for (size_t i = 0; i < q_pipe_interface.ops.size(); ++i) {
+        if (q_pipe_interface.ops.is_default()) {  // no operation on any vliw pipelane
+            tmp_out_q_pipe_interface.ops.assign_default(1);
         } else {
-            current_timing.type      = TIMING_POINT;
-            current_timing.wait_time = 0;
-            current_timing.label     = 0;  // reset timing label
+            tmp_out_q_pipe_interface.ops.clear();  // clear operations
+
+            tmp_out_q_pipe_interface.ops.push_back(q_pipe_interface.ops[i]);  // push i-th operation
+        }
+
+        vec_q_pipe_interface[i] = tmp_out_q_pipe_interface;
+    }
+}
+
+void Q_tech_ind::do_levelized_cycle() {
 
-            for (size_t i = 0; i < m_vliw_width; ++i) {
-                vec_vliw_in_pipe_sig[i].write(tmp_in_q_pipe_interface);
-            }
+    while (true) {
+        wait();
+        Profile_process profile;
+
+        // from the last stage to the first one, so that every stage reads what the previous one
+        // has written in the last cycle, as through a signal
+        meas_issue_gen.log_telf_line(m_meas_issue);
+        meas_issue_gen.gen_meas_issue(m_combined_q_pipe_interface, m_meas_issue);
+
+        op_combiner.log_telf_line(m_combined_q_pipe_interface);
+        op_combiner.combine_cycle(m_vec_vliw_out, m_combined_q_pipe_interface);
+
+        for (size_t i = 0; i < m_vliw_width; ++i) {
+            vec_vliw_pipelane[i].cycle(m_vec_vliw_in[i], m_vec_vliw_out[i]);
         }
+
+        distribute(m_decoded_q_pipe_interface, m_vec_vliw_in);
+
+        q_decoder->log_telf_line(m_decoded_q_pipe_interface);
+        q_decoder->decode(m_decoded_q_pipe_interface);
+
+        out_q_pipe_interface.write(m_combined_q_pipe_interface);
+        out_Qp2MRF_meas_issue.write(m_meas_issue);
     }
 }
 
-}  // end of namespace cactus
\ No newline at end of file
+}  // end of namespace cactus
@@ -67,12 +67,33 @@ class Q_tech_ind : public Telf_module {
     unsigned int     m_num_qubits;
     unsigned int     m_vliw_width;
     Instruction_type m_instruction_type;
+    bool             m_levelized;
+
+  protected:
+    // the input of a vliw pipelane, kept so that distribute does not allocate in every cycle
+    Q_pipe_interface m_distributed_q_pipe_interface;
+
+  protected:  // the outputs of the stages in the levelized quantum pipeline
+    Q_pipe_interface              m_decoded_q_pipe_interface;
+    std::vector<Q_pipe_interface> m_vec_vliw_in;
+    std::vector<Q_pipe_interface> m_vec_vliw_out;
+    Q_pipe_interface              m_combined_q_pipe_interface;
+    Generic_meas_if               m_meas_issue;
 
   public:
     void config();
 
     void do_output();  // methods
 
+    // the operations of an instruction to the vliw pipelanes, with the timing point they belong to
+    void distribute(const Q_pipe_interface&        q_pipe_interface,
+                    std::vector<Q_pipe_interface>& vec_q_pipe_interface);
+
+    // The levelized quantum pipeline. Instead of a SystemC process per stage, every clock cycle
+    // evaluates all the stages as plain function calls, in an order fixed at elaboration. The
+    // outputs are the same, cycle by cycle.
+    void do_levelized_cycle();
+
     Q_tech_ind(const sc_core::sc_module_name& n);
 
     ~Q_tech_ind();
@@ -51,4 +51,13 @@ Vliw_pipelane::Vliw_pipelane(const sc_core::sc_module_name& n)
     logger->trace("Finished initializing {}...", this->name());
 }
 
+void Vliw_pipelane::cycle(const Q_pipe_interface& input, Q_pipe_interface& output) {
+    mask_reg_file.write_regs(input);
+    mask_reg_file.read_regs(input, m_register_addressing);
+
+    addr_mask_decoder.decode_mask(m_register_addressing, m_mask_decode);
+
+    op_decoder.decode_op(m_mask_decode, output);
+}
+
 }  // namespace cactus
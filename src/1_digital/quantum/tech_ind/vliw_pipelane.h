@@ -38,9 +38,17 @@ class Vliw_pipelane : public Telf_module {
     Mask_register_file mask_reg_file;      // register addressing
     Op_decoder         op_decoder;         // operation decoder
 
+  protected:  // the outputs of the internal modules in the levelized quantum pipeline
+    Q_pipe_interface m_register_addressing;
+    Q_pipe_interface m_mask_decode;
+
   public:
     void config();
 
+    // one clock cycle of the pipelane in the levelized quantum pipeline: the mask register file
+    // latches the input, and the address and operation decoders follow combinationally.
+    void cycle(const Q_pipe_interface& input, Q_pipe_interface& output);
+
     Vliw_pipelane(const sc_core::sc_module_name& n);
 
     SC_HAS_PROCESS(Vliw_pipelane);
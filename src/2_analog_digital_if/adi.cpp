@@ -1,6 +1,7 @@
 #include "adi.h"
 
 #include "num_util.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -12,7 +13,7 @@ void Analog_digital_if::config() {
     m_qubit_simulator = global_config.qubit_simulator;
 
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "adi");
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
 }
 
 // instance a convert method, could be specified in configure file
@@ -47,6 +48,8 @@ Analog_digital_if::Analog_digital_if(const sc_core::sc_module_name& n)
     // instance sub module
     instance_adi_convert();
 
+    Idle_skipper::get_instance().add_module(this);
+
     // ------------------------------------------------------------------------------------------
     // signal convert
     // ------------------------------------------------------------------------------------------
@@ -71,7 +74,9 @@ Analog_digital_if::Analog_digital_if(const sc_core::sc_module_name& n)
     msmt_result_gen.out_meas_result(out_meas_result);
 
     // methods
-    SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, in_50MHz_clock.pos());
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
@@ -84,10 +89,29 @@ Analog_digital_if::~Analog_digital_if() {
     }
 }
 
+uint64_t Analog_digital_if::num_idle_cycles() {
+    // a moment or a measurement result on its way through
+    if (ops_2_qsim.read().triggered || !msmt_res.read().results.empty() ||
+        out_meas_result.read().get_meas_data_valid().any()) {
+        return 0;
+    }
+
+    // the converter has nothing to convert, both sides only write the same empty values again
+    const Q_pipe_interface& q_pipe_interface = in_q_pipe_interface.read();
+    for (size_t op_idx = 0; op_idx < q_pipe_interface.ops.size(); ++op_idx) {
+        if (q_pipe_interface.ops[op_idx].is_valid()) return 0;
+    }
+    return UINT64_MAX;
+}
+
+// nothing counts the cycles, the cycle numbers of the moments are derived from the time
+void Analog_digital_if::skip_cycles(uint64_t num_cycles) {}
+
 void Analog_digital_if::log_telf() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (is_telf_on) {
             add_telf_line();
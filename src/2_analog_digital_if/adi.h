@@ -6,6 +6,7 @@
 #include "analog_digital_convert.h"
 #include "generic_if.h"
 #include "global_json.h"
+#include "idle_skip.h"
 #include "interface_lib.h"
 #include "msmt_result_gen.h"
 #include "telf_module.h"
@@ -17,7 +18,7 @@ using sc_core::sc_signal;
 using sc_core::sc_vector;
 using sc_dt::sc_uint;
 
-class Analog_digital_if : public Telf_module {
+class Analog_digital_if : public Telf_module, public Idle_skippable {
   public:  // general IO
     sc_in<bool> in_clock;
     sc_in<bool> reset;
@@ -55,6 +56,10 @@ class Analog_digital_if : public Telf_module {
     // specified a analog-digital signal convert method
     void instance_adi_convert();
 
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
+
   public:
     Analog_digital_if(const sc_core::sc_module_name& n);
 
@@ -1,6 +1,7 @@
 #include "analog_digital_convert.h"
 
 #include "global_counter.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -47,13 +48,13 @@ void Adi_convert_to_quantumsim::signal_convert() {
     auto logger        = get_logger_or_exit("console");
     auto counter_50MHz = global_counter::get("cycle_counter_50MHz");  // get cycle count
 
-    Q_pipe_interface q_pipe_interface;
-    Ops_2_qsim       i_ops;
-    std::string      operation_name;
-    Atom_qop         atom_qop;
+    Ops_2_qsim  i_ops;
+    std::string operation_name;
+    Atom_qop    atom_qop;
 
     while (true) {
         wait();
+        Profile_process profile;
 
         i_ops.reset();
 
@@ -62,7 +63,7 @@ void Adi_convert_to_quantumsim::signal_convert() {
             continue;
         }
 
-        q_pipe_interface = in_q_pipe_interface.read();
+        const Q_pipe_interface& q_pipe_interface = in_q_pipe_interface.read();
 
         for (size_t op_idx = 0; op_idx < q_pipe_interface.ops.size(); ++op_idx) {
 
@@ -160,13 +161,13 @@ void Adi_convert_to_circuit::signal_convert() {
     auto logger        = get_logger_or_exit("console");
     auto counter_50MHz = global_counter::get("cycle_counter_50MHz");  // get cycle count
 
-    Q_pipe_interface q_pipe_interface;
-    Ops_2_qsim       i_ops;
-    std::string      operation_name;
-    Atom_qop         atom_qop;
+    Ops_2_qsim  i_ops;
+    std::string operation_name;
+    Atom_qop    atom_qop;
 
     while (true) {
         wait();
+        Profile_process profile;
 
         i_ops.reset();
 
@@ -175,7 +176,7 @@ void Adi_convert_to_circuit::signal_convert() {
             continue;
         }
 
-        q_pipe_interface = in_q_pipe_interface.read();
+        const Q_pipe_interface& q_pipe_interface = in_q_pipe_interface.read();
 
         // iterate each qubit
         for (size_t op_idx = 0; op_idx < q_pipe_interface.ops.size(); ++op_idx) {
@@ -1,5 +1,7 @@
 #include "msmt_result_gen.h"
 
+#include "profiler.h"
+
 namespace cactus {
 
 void Msmt_result_gen::config() {
@@ -8,7 +10,7 @@ void Msmt_result_gen::config() {
 
     m_num_qubits = global_config.num_qubits;
 
-    is_telf_on = true;
+    is_telf_on = global_config.telf_on;
     telf_fn    = sep_telf_fn(global_config.output_dir, this->name(), "meas_result_gen");
 }
 
@@ -24,37 +26,34 @@ Msmt_result_gen::Msmt_result_gen(const sc_core::sc_module_name& n)
 
     SC_CTHREAD(gen_msmt_result, in_50MHz_clock);
 
-    SC_CTHREAD(log_telf, in_50MHz_clock);
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, in_50MHz_clock);
+    }
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
 void Msmt_result_gen::gen_msmt_result() {
 
-    auto logger = get_logger_or_exit("console");
-
-    Generic_meas_if   meas_result;
-    std::vector<bool> vec_meas_data;
-    std::vector<bool> vec_meas_data_valid;
+    auto         logger      = get_logger_or_exit("console");
+    Shot_record& shot_record = Shot_record::get_instance();
 
-    Res_from_qsim                                      i_msmt_res;
-    std::vector<std::pair<unsigned int, unsigned int>> results;
+    Generic_meas_if meas_result;
+    Bit_set         meas_data(m_num_qubits);
+    Bit_set         meas_data_valid(m_num_qubits);
 
     while (true) {
         wait();
+        Profile_process profile;
 
         // read result from simulator
-        i_msmt_res = msmt_res.read();
-        results    = i_msmt_res.results;
+        const std::vector<std::pair<unsigned int, unsigned int>>& results =
+          msmt_res.read().results;
 
         // default: no returned measurement results.
         meas_result.reset();
-        vec_meas_data.clear();
-        vec_meas_data_valid.clear();
-        for (size_t i = 0; i < m_num_qubits; i++) {
-            vec_meas_data.push_back(false);
-            vec_meas_data_valid.push_back(false);
-        }
+        meas_data.reset();
+        meas_data_valid.reset();
 
         // check whether result size exceed number of qubits
         if (results.size() > m_num_qubits) {
@@ -70,14 +69,23 @@ void Msmt_result_gen::gen_msmt_result() {
                 unsigned int qubit  = results[i].first;
                 unsigned int result = results[i].second;
 
+                if (qubit >= m_num_qubits) {
+                    logger->error("{}: Qubit simulator has returned a result of qubit '{}', which "
+                                  "is not simulated. Simulation aborts!",
+                                  this->name(), qubit);
+                    exit(EXIT_FAILURE);
+                }
+
                 // result is 0 or 1
-                vec_meas_data[qubit]       = (result > 0);
-                vec_meas_data_valid[qubit] = true;
+                meas_data.set(qubit, result > 0);
+                meas_data_valid.set(qubit);
+
+                if (shot_record.is_enabled()) shot_record.add_meas(qubit, result > 0);
             }
         }
 
-        meas_result.set_meas_data(vec_meas_data);
-        meas_result.set_meas_data_valid(vec_meas_data_valid);
+        meas_result.set_meas_data(meas_data);
+        meas_result.set_meas_data_valid(meas_data_valid);
 
         // output measurement result
         out_meas_result.write(meas_result);
@@ -86,33 +94,24 @@ void Msmt_result_gen::gen_msmt_result() {
 
 void Msmt_result_gen::log_telf() {
 
-    Generic_meas_if   meas_result;
-    std::vector<bool> vec_meas_data;
-    std::vector<bool> vec_meas_data_valid;
-    bool              meas_result_valid;
-
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (is_telf_on) {
 
-            meas_result         = out_meas_result.read();
-            vec_meas_data       = meas_result.get_meas_data();
-            vec_meas_data_valid = meas_result.get_meas_data_valid();
-
-            meas_result_valid = 0;
-            for (size_t i = 0; i < vec_meas_data_valid.size(); ++i) {
-                meas_result_valid |= vec_meas_data_valid[i];
-            }
+            const Generic_meas_if& meas_result     = out_meas_result.read();
+            const Bit_set&         meas_data       = meas_result.get_meas_data();
+            const Bit_set&         meas_data_valid = meas_result.get_meas_data_valid();
 
-            if (meas_result_valid) {
+            if (meas_data_valid.any()) {
                 // telf_os << meas;
                 telf_os << std::setfill(' ') << std::setw(16)
                         << sc_core::sc_time_stamp().to_string();
-                for (size_t i = 0; i < vec_meas_data.size(); ++i) {
-                    if (vec_meas_data_valid[i]) {
-                        telf_os << " " << std::setfill(' ') << std::setw(3) << vec_meas_data[i];
+                for (size_t i = 0; i < meas_data.size(); ++i) {
+                    if (meas_data_valid.test(i)) {
+                        telf_os << " " << std::setfill(' ') << std::setw(3) << meas_data.test(i);
                     } else {
                         telf_os << " " << std::setfill(' ') << std::setw(3) << "x";
                     }
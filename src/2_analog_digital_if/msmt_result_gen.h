@@ -9,6 +9,7 @@
 #include "logger_wrapper.h"
 #include "num_util.h"
 #include "q_data_type.h"
+#include "shot_farm.h"
 #include "telf_module.h"
 
 namespace cactus {
@@ -15,6 +15,7 @@
 #include "json_wrapper.h"
 #include "logger_wrapper.h"
 #include "num_util.h"
+#include "profiler.h"
 
 using json = nlohmann::json;
 namespace cactus {
@@ -36,7 +37,11 @@ If_QIcircuit::If_QIcircuit(const sc_core::sc_module_name& n)
 
     init_python_api();
 
-    SC_CTHREAD(log_telf, clock_50MHz.pos());
+    Idle_skipper::get_instance().add_module(this);
+
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, clock_50MHz.pos());
+    }
     SC_CTHREAD(apply_quantum_operation, clock_50MHz.pos());
 }
 
@@ -58,6 +63,7 @@ void If_QIcircuit::log_telf() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (is_telf_on) {
             add_telf_line();
@@ -206,6 +212,7 @@ void If_QIcircuit::apply_quantum_operation() {
 
     while (true) {
         wait();
+        Profile_process profile;
 
         moment = ops_2_qsim.read();
 
@@ -262,6 +269,14 @@ void If_QIcircuit::apply_quantum_operation() {
     }
 }
 
+uint64_t If_QIcircuit::num_idle_cycles() {
+    // without a moment, the empty results are only written again
+    if (ops_2_qsim.read().triggered || !(msmt_res.read() == Res_from_qsim())) return 0;
+    return UINT64_MAX;
+}
+
+void If_QIcircuit::skip_cycles(uint64_t num_cycles) {}
+
 void If_QIcircuit::apply_single_qubit_gate(std::string quantum_operation, unsigned int qubit) {
     auto logger = get_logger_or_exit("qsim_logger");
 
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "global_json.h"
+#include "idle_skip.h"
 #include "interface_lib.h"
 #include "telf_module.h"
 
@@ -28,7 +29,7 @@ using sc_core::sc_vector;
 using sc_dt::sc_uint;
 using std::vector;
 
-class If_QIcircuit : public Telf_module {
+class If_QIcircuit : public Telf_module, public Idle_skippable {
   public:  // general IO
     sc_in<bool> clock_50MHz;
     sc_in<bool> init;
@@ -70,6 +71,10 @@ class If_QIcircuit : public Telf_module {
     void config();
     void post_py_process(PyObject* pValue, PyObject* pMethod, const std::string& err_msg);
 
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
+
   public:
     If_QIcircuit(const sc_core::sc_module_name& n);
 
@@ -1,5 +1,6 @@
 #include "if_quantumsim.h"
 
+#include <algorithm>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -7,6 +8,7 @@
 #include "global_counter.h"
 #include "logger_wrapper.h"
 #include "num_util.h"
+#include "profiler.h"
 
 namespace cactus {
 
@@ -25,10 +27,16 @@ If_QuantumSim::If_QuantumSim(const sc_core::sc_module_name& n)
 
     init_python_api();
 
-    SC_CTHREAD(log_telf, clock_50MHz.pos());
+    Idle_skipper::get_instance().add_module(this);
+
+    if (is_telf_on) {
+        SC_CTHREAD(log_telf, clock_50MHz.pos());
+    }
     SC_CTHREAD(apply_quantum_operation, clock_50MHz.pos());
 }
 
+If_QuantumSim::~If_QuantumSim() { stop_worker(); }
+
 void If_QuantumSim::config() {
 
     Global_config& global_config = Global_config::get_instance();
@@ -40,9 +48,13 @@ void If_QuantumSim::config() {
     cycle_time              = global_config.cycle_time;
     m_instruction_type      = global_config.instruction_type;
     mock_msmt_res_fn        = global_config.mock_msmt_res_fn;
+    m_async                 = global_config.async_qsim;
 
     operation_time.insert(global_config.two_qubit_gate_time.begin(),
                           global_config.two_qubit_gate_time.end());
+
+    last_gate_durations.assign(num_qubits, 0);
+    pre_gate_start_point.assign(num_qubits, 0);
 }
 
 void If_QuantumSim::add_telf_header() {}
@@ -51,6 +63,7 @@ void If_QuantumSim::log_telf() {
     while (true) {
 
         wait();
+        Profile_process profile;
 
         if (is_telf_on) {
             add_telf_line();
@@ -241,23 +254,16 @@ void If_QuantumSim::init_python_api() {
 // - current_cycle  corresponds to the cycle of the current operation being processed.
 void If_QuantumSim::apply_quantum_operation() {
 
-    auto         logger = get_logger_or_exit("qsim_logger");
-    stringstream ss;
-
-    std::string          op_name;
-    std::string          op_name_prefix;
-    bool                 is_1st_op = true;
-    vector<unsigned int> last_gate_durations(num_qubits, 0);
-    vector<int>          pre_gate_start_point(num_qubits, 0);
-    unsigned int         current_cycle = 0;
-    unsigned int         idle_duration = 0, cur_gate_duration = 0, pre_gate_duration = 0;
+    Ops_2_qsim    moment;
+    Res_from_qsim res_from_qsim;
 
-    Ops_2_qsim           moment;
-    vector<unsigned int> target_qubits;
-    Res_from_qsim        res_from_qsim;
+    // the cycles of the fast-forward engine come before the ones of the simulation
+    const Arch_state& ff_state = Global_config::get_instance().ff_state;
+    unsigned int cycle_offset  = ff_state.valid ? static_cast<unsigned int>(ff_state.q_cycle) : 0;
 
     while (true) {
         wait();
+        Profile_process profile;
 
         moment = ops_2_qsim.read();
 
@@ -274,142 +280,303 @@ void If_QuantumSim::apply_quantum_operation() {
         // ------------------------------------------------------------
         // If there comes at lease one quantum operation
         // ------------------------------------------------------------
-        op_name        = "Null";
-        op_name_prefix = "Null";
-        res_from_qsim.reset();
+        moment.cycle += cycle_offset;
 
-        // If this is the first operation of entire circuit, record this clock cycle
-        if (is_1st_op) {
-            starting_cycle = moment.cycle;
+        if (!m_async) {
+            res_from_qsim = apply_moment(moment);
+        } else {
+            bool wants_result = std::any_of(
+              moment.atom_ops.begin(), moment.atom_ops.end(),
+              [](const Atom_qop& op) { return op.operation == "measure"; });
+
+            Qsim_task task;
+            task.moment       = std::move(moment);
+            task.wants_result = wants_result;
+            m_tasks.push(std::move(task));
+
+            // only the measurement results are waited for, the other moments return none
+            if (wants_result) {
+                m_results.pop(res_from_qsim);
+            } else {
+                res_from_qsim.reset();
+            }
         }
 
-        current_cycle = moment.cycle;
+        msmt_res.write(res_from_qsim);
+    }
+}
 
-        ss.str("");
-        ss << "The following operations arrive at cycle: " << current_cycle << std::endl;
-        for (size_t op_idx = 0; op_idx < moment.atom_ops.size(); op_idx++) {
-            ss << moment.atom_ops[op_idx];
-        }
-        logger->debug("{}", ss.str());
+uint64_t If_QuantumSim::num_idle_cycles() {
+    // without a moment, the empty results are only written again. The idle gates are derived
+    // from the cycles of the moments, so the skipped cycles need no idle gates either.
+    if (ops_2_qsim.read().triggered || !(msmt_res.read() == Res_from_qsim())) return 0;
+    return UINT64_MAX;
+}
 
-        moment.trim_qnops();
+void If_QuantumSim::skip_cycles(uint64_t num_cycles) {}
 
-        target_qubits.clear();
+void If_QuantumSim::start_of_simulation() {
+    if (m_async) start_worker();
+}
 
-        // iterate over all individual operations
-        for (auto it_op = moment.atom_ops.begin(); it_op != moment.atom_ops.end(); it_op++) {
-            op_name       = it_op->operation;
-            target_qubits = it_op->target_qubits;
+void If_QuantumSim::end_of_simulation() { stop_worker(); }
 
-            size_t number_target_qubits = target_qubits.size();
+void If_QuantumSim::start_worker() {
+    auto logger = get_logger_or_exit("qsim_logger");
 
-            if (number_target_qubits > 2) {
+    // the worker takes the interpreter over until it stops
+    m_main_thread_state = PyEval_SaveThread();
+    m_worker            = std::thread(&If_QuantumSim::run_worker, this);
 
-                logger->error(
-                  "Currently support at most two-qubit operations. But found operation {} "
-                  "operates on {} qubits. Aborts!",
-                  op_name, target_qubits.size());
+    logger->trace("{}: Started the worker of the qubit simulator.", this->name());
+}
 
-                exit(EXIT_FAILURE);
-            }
+void If_QuantumSim::stop_worker() {
+    if (!m_worker.joinable()) return;
 
-            // if instruction type is asm,op_name_prefix is used
-            if (m_instruction_type == Instruction_type::ASM && op_name.find_first_of("rxyz") == 0) {
-                if (op_name.size() > 2 && ((op_name[1] == 'm') || (op_name[0] == 'r'))) {
-                    op_name_prefix = op_name.substr(0, 2);
-                } else {
-                    op_name_prefix = op_name.substr(0, 1);
-                }
-            } else {
-                op_name_prefix = op_name;
-            }
+    Qsim_task task;
+    task.stop = true;
+    m_tasks.push(std::move(task));
+    m_worker.join();
 
-            // Get the duration of the current gate
-            auto it = operation_time.find(op_name_prefix);
+    PyEval_RestoreThread(m_main_thread_state);
+    m_main_thread_state = nullptr;
+}
 
-            if (it != operation_time.end())
+void If_QuantumSim::run_worker() {
+    PyGILState_STATE gil_state = PyGILState_Ensure();
 
-                cur_gate_duration = it->second;
+    Qsim_task task;
+    while (true) {
+        m_tasks.pop(task);
+        if (task.stop) break;
 
-            else {
-                logger->error("If_QuantumSim: found undefined operation ({}). Aborts!", op_name);
-                exit(EXIT_FAILURE);
-            }
+        Res_from_qsim res_from_qsim = apply_moment(std::move(task.moment));
+        if (task.wants_result) m_results.push(std::move(res_from_qsim));
+    }
+
+    PyGILState_Release(gil_state);
+}
+
+Res_from_qsim If_QuantumSim::apply_moment(Ops_2_qsim moment) {
+
+    auto         logger = get_logger_or_exit("qsim_logger");
+    stringstream ss;
 
-            // ============================== idle ==============================
-            for (size_t i = 0; i < number_target_qubits; i++) {
+    std::string          op_name        = "Null";
+    std::string          op_name_prefix = "Null";
+    unsigned int         current_cycle  = 0;
+    unsigned int         idle_duration = 0, cur_gate_duration = 0, pre_gate_duration = 0;
+    vector<unsigned int> target_qubits;
+    Res_from_qsim        res_from_qsim;
 
-                unsigned int qubit = target_qubits[i];
+    // If this is the first operation of entire circuit, record this clock cycle
+    if (is_1st_op) {
+        starting_cycle = moment.cycle;
+    }
 
-                // Get the duration of the previous gate
-                pre_gate_duration = last_gate_durations[qubit];
+    current_cycle = moment.cycle;
 
-                idle_duration = get_idle_duration(is_1st_op, cur_gate_duration, current_cycle,
-                                                  pre_gate_start_point[qubit], pre_gate_duration);
+    ss.str("");
+    ss << "The following operations arrive at cycle: " << current_cycle << std::endl;
+    for (size_t op_idx = 0; op_idx < moment.atom_ops.size(); op_idx++) {
+        ss << moment.atom_ops[op_idx];
+    }
+    logger->debug("{}", ss.str());
 
-                logger->debug(
-                  "is_1st_op: {}, cur_gate_duration: {}, current_cycle: {}, "
-                  "pre_gate_start_point[{}]: {}, pre_gate_duration: {}",
-                  is_1st_op, cur_gate_duration, current_cycle, qubit, pre_gate_start_point[qubit],
-                  pre_gate_duration);
+    moment.trim_qnops();
 
-                logger->debug("The duration of this idling gate is {} ns.", idle_duration);
+    // iterate over all individual operations
+    for (auto it_op = moment.atom_ops.begin(); it_op != moment.atom_ops.end(); it_op++) {
+        op_name       = it_op->operation;
+        target_qubits = it_op->target_qubits;
 
-                // Apply an idling gate before the quantum operation
-                if (idle_duration > 0) {  // the idle_duration will be 0 for the first operaiton.
-                    apply_idle_gate(idle_duration, static_cast<unsigned int>(qubit));
-                }
+        size_t number_target_qubits = target_qubits.size();
+
+        if (number_target_qubits > 2) {
+
+            logger->error(
+              "Currently support at most two-qubit operations. But found operation {} "
+              "operates on {} qubits. Aborts!",
+              op_name, target_qubits.size());
+
+            exit(EXIT_FAILURE);
+        }
+
+        // if instruction type is asm,op_name_prefix is used
+        if (m_instruction_type == Instruction_type::ASM && op_name.find_first_of("rxyz") == 0) {
+            if (op_name.size() > 2 && ((op_name[1] == 'm') || (op_name[0] == 'r'))) {
+                op_name_prefix = op_name.substr(0, 2);
+            } else {
+                op_name_prefix = op_name.substr(0, 1);
             }
+        } else {
+            op_name_prefix = op_name;
+        }
+
+        // Get the duration of the current gate
+        auto it = operation_time.find(op_name_prefix);
 
-            // ============================== apply ==============================
-            if (number_target_qubits == 1) {
-                unsigned int qubit = target_qubits[0];
+        if (it != operation_time.end())
 
-                // If a measurement
-                if (op_name.compare("measure") == 0) {
+            cur_gate_duration = it->second;
 
-                    unsigned int result = measure_qubit(qubit);
-                    res_from_qsim.results.push_back(std::make_pair(qubit, result));
+        else {
+            logger->error("If_QuantumSim: found undefined operation ({}). Aborts!", op_name);
+            exit(EXIT_FAILURE);
+        }
 
-                } else if (op_name.compare("mock_meas") == 0) {
-                    // if a mock measurement, only execute once
-                    if (qubit == 0) {
-                        mock_measure(mock_msmt_res_fn);
-                    }
+        // ============================== idle ==============================
+        for (size_t i = 0; i < number_target_qubits; i++) {
 
-                } else {  // If not a measurement operation
-                    apply_single_qubit_gate(op_name, qubit);
+            unsigned int qubit = target_qubits[i];
 
-                    // Print out the single_ptms_to_do for this qubit
-                    print_ptms_to_do(qubit);
-                }
+            // Get the duration of the previous gate
+            pre_gate_duration = last_gate_durations[qubit];
 
-                // After applying this quantum operation, it is recorded as the previous operation
-                pre_gate_start_point[qubit] = current_cycle;
-                last_gate_durations[qubit]  = cur_gate_duration;
+            idle_duration = get_idle_duration(is_1st_op, cur_gate_duration, current_cycle,
+                                              pre_gate_start_point[qubit], pre_gate_duration);
+
+            logger->debug(
+              "is_1st_op: {}, cur_gate_duration: {}, current_cycle: {}, "
+              "pre_gate_start_point[{}]: {}, pre_gate_duration: {}",
+              is_1st_op, cur_gate_duration, current_cycle, qubit, pre_gate_start_point[qubit],
+              pre_gate_duration);
+
+            logger->debug("The duration of this idling gate is {} ns.", idle_duration);
+
+            // Apply an idling gate before the quantum operation
+            if (idle_duration > 0) {  // the idle_duration will be 0 for the first operaiton.
+                apply_idle_gate(idle_duration, static_cast<unsigned int>(qubit));
             }
+        }
+
+        // ============================== apply ==============================
+        if (number_target_qubits == 1) {
+            unsigned int qubit = target_qubits[0];
+
+            // If a measurement
+            if (op_name.compare("measure") == 0) {
+
+                unsigned int result = measure_qubit(qubit);
+                res_from_qsim.results.push_back(std::make_pair(qubit, result));
 
-            if (number_target_qubits == 2) {
-                unsigned int qubit0 = target_qubits[0];
-                unsigned int qubit1 = target_qubits[1];
+            } else if (op_name.compare("mock_meas") == 0) {
+                // if a mock measurement, only execute once
+                if (qubit == 0) {
+                    mock_measure(mock_msmt_res_fn);
+                }
 
-                apply_two_qubit_gate(std::string(""), qubit0, qubit1);
+            } else {  // If not a measurement operation
+                apply_single_qubit_gate(op_name, qubit);
 
-                pre_gate_start_point[qubit0] = current_cycle;
-                pre_gate_start_point[qubit1] = current_cycle;
-                last_gate_durations[qubit0]  = cur_gate_duration;
-                last_gate_durations[qubit1]  = cur_gate_duration;
+                // Print out the single_ptms_to_do for this qubit
+                print_ptms_to_do(qubit);
             }
+
+            // After applying this quantum operation, it is recorded as the previous operation
+            pre_gate_start_point[qubit] = current_cycle;
+            last_gate_durations[qubit]  = cur_gate_duration;
         }
 
-        // After the quantum operations are applied, we can print out the full density matrix.
-        print_full_dm();
+        if (number_target_qubits == 2) {
+            unsigned int qubit0 = target_qubits[0];
+            unsigned int qubit1 = target_qubits[1];
 
-        msmt_res.write(res_from_qsim);
+            apply_two_qubit_gate(std::string(""), qubit0, qubit1);
+
+            pre_gate_start_point[qubit0] = current_cycle;
+            pre_gate_start_point[qubit1] = current_cycle;
+            last_gate_durations[qubit0]  = cur_gate_duration;
+            last_gate_durations[qubit1]  = cur_gate_duration;
+        }
+    }
+
+    // After the quantum operations are applied, we can print out the full density matrix.
+    print_full_dm();
+
+    // Since there is already operations happened, it is no longer the first operation
+    is_1st_op = false;
+
+    return res_from_qsim;
+}
+
+bool If_QuantumSim::save_state(Cache_writer& writer) {
+
+    auto logger = get_logger_or_exit("qsim_logger");
+
+    auto pMethod = PyUnicode_FromString("get_state");
+    auto pValue  = PyObject_CallMethodObjArgs(interface, pMethod, NULL);
+    Py_DECREF(pMethod);
+
+    char*      data = nullptr;
+    Py_ssize_t size = 0;
+    if (pValue == NULL || PyBytes_AsStringAndSize(pValue, &data, &size) != 0) {
+        PyErr_Print();
+        Py_XDECREF(pValue);
+        logger->error("Failed to call get_state.");
+        return false;
+    }
+
+    writer.put(is_1st_op);
+    writer.put(starting_cycle);
+    writer.put(last_gate_durations);
+    writer.put(pre_gate_start_point);
+    writer.put(std::string(data, static_cast<size_t>(size)));
+
+    Py_DECREF(pValue);
+    return true;
+}
+
+bool If_QuantumSim::restore_state(Cache_reader& reader) {
+
+    auto logger = get_logger_or_exit("qsim_logger");
+
+    std::string state;
+    reader.get(is_1st_op);
+    reader.get(starting_cycle);
+    reader.get(last_gate_durations);
+    reader.get(pre_gate_start_point);
+    reader.get(state);
+    if (!reader.ok() || last_gate_durations.size() != num_qubits ||
+        pre_gate_start_point.size() != num_qubits) {
+        return false;
+    }
+
+    auto pMethod = PyUnicode_FromString("set_state");
+    auto pArgs   = PyBytes_FromStringAndSize(state.data(), static_cast<Py_ssize_t>(state.size()));
+    auto pValue  = PyObject_CallMethodObjArgs(interface, pMethod, pArgs, NULL);
+    Py_DECREF(pArgs);
+    Py_DECREF(pMethod);
 
-        // Since there is already operations happened, it is no longer the first operation
-        is_1st_op = false;
+    if (pValue == NULL) {
+        PyErr_Print();
+        logger->error("Failed to call set_state.");
+        return false;
     }
+
+    Py_DECREF(pValue);
+    return true;
+}
+
+bool If_QuantumSim::set_seed(uint64_t seed) {
+
+    auto logger = get_logger_or_exit("qsim_logger");
+
+    auto pMethod = PyUnicode_FromString("set_seed");
+    auto pArgs   = PyLong_FromUnsignedLongLong(seed);
+    auto pValue  = PyObject_CallMethodObjArgs(interface, pMethod, pArgs, NULL);
+    Py_DECREF(pArgs);
+    Py_DECREF(pMethod);
+
+    if (pValue == NULL) {
+        PyErr_Print();
+        logger->error("Failed to call set_seed.");
+        return false;
+    }
+
+    Py_DECREF(pValue);
+    return true;
 }
 
 unsigned int If_QuantumSim::get_idle_duration(bool is_1st_op, unsigned int cur_gate_duration,
@@ -463,6 +630,8 @@ void If_QuantumSim::apply_idle_gate(unsigned int idle_duration, unsigned int qub
 
     logger->debug("An idling gate of {}ns is applied on qubit {}.", idle_duration, qubit);
 
+    Profile_scope scope("QuantumSim idle gate");
+
     // calculate_gamma_lamda
     auto pArgs   = PyLong_FromLong(idle_duration);
     auto pMethod = PyUnicode_FromString("calculate_gamma_lamda");
@@ -492,6 +661,8 @@ void If_QuantumSim::apply_single_qubit_gate(std::string quantum_operation, unsig
         return;
     }
 
+    Profile_scope scope("QuantumSim single-qubit gate");
+
     // Prepare the ptm for the quantum gate
     auto pMethod = PyUnicode_FromString("prepare_ptm");
     auto pArgs   = PyUnicode_FromString(quantum_operation.c_str());
@@ -514,6 +685,8 @@ unsigned int If_QuantumSim::measure_qubit(unsigned int qubit) {
     auto logger = get_logger_or_exit("qsim_logger");
     logger->debug("To measure the qubit {}.", qubit);
 
+    Profile_scope scope("QuantumSim measurement");
+
     unsigned int single_msmt_result = 0;
 
     auto pMethod = PyUnicode_FromString("apply_measurement");
@@ -539,6 +712,8 @@ void If_QuantumSim::mock_measure(std::string mock_msmt_res_fn) {
     auto logger = get_logger_or_exit("qsim_logger");
     logger->debug("To apply a mock measurement");
 
+    Profile_scope scope("QuantumSim mock measurement");
+
     auto pMethod = PyUnicode_FromString("apply_mock_meas");
     auto pArgs   = PyUnicode_FromString(mock_msmt_res_fn.c_str());
     auto pValue  = PyObject_CallMethodObjArgs(interface, pMethod, pArgs, NULL);
@@ -555,6 +730,8 @@ void If_QuantumSim::apply_two_qubit_gate(std::string quantum_operation, unsigned
     logger->debug("To apply two-qubit-gate {} on qubit {} and {}.", quantum_operation, qubit0,
                   qubit1);
 
+    Profile_scope scope("QuantumSim two-qubit gate");
+
     // Prepare the active two-qubit ptm
     auto pMethod = PyUnicode_FromString("prepare_two_ptm");
     auto pValue  = PyObject_CallMethodObjArgs(interface, pMethod, NULL);
@@ -5,10 +5,13 @@
 
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "global_json.h"
+#include "idle_skip.h"
 #include "interface_lib.h"
+#include "spsc_queue.h"
 #include "telf_module.h"
 
 #ifdef _DEBUG
@@ -27,7 +30,18 @@ using sc_core::sc_signal;
 using sc_core::sc_vector;
 using sc_dt::sc_uint;
 
-class If_QuantumSim : public Telf_module {
+// the moments on their way to the worker of the qubit simulator
+#define QSIM_QUEUE_SIZE 1024
+
+// a moment for the worker of the qubit simulator
+class Qsim_task {
+  public:
+    Ops_2_qsim moment;
+    bool       wants_result = false;  // the moment measures, and its results are waited for
+    bool       stop         = false;  // the simulation has ended, the worker returns
+};
+
+class If_QuantumSim : public Telf_module, public Qubit_backend, public Idle_skippable {
   public:  // general IO
     sc_in<bool> clock_50MHz;
     sc_in<bool> init;
@@ -65,6 +79,31 @@ class If_QuantumSim : public Telf_module {
 
     unsigned int starting_cycle = 0;
 
+    // the state of the qubits carried from one moment to the next
+    bool                      is_1st_op = true;
+    std::vector<unsigned int> last_gate_durations;
+    std::vector<int>          pre_gate_start_point;
+
+  protected:  // the worker thread
+    // With Global_config::async_qsim, the moments are applied by a worker thread, which owns
+    // the Python interpreter during the simulation, while the SystemC thread goes on with the
+    // digital model. The SystemC thread only waits for the worker when a moment measures, so the
+    // results are written on the same cycle as without the worker.
+    bool                      m_async = false;
+    std::thread               m_worker;
+    PyThreadState*            m_main_thread_state = nullptr;
+    Spsc_queue<Qsim_task>     m_tasks{QSIM_QUEUE_SIZE};
+    Spsc_queue<Res_from_qsim> m_results{QSIM_QUEUE_SIZE};
+
+    // the worker is only started when the simulation starts, so that a process forked before
+    // (see shot_farm.h and zygote.h) has its own
+    void start_of_simulation() override;
+    void end_of_simulation() override;
+
+    void start_worker();
+    void stop_worker();
+    void run_worker();
+
   protected:  // logging methods
     void add_telf_line();
     void add_telf_header();
@@ -87,8 +126,25 @@ class If_QuantumSim : public Telf_module {
     void config();
     void post_py_process(PyObject* pValue, PyObject* pMethod, const std::string& err_msg);
 
+  public:
+    // apply the operations of one moment, and return the measurement results
+    Res_from_qsim apply_moment(Ops_2_qsim moment) override;
+
+    // the density matrix, the measurement results and the random generator of QuantumSim, and
+    // the timing of the last gate on every qubit
+    bool save_state(Cache_writer& writer) override;
+    bool restore_state(Cache_reader& reader) override;
+
+    // seeds the random generator of the measurements of QuantumSim
+    bool set_seed(uint64_t seed) override;
+
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override;
+
   public:
     If_QuantumSim(const sc_core::sc_module_name& n);
+    ~If_QuantumSim();
 
     SC_HAS_PROCESS(If_QuantumSim);
 };
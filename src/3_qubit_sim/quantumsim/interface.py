@@ -4,6 +4,7 @@ from quantumsim.sparsedm import *
 from quantumsim.circuit import *
 from quantumsim.ptm import *
 import random
+import pickle
 # import sys
 
 # FORMATTER = logging.Formatter("%(asctime)s — %(name)s — %(levelname)s — %(message)s")
@@ -291,6 +292,38 @@ class interface_quantumsim:
         #         print((self.measurements[str(i)][j * 30:(j + 1) * 30]))
         # print('+', '-' * 77, '+\n')
 
+    def get_state(self):
+        """
+        Return the state of the qubits and of the random generator as bytes, for checkpoints.
+        The full density matrix may live on the GPU, so it is saved as a numpy array.
+        """
+        full_dm = self.sdm.full_dm
+        self.sdm.full_dm = None
+        try:
+            state = pickle.dumps((self.sdm, full_dm.no_qubits, full_dm.to_array(),
+                                  self.measurements, self.current_measurement,
+                                  random.getstate()))
+        finally:
+            self.sdm.full_dm = full_dm
+        return state
+
+    def set_state(self, state):
+        """
+        Restore the state returned by get_state.
+        """
+        dm_class = type(self.sdm.full_dm)
+        (sdm, no_qubits, dm_array, self.measurements, self.current_measurement,
+         random_state) = pickle.loads(state)
+        sdm.full_dm = dm_class(no_qubits, dm_array)
+        self.sdm = sdm
+        random.setstate(random_state)
+
+    def set_seed(self, seed):
+        """
+        Seed the random generator of the measurements, so that a shot can be reproduced.
+        """
+        random.seed(seed)
+
     def record_msmt_results(self):
         f = open("qvm_msmt_result.txt", "w+")
 
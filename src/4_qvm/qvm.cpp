@@ -12,6 +12,61 @@ void QVM::config() {
 
 void QVM::init_mem_asm(std::string asm_fn) { cclight.init_mem_asm(asm_fn); }
 
+void QVM::load_program() { cclight.load_program(); }
+
+void QVM::fast_forward() {
+    auto           logger        = get_logger_or_exit("console");
+    Global_config& global_config = Global_config::get_instance();
+
+    Qubit_backend* backend = nullptr;
+    if (m_qubit_simulator == Qubit_simulator_type::QUANTUMSIM) backend = p_quantumsim;
+
+    Fast_forward_engine engine(backend);
+    engine.load_program();
+
+    std::string error_msg;
+    if (!global_config.init_checkpoint_fn.empty()) {
+        Arch_state state;
+        if (!restore_checkpoint(global_config.init_checkpoint_fn, state, backend, error_msg)) {
+            logger->error("{}: Cannot restore the checkpoint '{}', {}. Simulation aborts!",
+                          this->name(), global_config.init_checkpoint_fn, error_msg);
+            exit(EXIT_FAILURE);
+        }
+        logger->info("{}: Restored the checkpoint '{}' (pc: {}, 50 MHz cycle: {}).", this->name(),
+                     global_config.init_checkpoint_fn, state.pc, state.q_cycle);
+        engine.set_state(state);
+    }
+
+    if (global_config.ff_target.is_set()) {
+        engine.run(global_config.ff_target);
+    }
+
+    if (!global_config.save_checkpoint_fn.empty()) {
+        if (!save_checkpoint(global_config.save_checkpoint_fn, engine.state(), backend,
+                             error_msg)) {
+            logger->error("{}: Cannot save the checkpoint '{}', {}. Simulation aborts!",
+                          this->name(), global_config.save_checkpoint_fn, error_msg);
+            exit(EXIT_FAILURE);
+        }
+        logger->info("{}: Saved the checkpoint '{}'.", this->name(),
+                     global_config.save_checkpoint_fn);
+    }
+
+    global_config.ff_state = engine.state();
+}
+
+void QVM::set_seed(uint64_t seed) {
+    auto logger = get_logger_or_exit("console");
+
+    Qubit_backend* backend = nullptr;
+    if (m_qubit_simulator == Qubit_simulator_type::QUANTUMSIM) backend = p_quantumsim;
+
+    if (backend == nullptr || !backend->set_seed(seed)) {
+        logger->warn("{}: The qubit simulator cannot be seeded, the shots may not be reproducible.",
+                     this->name());
+    }
+}
+
 QVM::QVM(const sc_core::sc_module_name& n)
     : sc_core::sc_module(n)
     , cclight("cclight")
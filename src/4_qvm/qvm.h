@@ -6,6 +6,8 @@
 
 #include "adi.h"
 #include "cclight_new.h"
+#include "checkpoint.h"
+#include "fast_forward.h"
 #include "generic_if.h"
 #include "if_QIcircuit.h"
 #include "if_quantumsim.h"
@@ -36,6 +38,19 @@ SC_MODULE(QVM) {
   public:
     void init_mem_asm(std::string asm_fn);
 
+    // see Icache_rtl::load_program()
+    void load_program();
+
+    // run the program with the fast-forward engine up to Global_config::ff_target, and leave
+    // the state it reaches in Global_config::ff_state for the cycle-accurate simulation. The
+    // engine starts from the checkpoint Global_config::init_checkpoint_fn if any, and saves the
+    // state it reaches to Global_config::save_checkpoint_fn if any.
+    void fast_forward();
+
+    // seed the qubit simulator, after fast-forwarding since a checkpoint restores its random
+    // generator (see shot_farm.h)
+    void set_seed(uint64_t seed);
+
   private:  // internal modules
     CC_Light          cclight;
     Analog_digital_if adi;
@@ -1,17 +1,138 @@
+#include <chrono>
+#include <cstdio>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <systemc>
 
 #include "cactus_ver.h"
 #include "cclight_new.h"
 #include "global_counter.h"
 #include "global_json.h"
+#include "idle_skip.h"
 #include "logger_wrapper.h"
+#include "profiler.h"
 #include "q_data_type.h"
+#include "shot_farm.h"
 #include "tb_qvm.h"
+#include "zygote.h"
 
 using namespace cactus;
 
+// runs the shots in processes forked from this one, in which the model is already elaborated
+static int run_shots(QVM_TB& tb) {
+    auto           logger        = get_logger_or_exit("console");
+    Global_config& global_config = Global_config::get_instance();
+
+    Shot_record::get_instance().enable();
+
+    Shot_farm farm(global_config.num_shots, global_config.output_dir,
+                   global_config.num_load_threads);
+    logger->info("Running {} shots in {} processes.", global_config.num_shots,
+                 farm.num_workers());
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto run_shot = [&](unsigned int shot, uint64_t seed, Shot_result& result) {
+        if (global_config.ff_target.is_set() || !global_config.init_checkpoint_fn.empty()) {
+            tb.fast_forward();
+        }
+        tb.set_seed(seed);
+
+        try {
+            sc_start();
+        } catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+
+        result = Shot_record::get_instance().result();
+        if (!global_config.data_mem_dump_fn.empty()) {
+            result.mem_words = global_config.data_memory->dump_words();
+        }
+        return true;
+    };
+
+    std::string error_msg;
+    if (!farm.run(run_shot, error_msg)) {
+        logger->error("main: {}. Simulation aborts!", error_msg);
+        exit(EXIT_FAILURE);
+    }
+
+    if (!farm.write_csv(global_config.num_qubits)) {
+        logger->error("main: Failed to write the results of the shots to '{}'. Simulation aborts!",
+                      global_config.output_dir);
+        exit(EXIT_FAILURE);
+    }
+
+    auto   stop    = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    logger->info("Ran {} shots in {:.3f} s. The outcomes are in shots.csv and histogram.csv.",
+                 global_config.num_shots, seconds);
+
+    return 0;
+}
+
+// serves the run requests in processes forked from this one, in which the model is already
+// elaborated
+static int run_zygote(QVM_TB& tb) {
+    auto           logger        = get_logger_or_exit("console");
+    Global_config& global_config = Global_config::get_instance();
+
+    FILE* requests = stdin;
+    if (global_config.zygote_fn != "-") {
+        requests = fopen(global_config.zygote_fn.c_str(), "r");
+        if (requests == nullptr) {
+            logger->error("main: Failed to open the run requests '{}'. Simulation aborts!",
+                          global_config.zygote_fn);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Zygote zygote(global_config.output_dir, global_config.num_load_threads);
+    logger->info("Ready to serve runs, up to {} at a time.", zygote.num_workers());
+
+    auto run = [&](const Run_request& request) {
+        if (global_config.instruction_type == Instruction_type::BIN &&
+            !global_config.assemble_bin) {
+            global_config.qisa_bin_fn = request.program;
+        } else {
+            global_config.qisa_asm_fn = request.program;
+        }
+        global_config.data_mem_dump_fn = request.data_mem_dump_fn;
+
+        tb.load_program();
+        if (global_config.ff_target.is_set() || !global_config.init_checkpoint_fn.empty()) {
+            tb.fast_forward();
+        }
+
+        try {
+            sc_start();
+        } catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (!global_config.data_mem_dump_fn.empty()) {
+            global_config.data_memory->dump(global_config.data_mem_dump_fn);
+        }
+        return EXIT_SUCCESS;
+    };
+
+    unsigned int num_failed = 0;
+    std::string  error_msg;
+    // the requests are read from the file descriptor, past the buffer of the FILE
+    bool served = zygote.serve(fileno(requests), std::cout, run, num_failed, error_msg);
+    if (requests != stdin) fclose(requests);
+    if (!served) {
+        logger->error("main: {}. Simulation aborts!", error_msg);
+        exit(EXIT_FAILURE);
+    }
+
+    return num_failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
 int sc_main(int argc, char* argv[]) {
 
     // The following command turns off warning about IEEE 1666 deprecated features.
@@ -24,14 +145,42 @@ int sc_main(int argc, char* argv[]) {
     std::cout << "Control Architecture Simulator, " << CACTUS_VERSION << std::endl;
     std::cout << "Simulation Starts." << std::endl;
 
-    sc_clock clock_200MHz("clock_200MHz", 2.0, sc_core::SC_NS, 0.5);
-    sc_clock clock_50MHz("clock_50MHz", 20.0, sc_core::SC_NS, 0.5);
-
     // CC_Light_TB tb("cclight_tb", global_config,  num_sim_cycles);
     QVM_TB tb("qvm_tb", global_config.num_sim_cycles);
 
-    tb.clock_200MHz(clock_200MHz);
-    tb.clock_50MHz(clock_50MHz);
+    // the clocks stop while the processor only waits, see idle_skip.h
+    std::unique_ptr<sc_clock>        clock_200MHz;
+    std::unique_ptr<sc_clock>        clock_50MHz;
+    std::unique_ptr<Idle_skip_clock> skip_clock;
+    if (global_config.skip_idle) {
+        skip_clock.reset(new Idle_skip_clock("skip_clock", sc_core::sc_time(2.0, sc_core::SC_NS),
+                                             sc_core::sc_time(20.0, sc_core::SC_NS)));
+        tb.clock_200MHz(skip_clock->clock_200MHz);
+        tb.clock_50MHz(skip_clock->clock_50MHz);
+    } else {
+        clock_200MHz.reset(new sc_clock("clock_200MHz", 2.0, sc_core::SC_NS, 0.5));
+        clock_50MHz.reset(new sc_clock("clock_50MHz", 20.0, sc_core::SC_NS, 0.5));
+        tb.clock_200MHz(*clock_200MHz);
+        tb.clock_50MHz(*clock_50MHz);
+    }
+
+    // every shot fast-forwards on its own, with its own seed
+    if (global_config.num_shots > 0) return run_shots(tb);
+
+    // every run loads its own program
+    if (!global_config.zygote_fn.empty()) return run_zygote(tb);
+
+    // skip the beginning of the program, the cycle-accurate simulation starts from there
+    if (global_config.ff_target.is_set() || !global_config.init_checkpoint_fn.empty()) {
+        tb.fast_forward();
+    }
+
+    // only the simulation is profiled, not the elaboration nor the loading of the program
+    Profiler& profiler = Profiler::get_instance();
+    if (global_config.profile) {
+        profiler.enable();
+        profiler.start();
+    }
 
     try {
         sc_start();
@@ -39,6 +188,27 @@ int sc_main(int argc, char* argv[]) {
         std::cerr << e.what() << std::endl;
     }
 
+    if (global_config.profile) {
+        profiler.stop();
+
+        std::string profile_fn = global_config.output_dir;
+        if (!profile_fn.empty() && profile_fn.back() != '/') profile_fn += "/";
+        profile_fn += "profile.txt";
+
+        std::vector<Profiled_clock> domains = {{"clock_200MHz", 2.0, Clock_domain::CLOCK_200MHZ},
+                                               {"clock_50MHz", 20.0, Clock_domain::CLOCK_50MHZ}};
+        if (profiler.write_report(profile_fn, domains)) {
+            std::cout << "The profile is written to '" << profile_fn << "'." << std::endl;
+        } else {
+            std::cerr << "Failed to write the profile to '" << profile_fn << "'." << std::endl;
+        }
+    }
+
+    if (global_config.skip_idle) {
+        std::cout << "Skipped " << Idle_skipper::get_instance().num_skipped_cycles()
+                  << " idle cycles (50MHz)." << std::endl;
+    }
+
     // dump data memory
     if (!global_config.data_mem_dump_fn.empty()) {
         global_config.data_memory->dump(global_config.data_mem_dump_fn);
@@ -35,11 +35,21 @@ Quma_tb_base::Quma_tb_base(const sc_core::sc_module_name& n, unsigned int num_si
     }
     progress_bar = new Progress_bar(m_num_sim_cycles, m_bar_width);
 
+    Idle_skipper::get_instance().add_module(this);
+
     SC_CTHREAD(do_test, clock_200MHz.pos());
 
     logger->trace("Finished initializing {}...", this->name());
 }
 
+uint64_t Quma_tb_base::num_idle_cycles() {
+    auto counter_50MHz = global_counter::get("cycle_counter_50MHz");
+
+    // the simulation stops right after m_num_sim_cycles, as when no cycle is skipped
+    unsigned int cur_cycle = counter_50MHz->get_cur_cycle_num();
+    return (cur_cycle < m_num_sim_cycles) ? (m_num_sim_cycles - cur_cycle) : 0;
+}
+
 Quma_tb_base::~Quma_tb_base() {
     if (progress_bar) {
         delete progress_bar;
@@ -56,19 +66,34 @@ void Quma_tb_base::do_test() {
     unsigned int cur_cycle;
     bool         is_sc_stop = false;
 
-    std::vector<unsigned int>           vec_percent_cycle;
-    std::vector<unsigned int>::iterator it;
+    std::vector<unsigned int> vec_percent_cycle;
+    size_t                    next_percent = 0;
 
     for (unsigned int i = 0; i < m_bar_width; ++i) {
         vec_percent_cycle.push_back(static_cast<unsigned int>(m_num_sim_cycles * i / m_bar_width));
     }
 
+    // the cycle number jumps over some percentages when idle cycles are skipped
+    auto update_progress_bar = [&](unsigned int cur_cycle) {
+        bool passed = false;
+        while (next_percent < vec_percent_cycle.size() &&
+               vec_percent_cycle[next_percent] <= cur_cycle) {
+            next_percent++;
+            passed = true;
+        }
+        if (passed && !is_sc_stop) {
+            progress_bar->display_bar(cur_cycle);
+        }
+    };
+
     wait();
 
     reset.write(1);
 
     started.write(true);
-    App2Clp_init_pc.write(0);
+    // start from where the fast-forward engine has stopped, if it has run
+    const Arch_state& ff_state = Global_config::get_instance().ff_state;
+    App2Clp_init_pc.write(ff_state.valid ? ff_state.pc : 0);
     run.write(0);
     wait();
     reset.write(0);
@@ -155,18 +180,12 @@ void Quma_tb_base::do_test() {
                     sc_stop();
                 }
 
-                it = std::find(vec_percent_cycle.begin(), vec_percent_cycle.end(), cur_cycle);
-                if (it != vec_percent_cycle.end() && !is_sc_stop) {
-                    progress_bar->display_bar(cur_cycle);
-                }
+                update_progress_bar(cur_cycle);
             }
         }
 
-        // if cur_cycle is in vec_percent_cycle
-        it = std::find(vec_percent_cycle.begin(), vec_percent_cycle.end(), cur_cycle);
-        if (it != vec_percent_cycle.end() && !is_sc_stop) {
-            progress_bar->display_bar(cur_cycle);
-        }
+        // if cur_cycle has reached the next percentage
+        update_progress_bar(cur_cycle);
 
         if (cur_cycle > m_num_sim_cycles) {
             logger->info("{}: Simulation has conducted for {} cycles (50MHz). Simulation stops.",
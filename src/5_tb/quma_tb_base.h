@@ -41,6 +41,7 @@ Usage:
 #include <systemc>
 
 #include "global_json.h"
+#include "idle_skip.h"
 #include "progress_bar.h"
 #include "q_data_type.h"
 
@@ -49,7 +50,7 @@ using namespace sc_dt;
 
 namespace cactus {
 
-class Quma_tb_base : public sc_core::sc_module {
+class Quma_tb_base : public sc_core::sc_module, public Idle_skippable {
   public:  // clock & reset & init
     sc_in<bool> clock_200MHz;
     sc_in<bool> clock_50MHz;
@@ -81,6 +82,10 @@ class Quma_tb_base : public sc_core::sc_module {
 
     void config();
 
+  public:  // idle cycles, see idle_skip.h
+    uint64_t num_idle_cycles() override;
+    void     skip_cycles(uint64_t num_cycles) override {}
+
   public:
     Quma_tb_base(const sc_core::sc_module_name& n, unsigned int num_sim_cycles_ = 3000);
 
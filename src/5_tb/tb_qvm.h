@@ -37,6 +37,16 @@ class QVM_TB : public Quma_tb_base {
 
     void config();
 
+  public:
+    // see QVM::fast_forward()
+    void fast_forward() { qvm.fast_forward(); }
+
+    // see QVM::set_seed()
+    void set_seed(uint64_t seed) { qvm.set_seed(seed); }
+
+    // see Icache_rtl::load_program()
+    void load_program() { qvm.load_program(); }
+
   public:
     QVM_TB(const sc_core::sc_module_name& n, unsigned int num_sim_cycles_ = 3000);
 
@@ -0,0 +1,140 @@
+/** eqasm_as.cpp
+ *
+ * A command line eQASM assembler and disassembler, replacing assemble.py.
+ *
+ * Usage:
+ *   eqasm_as -i prog.eqasm -o prog.bin      assemble
+ *   eqasm_as -d -i prog.bin -o prog.eqasm   disassemble
+ *
+ * Quantum operations are encoded with the qisa_opcodes.qmap file given by '-m', or the one next to
+ * the input file. Without any qmap file, the binary opcodes of the gate configuration ('-g', or
+ * the default one of the simulator) are used. The opcodes must name every operation of the
+ * program: e.g. test_files/qvm_test/qisa_opcodes.qmap only defines CZ_1 to CZ_7, not CZ.
+ *
+ * The binary holds the words of the source only, without the stop the simulator appends.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <systemc>
+
+#include "cmdparser/cmdparser.h"
+#include "eqasm_assembler.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+
+using namespace cactus;
+
+static std::string dir_of(const std::string& fn) {
+    size_t pos = fn.find_last_of("/\\");
+    return (pos == std::string::npos) ? std::string("./") : fn.substr(0, pos + 1);
+}
+
+static bool file_exists(const std::string& fn) {
+    std::ifstream fin(fn);
+    return static_cast<bool>(fin);
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    cli::Parser cmdparser(argc, argv);
+    cmdparser.set_required<std::string>("i", "input", "Specify the input asm (or bin) file.");
+    cmdparser.set_optional<std::string>("o", "output", "",
+                                        "Specify the output bin (or asm) file. The input file "
+                                        "with the extension '.bin' (or '.eqasm') by default.");
+    cmdparser.set_optional<bool>("d", "disassemble", false,
+                                 "Disassemble the binary input file instead of assembling it.");
+    cmdparser.set_optional<std::string>(
+      "m", "qmap", "",
+      "Specify the qisa_opcodes.qmap file. The one next to the input file by default.");
+    cmdparser.set_optional<std::string>(
+      "g", "gate_config", "",
+      "Specify the gate configuration file whose binary opcodes are used without a qmap file.");
+    cmdparser.set_optional<std::string>("t", "tp_config", "",
+                                        "Specify the topology configuration file.");
+    cmdparser.set_optional<unsigned int>(
+      "j", "threads", 0, "Specify the number of threads. 0 uses one thread per core.");
+    cmdparser.run_and_exit_if_error();
+
+    const std::string  in_fn       = cmdparser.get<std::string>("i");
+    std::string        out_fn      = cmdparser.get<std::string>("o");
+    const bool         disassemble = cmdparser.get<bool>("d");
+    std::string        qmap_fn     = cmdparser.get<std::string>("m");
+    const std::string  gate_fn     = cmdparser.get<std::string>("g");
+    const std::string  topology_fn = cmdparser.get<std::string>("t");
+    const unsigned int num_threads = cmdparser.get<unsigned int>("j");
+
+    Global_config& global_config = Global_config::get_instance();
+    global_config.set_log_level_default();
+    auto logger = get_logger_or_exit("console");
+
+    if (!topology_fn.empty()) global_config.read_from_file(topology_fn);
+
+    global_config.instruction_type = Instruction_type::BIN;
+    global_config.set_qubit_gate_default();
+    if (!gate_fn.empty()) global_config.read_qubit_gate_config(gate_fn);
+
+    Eqasm_assembler assembler;
+    if (qmap_fn.empty() && file_exists(dir_of(in_fn) + "qisa_opcodes.qmap")) {
+        qmap_fn = dir_of(in_fn) + "qisa_opcodes.qmap";
+    }
+    if (qmap_fn.empty()) {
+        assembler.set_q_opcodes(global_config.opcode_to_opname_lut);
+    } else {
+        std::string error_msg;
+        if (!assembler.load_qmap(qmap_fn, error_msg)) {
+            logger->error("eqasm_as: {}. Aborts!", error_msg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (out_fn.empty()) {
+        size_t dot = in_fn.find_last_of('.');
+        size_t sep = in_fn.find_last_of("/\\");
+        std::string base =
+          ((dot == std::string::npos) || ((sep != std::string::npos) && (dot < sep)))
+            ? in_fn
+            : in_fn.substr(0, dot);
+        out_fn = base + (disassemble ? ".eqasm" : ".bin");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<uint32_t> words;
+    size_t                num_bytes = 0;
+    if (disassemble) {
+        if (!Eqasm_assembler::read_bin(in_fn, words)) {
+            logger->error("eqasm_as: Failed to read the binary file '{}'. Aborts!", in_fn);
+            return EXIT_FAILURE;
+        }
+        num_bytes = words.size() * 4;
+
+        std::ofstream fout(out_fn);
+        if (!fout || !assembler.disassemble(words, fout)) {
+            logger->error("eqasm_as: Failed to disassemble '{}' into '{}'. Aborts!", in_fn,
+                          out_fn);
+            return EXIT_FAILURE;
+        }
+    } else {
+        assembler.declare_gates();
+        assembler.assemble(in_fn, words, num_threads);
+
+        std::ifstream fin(in_fn, std::ios::binary | std::ios::ate);
+        num_bytes = static_cast<size_t>(fin.tellg());
+
+        if (!Eqasm_assembler::write_bin(out_fn, words)) {
+            logger->error("eqasm_as: Failed to write the binary file '{}'. Aborts!", out_fn);
+            return EXIT_FAILURE;
+        }
+    }
+
+    double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << (disassemble ? "Disassembled " : "Assembled ") << words.size()
+              << " instructions from '" << in_fn << "' into '" << out_fn << "' in " << seconds
+              << " s (" << (seconds > 0 ? num_bytes / seconds / 1e6 : 0) << " MB/s)."
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
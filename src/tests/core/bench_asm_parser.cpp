@@ -0,0 +1,87 @@
+/** bench_asm_parser.cpp
+ *
+ * Generates a large eQASM program, then loads and decodes it like the instruction cache does,
+ * and reports the throughput in lines per second.
+ *
+ * Usage: bench_asm_parser [num_lines] [num_threads]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "asm_program.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "qasm_instruction.h"
+
+using namespace cactus;
+
+static const char* insn_templates[] = {"ldi r1, 100",
+                                       "addi r2, r1, -5",
+                                       "add r3, r1, r2",
+                                       "ldui r6, r1, 0x7f",
+                                       "lw r4, 4(r3)",
+                                       "sw r4, 0x8(r3)",
+                                       "smis s1, {0, 1, 2}",
+                                       "smit t2, {(0, 1), (2, 3)}",
+                                       "2, x90 s1 | cz t2",
+                                       "1, measz s1",
+                                       "qwait 100",
+                                       "fmr r5, q1",
+                                       "bne r1, r2, loop"};
+
+int sc_main(int argc, char* argv[]) {
+
+    size_t num_lines = 1000000;
+    if (argc > 1) num_lines = std::stoul(argv[1]);
+
+    unsigned int num_threads = 1;
+    if (argc > 2) num_threads = static_cast<unsigned int>(std::stoul(argv[2]));
+
+    auto console = safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::info);
+
+    // the operations used by the generated program
+    Global_config& global_config                    = Global_config::get_instance();
+    global_config.single_qubit_gate_time["x"]       = 1;
+    global_config.single_qubit_gate_time["measure"] = 15;
+    global_config.two_qubit_gate_time["cz"]         = 2;
+
+    const std::string asm_fn = "bench_asm_parser.eqasm";
+
+    std::ofstream asm_file(asm_fn);
+    // a label every 1000 lines keeps the branches within the range of the branch offset
+    asm_file << "loop0: nop" << std::endl;
+    const size_t num_templates = sizeof(insn_templates) / sizeof(insn_templates[0]);
+    for (size_t i = 1; i < num_lines; ++i) {
+        if (i % 1000 == 0) asm_file << "loop" << i / 1000 << ": ";
+        asm_file << insn_templates[i % num_templates];
+        if (i % num_templates == num_templates - 1) asm_file << i / 1000 << "  # back to the label";
+        asm_file << std::endl;
+    }
+    size_t file_size = static_cast<size_t>(asm_file.tellp());
+    asm_file.close();
+
+    auto start = std::chrono::steady_clock::now();
+
+    Asm_program program;
+    program.load(asm_fn, num_threads);
+
+    std::vector<Qasm_instruction> insns;
+    program.decode(insns, num_threads);
+
+    auto   stop    = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+
+    console->info("Parsed {} lines ({:.1f} MB, {} elementary instructions) on {} thread(s) in "
+                  "{:.3f} s: {:.0f} lines/s.",
+                  num_lines, file_size / 1e6, program.lines.size(), num_threads, seconds,
+                  num_lines / seconds);
+
+    std::remove(asm_fn.c_str());
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/** bench_cycle_rate.cpp
+ *
+ * Runs the cycle-accurate model of CC-Light, without qubit simulator, on a program which loops
+ * forever over classical and quantum instructions, and reports the simulation speed in
+ * simulated cycles (200 MHz) per second. The number of SystemC processes of each kind is
+ * reported too, since every thread process costs a coroutine stack and a context switch per
+ * activation, and a method process does not.
+ *
+ * Build and run it before and after a change of the model to compare both.
+ *
+ * Usage: bench_cycle_rate [num_cycles]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <systemc>
+
+#include "cclight_new.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "num_util.h"
+
+using namespace cactus;
+using namespace sc_core;
+using sc_dt::sc_uint;
+
+static const char* program_text = R"(start:
+    smis s0, {0}
+    smis s1, {1, 4}
+    smis s2, {2, 3}
+    smit t0, {(2, 0)}
+    ldi r0, 0
+    ldi r1, 1
+    ldi r2, 0
+loop:
+    add r2, r2, r1
+    sw r2, 4(r0)
+    lw r3, 4(r0)
+    1, x s0 | h s1
+    1, cz t0 | y s1
+    2, x s2
+    cmp r2, r3
+    br always, loop
+)";
+
+// drives reset, init and run as the testbench of the simulator does
+SC_MODULE(Bench_driver) {
+  public:
+    sc_in<bool> clock;
+
+    sc_signal<bool>                          reset;
+    sc_signal<bool>                          init;
+    sc_signal<bool>                          run;
+    sc_signal<sc_uint<MEMORY_ADDRESS_WIDTH>> init_pc;
+
+    void drive() {
+        reset.write(true);
+        init_pc.write(0);
+        run.write(false);
+        wait();
+        reset.write(false);
+        wait();
+        init.write(true);
+        wait();
+        init.write(false);
+        wait();
+        run.write(true);
+
+        while (true) wait();
+    }
+
+    SC_CTOR(Bench_driver) { SC_CTHREAD(drive, clock.pos()); }
+};
+
+// the number of processes of each kind under the object
+static void count_processes(sc_object* object, std::map<std::string, unsigned int>& counts) {
+    std::string kind = object->kind();
+    if (kind == "sc_method_process" || kind == "sc_thread_process" ||
+        kind == "sc_cthread_process") {
+        counts[kind]++;
+    }
+    for (sc_object* child : object->get_child_objects()) {
+        count_processes(child, counts);
+    }
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    unsigned int num_cycles = 200000;
+    if (argc > 1) num_cycles = static_cast<unsigned int>(std::stoul(argv[1]));
+
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+
+    Global_config& global_config = Global_config::get_instance();
+    global_config.set_log_level_default();
+    auto console = get_logger_or_exit("console");
+    console->set_level(spdlog::level::info);
+
+    const std::string asm_fn = "bench_cycle_rate.eqasm";
+    {
+        std::ofstream asm_file(asm_fn);
+        asm_file << program_text;
+    }
+
+    global_config.instruction_type = Instruction_type::ASM;
+    global_config.qisa_asm_fn      = asm_fn;
+    global_config.output_dir       = "./bench_cycle_rate/";
+    global_config.set_qubit_gate_default();
+    global_config.init_data_memory("1K");
+    create_dir_if_not_exist(global_config.output_dir);
+
+    sc_clock clock_200MHz("clock_200MHz", 2.0, SC_NS, 0.5);
+    sc_clock clock_50MHz("clock_50MHz", 20.0, SC_NS, 0.5);
+
+    Bench_driver driver("driver");
+    driver.clock(clock_200MHz);
+
+    sc_signal<bool>             done;
+    sc_signal<bool>             eq_empty;
+    sc_signal<Generic_meas_if>  meas_result;
+    sc_signal<Q_pipe_interface> q_pipe_interface;
+
+    CC_Light cclight("cclight");
+    cclight.in_clock(clock_200MHz);
+    cclight.in_50MHz_clock(clock_50MHz);
+    cclight.reset(driver.reset);
+    cclight.init(driver.init);
+    cclight.App2Clp_init_pc(driver.init_pc);
+    cclight.Clp2App_done(done);
+    cclight.Qp2App_eq_empty(eq_empty);
+    cclight.run(driver.run);
+    cclight.in_meas_result(meas_result);
+    cclight.out_q_pipe_interface(q_pipe_interface);
+
+    // elaboration, and the first delta cycles, are not part of the measure
+    sc_start(SC_ZERO_TIME);
+
+    std::map<std::string, unsigned int> counts;
+    for (sc_object* object : sc_get_top_level_objects()) {
+        count_processes(object, counts);
+    }
+    console->info("Processes: {} methods, {} threads, {} clocked threads.",
+                  counts["sc_method_process"], counts["sc_thread_process"],
+                  counts["sc_cthread_process"]);
+
+    auto start = std::chrono::steady_clock::now();
+
+    sc_start(2.0 * num_cycles, SC_NS);
+
+    auto   stop    = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+
+    console->info("Simulated {} cycles (200 MHz) in {:.3f} s: {:.0f} cycles/s.", num_cycles,
+                  seconds, num_cycles / seconds);
+
+    std::remove(asm_fn.c_str());
+
+    return 0;
+}
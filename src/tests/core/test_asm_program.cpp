@@ -0,0 +1,161 @@
+/** test_asm_program.cpp
+ *
+ * Checks that loading and decoding an eQASM program on several threads gives exactly the same
+ * program image as loading it line by line on one thread, and that hexadecimal immediates are
+ * read as the bits of an int.
+ *
+ * Usage: tb_asm_program [num_lines]
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "asm_program.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "qasm_instruction.h"
+
+using namespace cactus;
+
+static const char* insn_templates[] = {"ldi r1, 100",
+                                       "  addi r2, r1, -5   # comment",
+                                       "",
+                                       "# only a comment",
+                                       "add r3, r1, r2\r",
+                                       "lw r4, 4(r3)",
+                                       "ldi r1, 0xFFFFFFFF",
+                                       "addi r2, r1, 0xFFFFFFFC",
+                                       "smis s1, {0, 1, 2}",
+                                       "smit t2, {(0, 1), (2, 3)}",
+                                       "SMIT t3,{{1,2},{3,4}}",
+                                       "sub r3 r1 r2",
+                                       "xor r3, r1, r2 ,",
+                                       "2, x90 s1 | cz t2",
+                                       "1, measz s1",
+                                       "qwait 100",
+                                       "fmr r5, q1",
+                                       "bne r1, r2, loop",
+                                       "beq r1, r2, next",
+                                       "br always, start"};
+
+static bool same_insn(Qasm_instruction& a, Qasm_instruction& b) {
+    return a.get_type() == b.get_type() && a.insn_addr == b.insn_addr &&
+           a.get_insn_asm() == b.get_insn_asm() &&
+           a.get_insn_line_num_in_file() == b.get_insn_line_num_in_file() &&
+           a.get_insn_str_in_file() == b.get_insn_str_in_file() &&
+           a.get_opcode() == b.get_opcode() && a.get_rs_addr() == b.get_rs_addr() &&
+           a.get_rt_addr() == b.get_rt_addr() && a.get_rd_addr() == b.get_rd_addr() &&
+           a.get_imm() == b.get_imm() && a.get_uimm() == b.get_uimm() &&
+           a.get_br_addr() == b.get_br_addr() && a.get_br_cond() == b.get_br_cond() &&
+           a.get_qubit_sel() == b.get_qubit_sel() && a.is_q_insn() == b.is_q_insn() &&
+           a.is_cl_insn() == b.is_cl_insn() && a.is_meas() == b.is_meas() &&
+           a.is_rd_used() == b.is_rd_used() && a.is_rs_used() == b.is_rs_used() &&
+           a.is_rt_used() == b.is_rt_used() && a.get_q_insn_type() == b.get_q_insn_type() &&
+           a.get_q_time_specified() == b.get_q_time_specified() &&
+           a.get_q_qubit_indices() == b.get_q_qubit_indices() &&
+           a.get_q_qubit_tuples() == b.get_q_qubit_tuples() &&
+           a.get_q_reg_num() == b.get_q_reg_num() && a.get_q_op_name() == b.get_q_op_name() &&
+           a.get_q_num_tgt_qubits_type() == b.get_q_num_tgt_qubits_type();
+}
+
+static int compare(const std::string& asm_fn, unsigned int num_threads, size_t chunk_size) {
+    Asm_program                   seq, par;
+    std::vector<Qasm_instruction> seq_insns, par_insns;
+
+    seq.load(asm_fn, 1);
+    seq.decode(seq_insns, 1);
+
+    par.min_chunk_size = chunk_size;
+    par.load(asm_fn, num_threads);
+    par.decode(par_insns, num_threads);
+
+    if (seq.lines.size() != par.lines.size() || seq.map_label != par.map_label) {
+        std::cout << "FAILED (" << num_threads << " threads, chunks of " << chunk_size
+                  << " bytes): different number of lines or labels." << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < seq.lines.size(); ++i) {
+        if (!same_insn(seq_insns[i], par_insns[i])) {
+            std::cout << "FAILED (" << num_threads << " threads, chunks of " << chunk_size
+                      << " bytes): instruction " << i << " differs: '"
+                      << seq_insns[i].get_insn_asm() << "' at line "
+                      << seq_insns[i].get_insn_line_num_in_file() << " vs '"
+                      << par_insns[i].get_insn_asm() << "' at line "
+                      << par_insns[i].get_insn_line_num_in_file() << "." << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Passed (" << num_threads << " threads, chunks of " << chunk_size
+              << " bytes): " << seq.lines.size() << " instructions, " << seq.map_label.size()
+              << " labels." << std::endl;
+    return 0;
+}
+
+// hexadecimal immediates of up to 32 bits are the bits of an int, as with the regex parser
+static int check_hex_immediates() {
+    const std::string asm_fn = "test_asm_program_hex.eqasm";
+    std::ofstream     asm_file(asm_fn, std::ios::binary);
+    asm_file << "ldi r1, 0xFFFFFFFF\naddi r2, r1, 0xFFFFFFFC\nlw r3, 0x10(r2)\nldi r4, -0x10\n";
+    asm_file.close();
+
+    Asm_program                   program;
+    std::vector<Qasm_instruction> insns;
+    program.load(asm_fn, 1);
+    program.decode(insns, 1);
+    std::remove(asm_fn.c_str());
+
+    const int imms[] = {-1, -4, 16, -16};
+    for (size_t i = 0; i < sizeof(imms) / sizeof(imms[0]); ++i) {
+        if (insns[i].get_imm() != imms[i]) {
+            std::cout << "FAILED: '" << insns[i].get_insn_asm() << "' gives the immediate "
+                      << insns[i].get_imm() << " instead of " << imms[i] << "." << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Passed: hexadecimal immediates." << std::endl;
+    return 0;
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    size_t num_lines = 20000;
+    if (argc > 1) num_lines = std::stoul(argv[1]);
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    Global_config& global_config                    = Global_config::get_instance();
+    global_config.single_qubit_gate_time["x"]       = 1;
+    global_config.single_qubit_gate_time["measure"] = 15;
+    global_config.two_qubit_gate_time["cz"]         = 2;
+
+    const std::string asm_fn        = "test_asm_program.eqasm";
+    const size_t      num_templates = sizeof(insn_templates) / sizeof(insn_templates[0]);
+
+    // labels are defined more than once, and the file does not end with a new line
+    std::ofstream asm_file(asm_fn, std::ios::binary);
+    asm_file << "start: nop\n";
+    for (size_t i = 1; i < num_lines; ++i) {
+        if (i % 97 == 0) asm_file << "loop: ";
+        if (i % 89 == 0) asm_file << "next:\n";
+        asm_file << insn_templates[i % num_templates] << "\n";
+    }
+    asm_file << "stop";
+    asm_file.close();
+
+    int failed = 0;
+    failed += compare(asm_fn, 2, 4096);
+    failed += compare(asm_fn, 3, 1000);
+    failed += compare(asm_fn, 8, 64);
+    failed += compare(asm_fn, 0, 1 << 20);
+    failed += check_hex_immediates();
+
+    std::remove(asm_fn.c_str());
+
+    std::cout << (failed ? "Test_asm_program FAILED." : "Test_asm_program passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/** test_bit_set.cpp
+ *
+ * Checks the sets of bits against a vector of bools, for widths around the word boundaries:
+ *  - the single bits, the count and the bits visited in order,
+ *  - the word-wise operations, also between sets of different widths,
+ *  - the bits beyond the width are never seen, after a resize or set_all,
+ *  - a partial overwrite keeps the bits beyond the width of the source,
+ *  - the hexadecimal form of a mask wider than a word.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "bit_set.h"
+
+using namespace cactus;
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+// a pseudo-random pattern of bits
+static std::vector<bool> pattern(size_t width, unsigned int seed) {
+    std::vector<bool> bits(width);
+    for (size_t i = 0; i < width; ++i) {
+        seed    = seed * 1103515245 + 12345;
+        bits[i] = (seed >> 16) & 1;
+    }
+    return bits;
+}
+
+static Bit_set to_bit_set(const std::vector<bool>& bits) {
+    Bit_set bit_set(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i) bit_set.set(i, bits[i]);
+    return bit_set;
+}
+
+static bool same(const Bit_set& bit_set, const std::vector<bool>& bits) {
+    if (bit_set.size() != bits.size()) return false;
+    for (size_t i = 0; i < bits.size(); ++i) {
+        if (bit_set.test(i) != bits[i]) return false;
+    }
+    return true;
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    const size_t widths[] = {1, 7, 63, 64, 65, 127, 128, 129, 500, BIT_SET_MAX_WIDTH};
+
+    for (size_t width : widths) {
+        const std::string at = " (width " + std::to_string(width) + ")";
+
+        std::vector<bool> a = pattern(width, 1);
+        std::vector<bool> b = pattern(width, 2);
+        Bit_set           x = to_bit_set(a);
+        Bit_set           y = to_bit_set(b);
+
+        // -------------------------------------------------------------------------------------
+        // single bits
+        // -------------------------------------------------------------------------------------
+        check(same(x, a), "the bits are set" + at);
+
+        size_t              num_bits = 0;
+        std::vector<size_t> visited;
+        for (size_t i = 0; i < width; ++i) num_bits += a[i];
+        x.for_each([&](size_t i) { visited.push_back(i); });
+        check(x.count() == num_bits && visited.size() == num_bits, "the bits are counted" + at);
+        bool in_order = true;
+        for (size_t k = 0; k < visited.size(); ++k) {
+            in_order &= a[visited[k]] && (k == 0 || visited[k - 1] < visited[k]);
+        }
+        check(in_order, "the bits are visited in order" + at);
+        check(x.any() == (num_bits > 0) && x.none() == (num_bits == 0), "any and none" + at);
+
+        // -------------------------------------------------------------------------------------
+        // word-wise operations
+        // -------------------------------------------------------------------------------------
+        std::vector<bool> r_and(width), r_or(width), r_xor(width), r_and_not(width);
+        for (size_t i = 0; i < width; ++i) {
+            r_and[i]     = a[i] && b[i];
+            r_or[i]      = a[i] || b[i];
+            r_xor[i]     = a[i] != b[i];
+            r_and_not[i] = a[i] && !b[i];
+        }
+        check(same(x & y, r_and), "and" + at);
+        check(same(x | y, r_or), "or" + at);
+        check(same(x ^ y, r_xor), "xor" + at);
+        check(same(Bit_set(x).and_not(y), r_and_not), "and not" + at);
+
+        check(x == to_bit_set(a) && (x != y) == (a != b), "equality" + at);
+        check(Bit_set(width) != Bit_set(width - 1), "sets of different widths differ" + at);
+
+        Bit_set all(width);
+        all.set_all();
+        check(all.count() == width, "all the bits are set" + at);
+
+        // a narrower set has no bit beyond its width
+        Bit_set narrow = to_bit_set(pattern(width / 2, 3));
+        Bit_set wide   = all;
+        wide &= narrow;
+        check(wide.count() == narrow.count() && wide.size() == width,
+              "and with a narrower set" + at);
+
+        // -------------------------------------------------------------------------------------
+        // width
+        // -------------------------------------------------------------------------------------
+        Bit_set grown(all);
+        grown.resize(width / 2);
+        grown.resize(width);
+        check(grown.count() == width / 2, "the bits beyond a smaller width are cleared" + at);
+
+        Bit_set over = all;
+        over.reset();
+        over.overwrite(narrow);
+        Bit_set kept = all;
+        kept.overwrite(narrow);
+        check((over | narrow) == over && over.count() == narrow.count() &&
+                kept.count() == narrow.count() + (width - width / 2),
+              "an overwrite replaces only the bits within the width of the source" + at);
+    }
+
+    Bit_set empty;
+    check(empty.size() == 0 && empty.none() && empty.count() == 0, "an empty set reads as 0");
+    check(empty.to_hex() == "0", "an empty mask is 0x0");
+
+    Bit_set mask(130);
+    mask.set(1);
+    mask.set(2);
+    check(mask.to_hex() == "6", "a mask is written without leading zeros");
+    mask.set(129);
+    check(mask.to_hex() == "2" + std::string(31, '0') + "6",
+          "the words of a wide mask are written in full: " + mask.to_hex());
+
+    std::cout << (failed ? "Test_bit_set FAILED." : "Test_bit_set passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/** test_checkpoint.cpp
+ *
+ * Checks that a simulation restored from a checkpoint continues exactly as the one which saved
+ * it:
+ *  - the registers, the data memory and the qubit state reached after the restore are the same
+ *    as when running the program at once,
+ *  - checkpoints of another program, or damaged ones, are rejected.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "checkpoint.h"
+#include "fast_forward.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+
+using namespace cactus;
+
+static const char* program_text = R"(start:
+    ldi r0, 0
+    ldi r1, 1
+    ldi r2, 0
+    ldi r3, 10
+    ldi r4, 0
+loop:
+    add r4, r4, r1
+    add r2, r2, r4
+    cmp r4, r3
+    br lt, loop
+    sw r2, 4(r0)
+    smis s1, {0, 2}
+    smis s3, {1}
+    1, h s1
+    2, measz s1
+marker:
+    fmr r8, q2
+    qwait 7
+    1, x s3
+    1, measz s3
+    qwait 30
+    fmr r9, q1
+    lw r10, 4(r0)
+    stop
+)";
+
+// measures qubits with a pseudo-random generator, whose state is part of the qubit state
+class Mock_backend : public Qubit_backend {
+  public:
+    uint64_t                  seed = 12345;
+    std::vector<unsigned int> num_ops_on_qubit;
+
+    Res_from_qsim apply_moment(Ops_2_qsim moment) override {
+        Res_from_qsim res;
+        for (const auto& qop : moment.atom_ops) {
+            for (unsigned int q : qop.target_qubits) {
+                if (q >= num_ops_on_qubit.size()) num_ops_on_qubit.resize(q + 1, 0);
+                num_ops_on_qubit[q]++;
+            }
+
+            std::string name = qop.operation;
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            if (name.find("meas") == std::string::npos) continue;
+
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            res.results.push_back(
+              std::make_pair(qop.target_qubits[0], static_cast<unsigned int>(seed >> 63)));
+        }
+        return res;
+    }
+
+    bool save_state(Cache_writer& writer) override {
+        writer.put(seed);
+        writer.put(num_ops_on_qubit);
+        return true;
+    }
+
+    bool restore_state(Cache_reader& reader) override {
+        reader.get(seed);
+        reader.get(num_ops_on_qubit);
+        return reader.ok();
+    }
+};
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static bool same_state(const Arch_state& a, const Arch_state& b) {
+    return a.pc == b.pc && std::equal(a.regs, a.regs + REG_FILE_NUM, b.regs) &&
+           std::equal(a.flags_cmp, a.flags_cmp + NUM_CMP_FLAGS, b.flags_cmp) &&
+           a.mask_reg.s_reg_content == b.mask_reg.s_reg_content &&
+           a.mask_reg.m_reg_content == b.mask_reg.m_reg_content &&
+           a.meas_results == b.meas_results && a.q_cycle == b.q_cycle &&
+           a.num_insns == b.num_insns;
+}
+
+static void write_file(const std::string& fn, const std::string& content) {
+    std::ofstream file(fn, std::ios::binary);
+    file << content;
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.instruction_type = Instruction_type::ASM;
+    global_config.set_qubit_gate_default();
+    global_config.init_data_memory("1K");
+
+    const std::string asm_fn        = "test_checkpoint.eqasm";
+    const std::string checkpoint_fn = "test_checkpoint.ckpt";
+    write_file(asm_fn, program_text);
+    global_config.qisa_asm_fn = asm_fn;
+
+    Ff_target marker;
+    marker.parse("label:marker");
+
+    // ---------------------------------------------------------------------------------------
+    // the whole program at once
+    // ---------------------------------------------------------------------------------------
+    Mock_backend        full_backend;
+    Fast_forward_engine full(&full_backend);
+    full.load_asm(asm_fn);
+    check(full.run(Ff_target()) == FF_PROGRAM_END, "the program runs to its end");
+    check(full.state().regs[10] == 55, "the program loads the sum it stored");
+
+    // ---------------------------------------------------------------------------------------
+    // up to the marker, saved, and restored into a new simulation
+    // ---------------------------------------------------------------------------------------
+    global_config.data_memory->init_data_mem();
+
+    std::string error_msg;
+    {
+        Mock_backend        backend;
+        Fast_forward_engine engine(&backend);
+        engine.load_asm(asm_fn);
+        check(engine.run(marker) == FF_TARGET_REACHED, "the marker is reached");
+        check(save_checkpoint(checkpoint_fn, engine.state(), &backend, error_msg),
+              "the checkpoint is saved: " + error_msg);
+    }
+
+    global_config.data_memory->init_data_mem();
+
+    Mock_backend        backend;
+    Fast_forward_engine engine(&backend);
+    engine.load_asm(asm_fn);
+
+    Arch_state state;
+    check(restore_checkpoint(checkpoint_fn, state, &backend, error_msg),
+          "the checkpoint is restored: " + error_msg);
+    check(state.valid && state.pc > 0, "the restored state is past the beginning");
+    check(global_config.data_memory->read_mem(1) == 55, "the data memory is restored");
+    check(backend.num_ops_on_qubit.size() == 3 && backend.num_ops_on_qubit[1] == 0,
+          "the qubit state is restored");
+
+    engine.set_state(state);
+    check(engine.run(Ff_target()) == FF_PROGRAM_END, "the restored program runs to its end");
+    check(same_state(engine.state(), full.state()), "the restored run reaches the same state");
+    check(backend.seed == full_backend.seed &&
+            backend.num_ops_on_qubit == full_backend.num_ops_on_qubit,
+          "the restored run reaches the same qubit state");
+
+    // ---------------------------------------------------------------------------------------
+    // checkpoints which cannot be restored
+    // ---------------------------------------------------------------------------------------
+    write_file(asm_fn, std::string(program_text) + "    nop\n");
+    check(!restore_checkpoint(checkpoint_fn, state, &backend, error_msg),
+          "a checkpoint of another program is rejected");
+    write_file(asm_fn, program_text);
+
+    std::string content;
+    {
+        std::ifstream file(checkpoint_fn, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    write_file(checkpoint_fn, content.substr(0, content.size() - 8));
+    check(!restore_checkpoint(checkpoint_fn, state, &backend, error_msg),
+          "a truncated checkpoint is rejected");
+    check(!restore_checkpoint("no_such_checkpoint.ckpt", state, &backend, error_msg),
+          "a missing checkpoint is rejected");
+
+    std::remove(checkpoint_fn.c_str());
+    std::remove(asm_fn.c_str());
+
+    std::cout << (failed ? "Test_checkpoint FAILED." : "Test_checkpoint passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
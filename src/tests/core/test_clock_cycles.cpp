@@ -0,0 +1,157 @@
+/** test_clock_cycles.cpp
+ *
+ * Checks that the cycle numbers derived from the simulation time are the ones a clocked process
+ * counts, on every clock cycle:
+ *  - the rising edges of the clock (Clock_cycles::num_edges),
+ *  - the cycles the removed counters of the modules counted, which waited for the edge after the
+ *    first before counting (Clock_cycles::num_cycles),
+ *  - the cycles during which 'started' was true (Cycle_counter), with 'started' true from the
+ *    beginning, and set and reset by a clocked process. At a rising edge, a clocked process
+ *    reads them before the edge is counted,
+ * for an sc_clock which starts at time 0, one which starts later with a falling edge, and a
+ * clock of Idle_skip_clock.
+ */
+
+#include <iostream>
+#include <systemc>
+
+#include "cycle_counter.h"
+#include "idle_skip.h"
+#include "logger_wrapper.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define NUM_CYCLES 60
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+SC_MODULE(Cycle_checker) {
+  public:
+    sc_in<bool> clock;
+
+    sc_signal<bool> always_started;
+    sc_signal<bool> started;
+
+    Cycle_counter always_counter;
+    Cycle_counter counter;
+    Clock_cycles  clock_cycles{clock};
+
+    // counted by clocked processes
+    uint64_t     ref_num_edges   = 0;
+    uint64_t     ref_num_cycles  = 0;
+    uint64_t     ref_num_started = 0;
+    uint64_t     ref_num_always  = 0;
+    unsigned int num_checks      = 0;
+    unsigned int num_edge_checks = 0;
+    bool         same            = true;
+    bool         same_at_edge    = true;
+    uint64_t     first_mismatch  = 0;
+
+    // sets and resets 'started', as a testbench does
+    void drive() {
+        for (int cycle = 0;; ++cycle) {
+            if (cycle == 5 || cycle == 30) started.write(true);
+            if (cycle == 20) started.write(false);
+            wait();
+        }
+    }
+
+    void count_edges() {
+        while (true) {
+            ref_num_edges++;
+            wait();
+        }
+    }
+
+    // as the modules and Cycle_counter used to count
+    void count_cycles() {
+        while (true) {
+            wait();
+            num_edge_checks++;
+            same_at_edge = same_at_edge &&
+                           (always_counter.get_cur_cycle_num() == ref_num_always) &&
+                           (counter.get_cur_cycle_num() == ref_num_started);
+
+            ref_num_cycles++;
+            if (always_started.read()) ref_num_always++;
+            if (started.read()) ref_num_started++;
+        }
+    }
+
+    // between two rising edges, when every clocked process has run
+    void compare() {
+        num_checks++;
+        bool same_cycle = (clock_cycles.num_edges() == ref_num_edges) &&
+                          (clock_cycles.num_cycles() == ref_num_cycles) &&
+                          (always_counter.get_cur_cycle_num() == ref_num_always) &&
+                          (counter.get_cur_cycle_num() == ref_num_started);
+        if (!same_cycle && same) {
+            same           = false;
+            first_mismatch = ref_num_edges;
+        }
+    }
+
+    SC_CTOR(Cycle_checker)
+        : always_counter("always_counter")
+        , counter("counter") {
+        always_started.write(true);
+
+        always_counter.in_clock(clock);
+        always_counter.in_started(always_started);
+        counter.in_clock(clock);
+        counter.in_started(started);
+
+        SC_CTHREAD(drive, clock.pos());
+        SC_CTHREAD(count_edges, clock.pos());
+        SC_CTHREAD(count_cycles, clock.pos());
+
+        SC_METHOD(compare);
+        sensitive << clock.neg();
+        dont_initialize();
+    }
+};
+
+static void check_checker(const Cycle_checker& checker, const std::string& clock_name) {
+    check(checker.num_checks >= NUM_CYCLES - 1, clock_name + ": every cycle is checked");
+    check(checker.same, clock_name + ": the derived cycle numbers are the counted ones, the first "
+                                     "difference is at edge " +
+                          std::to_string(checker.first_mismatch));
+    check(checker.num_edge_checks >= NUM_CYCLES - 1, clock_name + ": every edge is checked");
+    check(checker.same_at_edge, clock_name + ": the counters are read at an edge before it counts");
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+
+    sc_clock        clock("clock", 5.0, SC_NS);
+    sc_clock        late_clock("late_clock", 8.0, SC_NS, 0.25, 3.0, SC_NS, false);
+    Idle_skip_clock skip_clock("skip_clock", sc_time(2.0, SC_NS), sc_time(20.0, SC_NS));
+
+    Cycle_checker checker("checker");
+    checker.clock(clock);
+    Cycle_checker late_checker("late_checker");
+    late_checker.clock(late_clock);
+    Cycle_checker skip_checker("skip_checker");
+    skip_checker.clock(skip_clock.clock_50MHz);
+
+    sc_start(sc_time(20.0 * NUM_CYCLES, SC_NS));
+
+    check_checker(checker, "sc_clock");
+    check_checker(late_checker, "sc_clock starting with a falling edge");
+    check_checker(skip_checker, "Idle_skip_clock");
+
+    std::cout << (failed ? "Test_clock_cycles FAILED." : "Test_clock_cycles passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
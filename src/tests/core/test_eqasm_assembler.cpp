@@ -0,0 +1,144 @@
+/** test_eqasm_assembler.cpp
+ *
+ * Checks the eQASM assembler against the decoders of the simulator:
+ *  - every assembled word decodes (in binary mode) into the instruction the asm parser decoded,
+ *  - the disassembled listing assembles back into the same words.
+ *
+ * Usage: tb_eqasm_assembler [num_lines]
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "asm_program.h"
+#include "eqasm_assembler.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "qasm_instruction.h"
+
+using namespace cactus;
+
+// only instructions which have a binary encoding. The edges are the ones of the default topology.
+static const char* insn_templates[] = {"ldi r1, 100",
+                                       "ldi r2, -5   # comment",
+                                       "",
+                                       "ldui r3, r1, 0x7fff",
+                                       "add r3, r1, r2\r",
+                                       "sub r4, r3, r1",
+                                       "and r5, r4, r3",
+                                       "or r5, r4, r3",
+                                       "xor r5, r4, r3",
+                                       "not r6, r5",
+                                       "cmp r1, r2",
+                                       "nop",
+                                       "fbr lt, r7",
+                                       "fmr r8, q3",
+                                       "smis s1, {0, 1, 2}",
+                                       "smit t2, {(2, 0), (3, 1)}",
+                                       "2, x90 s1 | cz t2",
+                                       "1, measz s1",
+                                       "h s2",
+                                       "qwait 100",
+                                       "qwaitr r1",
+                                       "bne r1, r2, loop",
+                                       "beq r1, r2, next",
+                                       "br always, start"};
+
+static bool same_cl_insn(Qasm_instruction& a, Qasm_instruction& b) {
+    return a.is_cl_insn() == b.is_cl_insn() && a.is_q_insn() == b.is_q_insn() &&
+           a.get_opcode() == b.get_opcode() && a.get_rs_addr() == b.get_rs_addr() &&
+           a.get_rt_addr() == b.get_rt_addr() && a.get_rd_addr() == b.get_rd_addr() &&
+           a.get_imm() == b.get_imm() && a.get_uimm() == b.get_uimm() &&
+           a.get_br_addr() == b.get_br_addr() && a.get_br_cond() == b.get_br_cond() &&
+           a.get_qubit_sel() == b.get_qubit_sel();
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    size_t num_lines = 20000;
+    if (argc > 1) num_lines = std::stoul(argv[1]);
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.instruction_type = Instruction_type::BIN;
+    global_config.set_qubit_gate_default();
+
+    Eqasm_assembler assembler;
+    assembler.set_q_opcodes(global_config.opcode_to_opname_lut);
+    assembler.declare_gates();
+
+    const std::string asm_fn        = "test_eqasm_assembler.eqasm";
+    const std::string dis_fn        = "test_eqasm_assembler.dis.eqasm";
+    const size_t      num_templates = sizeof(insn_templates) / sizeof(insn_templates[0]);
+
+    std::ofstream asm_file(asm_fn, std::ios::binary);
+    asm_file << "start: nop\n";
+    for (size_t i = 1; i < num_lines; ++i) {
+        if (i % 97 == 0) asm_file << "loop: ";
+        if (i % 89 == 0) asm_file << "next:\n";
+        asm_file << insn_templates[i % num_templates] << "\n";
+    }
+    asm_file << "stop";
+    asm_file.close();
+
+    int failed = 0;
+
+    Asm_program                   program;
+    std::vector<Qasm_instruction> insns;
+    std::vector<uint32_t>         words;
+    program.load(asm_fn, 0);
+    program.decode(insns, 0);
+    assembler.assemble(asm_fn, words, 0);
+
+    // the extra stop the parser appends is only assembled for the simulation
+    std::vector<uint32_t> sim_words;
+    assembler.assemble(asm_fn, sim_words, 0, true);
+    if ((words.size() + 1 != insns.size()) || (sim_words.size() != insns.size())) {
+        std::cout << "FAILED: " << words.size() << " words, " << sim_words.size()
+                  << " for the simulation, for " << insns.size() << " instructions." << std::endl;
+        ++failed;
+    }
+
+    // classical instructions decode into the same fields in both modes
+    for (size_t i = 0; !failed && i < words.size(); ++i) {
+        Qasm_instruction bin_insn;
+        bin_insn.set_instruction(words[i], static_cast<unsigned int>(i));
+        if (insns[i].is_cl_insn() && !same_cl_insn(insns[i], bin_insn)) {
+            std::cout << "FAILED: '" << insns[i].get_insn_asm() << "' at line "
+                      << insns[i].get_insn_line_num_in_file() << " decodes differently from 0x"
+                      << std::hex << words[i] << std::dec << "." << std::endl;
+            ++failed;
+        }
+    }
+
+    // disassembling and assembling again gives the same program
+    std::vector<uint32_t> re_words;
+    if (!failed) {
+        std::ofstream dis_file(dis_fn);
+        if (!assembler.disassemble(words, dis_file)) {
+            std::cout << "FAILED: the program cannot be disassembled." << std::endl;
+            ++failed;
+        }
+        dis_file.close();
+    }
+    if (!failed) {
+        assembler.assemble(dis_fn, re_words, 2);
+        if (re_words != words) {
+            std::cout << "FAILED: the disassembled program assembles into different words."
+                      << std::endl;
+            ++failed;
+        }
+    }
+
+    std::remove(asm_fn.c_str());
+    std::remove(dis_fn.c_str());
+
+    std::cout << (failed ? "Test_eqasm_assembler FAILED." : "Test_eqasm_assembler passed.")
+              << " (" << words.size() << " instructions)" << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/** test_fast_forward.cpp
+ *
+ * Checks the fast-forward engine on a small program, in asm and binary mode:
+ *  - the registers, the data memory and the quantum timeline it reaches,
+ *  - the moments it sends to the qubit simulator,
+ *  - stopping at a label, a pc or a cycle, and continuing from there gives the same state as
+ *    running the program at once.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "eqasm_assembler.h"
+#include "fast_forward.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+
+using namespace cactus;
+
+static const char* program_text = R"(start:
+    ldi r0, 0
+    ldi r1, 1
+    ldi r2, 0
+    ldi r3, 10
+    ldi r4, 0
+loop:
+    add r4, r4, r1
+    add r2, r2, r4
+    cmp r4, r3
+    br lt, loop
+    sw r2, 4(r0)
+    ldi r5, -3
+    sb r5, 9(r0)
+    lb r6, 9(r0)
+    lbu r7, 9(r0)
+    smis s1, {0, 2}
+    smit t2, {(2, 0)}
+    qwait 10
+marker:
+    1, h s1
+    2, cz t2
+    qwaitr r3
+    1, measz s1
+    qwait 30
+    fmr r8, q2
+    fmr r9, q1
+    ldui r10, r1, 3
+    stop
+)";
+
+// records the moments, and measures every even qubit as 1
+class Mock_backend : public Qubit_backend {
+  public:
+    std::vector<Ops_2_qsim> moments;
+
+    Res_from_qsim apply_moment(Ops_2_qsim moment) override {
+        Res_from_qsim res;
+        for (const auto& qop : moment.atom_ops) {
+            std::string name = qop.operation;
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            if (name.find("meas") == std::string::npos) continue;
+            unsigned int qubit = qop.target_qubits[0];
+            res.results.push_back(std::make_pair(qubit, (qubit % 2 == 0) ? 1u : 0u));
+        }
+        moments.push_back(moment);
+        return res;
+    }
+};
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static bool same_state(const Arch_state& a, const Arch_state& b) {
+    return a.pc == b.pc && std::equal(a.regs, a.regs + REG_FILE_NUM, b.regs) &&
+           std::equal(a.flags_cmp, a.flags_cmp + NUM_CMP_FLAGS, b.flags_cmp) &&
+           a.meas_results == b.meas_results && a.q_cycle == b.q_cycle &&
+           a.num_insns == b.num_insns;
+}
+
+// the cycle and the target qubits of every moment
+static std::vector<std::pair<unsigned int, std::vector<unsigned int>>> timeline(
+  const std::vector<Ops_2_qsim>& moments) {
+    std::vector<std::pair<unsigned int, std::vector<unsigned int>>> result;
+    for (const auto& moment : moments) {
+        for (const auto& qop : moment.atom_ops) {
+            result.push_back(std::make_pair(moment.cycle, qop.target_qubits));
+        }
+    }
+    return result;
+}
+
+static Ff_target target_of(const std::string& text) {
+    Ff_target target;
+    check(target.parse(text), "'" + text + "' is a valid target");
+    return target;
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.instruction_type = Instruction_type::BIN;
+    global_config.set_qubit_gate_default();
+    global_config.init_data_memory("1K");
+
+    Eqasm_assembler assembler;
+    assembler.set_q_opcodes(global_config.opcode_to_opname_lut);
+    assembler.declare_gates();
+
+    const std::string asm_fn = "test_fast_forward.eqasm";
+    std::ofstream     asm_file(asm_fn, std::ios::binary);
+    asm_file << program_text;
+    asm_file.close();
+
+    Ff_target invalid;
+    check(!invalid.parse("pc:"), "'pc:' is rejected");
+    check(!invalid.parse("cycle:12x"), "'cycle:12x' is rejected");
+    check(!invalid.parse("line:3"), "'line:3' is rejected");
+
+    // ---------------------------------------------------------------------------------------
+    // the whole program at once
+    // ---------------------------------------------------------------------------------------
+    Mock_backend        full_backend;
+    Fast_forward_engine full(&full_backend);
+    full.load_asm(asm_fn);
+    check(full.run(Ff_target()) == FF_PROGRAM_END, "the program runs to its end");
+
+    const Arch_state& s = full.state();
+    check(s.regs[2] == 55, "the loop sums up to 55");
+    check(s.regs[6] == -3 && s.regs[7] == 253, "lb sign extends and lbu does not");
+    check(s.regs[8] == 1 && s.regs[9] == 0, "fmr reads the measurement results");
+    check(s.regs[10] == ((3 << 17) | 1), "ldui keeps the low bits of rs");
+    check(global_config.data_memory->read_mem(1) == 55, "sw stores the sum");
+    check(((global_config.data_memory->read_mem(2) >> 8) & 0xFF) == 0xFD, "sb stores one byte");
+    check(s.q_cycle == 54, "the timeline ends at cycle 54");
+    check(full.num_insns() > 0 && s.pc + 2 == full.num_insns(), "the engine stops at the stop");
+
+    auto expected = std::vector<std::pair<unsigned int, std::vector<unsigned int>>>{
+      {11, {0}}, {11, {2}}, {13, {2, 0}}, {24, {0}}, {24, {2}}};
+    check(timeline(full_backend.moments) == expected, "the moments follow the timing points");
+
+    // ---------------------------------------------------------------------------------------
+    // up to a label, a pc or a cycle, and then the rest of the program
+    // ---------------------------------------------------------------------------------------
+    const std::string targets[] = {"label:marker", "pc:7", "cycle:12"};
+    for (const auto& text : targets) {
+        global_config.data_memory->init_data_mem();
+
+        Mock_backend        backend;
+        Fast_forward_engine engine(&backend);
+        engine.load_asm(asm_fn);
+
+        check(engine.run(target_of(text)) == FF_TARGET_REACHED, text + " is reached");
+        if (text == "label:marker") {
+            check(engine.state().q_cycle == 10 && backend.moments.empty(),
+                  "the label stops before the first bundle");
+        } else if (text == "pc:7") {
+            check(engine.state().pc == 7, "pc:7 stops at pc 7");
+        } else {
+            check(engine.state().q_cycle == 11 && backend.moments.size() == 1,
+                  "cycle:12 stops before the bundle at cycle 13");
+        }
+
+        engine.run(Ff_target());
+        check(same_state(engine.state(), s), text + " and the rest give the same state");
+        check(timeline(backend.moments) == expected, text + " and the rest give the same moments");
+        check(global_config.data_memory->read_mem(1) == 55, text + " and the rest store the sum");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // the binary program, without the memory instructions which have no binary encoding
+    // ---------------------------------------------------------------------------------------
+    const std::string bin_asm_fn = "test_fast_forward_bin.eqasm";
+    std::ifstream     asm_in(asm_fn);
+    std::ofstream     bin_asm_file(bin_asm_fn, std::ios::binary);
+    std::string       line;
+    while (std::getline(asm_in, line)) {
+        if (line.find('(') == std::string::npos || line.find("smit") != std::string::npos) {
+            bin_asm_file << line << "\n";
+        }
+    }
+    bin_asm_file.close();
+
+    Mock_backend        asm_ref_backend;
+    Fast_forward_engine asm_ref(&asm_ref_backend);
+    asm_ref.load_asm(bin_asm_fn);
+    asm_ref.run(Ff_target());
+
+    std::vector<uint32_t> words;
+    assembler.assemble(bin_asm_fn, words);
+
+    Mock_backend        bin_backend;
+    Fast_forward_engine bin(&bin_backend);
+    bin.load_bin(words);
+    check(bin.run(Ff_target()) == FF_PROGRAM_END, "the binary program runs to its end");
+
+    check(std::equal(asm_ref.state().regs, asm_ref.state().regs + REG_FILE_NUM, bin.state().regs),
+          "the binary program computes the same registers");
+    check(bin.state().regs[2] == 55 && bin.state().regs[8] == 1,
+          "the binary program sums and measures");
+    check(bin.state().q_cycle == s.q_cycle, "the binary program has the same timeline");
+    check(timeline(bin_backend.moments) == expected, "the binary program has the same moments");
+
+    std::remove(bin_asm_fn.c_str());
+    std::remove(asm_fn.c_str());
+
+    std::cout << (failed ? "Test_fast_forward FAILED." : "Test_fast_forward passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
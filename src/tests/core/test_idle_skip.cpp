@@ -0,0 +1,122 @@
+/** test_idle_skip.cpp
+ *
+ * Checks the skipping of idle cycles with a module which waits for a number of 50 MHz cycles:
+ *  - the clocks stop while it waits, and the cycles are skipped,
+ *  - the global cycle counters follow the simulation time as if every cycle had been simulated,
+ *  - the wait ends at the same cycle and the same time as without skipping.
+ */
+
+#include <iostream>
+#include <systemc>
+
+#include "global_counter.h"
+#include "idle_skip.h"
+#include "logger_wrapper.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define START_CYCLE 10
+#define WAIT_CYCLES 100
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+SC_MODULE(Waiter), public Idle_skippable {
+  public:
+    sc_in<bool> clock_200MHz;
+    sc_in<bool> clock_50MHz;
+
+    sc_signal<bool> started;
+
+    uint64_t m_remaining = 0;  // cycles to wait
+    bool     m_waiting   = false;
+
+    sc_time      start_time;
+    unsigned int end_cycle = 0;
+    sc_time      end_time;
+    bool         counters_follow_time = true;
+
+    uint64_t num_idle_cycles() override {
+        // the last cycles of the wait are simulated
+        return (m_waiting && m_remaining > 2) ? (m_remaining - 2) : 0;
+    }
+
+    void skip_cycles(uint64_t num_cycles) override {
+        if (m_waiting) m_remaining -= num_cycles;
+    }
+
+    void do_wait() {
+        auto counter_50MHz = global_counter::get("cycle_counter_50MHz");
+
+        wait();
+        started.write(true);
+
+        // the counters and the time when counting starts
+        wait();
+        unsigned int first_cycle = counter_50MHz->get_cur_cycle_num();
+        sc_time      first_time  = sc_time_stamp();
+
+        while (true) {
+            wait();
+
+            unsigned int cycle  = counter_50MHz->get_cur_cycle_num();
+            double       num_50 = (sc_time_stamp() - first_time) / sc_time(20, SC_NS);
+            counters_follow_time &= (cycle - first_cycle == static_cast<unsigned int>(num_50));
+
+            if (cycle == START_CYCLE) {
+                m_remaining = WAIT_CYCLES;
+                m_waiting   = true;
+                start_time  = sc_time_stamp();
+            } else if (m_waiting) {
+                m_remaining--;
+                if (m_remaining == 0) {
+                    m_waiting = false;
+                    end_cycle = cycle;
+                    end_time  = sc_time_stamp();
+                }
+            }
+        }
+    }
+
+    SC_CTOR(Waiter) {
+        global_counter::register_counter(clock_200MHz, started, "cycle_counter_200MHz");
+        global_counter::register_counter(clock_50MHz, started, "cycle_counter_50MHz");
+
+        Idle_skipper::get_instance().add_module(this);
+
+        SC_CTHREAD(do_wait, clock_50MHz.pos());
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("counter_registry_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    Idle_skip_clock skip_clock("skip_clock", sc_time(2.0, SC_NS), sc_time(20.0, SC_NS));
+    Waiter          waiter("waiter");
+    waiter.clock_200MHz(skip_clock.clock_200MHz);
+    waiter.clock_50MHz(skip_clock.clock_50MHz);
+
+    sc_start(sc_time(4000, SC_NS));
+
+    Idle_skipper& skipper = Idle_skipper::get_instance();
+    check(skipper.num_skipped_cycles() + 4 >= WAIT_CYCLES, "the wait is skipped");
+    check(waiter.counters_follow_time, "the counters follow the simulation time");
+
+    unsigned int start_cycle = START_CYCLE;
+    check(waiter.end_cycle == start_cycle + WAIT_CYCLES, "the wait ends at the same cycle");
+    check(waiter.end_time - waiter.start_time == sc_time(20, SC_NS) * WAIT_CYCLES,
+          "the wait ends at the same time");
+
+    std::cout << (failed ? "Test_idle_skip FAILED." : "Test_idle_skip passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
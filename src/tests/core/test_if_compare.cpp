@@ -0,0 +1,195 @@
+/** test_if_compare.cpp
+ *
+ * Checks that the comparison of the pipeline and measurement interfaces stays exact although it
+ * skips the lists held in the same shared block:
+ *  - copies compare equal, also after the source is rebuilt with the same content,
+ *  - any change through a non-const accessor or a setter is seen, also after the values were
+ *    found equal once,
+ *  - the lists of default operations share their elements until one of them is changed,
+ *  - a signal notifies a change of the content, and only a change, when the writer rebuilds its
+ *    value in every cycle.
+ */
+
+#include <iostream>
+#include <systemc>
+
+#include "generic_if.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define NUM_CYCLES 20
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static void build(Q_pipe_interface& q_pipe_interface, size_t qubit) {
+    Fledged_qop qop;
+    qop.op.type = REPR_NAME;
+    qop.op.name = "x";
+    qop.addr.sq_op_addr.qubit_indices.push_back(qubit);
+
+    q_pipe_interface.reset();
+    q_pipe_interface.if_content.valid_qop = true;
+    q_pipe_interface.ops.push_back(qop);
+}
+
+// rebuilds its outputs in every cycle, with a new content every 4 cycles
+SC_MODULE(Rebuilding_writer) {
+  public:
+    sc_in<bool> clock;
+
+    sc_out<Q_pipe_interface> out_q_pipe_interface;
+    sc_out<Generic_meas_if>  out_meas;
+
+    void write() {
+        Q_pipe_interface q_pipe_interface;
+        Generic_meas_if  meas;
+
+        for (int cycle = 0; cycle < NUM_CYCLES; ++cycle) {
+            build(q_pipe_interface, cycle / 4);
+            out_q_pipe_interface.write(q_pipe_interface);
+
+            Bit_set meas_ena(7);
+            meas_ena.set(cycle / 4);
+            meas.reset();
+            meas.set_meas_ena(meas_ena);
+            out_meas.write(meas);
+
+            wait();
+        }
+        sc_stop();
+    }
+
+    SC_CTOR(Rebuilding_writer) { SC_CTHREAD(write, clock.pos()); }
+};
+
+SC_MODULE(Change_counter) {
+  public:
+    sc_in<Q_pipe_interface> in_q_pipe_interface;
+    sc_in<Generic_meas_if>  in_meas;
+
+    unsigned int num_q_pipe_changes = 0;
+    unsigned int num_meas_changes   = 0;
+
+    void count_q_pipe() { num_q_pipe_changes++; }
+    void count_meas() { num_meas_changes++; }
+
+    SC_CTOR(Change_counter) {
+        SC_METHOD(count_q_pipe);
+        sensitive << in_q_pipe_interface;
+        dont_initialize();
+
+        SC_METHOD(count_meas);
+        sensitive << in_meas;
+        dont_initialize();
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    // ---------------------------------------------------------------------------------------
+    // copies and rebuilt values
+    // ---------------------------------------------------------------------------------------
+    {
+        Q_pipe_interface a, b;
+        build(a, 1);
+        b = a;
+        check(b == a, "a copy is equal");
+
+        build(a, 1);
+        check(b == a && a == b, "a value rebuilt with the same content is equal");
+
+        build(a, 2);
+        check(!(b == a), "a value rebuilt with another content differs");
+
+        b = a;
+        check(b == a, "the copy of a changed value is equal");
+        a.ops[0].addr.sq_op_addr.qubit_indices[0] = 3;
+        check(!(b == a), "a change through operator [] is seen after a copy");
+
+        b = a;
+        check(b == a, "the values are found equal");
+        for (auto& qop : a.ops) qop.op.name = "y";
+        check(!(b == a), "a change through an iterator is seen after a comparison");
+
+        Q_pipe_interface c(a);
+        check(c == a, "a copy-constructed value is equal");
+        a.ops.clear();
+        a.ops.push_back(c.ops[0]);
+        check(c == a, "the same content pushed again is equal");
+        a.ops.resize(2);
+        check(!(c == a), "a resized value differs");
+    }
+
+    {
+        Q_pipe_interface a, b;
+        a.ops.assign_default(4);
+        b.ops.assign_default(4);
+        check(a.ops.is_default() && b == a, "the lists of default operations are equal");
+
+        const Q_pipe_interface& c = a;
+        check(c.ops.size() == 4 && !c.ops[3].is_valid(), "the default operations are not valid");
+        check(a.ops.is_default(), "a read keeps the default operations");
+
+        build(b, 1);
+        b.reset();
+        b.ops.assign_default(4);
+        check(b.ops.is_default() && b == a, "a rebuilt list takes the default operations again");
+
+        a.ops[3].op.type = REPR_NAME;
+        check(!a.ops.is_default() && !(b == a), "a change to the default operations is a copy");
+        Q_pipe_interface d;
+        d.ops.resize(4);
+        check(b.ops.is_default() && b == d, "the default operations are unchanged");
+    }
+
+    {
+        Generic_meas_if a, b;
+        Bit_set all(7);
+        all.set_all();
+        a.set_meas_ena(all);
+        b = a;
+        check(b == a, "a copied measurement is equal");
+
+        a.set_meas_data(all);
+        check(!(b == a), "a set measurement is seen after a copy");
+
+        b = a;
+        check(b == a, "the measurements are found equal");
+        a.reset();
+        check(!(b == a), "a reset measurement is seen after a comparison");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // the value-changed events of signals
+    // ---------------------------------------------------------------------------------------
+    sc_clock                    clock("clock", 20.0, SC_NS);
+    sc_signal<Q_pipe_interface> q_pipe_interface;
+    sc_signal<Generic_meas_if>  meas;
+
+    Rebuilding_writer writer("writer");
+    writer.clock(clock);
+    writer.out_q_pipe_interface(q_pipe_interface);
+    writer.out_meas(meas);
+
+    Change_counter counter("counter");
+    counter.in_q_pipe_interface(q_pipe_interface);
+    counter.in_meas(meas);
+
+    sc_start();
+
+    check(counter.num_q_pipe_changes == NUM_CYCLES / 4,
+          std::to_string(counter.num_q_pipe_changes) + " changes of the pipeline interface");
+    check(counter.num_meas_changes == NUM_CYCLES / 4,
+          std::to_string(counter.num_meas_changes) + " changes of the measurement");
+
+    std::cout << (failed ? "Test_if_compare FAILED." : "Test_if_compare passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/** test_levelized_q_pipe.cpp
+ *
+ * Checks that the levelized technology-independent quantum pipeline behaves exactly as the one
+ * made of a SystemC process per stage. Both are fed with the same quantum instructions, and
+ * compared on every clock cycle:
+ *  - the operations sent to the technology-dependent part,
+ *  - the measurements issued to the measurement register file,
+ *  - the telf logs.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <systemc>
+
+#include "asm_program.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "tech_ind/q_tech_ind.h"
+
+using namespace cactus;
+using namespace sc_core;
+using sc_dt::sc_uint;
+
+// operations merged into the same timing point, measurements, waits from 0 to several cycles,
+// and instructions one right after the other
+static const char* program_text = R"(start:
+    smis s0, {0}
+    smis s1, {0, 2}
+    smis s2, {1, 4}
+    smis s3, {5}
+    smit t0, {(2, 0)}
+    smit t1, {(3, 6)}
+    1, h s1 | x s2
+    0, cz t1
+    qwait 3
+    2, x s0 | y s2
+    cz t0
+    1, measz s1 | measz s2
+    qwait 0
+    0, y s3
+    qwait 20
+    3, measz s0
+    1, mock_meas
+    stop
+)";
+
+#define NUM_RESET_CYCLES 4
+#define NUM_CYCLES 200
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+// feeds the quantum instructions of the program, with a gap of i % 3 cycles before the i-th
+SC_MODULE(Q_insn_source) {
+  public:
+    sc_in<bool> clock;
+
+    sc_out<bool>                reset;
+    sc_out<Qasm_instruction>    insn;
+    sc_out<bool>                valid;
+    sc_out<sc_uint<INSN_WIDTH>> rs_wait_time;
+
+    std::vector<Qasm_instruction> insns;
+
+    void feed() {
+        reset.write(true);
+        valid.write(false);
+        rs_wait_time.write(0);
+        for (int i = 0; i < NUM_RESET_CYCLES; ++i) wait();
+        reset.write(false);
+
+        for (size_t i = 0; i < insns.size(); ++i) {
+            valid.write(false);
+            for (size_t gap = 0; gap < i % 3; ++gap) wait();
+
+            insn.write(insns[i]);
+            valid.write(true);
+            wait();
+        }
+
+        valid.write(false);
+        while (true) wait();
+    }
+
+    SC_CTOR(Q_insn_source) { SC_CTHREAD(feed, clock.pos()); }
+};
+
+// compares the outputs of both pipelines on every clock cycle
+SC_MODULE(Q_pipe_comparator) {
+  public:
+    sc_in<bool> clock;
+
+    sc_in<Q_pipe_interface> ref_q_pipe_interface;
+    sc_in<Q_pipe_interface> lvl_q_pipe_interface;
+    sc_in<Generic_meas_if>  ref_meas_issue;
+    sc_in<Generic_meas_if>  lvl_meas_issue;
+
+    unsigned int num_cycles      = 0;
+    unsigned int num_qop_cycles  = 0;
+    unsigned int num_meas_cycles = 0;
+    unsigned int first_mismatch  = 0;
+    bool         same            = true;
+
+    void compare() {
+        while (true) {
+            wait();
+            num_cycles++;
+
+            Q_pipe_interface ref_q_pipe = ref_q_pipe_interface.read();
+            Generic_meas_if  ref_meas   = ref_meas_issue.read();
+            Generic_meas_if  lvl_meas   = lvl_meas_issue.read();
+
+            bool same_cycle = (ref_q_pipe == lvl_q_pipe_interface.read()) &&
+                              (ref_meas == lvl_meas) && (ref_meas.timing == lvl_meas.timing);
+            if (!same_cycle && same) {
+                same           = false;
+                first_mismatch = num_cycles;
+            }
+
+            if (ref_q_pipe.if_content.valid_qop) num_qop_cycles++;
+            if (ref_meas.get_meas_ena().any()) num_meas_cycles++;
+        }
+    }
+
+    SC_CTOR(Q_pipe_comparator) { SC_CTHREAD(compare, clock.pos()); }
+};
+
+static std::string read_file(const std::string& fn) {
+    std::ifstream     file(fn);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("telf_logger", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.instruction_type = Instruction_type::ASM;
+    global_config.output_dir       = "./";
+    global_config.set_qubit_gate_default();
+
+    const std::string asm_fn = "test_levelized_q_pipe.eqasm";
+    {
+        std::ofstream file(asm_fn);
+        file << program_text;
+    }
+
+    Asm_program                   program;
+    std::vector<Qasm_instruction> insns;
+    program.load(asm_fn);
+    program.decode(insns);
+    std::remove(asm_fn.c_str());
+
+    sc_clock                       clock("clock", 5.0, SC_NS);
+    sc_signal<bool>                reset;
+    sc_signal<Qasm_instruction>    insn;
+    sc_signal<bool>                valid;
+    sc_signal<sc_uint<INSN_WIDTH>> rs_wait_time;
+
+    Q_insn_source source("source");
+    for (auto& q_insn : insns) {
+        if (q_insn.is_q_insn()) source.insns.push_back(q_insn);
+    }
+    source.clock(clock);
+    source.reset(reset);
+    source.insn(insn);
+    source.valid(valid);
+    source.rs_wait_time(rs_wait_time);
+
+    // the numbers in the names keep the telf files of both pipelines apart
+    global_config.levelized_q_pipe = false;
+    Q_tech_ind ref_q_pipe("q_tech_ind_0");
+
+    global_config.levelized_q_pipe = true;
+    Q_tech_ind lvl_q_pipe("q_tech_ind_1");
+
+    sc_signal<Q_pipe_interface> ref_q_pipe_interface, lvl_q_pipe_interface;
+    sc_signal<Generic_meas_if>  ref_meas_issue, lvl_meas_issue;
+
+    Q_tech_ind*                  q_pipes[] = {&ref_q_pipe, &lvl_q_pipe};
+    sc_signal<Q_pipe_interface>* outs[] = {&ref_q_pipe_interface, &lvl_q_pipe_interface};
+    sc_signal<Generic_meas_if>*  meas[] = {&ref_meas_issue, &lvl_meas_issue};
+    for (int i = 0; i < 2; ++i) {
+        q_pipes[i]->in_clock(clock);
+        q_pipes[i]->reset(reset);
+        q_pipes[i]->in_bundle(insn);
+        q_pipes[i]->in_valid_bundle(valid);
+        q_pipes[i]->in_rs_wait_time(rs_wait_time);
+        q_pipes[i]->out_q_pipe_interface(*outs[i]);
+        q_pipes[i]->out_Qp2MRF_meas_issue(*meas[i]);
+    }
+
+    Q_pipe_comparator comparator("comparator");
+    comparator.clock(clock);
+    comparator.ref_q_pipe_interface(ref_q_pipe_interface);
+    comparator.lvl_q_pipe_interface(lvl_q_pipe_interface);
+    comparator.ref_meas_issue(ref_meas_issue);
+    comparator.lvl_meas_issue(lvl_meas_issue);
+
+    sc_start(5.0 * NUM_CYCLES, SC_NS);
+
+    check(comparator.num_qop_cycles > 0, "the pipeline outputs quantum operations");
+    check(comparator.num_meas_cycles > 0, "the pipeline issues measurements");
+    check(comparator.same, "both pipelines have the same outputs, the first difference is at "
+                           "cycle " + std::to_string(comparator.first_mismatch));
+
+    for (Q_tech_ind* q_pipe : q_pipes) {
+        q_pipe->q_decoder->close_telf_file();
+        q_pipe->op_combiner.close_telf_file();
+        q_pipe->meas_issue_gen.close_telf_file();
+    }
+    for (const char* telf : {"q_decoder_asm", "op_combine", "meas_issue_gen"}) {
+        std::string ref_fn = std::string("./") + telf + "_0.csv";
+        std::string lvl_fn = std::string("./") + telf + "_1.csv";
+        check(read_file(ref_fn) == read_file(lvl_fn),
+              std::string("both pipelines have the same ") + telf + " log");
+        std::remove(ref_fn.c_str());
+        std::remove(lvl_fn.c_str());
+    }
+
+    std::cout << (failed ? "Test_levelized_q_pipe FAILED." : "Test_levelized_q_pipe passed.")
+              << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/** test_profiler.cpp
+ *
+ * Checks the profile of a short simulation:
+ *  - the sections are counted and timed, also when timed by several threads at once,
+ *  - the activations of a process are counted and timed, under the name of its module, also
+ *    when the process keeps the simulation thread busy,
+ *  - the simulated cycles per second of the clock domains are reported.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <systemc>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define NUM_THREADS 4
+#define NUM_CALLS 1000
+#define NUM_ACTIVATIONS 10
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static void busy_wait(double seconds) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() <
+           seconds) {
+    }
+}
+
+SC_MODULE(Busy_module) {
+  public:
+    sc_in<bool> clock;
+
+    // keeps the simulation thread busy for a while on every cycle
+    void spin() {
+        for (int cycle = 0; cycle < NUM_ACTIVATIONS; ++cycle) {
+            wait();
+            Profile_process profile;
+
+            busy_wait(0.01);
+        }
+        sc_stop();
+    }
+
+    SC_CTOR(Busy_module) {
+        SC_CTHREAD(spin, clock.pos());
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    Profiler& profiler = Profiler::get_instance();
+
+    // ---------------------------------------------------------------------------------------
+    // disabled
+    // ---------------------------------------------------------------------------------------
+    { Profile_scope scope("not counted"); }
+
+    profiler.enable();
+
+    // ---------------------------------------------------------------------------------------
+    // a simulation and sections timed by several threads
+    // ---------------------------------------------------------------------------------------
+    sc_clock    clock("clock", 20.0, SC_NS, 0.5);
+    Busy_module busy("busy");
+    busy.clock(clock);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back([]() {
+            for (int j = 0; j < NUM_CALLS; ++j) Profile_scope scope("worker section");
+        });
+    }
+
+    profiler.start();
+    {
+        Profile_scope scope("simulation section");
+        sc_start();
+    }
+    profiler.stop();
+
+    for (auto& thread : threads) thread.join();
+
+    const std::string fn = "./profile_test.txt";
+    check(profiler.write_report(fn, {{"clock_50MHz", 20.0, Clock_domain::CLOCK_50MHZ}}),
+          "the report is written");
+
+    std::ifstream     is(fn);
+    std::stringstream report;
+    report << is.rdbuf();
+    std::string text = report.str();
+
+    check(text.find("not counted") == std::string::npos,
+          "no section is timed while the profiler is disabled:\n" + text);
+    check(text.find(std::to_string(NUM_THREADS * NUM_CALLS) + " ") != std::string::npos &&
+            text.find("worker section") != std::string::npos,
+          "the calls of all threads are counted:\n" + text);
+    check(text.find("simulation section") != std::string::npos,
+          "the section around the simulation is reported:\n" + text);
+    check(text.find("clock_50MHz") != std::string::npos &&
+            text.find(" cycles/s") != std::string::npos,
+          "the simulated cycles are reported:\n" + text);
+
+    // the busy process takes about 0.1 s, the first module of the report
+    size_t processes = text.find("SystemC processes");
+    size_t module    = text.find('\n', text.find("module / process", processes)) + 1;
+    check(processes != std::string::npos &&
+            text.compare(text.find_first_not_of(" 0123456789.%", module), 4, "busy") == 0,
+          "the busy module takes the most time:\n" + text);
+
+    size_t      spin = text.find("spin");
+    size_t      line = text.rfind('\n', spin) + 1;
+    std::string fields(text, line, spin - line);
+    double      share, seconds;
+    uint64_t    num_activations = 0;
+    std::istringstream(fields) >> share >> fields >> seconds >> num_activations;
+    check(spin != std::string::npos && num_activations == NUM_ACTIVATIONS && seconds >= 0.09,
+          "the activations of the busy process are counted and timed:\n" + text);
+
+    std::remove(fn.c_str());
+
+    std::cout << (failed ? "Test_profiler FAILED." : "Test_profiler passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
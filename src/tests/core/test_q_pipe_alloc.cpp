@@ -0,0 +1,269 @@
+/** test_q_pipe_alloc.cpp
+ *
+ * Checks that the quantum pipeline does not allocate on the heap in steady state. The quantum
+ * instructions of a program are fed in a loop to the technology-independent pipeline, made of a
+ * SystemC process per stage as well as levelized, and to the event queue and the fast
+ * conditional execution behind it. After a warm-up, during which the interfaces between the
+ * stages grow to their largest content, every allocation is counted:
+ *  - the operations flow through all the stages during the counted cycles,
+ *  - no allocation is made during the counted cycles.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <systemc>
+
+#include "asm_program.h"
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "tech_dep/q_tech_dep.h"
+#include "tech_ind/q_tech_ind.h"
+
+using namespace cactus;
+using namespace sc_core;
+using sc_dt::sc_uint;
+
+// the same register is always set to the same number of qubits, so that the register contents
+// keep their size too
+static const char* program_text = R"(start:
+    smis s0, {0}
+    smis s1, {0, 2}
+    smis s2, {1, 4}
+    smis s3, {5}
+    smit t0, {(2, 0)}
+    smit t1, {(3, 6)}
+    1, h s1 | x s2
+    0, cz t1
+    qwait 3
+    2, x s0 | y s2
+    cz t0
+    1, measz s1 | measz s2
+    qwait 0
+    0, y s3
+    qwait 2
+    3, measz s0
+    1, mock_meas
+    stop
+)";
+
+#define NUM_RESET_CYCLES 4
+#define NUM_FILL_CYCLES 100
+// the blocks of the lists in flight reach their largest number after some 28000 cycles
+#define NUM_WARM_UP_CYCLES 40000
+#define NUM_COUNTED_CYCLES 20000
+
+// --------------------------------------------------------------------------------------------
+// allocation counting
+// --------------------------------------------------------------------------------------------
+static std::atomic<bool>     counting{false};
+static std::atomic<uint64_t> num_allocations{0};
+
+void* operator new(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) num_allocations++;
+
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+// feeds the quantum instructions of the program again and again, with a gap of i % 3 cycles
+// before the i-th. Like Quma_tb_base, it starts the timing control unit once the event queue
+// has been filled, as the event queue manager stops with an error when it runs empty.
+SC_MODULE(Q_insn_loop) {
+  public:
+    sc_in<bool> clock;
+
+    sc_out<bool>                reset;
+    sc_out<Qasm_instruction>    insn;
+    sc_out<bool>                valid;
+    sc_out<sc_uint<INSN_WIDTH>> rs_wait_time;
+    sc_out<bool>                run;
+
+    std::vector<Qasm_instruction> insns;
+
+    void feed() {
+        reset.write(true);
+        valid.write(false);
+        rs_wait_time.write(0);
+        run.write(false);
+        for (int i = 0; i < NUM_RESET_CYCLES; ++i) wait();
+        reset.write(false);
+
+        while (true) {
+            for (size_t i = 0; i < insns.size(); ++i) {
+                valid.write(false);
+                for (size_t gap = 0; gap < i % 3; ++gap) wait();
+
+                insn.write(insns[i]);
+                valid.write(true);
+                wait();
+            }
+        }
+    }
+
+    void start() {
+        for (int i = 0; i < NUM_RESET_CYCLES + NUM_FILL_CYCLES; ++i) wait();
+        run.write(true);
+    }
+
+    SC_CTOR(Q_insn_loop) {
+        SC_CTHREAD(feed, clock.pos());
+        SC_CTHREAD(start, clock.pos());
+    }
+};
+
+// counts the allocations of the counted cycles, and the operations which flow meanwhile
+SC_MODULE(Alloc_monitor) {
+  public:
+    sc_in<bool> clock;
+
+    sc_in<Q_pipe_interface> ref_q_pipe_interface;
+    sc_in<Q_pipe_interface> lvl_q_pipe_interface;
+    sc_in<Q_pipe_interface> dep_q_pipe_interface;
+
+    unsigned int num_ref_qop_cycles = 0;
+    unsigned int num_lvl_qop_cycles = 0;
+    unsigned int num_dep_qop_cycles = 0;
+
+    void monitor() {
+        for (int i = 0; i < NUM_WARM_UP_CYCLES; ++i) wait();
+
+        num_allocations = 0;
+        counting        = true;
+
+        for (int i = 0; i < NUM_COUNTED_CYCLES; ++i) {
+            wait();
+
+            if (ref_q_pipe_interface.read().if_content.valid_qop) num_ref_qop_cycles++;
+            if (lvl_q_pipe_interface.read().if_content.valid_qop) num_lvl_qop_cycles++;
+            if (dep_q_pipe_interface.read().if_content.valid_qop) num_dep_qop_cycles++;
+        }
+
+        counting = false;
+        sc_stop();
+    }
+
+    SC_CTOR(Alloc_monitor) { SC_CTHREAD(monitor, clock.pos()); }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("telf_logger", CODE_POSITION);
+    safe_create_logger("asm_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.instruction_type = Instruction_type::ASM;
+    global_config.output_dir       = "./";
+    global_config.telf_on          = false;
+    global_config.set_qubit_gate_default();
+
+    const std::string asm_fn = "test_q_pipe_alloc.eqasm";
+    {
+        std::ofstream file(asm_fn);
+        file << program_text;
+    }
+
+    Asm_program                   program;
+    std::vector<Qasm_instruction> insns;
+    program.load(asm_fn);
+    program.decode(insns);
+    std::remove(asm_fn.c_str());
+
+    sc_clock                       clock("clock", 5.0, SC_NS);
+    sc_clock                       clock_50MHz("clock_50MHz", 20.0, SC_NS);
+    sc_signal<bool>                reset;
+    sc_signal<Qasm_instruction>    insn;
+    sc_signal<bool>                valid;
+    sc_signal<sc_uint<INSN_WIDTH>> rs_wait_time;
+    sc_signal<bool>                run;
+
+    Q_insn_loop source("source");
+    for (auto& q_insn : insns) {
+        if (q_insn.is_q_insn()) source.insns.push_back(q_insn);
+    }
+    source.clock(clock);
+    source.reset(reset);
+    source.insn(insn);
+    source.valid(valid);
+    source.rs_wait_time(rs_wait_time);
+    source.run(run);
+
+    // the technology-independent pipelines
+    global_config.levelized_q_pipe = false;
+    Q_tech_ind ref_q_pipe("q_tech_ind_0");
+
+    global_config.levelized_q_pipe = true;
+    Q_tech_ind lvl_q_pipe("q_tech_ind_1");
+
+    sc_signal<Q_pipe_interface> ref_q_pipe_interface, lvl_q_pipe_interface;
+    sc_signal<Generic_meas_if>  ref_meas_issue, lvl_meas_issue;
+
+    Q_tech_ind*                  q_pipes[] = {&ref_q_pipe, &lvl_q_pipe};
+    sc_signal<Q_pipe_interface>* outs[] = {&ref_q_pipe_interface, &lvl_q_pipe_interface};
+    sc_signal<Generic_meas_if>*  meas[] = {&ref_meas_issue, &lvl_meas_issue};
+    for (int i = 0; i < 2; ++i) {
+        q_pipes[i]->in_clock(clock);
+        q_pipes[i]->reset(reset);
+        q_pipes[i]->in_bundle(insn);
+        q_pipes[i]->in_valid_bundle(valid);
+        q_pipes[i]->in_rs_wait_time(rs_wait_time);
+        q_pipes[i]->out_q_pipe_interface(*outs[i]);
+        q_pipes[i]->out_Qp2MRF_meas_issue(*meas[i]);
+    }
+
+    // the technology-dependent part, behind the reference pipeline
+    Q_tech_dep                  q_tech_dep("q_tech_dep");
+    sc_signal<Q_pipe_interface> dep_q_pipe_interface;
+    sc_signal<bool>             ready, eq_empty, eq_almostfull;
+    sc_signal<Generic_meas_if>  meas_cancel;
+
+    q_tech_dep.in_clock(clock);
+    q_tech_dep.reset(reset);
+    q_tech_dep.in_50MHz_clock(clock_50MHz);
+    q_tech_dep.in_q_pipe_interface(ref_q_pipe_interface);
+    q_tech_dep.run(run);
+    q_tech_dep.out_q_pipe_interface(dep_q_pipe_interface);
+    q_tech_dep.out_Qp2clp_ready(ready);
+    q_tech_dep.out_eq_empty(eq_empty);
+    q_tech_dep.out_eq_almostfull(eq_almostfull);
+    q_tech_dep.out_Qp2MRF_meas_cancel(meas_cancel);
+
+    Alloc_monitor monitor("monitor");
+    monitor.clock(clock);
+    monitor.ref_q_pipe_interface(ref_q_pipe_interface);
+    monitor.lvl_q_pipe_interface(lvl_q_pipe_interface);
+    monitor.dep_q_pipe_interface(dep_q_pipe_interface);
+
+    sc_start();
+
+    check(monitor.num_ref_qop_cycles > 0, "the pipeline outputs quantum operations");
+    check(monitor.num_lvl_qop_cycles > 0, "the levelized pipeline outputs quantum operations");
+    check(monitor.num_dep_qop_cycles > 0, "the event queue outputs quantum operations");
+    check(num_allocations == 0, std::to_string(num_allocations.load()) + " allocations in " +
+                                  std::to_string(NUM_COUNTED_CYCLES) + " cycles");
+
+    std::cout << (failed ? "Test_q_pipe_alloc FAILED." : "Test_q_pipe_alloc passed.")
+              << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/** test_shared_bundle.cpp
+ *
+ * Checks that the lists of the pipeline interfaces are shared instead of copied:
+ *  - a copy of a list copies no element, and a change of a shared list copies its elements once,
+ *    leaving the other copies untouched,
+ *  - the blocks of the lists which are gone are reused, with their slots,
+ *  - a bundle passed on unchanged through a chain of stages and signals is never copied, only
+ *    the writer which builds it fills its elements.
+ */
+
+#include <iostream>
+#include <systemc>
+
+#include "generic_if.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define NUM_ITEMS 8
+#define NUM_STAGES 4
+#define NUM_CYCLES 100
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+// an element which counts its copies
+static unsigned int num_copies = 0;
+
+class Counted {
+  public:
+    int value = 0;
+
+    Counted() {}
+    Counted(int _value)
+        : value(_value) {}
+    Counted(const Counted& other)
+        : value(other.value) {
+        num_copies++;
+    }
+
+    // the slots which grow are moved, and not counted
+    Counted(Counted&& other) noexcept
+        : value(other.value) {}
+
+    Counted& operator=(const Counted& other) {
+        value = other.value;
+        num_copies++;
+        return *this;
+    }
+
+    bool operator==(const Counted& other) const { return value == other.value; }
+};
+
+class Bundle {
+  public:
+    Slot_vector<Counted> items;
+
+    bool operator==(const Bundle& bundle) const { return items == bundle.items; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Bundle& bundle) { return os; }
+
+inline void sc_trace(sc_trace_file* tf, const Bundle& bundle, const std::string& name) {}
+
+// builds a new bundle in every cycle
+SC_MODULE(Bundle_writer) {
+  public:
+    sc_in<bool> clock;
+
+    sc_out<Bundle> out_bundle;
+
+    void write() {
+        Bundle bundle;
+        for (int cycle = 0; cycle < NUM_CYCLES; ++cycle) {
+            bundle.items.clear();
+            for (int i = 0; i < NUM_ITEMS; ++i) bundle.items.push_back(Counted(cycle + i));
+            out_bundle.write(bundle);
+            wait();
+        }
+        sc_stop();
+    }
+
+    SC_CTOR(Bundle_writer) { SC_CTHREAD(write, clock.pos()); }
+};
+
+// passes the bundle on, as Op_decoder does
+SC_MODULE(Forwarding_stage) {
+  public:
+    sc_in<Bundle>  in_bundle;
+    sc_out<Bundle> out_bundle;
+
+    Bundle m_bundle;
+
+    void forward() {
+        m_bundle = in_bundle.read();
+        out_bundle.write(m_bundle);
+    }
+
+    SC_CTOR(Forwarding_stage) {
+        SC_METHOD(forward);
+        sensitive << in_bundle;
+        dont_initialize();
+    }
+};
+
+SC_MODULE(Bundle_reader) {
+  public:
+    sc_in<Bundle> in_bundle;
+
+    unsigned int num_bundles = 0;
+    bool         in_order    = true;
+
+    void read() {
+        const Bundle& bundle = in_bundle.read();
+        in_order &= bundle.items.size() == NUM_ITEMS &&
+                    bundle.items[NUM_ITEMS - 1].value == (int)num_bundles + NUM_ITEMS - 1;
+        num_bundles++;
+    }
+
+    SC_CTOR(Bundle_reader) {
+        SC_METHOD(read);
+        sensitive << in_bundle;
+        dont_initialize();
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    // ---------------------------------------------------------------------------------------
+    // copies and changes
+    // ---------------------------------------------------------------------------------------
+    {
+        Slot_vector<Counted> a;
+        for (int i = 0; i < NUM_ITEMS; ++i) a.push_back(Counted(i));
+
+        num_copies = 0;
+        Slot_vector<Counted> b(a);
+        Slot_vector<Counted> c;
+        c = b;
+        check(num_copies == 0, "a copy copies no element");
+        check(c == a, "the copies are equal");
+
+        b[0] = Counted(100);
+        check(num_copies == NUM_ITEMS + 1, "a change of a shared list copies its elements once");
+        check(a[0].value == 0 && c[0].value == 0, "the other copies are untouched");
+
+        num_copies = 0;
+        b[1] = Counted(101);
+        check(num_copies == 1, "a list of its own is changed in place");
+
+        c.clear();
+        check(num_copies == 1 && a.size() == NUM_ITEMS && c.empty(),
+              "clearing a shared list copies nothing and leaves the other copies untouched");
+
+        c.push_back(Counted(7));
+        check(c.size() == 1 && c[0].value == 7 && a[0].value == 0,
+              "a cleared list is filled again on its own");
+
+        Slot_vector<Counted> d;
+        for (int i = 0; i < NUM_ITEMS; ++i) d.push_back(Counted(i));
+        num_copies = 0;
+        check(d == a && num_copies == 0, "equal lists are compared without a copy");
+        d[0] = Counted(100);
+        check(num_copies == 1 && a[0].value == 0,
+              "lists found equal keep their own blocks, a comparison changes neither");
+    }
+
+    {
+        Slot_vector<Counted> a;
+        a.reserve(4 * NUM_ITEMS);
+        check(a.capacity() == 4 * NUM_ITEMS, "the slots are reserved");
+    }
+    {
+        Slot_vector<Counted> a;
+        a.push_back(Counted(1));
+        check(a.capacity() >= 4 * NUM_ITEMS, "the block of a list which is gone is reused");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // a chain of stages
+    // ---------------------------------------------------------------------------------------
+    sc_clock          clock("clock", 20.0, SC_NS);
+    sc_signal<Bundle> bundles[NUM_STAGES + 1];
+
+    Bundle_writer writer("writer");
+    writer.clock(clock);
+    writer.out_bundle(bundles[0]);
+
+    std::vector<Forwarding_stage*> stages;
+    for (int i = 0; i < NUM_STAGES; ++i) {
+        stages.push_back(new Forwarding_stage(("stage_" + std::to_string(i)).c_str()));
+        stages[i]->in_bundle(bundles[i]);
+        stages[i]->out_bundle(bundles[i + 1]);
+    }
+
+    Bundle_reader reader("reader");
+    reader.in_bundle(bundles[NUM_STAGES]);
+
+    num_copies = 0;
+    sc_start();
+
+    check(reader.num_bundles == NUM_CYCLES && reader.in_order,
+          "the bundles pass through the stages in order");
+    check(num_copies == NUM_CYCLES * NUM_ITEMS,
+          std::to_string(num_copies) + " copies of the elements for " +
+            std::to_string(NUM_CYCLES * NUM_ITEMS) + " elements filled by the writer");
+
+    for (auto stage : stages) delete stage;
+
+    std::cout << (failed ? "Test_shared_bundle FAILED." : "Test_shared_bundle passed.")
+              << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
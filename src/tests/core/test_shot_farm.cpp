@@ -0,0 +1,164 @@
+/** test_shot_farm.cpp
+ *
+ * Checks that the shots run in forked processes give the results a single process would:
+ *  - every shot gets its own seed, which only depends on its index,
+ *  - the results are collected in the order of the shots, whatever the number of workers,
+ *  - the children see the state the parent has built before forking,
+ *  - the histogram and the csv files account for every shot,
+ *  - a shot which fails, or crashes, is reported, and its output is kept.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <systemc>
+
+#include "logger_wrapper.h"
+#include "shot_farm.h"
+
+using namespace cactus;
+
+#define NUM_SHOTS 40
+#define NUM_QUBITS 3
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static unsigned int num_lines(const std::string& fn) {
+    std::ifstream f(fn);
+    std::string   line;
+    unsigned int  n = 0;
+    while (std::getline(f, line)) n++;
+    return n;
+}
+
+// built before forking, as the elaborated model is
+static unsigned int parent_state = 0;
+
+// what a shot measures, from its seed only
+static Shot_result expected_result(unsigned int shot, uint64_t seed) {
+    Shot_result result;
+    result.meas.emplace_back(0, (seed & 1) != 0);
+    result.meas.emplace_back(2, (seed & 2) != 0);
+    result.meas.emplace_back(0, (seed & 4) != 0);
+    result.mem_words.push_back(shot);
+    result.mem_words.push_back(static_cast<unsigned int>(seed));
+    result.mem_words.push_back(parent_state);
+    return result;
+}
+
+static bool same_result(const Shot_result& a, const Shot_result& b) {
+    return a.meas == b.meas && a.mem_words == b.mem_words;
+}
+
+static bool run_shot(unsigned int shot, uint64_t seed, Shot_result& result) {
+    std::cout << "shot " << shot << std::endl;
+    result = expected_result(shot, seed);
+    return true;
+}
+
+static void check_farm(unsigned int num_workers, const std::string& output_dir) {
+    std::string name = std::to_string(num_workers) + " workers: ";
+
+    Shot_farm   farm(NUM_SHOTS, output_dir, num_workers);
+    std::string error_msg;
+    check(farm.run(run_shot, error_msg), name + "the shots run, " + error_msg);
+    check(farm.results().size() == NUM_SHOTS, name + "every shot has a result");
+
+    bool         same  = true;
+    unsigned int total = 0;
+    for (unsigned int shot = 0; shot < farm.results().size(); ++shot) {
+        same &= same_result(farm.results()[shot],
+                            expected_result(shot, Shot_farm::shot_seed(shot)));
+    }
+    check(same, name + "the results are the ones of the shots, in their order");
+
+    for (auto& entry : farm.histogram(NUM_QUBITS)) {
+        check(entry.first.size() == NUM_QUBITS && entry.first[1] == '-',
+              name + "an outcome has a bit per qubit, '-' for qubit 1: " + entry.first);
+        total += entry.second;
+    }
+    check(total == NUM_SHOTS, name + "the histogram counts every shot");
+
+    check(farm.write_csv(NUM_QUBITS), name + "the csv files are written");
+    check(num_lines(output_dir + "shots.csv") == NUM_SHOTS + 1, name + "a line per shot");
+    check(num_lines(output_dir + "histogram.csv") == farm.histogram(NUM_QUBITS).size() + 1,
+          name + "a line per outcome");
+    check(!std::ifstream(output_dir + "shot_0.log").good(),
+          name + "the output of the shots which succeed is removed");
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    const std::string output_dir = "./";
+    parent_state                 = 0x5a5a;
+
+    // ---------------------------------------------------------------------------------------
+    // the seeds
+    // ---------------------------------------------------------------------------------------
+    std::set<uint64_t> seeds;
+    for (unsigned int shot = 0; shot < 1000; ++shot) seeds.insert(Shot_farm::shot_seed(shot));
+    check(seeds.size() == 1000, "every shot has its own seed");
+    check(Shot_farm::shot_seed(7) == Shot_farm::shot_seed(7), "the seed of a shot is fixed");
+
+    // ---------------------------------------------------------------------------------------
+    // the results do not depend on the number of workers
+    // ---------------------------------------------------------------------------------------
+    check_farm(1, output_dir);
+    check_farm(4, output_dir);
+    check_farm(0, output_dir);
+
+    // ---------------------------------------------------------------------------------------
+    // shots which fail
+    // ---------------------------------------------------------------------------------------
+    {
+        Shot_farm   farm(NUM_SHOTS, output_dir, 4);
+        std::string error_msg;
+        bool        ok = farm.run(
+          [](unsigned int shot, uint64_t seed, Shot_result& result) {
+              std::cout << "shot " << shot << " fails" << std::endl;
+              return shot != 5;
+          },
+          error_msg);
+        check(!ok, "a shot which fails is reported");
+        check(error_msg.find("shot 5 ") != std::string::npos,
+              "the shot which fails is named: " + error_msg);
+
+        std::ifstream log(output_dir + "shot_5.log");
+        std::string   line;
+        check(std::getline(log, line) && line == "shot 5 fails",
+              "the output of the shot which fails is kept");
+        std::remove((output_dir + "shot_5.log").c_str());
+    }
+    {
+        Shot_farm   farm(NUM_SHOTS, output_dir, 4);
+        std::string error_msg;
+        bool        ok = farm.run(
+          [](unsigned int shot, uint64_t seed, Shot_result& result) {
+              if (shot == 3) abort();
+              return true;
+          },
+          error_msg);
+        check(!ok, "a shot which crashes is reported");
+        check(error_msg.find("shot 3 ") != std::string::npos,
+              "the shot which crashes is named: " + error_msg);
+        std::remove((output_dir + "shot_3.log").c_str());
+    }
+
+    std::remove((output_dir + "shots.csv").c_str());
+    std::remove((output_dir + "histogram.csv").c_str());
+
+    std::cout << (failed ? "Test_shot_farm FAILED." : "Test_shot_farm passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
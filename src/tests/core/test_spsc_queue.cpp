@@ -0,0 +1,111 @@
+/** test_spsc_queue.cpp
+ *
+ * Checks the queue between the SystemC thread and the worker of the qubit simulator:
+ *  - the capacity is a power of 2, a full queue refuses an item and leaves it untouched,
+ *  - the items pass from one thread to the other whole and in order, with a queue much smaller
+ *    than the number of items, so that both the full and the empty cases are met many times,
+ *  - a request and its answer make a round trip, as a measurement does.
+ */
+
+#include <iostream>
+#include <systemc>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.h"
+
+using namespace cactus;
+
+#define NUM_ITEMS 200000
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    // ---------------------------------------------------------------------------------------
+    // a single thread
+    // ---------------------------------------------------------------------------------------
+    {
+        Spsc_queue<std::vector<int>> queue(5);
+        check(queue.capacity() == 8, "the capacity is rounded up to a power of 2");
+
+        std::vector<int> item;
+        for (int i = 0; i < 8; ++i) {
+            item = {i};
+            check(queue.try_push(item), "there is room up to the capacity");
+        }
+
+        item = {8, 8};
+        check(!queue.try_push(item), "a full queue refuses an item");
+        check(item.size() == 2, "a refused item is left untouched");
+
+        check(queue.try_pop(item) && item == std::vector<int>{0}, "the first item comes first");
+        item = {8};
+        check(queue.try_push(item), "a popped slot is free again");
+
+        bool in_order = true;
+        for (int i = 1; i <= 8; ++i) in_order &= queue.try_pop(item) && item[0] == i;
+        check(in_order, "the items come out in order");
+        check(!queue.try_pop(item), "an empty queue has no item");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // two threads
+    // ---------------------------------------------------------------------------------------
+    {
+        Spsc_queue<std::vector<int>> queue(16);
+
+        std::thread producer([&]() {
+            for (int i = 0; i < NUM_ITEMS; ++i) queue.push(std::vector<int>(1 + i % 7, i));
+        });
+
+        bool             whole_and_in_order = true;
+        std::vector<int> item;
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            queue.pop(item);
+            whole_and_in_order &= item == std::vector<int>(1 + i % 7, i);
+        }
+        producer.join();
+
+        check(whole_and_in_order, "the items pass between the threads whole and in order");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // round trips
+    // ---------------------------------------------------------------------------------------
+    {
+        Spsc_queue<int> requests(4);
+        Spsc_queue<int> answers(4);
+
+        std::thread worker([&]() {
+            int request = 0;
+            while (true) {
+                requests.pop(request);
+                if (request < 0) break;
+                answers.push(request * 2);
+            }
+        });
+
+        bool answered = true;
+        for (int i = 0; i < 10000; ++i) {
+            int answer = 0;
+            requests.push(i);
+            answers.pop(answer);
+            answered &= answer == i * 2;
+        }
+        requests.push(-1);
+        worker.join();
+
+        check(answered, "every request gets its answer");
+    }
+
+    std::cout << (failed ? "Test_spsc_queue FAILED." : "Test_spsc_queue passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
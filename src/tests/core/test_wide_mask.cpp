@@ -0,0 +1,189 @@
+/** test_wide_mask.cpp
+ *
+ * Checks the qubit masks on a topology of many more qubits than the 64 bits of a word, a line
+ * of NUM_QUBITS qubits with a pair of directed edges between neighbours:
+ *  - a mask register holds a mask of any width,
+ *  - the address decoder selects exactly the qubits of a single-qubit mask, also beyond the
+ *    first word,
+ *  - the address decoder finds the qubit pair of each edge of a two-qubit mask.
+ */
+
+#include <iostream>
+#include <systemc>
+#include <vector>
+
+#include "global_json.h"
+#include "logger_wrapper.h"
+#include "tech_ind/addr_mask_decoder.h"
+
+using namespace cactus;
+using namespace sc_core;
+
+#define NUM_QUBITS 500
+#define NUM_RESET_CYCLES 2
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+// the edge 2k goes from the qubit k to k + 1, the edge 2k + 1 back
+static size_t left_qubit_of(size_t edge) { return edge / 2 + edge % 2; }
+static size_t right_qubit_of(size_t edge) { return edge / 2 + 1 - edge % 2; }
+
+static Bit_set mask_of(size_t width, const std::vector<size_t>& bits) {
+    Bit_set mask(width);
+    for (size_t bit : bits) mask.set(bit);
+    return mask;
+}
+
+static Q_pipe_interface masked_qop(const Bit_set& mask, num_tgt_qubits_type_t q_num_type) {
+    Fledged_qop qop;
+    qop.op.type              = REPR_NAME;
+    qop.op.name              = (q_num_type == SINGLE) ? "x" : "cz";
+    qop.addr.type.c_type     = INDIRECT_REG_NUM;
+    qop.addr.type.q_num_type = q_num_type;
+    if (q_num_type == SINGLE) {
+        qop.addr.sq_op_addr.mask = mask;
+    } else {
+        qop.addr.mq_op_addr.mask = mask;
+    }
+
+    Q_pipe_interface q_pipe_interface;
+    q_pipe_interface.if_content.valid_qop = true;
+    q_pipe_interface.ops.push_back(qop);
+    return q_pipe_interface;
+}
+
+// feeds the masked operations to the address decoder, one per cycle, and keeps what it decodes
+SC_MODULE(Mask_driver) {
+  public:
+    sc_in<bool> clock;
+
+    sc_out<bool>             reset;
+    sc_out<Q_pipe_interface> out_q_pipe_interface;
+    sc_in<Q_pipe_interface>  in_q_pipe_interface;
+
+    std::vector<Q_pipe_interface> inputs;
+    std::vector<Q_pipe_interface> decoded;
+
+    void drive() {
+        reset.write(true);
+        for (int i = 0; i < NUM_RESET_CYCLES; ++i) wait();
+        reset.write(false);
+
+        for (const auto& input : inputs) {
+            out_q_pipe_interface.write(input);
+            wait();
+            decoded.push_back(in_q_pipe_interface.read());
+        }
+        sc_stop();
+    }
+
+    SC_CTOR(Mask_driver) { SC_CTHREAD(drive, clock.pos()); }
+};
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    safe_create_logger("telf_logger", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    sc_core::sc_report_handler::set_actions("/IEEE_Std_1666/deprecated", sc_core::SC_DO_NOTHING);
+
+    Global_config& global_config   = Global_config::get_instance();
+    global_config.num_qubits       = NUM_QUBITS;
+    global_config.levelized_q_pipe = false;
+    global_config.telf_on          = false;
+
+    const size_t num_edges = 2 * (NUM_QUBITS - 1);
+
+    global_config.num_directed_edges = num_edges;
+    global_config.out_edges_of_qubit.assign(NUM_QUBITS, std::vector<unsigned int>());
+    global_config.in_edges_of_qubit.assign(NUM_QUBITS, std::vector<unsigned int>());
+    for (size_t edge = 0; edge < num_edges; ++edge) {
+        global_config.out_edges_of_qubit[left_qubit_of(edge)].push_back(edge);
+        global_config.in_edges_of_qubit[right_qubit_of(edge)].push_back(edge);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // mask registers
+    // ---------------------------------------------------------------------------------------
+    {
+        Bit_set    mask = mask_of(NUM_QUBITS, {0, 64, NUM_QUBITS - 1});
+        Sim_uint   reg_num;
+        Q_mask_reg mask_reg;
+        reg_num = 3;
+
+        mask_reg.set_reg_mask(mask, reg_num, SINGLE);
+        check(mask_reg.get_reg_mask(reg_num, SINGLE) == mask, "a wide mask is kept in a register");
+        check(mask_reg.get_reg_mask(reg_num, MULTIPLE).size() == 0,
+              "the registers of the two-qubit masks are apart");
+
+        mask_reg.reset();
+        check(mask_reg.get_reg_mask(reg_num, SINGLE).none(), "a reset clears the masks");
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // address decoding
+    // ---------------------------------------------------------------------------------------
+    const Bit_set sq_mask = mask_of(NUM_QUBITS, {0, 1, 63, 64, 65, 200, NUM_QUBITS - 1});
+    const Bit_set mq_mask = mask_of(num_edges, {0, 127, 401, num_edges - 1});
+
+    sc_clock                    clock("clock", 5.0, SC_NS);
+    sc_signal<bool>             reset;
+    sc_signal<Q_pipe_interface> masked, decoded;
+
+    Mask_driver driver("driver");
+    driver.inputs.push_back(masked_qop(sq_mask, SINGLE));
+    driver.inputs.push_back(masked_qop(mq_mask, MULTIPLE));
+    driver.clock(clock);
+    driver.reset(reset);
+    driver.out_q_pipe_interface(masked);
+    driver.in_q_pipe_interface(decoded);
+
+    Address_decoder addr_decoder("addr_decoder");
+    addr_decoder.in_clock(clock);
+    addr_decoder.reset(reset);
+    addr_decoder.in_q_pipe_interface(masked);
+    addr_decoder.out_q_pipe_interface(decoded);
+
+    sc_start();
+
+    check(driver.decoded.size() == 2, "all the masks are decoded");
+    if (driver.decoded.size() == 2) {
+        const Slot_vector<Fledged_qop>& sq_ops = driver.decoded[0].ops;
+        const Slot_vector<Fledged_qop>& mq_ops = driver.decoded[1].ops;
+        check(sq_ops.size() == NUM_QUBITS && mq_ops.size() == NUM_QUBITS,
+              "there is an operation slot for each qubit");
+
+        bool sq_selected = true;
+        for (size_t q = 0; q < sq_ops.size(); ++q) {
+            bool hardwired = (sq_ops[q].addr.type.c_type == HARDWIRE);
+            sq_selected &= (hardwired == sq_mask.test(q)) &&
+                           (!hardwired || sq_ops[q].addr.sq_op_addr.qubit_indices[0] == q);
+        }
+        check(sq_selected, "the qubits of a single-qubit mask are selected");
+
+        size_t num_hardwired = 0;
+        for (size_t q = 0; q < mq_ops.size(); ++q) {
+            num_hardwired += (mq_ops[q].addr.type.c_type == HARDWIRE);
+        }
+        bool pairs_found = (num_hardwired == 2 * mq_mask.count());
+        mq_mask.for_each([&](size_t edge) {
+            std::vector<size_t> pair = {left_qubit_of(edge), right_qubit_of(edge)};
+            for (size_t q : pair) {
+                pairs_found &= (mq_ops[q].addr.type.c_type == HARDWIRE) &&
+                               (mq_ops[q].addr.mq_op_addr.qubit_tuples[0] == pair);
+            }
+        });
+        check(pairs_found, "the qubit pairs of a two-qubit mask are found");
+    }
+
+    std::cout << (failed ? "Test_wide_mask FAILED." : "Test_wide_mask passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
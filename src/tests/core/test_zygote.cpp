@@ -0,0 +1,185 @@
+/** test_zygote.cpp
+ *
+ * Checks that the zygote serves every run request in a forked process:
+ *  - the requests are parsed, and empty and comment lines are skipped,
+ *  - every run is reported once, with its exit code, whatever the number of workers,
+ *  - the children see the state the zygote has built before forking, and cannot change it,
+ *  - the output of the runs which fail is kept, the one of the others is removed,
+ *  - a run is reported when it ends, while the zygote waits for the next request.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <systemc>
+#include <thread>
+#include <unistd.h>
+
+#include "logger_wrapper.h"
+#include "zygote.h"
+
+using namespace cactus;
+
+static int failed = 0;
+
+static void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cout << "FAILED: " << what << std::endl;
+        ++failed;
+    }
+}
+
+static unsigned int count(const std::string& text, const std::string& what) {
+    unsigned int n   = 0;
+    size_t       pos = 0;
+    while ((pos = text.find(what, pos)) != std::string::npos) {
+        n++;
+        pos += what.size();
+    }
+    return n;
+}
+
+// built before forking, as the warmed-up model is
+static unsigned int warm_state = 0;
+
+static const char* requests_text = R"(# the regression list
+pass_0.eqasm dump_0.bin
+pass_1.eqasm
+
+fail_2.eqasm
+pass_3.eqasm
+crash_4.eqasm
+pass_5.eqasm
+)";
+
+// the exit code of a run follows the name of its program
+static int run(const Run_request& request) {
+    std::cout << "running " << request.program << std::endl;
+
+    bool ok    = warm_state == 42;
+    warm_state = 0;
+
+    if (request.program.find("crash") == 0) abort();
+    if (request.program.find("fail") == 0) return 3;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// the read end of a pipe which holds the text, and is closed after it
+static int requests_pipe(const std::string& text) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    if (write(fds[1], text.data(), text.size()) != static_cast<ssize_t>(text.size())) return -1;
+    close(fds[1]);
+    return fds[0];
+}
+
+static void check_zygote(unsigned int num_workers, const std::string& output_dir) {
+    std::string name = std::to_string(num_workers) + " workers: ";
+
+    Zygote            zygote(output_dir, num_workers);
+    int               requests = requests_pipe(requests_text);
+    std::stringstream report;
+    unsigned int      num_failed = 0;
+    std::string       error_msg;
+
+    check(zygote.serve(requests, report, run, num_failed, error_msg),
+          name + "the runs are served, " + error_msg);
+    close(requests);
+    check(num_failed == 2, name + "two runs fail");
+    check(warm_state == 42, name + "the runs cannot change the state of the zygote");
+
+    std::string text = report.str();
+    check(count(text, "\n") == 6, name + "every run is reported once:\n" + text);
+    check(count(text, " passed (exit code 0) ") == 4, name + "four runs pass:\n" + text);
+    check(text.find("run 2 failed (exit code 3) ") != std::string::npos,
+          name + "the exit code of a run is reported:\n" + text);
+    check(text.find("run 4 failed") != std::string::npos,
+          name + "a run which crashes is reported:\n" + text);
+
+    std::ifstream log(output_dir + "run_2.log");
+    std::string   line;
+    check(std::getline(log, line) && line == "running fail_2.eqasm",
+          name + "the output of a run which fails is kept");
+    check(!std::ifstream(output_dir + "run_0.log").good(),
+          name + "the output of a run which passes is removed");
+
+    std::remove((output_dir + "run_2.log").c_str());
+    std::remove((output_dir + "run_4.log").c_str());
+}
+
+// the requests come from a pipe which stays open, as the standard input of an interactive
+// session: the first run is reported before the next request is written
+static void check_waiting_zygote(const std::string& output_dir) {
+    const std::string report_fn = output_dir + "zygote_report.txt";
+
+    int fds[2];
+    check(pipe(fds) == 0, "a pipe of requests is opened");
+
+    std::atomic<bool> reported_early(false);
+    std::thread       requester([&]() {
+        std::string first = "pass_0.eqasm\n";
+        check(write(fds[1], first.data(), first.size()) == static_cast<ssize_t>(first.size()),
+              "the first request is written");
+
+        for (int i = 0; i < 1000 && !reported_early; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::ifstream     report_file(report_fn);
+            std::stringstream text;
+            text << report_file.rdbuf();
+            reported_early = text.str().find("run 0 passed") != std::string::npos;
+        }
+
+        std::string second = "pass_1.eqasm\n";
+        check(write(fds[1], second.data(), second.size()) == static_cast<ssize_t>(second.size()),
+              "the second request is written");
+        close(fds[1]);
+    });
+
+    Zygote        zygote(output_dir, 2);
+    std::ofstream report(report_fn);
+    unsigned int  num_failed = 0;
+    std::string   error_msg;
+    check(zygote.serve(fds[0], report, run, num_failed, error_msg) && num_failed == 0,
+          "the waiting zygote serves the runs, " + error_msg);
+    requester.join();
+    close(fds[0]);
+    report.close();
+
+    check(reported_early, "a run is reported before the next request arrives");
+    std::remove(report_fn.c_str());
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    safe_create_logger("console", CODE_POSITION);
+    spdlog::set_level(spdlog::level::err);
+
+    const std::string output_dir = "./";
+    warm_state                   = 42;
+
+    // ---------------------------------------------------------------------------------------
+    // the requests
+    // ---------------------------------------------------------------------------------------
+    Run_request request;
+    check(request.parse("prog.eqasm mem.bin") && request.program == "prog.eqasm" &&
+            request.data_mem_dump_fn == "mem.bin",
+          "a request has a program and a dump file");
+    check(request.parse("  prog.bin") && request.data_mem_dump_fn.empty(),
+          "the dump file of a request is optional");
+    check(!request.parse("") && !request.parse("   "), "empty lines are not requests");
+    check(!request.parse("# prog.eqasm"), "comments are not requests");
+
+    // ---------------------------------------------------------------------------------------
+    // the runs
+    // ---------------------------------------------------------------------------------------
+    check_zygote(1, output_dir);
+    check_zygote(3, output_dir);
+    check_zygote(0, output_dir);
+    check_waiting_zygote(output_dir);
+
+    std::cout << (failed ? "Test_zygote FAILED." : "Test_zygote passed.") << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}